@@ -10,7 +10,14 @@
 #include <stdio.h>
 #include "pico/stdlib.h"
 #include "neural_network.h"
+#include "static_network.h"
+#include "quantized.h"
+#include "fixed_point.h"
+#include "streaming.h"
+#include "inference_cache.h"
+#include "code_lut.h"
 #include "temp_model_weights.h"
+#include "temp_model_weights_int8.h"
 #include "temp_sensor.h"
 
 using namespace CustomNN;
@@ -20,19 +27,287 @@ using namespace CustomNN;
 #define WINDOW_SIZE 10              // Number of temperature readings in sliding window
 #define SAMPLE_INTERVAL_MS 100      // Time between temperature readings
 #define DETECTION_THRESHOLD 0.7f    // Confidence threshold for "Touched" detection
+#define ADC_LUT_CODE_MIN 806        // Table range: about 60 °C ...
+#define ADC_LUT_CODE_MAX 934        // ... down to 0 °C (codes beyond are clamped)
+#define USE_INFERENCE_CACHE false   // Reuse the margin of a window of already-seen ADC codes
+#define INFERENCE_CACHE_SLOTS 64    // Cached windows (4 * (WINDOW_SIZE + 2) bytes each)
+#define TEMP_ADC_STEP_C 0.4681f     // One ADC code of the temperature sensor, in °C
+#define FIXED_INPUT_MAX_C 100.0f    // Fixed-point input range (+-°C); readings beyond saturate
+#define DETECTION_THRESHOLD_Q15 22938  // DETECTION_THRESHOLD in Q15
+
+// Model selection: MIKO_MODEL is one of these
+#define MODEL_RUNTIME 0             // Runtime engine, layer 2 folded into a logit margin
+#define MODEL_STATIC 1              // Compile-time unrolled model
+#define MODEL_INT8 2                // Integer-only int8 model
+#define MODEL_STREAMING 3           // Causal streaming: each sample computes only its own timestep
+#define MODEL_ADC_LUT 4             // Window of raw ADC codes, layer 1 from per-code tables
+#define MODEL_FIXED_POINT 5         // Q15 pipeline from ADC read to softmax
+#ifndef MIKO_MODEL                  // Set by CMake: -DMIKO_MODEL=FIXED_POINT etc.
+#define MIKO_MODEL MODEL_STATIC
+#endif
+
+#if USE_INFERENCE_CACHE && MIKO_MODEL != MODEL_STATIC && MIKO_MODEL != MODEL_RUNTIME
+#error "USE_INFERENCE_CACHE needs the static or runtime model (a float window and a margin)"
+#endif
+
+// Outcome of one inference; the floats are for the log line only
+struct Detection {
+    bool detected;
+    float normal_prob;
+    float touched_prob;
+    float last_temp;
+};
+
+#if USE_INFERENCE_CACHE
+// Logit margins keyed on the window's ADC codes: at rest the same window
+// repeats sample after sample, and a hit skips the model altogether
+InferenceCache margin_cache(WINDOW_SIZE, 1, INFERENCE_CACHE_SLOTS, TEMP_ADC_STEP_C);
+#endif
+
+// margin_of(window), through margin_cache when it is enabled
+template <typename MarginOf>
+float window_margin(const float* window, MarginOf margin_of) {
+#if USE_INFERENCE_CACHE
+    if (const float* cached = margin_cache.find(window)) {
+        return *cached;
+    }
+    const float margin = margin_of(window);
+    margin_cache.insert(&margin);
+    return margin;
+#else
+    return margin_of(window);
+#endif
+}
 
-// Global neural network instance
-NeuralNetwork* model = nullptr;
+// Each model defines, together:
+//   TempSample                       what the sliding window holds
+//   void init_model()                build and check the model
+//   TempSample read_sample(float*)   read the sensor (and the reading in °C)
+//   bool predict_window(window, out) decide on a full window
+#if MIKO_MODEL == MODEL_FIXED_POINT
+// Converted once at startup (exact power-of-two scaling); everything after
+// that is integer-only. Formats are worst-case bounds, so nothing saturates.
+const QFormat temp_fixed_input = FixedOps::format_for(FIXED_INPUT_MAX_C);
+const QFormat temp_fixed_hidden = FixedOps::output_bound(
+    &TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, TEMP_LAYER1_INPUT_SIZE,
+    TEMP_LAYER1_OUTPUT_SIZE, temp_fixed_input);
+FixedDenseLayer temp_fixed_layer1(
+    &TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, TEMP_LAYER1_INPUT_SIZE,
+    TEMP_LAYER1_OUTPUT_SIZE, ActivationType::ReLU, temp_fixed_input, temp_fixed_hidden);
+FixedDenseLayer temp_fixed_layer2(
+    &TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS, TEMP_LAYER2_INPUT_SIZE,
+    TEMP_LAYER2_OUTPUT_SIZE, ActivationType::Softmax, temp_fixed_hidden,
+    FixedOps::output_bound(&TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS,
+                           TEMP_LAYER2_INPUT_SIZE, TEMP_LAYER2_OUTPUT_SIZE, temp_fixed_hidden));
+const FixedDense* const temp_fixed_layers[] = {&temp_fixed_layer1.params(),
+                                               &temp_fixed_layer2.params()};
+static_assert(TEMP_LAYER1_INPUT_SIZE >= TEMP_LAYER1_OUTPUT_SIZE &&
+              TEMP_LAYER1_INPUT_SIZE >= TEMP_LAYER2_OUTPUT_SIZE, "Scratch too small");
+int16_t fixed_scratch_a[TEMP_LAYER1_INPUT_SIZE];
+int16_t fixed_scratch_b[TEMP_LAYER1_INPUT_SIZE];
+FixedSequential model_fixed(temp_fixed_layers, 2, fixed_scratch_a, fixed_scratch_b,
+                            TEMP_LAYER1_INPUT_SIZE);
+
+using TempSample = int16_t;  // In the model's input Q format
+
+void init_model() {
+    if (!model_fixed.is_valid()) {
+        printf("Error: fixed-point model layers do not chain!\n");
+    }
+}
 
-// Sliding window buffer for temperature readings
-float temp_window[WINDOW_SIZE] = {0};
+TempSample read_sample(float* temp_c) {
+    const int32_t temp_q16 = read_temperature_q16();
+    *temp_c = FixedOps::to_float(temp_q16, 16);
+    return FixedOps::saturate(FixedOps::shift_round(temp_q16, 16 - model_fixed.input_frac()));
+}
 
-void setup_model() {
-    printf("Initializing Thermal Anomaly Detection Model...\n");
+bool predict_window(const TempSample* window, Detection* out) {
+    // Integer-only inference and decision
+    int16_t logits[2];
+    int16_t probs[2];
+    model_fixed.predict_fixed(window, logits);
+    FixedOps::softmax(logits, model_fixed.output_frac(), probs, 2);
+
+    out->detected = (probs[1] > DETECTION_THRESHOLD_Q15);
+    out->normal_prob = FixedOps::to_float(probs[0], FixedOps::kProbFracBits);
+    out->touched_prob = FixedOps::to_float(probs[1], FixedOps::kProbFracBits);
+    out->last_temp = FixedOps::to_float(window[WINDOW_SIZE - 1], model_fixed.input_frac());
+    return true;
+}
+#elif MIKO_MODEL == MODEL_ADC_LUT
+// Layer 1 as tables of weight * temperature for every code in range, built
+// here once (10 x 129 x 8 int32, about 41 KB of RAM). A reading is stored
+// as its ADC code: no conversion, and layer 1 is integer adds only.
+CodeLutDenseLayer temp_lut_layer1(
+    &TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, TEMP_LAYER1_INPUT_SIZE,
+    TEMP_LAYER1_OUTPUT_SIZE, ActivationType::ReLU, ADC_LUT_CODE_MIN, ADC_LUT_CODE_MAX,
+    temperature_from_adc);
+using TempHead = StaticNetwork<
+    MarginDense<TEMP_LAYER2_INPUT_SIZE, TEMP_LAYER2_WEIGHTS, TEMP_LAYER2_BIAS>
+>;
+static_assert(TEMP_LAYER1_INPUT_SIZE == WINDOW_SIZE, "Model input must match the window");
+
+// DETECTION_THRESHOLD as a logit margin, set in init_model()
+float detection_margin = 0.0f;
+
+using TempSample = uint16_t; // Raw ADC code
+
+void init_model() {
+    if (!temp_lut_layer1.is_valid()) {
+        printf("Error: ADC lookup tables could not be built!\n");
+    }
+    detection_margin = BinaryClassifier::margin_for(DETECTION_THRESHOLD);
+    printf("  ADC tables: codes %d-%d, %zu bytes\n", ADC_LUT_CODE_MIN, ADC_LUT_CODE_MAX,
+           temp_lut_layer1.table_bytes());
+}
+
+TempSample read_sample(float* temp_c) {
+    const uint16_t code = read_temperature_raw();
+    *temp_c = temperature_from_adc(code);   // For the log line only
+    return code;
+}
 
-    // Create neural network with temperature model weights
+bool predict_window(const TempSample* window, Detection* out) {
+    // Table lookups and integer adds, then the one-dot-product margin
+    float hidden[TEMP_LAYER1_OUTPUT_SIZE];
+    float margin;
+    temp_lut_layer1.forward(window, hidden);
+    TempHead::predict(hidden, &margin);
+    out->detected = (margin > detection_margin);
+
+    out->touched_prob = BinaryClassifier::probability(margin);
+    out->normal_prob = 1.0f - out->touched_prob;
+    out->last_temp = temperature_from_adc(window[WINDOW_SIZE - 1]);
+    return true;
+}
+#elif MIKO_MODEL == MODEL_INT8
+// Generated by `make quantize`; weights and requant params stay in flash.
+// Scratch holds the widest tensor, which is the input window.
+static_assert(TEMP_LAYER1_INPUT_SIZE >= TEMP_LAYER1_OUTPUT_SIZE &&
+              TEMP_LAYER1_INPUT_SIZE >= TEMP_LAYER2_OUTPUT_SIZE, "Scratch too small");
+const QuantizedDense* const temp_model_q8_layers[] = {&TEMP_LAYER1_Q8, &TEMP_LAYER2_Q8};
+int8_t q8_scratch_a[TEMP_LAYER1_INPUT_SIZE];
+int8_t q8_scratch_b[TEMP_LAYER1_INPUT_SIZE];
+QuantizedSequential model_q8(temp_model_q8_layers, 2, q8_scratch_a, q8_scratch_b,
+                             TEMP_LAYER1_INPUT_SIZE);
+
+using TempSample = float;
+
+void init_model() {
+    if (!model_q8.is_valid()) {
+        printf("Error: int8 model layers do not chain!\n");
+    }
+}
+
+TempSample read_sample(float* temp_c) {
+    *temp_c = read_temperature();
+    return *temp_c;
+}
+
+bool predict_window(const TempSample* window, Detection* out) {
+    float output[2];
+    model_q8.predict(window, output);
+
+    out->normal_prob = output[0];
+    out->touched_prob = output[1];
+    out->detected = (out->touched_prob > DETECTION_THRESHOLD);
+    out->last_temp = window[WINDOW_SIZE - 1];
+    return true;
+}
+#elif MIKO_MODEL == MODEL_STREAMING
+// The Dense first layer is a causal Conv1D with WINDOW_SIZE taps (its
+// [10][8] weights are already [kernel][1][8]). Each reading goes into the
+// layer's ring buffer and one output timestep is computed as it arrives;
+// the window is never rescanned.
+const Conv1D temp_stream_conv = {&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, 0, 1,
+                                 TEMP_LAYER1_OUTPUT_SIZE, TEMP_LAYER1_INPUT_SIZE, 1, 1,
+                                 ActivationType::ReLU};
+StreamingConv1DLayer temp_stream_layer1(temp_stream_conv);
+DenseLayer temp_stream_dense2(&TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS,
+                              TEMP_LAYER2_INPUT_SIZE, TEMP_LAYER2_OUTPUT_SIZE,
+                              ActivationType::Softmax);
+StreamingPointwiseLayer temp_stream_layer2(temp_stream_dense2);
+const StreamingLayer* const temp_stream_layers[] = {&temp_stream_layer1, &temp_stream_layer2};
+StreamingSequential model_stream(temp_stream_layers, 2);
+static_assert(TEMP_LAYER1_INPUT_SIZE == WINDOW_SIZE, "Model input must match the window");
+
+// Latest output, updated by read_sample(); valid once warmed up
+float stream_probs[2] = {1.0f, 0.0f};
+bool stream_ready = false;
+
+using TempSample = float;
+
+void init_model() {
+    if (!model_stream.is_valid()) {
+        printf("Error: streaming model layers do not chain!\n");
+    }
+}
+
+TempSample read_sample(float* temp_c) {
+    *temp_c = read_temperature();
+    stream_ready = model_stream.push(temp_c, stream_probs);
+    return *temp_c;
+}
+
+bool predict_window(const TempSample* window, Detection* out) {
+    // Already computed when the reading arrived, from that reading alone
+    out->normal_prob = stream_probs[0];
+    out->touched_prob = stream_probs[1];
+    out->detected = stream_ready && (out->touched_prob > DETECTION_THRESHOLD);
+    out->last_temp = window[WINDOW_SIZE - 1];
+    return true;
+}
+#elif MIKO_MODEL == MODEL_STATIC
+// Shapes and weights are bound at compile time; predict() inlines fully.
+// The output layer is folded into the logit margin z1 - z0.
+using TempModel = StaticNetwork<
+    Dense<TEMP_LAYER1_INPUT_SIZE, TEMP_LAYER1_OUTPUT_SIZE, ActivationType::ReLU,
+          TEMP_LAYER1_WEIGHTS, TEMP_LAYER1_BIAS>,
+    MarginDense<TEMP_LAYER2_INPUT_SIZE, TEMP_LAYER2_WEIGHTS, TEMP_LAYER2_BIAS>
+>;
+static_assert(TempModel::input_size == WINDOW_SIZE, "Model input must match the window");
+
+// DETECTION_THRESHOLD as a logit margin, set in init_model()
+float detection_margin = 0.0f;
+
+using TempSample = float;
+
+void init_model() {
+    detection_margin = BinaryClassifier::margin_for(DETECTION_THRESHOLD);
+}
+
+TempSample read_sample(float* temp_c) {
+    *temp_c = read_temperature();
+    return *temp_c;
+}
+
+bool predict_window(const TempSample* window, Detection* out) {
+    // Decide on the logit margin: one dot product past the hidden layer,
+    // no exp or division
+    const float margin = window_margin(window, [](const float* input) {
+        float z;
+        TempModel::predict(input, &z);
+        return z;
+    });
+    out->detected = (margin > detection_margin);
+
+    out->touched_prob = BinaryClassifier::probability(margin);
+    out->normal_prob = 1.0f - out->touched_prob;
+    out->last_temp = window[WINDOW_SIZE - 1];
+    return true;
+}
+#elif MIKO_MODEL == MODEL_RUNTIME
+// Global binary classifier instance
+BinaryClassifier* model = nullptr;
+
+using TempSample = float;
+
+void init_model() {
+    // Create the classifier with temperature model weights; layer 2 is
+    // folded into a margin vector here
     // Cast 2D arrays to 1D pointers for compatibility
-    model = new NeuralNetwork(
+    model = new BinaryClassifier(
         &TEMP_LAYER1_WEIGHTS[0][0],  // Layer 1 weights [10][8] -> 1D array
         TEMP_LAYER1_BIAS,             // Layer 1 bias [8]
         TEMP_LAYER1_INPUT_SIZE,       // 10
@@ -40,18 +315,59 @@ void setup_model() {
         &TEMP_LAYER2_WEIGHTS[0][0],  // Layer 2 weights [8][2] -> 1D array
         TEMP_LAYER2_BIAS,             // Layer 2 bias [2]
         TEMP_LAYER2_INPUT_SIZE,       // 8
-        TEMP_LAYER2_OUTPUT_SIZE       // 2
+        TEMP_LAYER2_OUTPUT_SIZE,      // 2
+        DETECTION_THRESHOLD
     );
+    if (!model->is_valid()) {
+        printf("Error: model is not a two-class model!\n");
+    }
+}
+
+TempSample read_sample(float* temp_c) {
+    *temp_c = read_temperature();
+    return *temp_c;
+}
+
+bool predict_window(const TempSample* window, Detection* out) {
+    if (!model) {
+        printf("Error: Model not initialized!\n");
+        return false;
+    }
+    // Decide on the logit margin: one dot product past the hidden layer,
+    // no exp or division
+    const float margin = window_margin(window, [](const float* input) {
+        return model->margin(input);
+    });
+    out->detected = model->is_valid() && (margin > model->margin_threshold());
+
+    out->touched_prob = BinaryClassifier::probability(margin);
+    out->normal_prob = 1.0f - out->touched_prob;
+    out->last_temp = window[WINDOW_SIZE - 1];
+    return true;
+}
+#else
+#error "MIKO_MODEL must be one of the MODEL_* values"
+#endif
+
+// Sliding window buffer for temperature readings
+TempSample temp_window[WINDOW_SIZE] = {0};
+
+void setup_model() {
+    printf("Initializing Thermal Anomaly Detection Model...\n");
+    init_model();
 
     printf("✓ Model initialized!\n");
     printf("  Input: %zu temperature readings (sliding window)\n", TEMP_LAYER1_INPUT_SIZE);
     printf("  Hidden layer: %zu neurons (ReLU)\n", TEMP_LAYER1_OUTPUT_SIZE);
     printf("  Output: %zu classes (Normal, Touched)\n", TEMP_LAYER2_OUTPUT_SIZE);
     printf("  Sample interval: %d ms\n", SAMPLE_INTERVAL_MS);
+#if USE_INFERENCE_CACHE
+    printf("  Inference cache: %zu windows\n", margin_cache.capacity());
+#endif
     sleep_ms(500);
 }
 
-void add_temperature_to_window(float new_temp) {
+void add_temperature_to_window(TempSample new_temp) {
     // Shift window left (discard oldest reading)
     for (int i = 0; i < WINDOW_SIZE - 1; i++) {
         temp_window[i] = temp_window[i + 1];
@@ -60,34 +376,28 @@ void add_temperature_to_window(float new_temp) {
     temp_window[WINDOW_SIZE - 1] = new_temp;
 }
 
+// Reads one temperature into the window and returns it in °C for logging
+float sample_temperature() {
+    float temp;
+    add_temperature_to_window(read_sample(&temp));
+    return temp;
+}
+
 void run_inference() {
-    if (!model) {
-        printf("Error: Model not initialized!\n");
+    Detection result;
+    if (!predict_window(temp_window, &result)) {
         return;
     }
 
-    // Prepare output buffer
-    float output[2];
-
-    // Run inference on the temperature window
-    model->predict(temp_window, output);
-
-    // Extract probabilities
-    float normal_prob = output[0];
-    float touched_prob = output[1];
-
-    // Determine if finger/heat detected
-    bool detected = (touched_prob > DETECTION_THRESHOLD);
-
     // Print results
     printf("Temp: %.2f°C | Normal: %.2f | Touched: %.2f | %s\n",
-           temp_window[WINDOW_SIZE - 1],
-           normal_prob,
-           touched_prob,
-           detected ? "🔥 DETECTED!" : "Normal");
+           result.last_temp,
+           result.normal_prob,
+           result.touched_prob,
+           result.detected ? "🔥 DETECTED!" : "Normal");
 
     // Control LED based on detection
-    gpio_put(PICO_DEFAULT_LED_PIN, detected ? 1 : 0);
+    gpio_put(PICO_DEFAULT_LED_PIN, result.detected ? 1 : 0);
 }
 
 void data_collection_mode() {
@@ -167,8 +477,7 @@ int main() {
 
     // Fill the window with initial readings
     for (int i = 0; i < WINDOW_SIZE; i++) {
-        float temp = read_temperature();
-        add_temperature_to_window(temp);
+        float temp = sample_temperature();
         printf("  [%d/%d] %.2f°C\n", i + 1, WINDOW_SIZE, temp);
         sleep_ms(SAMPLE_INTERVAL_MS);
     }
@@ -179,11 +488,8 @@ int main() {
     // Main inference loop
     uint32_t sample_count = 0;
     while (true) {
-        // Read new temperature
-        float temp = read_temperature();
-
-        // Add to sliding window
-        add_temperature_to_window(temp);
+        // Read new temperature into the sliding window
+        sample_temperature();
 
         // Run inference every reading
         if (sample_count % 1 == 0) {  // Can adjust to run inference less frequently
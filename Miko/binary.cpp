@@ -0,0 +1,250 @@
+/**
+ * Binary / Ternary Weight Layers Implementation
+ */
+
+#include "binary.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace CustomNN {
+
+namespace {
+
+constexpr uint32_t kSignMask = 0x80000000u;
+
+// value * 2^-shift rounded half up (shift >= 0), or a left shift, on the
+// 64-bit products of the integer path
+int64_t shift_round_wide(int64_t value, int32_t shift) {
+    if (shift > 0) {
+        shift = std::min(shift, 62);
+        return (value >> shift) + ((value >> (shift - 1)) & 1);
+    }
+    return value * (int64_t{1} << std::min(-shift, 30));
+}
+
+int32_t to_q16(float value) {
+    const double q = std::round(std::ldexp(static_cast<double>(value), 16));
+    return static_cast<int32_t>(std::min<double>(
+        std::max<double>(q, std::numeric_limits<int32_t>::min()),
+        std::numeric_limits<int32_t>::max()));
+}
+
+// Dot product of row j's weights with packed input signs over words
+// [word_begin, word_end); input_bits is indexed from word_begin
+int32_t row_dot(const BinaryDense& layer, size_t j, const uint32_t* input_bits,
+                size_t word_begin, size_t word_end) {
+    const size_t row_words = BinaryOps::words(layer.input_size);
+    const uint32_t* signs = layer.signs + j * row_words;
+
+    uint32_t mismatches = 0;
+    uint32_t active = 0;
+    if (layer.nonzero == nullptr) {
+        for (size_t w = word_begin; w < word_end; ++w) {
+            mismatches += BinaryOps::popcount(signs[w] ^ input_bits[w - word_begin]);
+        }
+        // Padding bits are zero on both sides, so they never mismatch
+        active = static_cast<uint32_t>(
+            std::min(word_end * BinaryOps::kWordBits, layer.input_size) -
+            word_begin * BinaryOps::kWordBits);
+    } else {
+        const uint32_t* nonzero = layer.nonzero + j * row_words;
+        for (size_t w = word_begin; w < word_end; ++w) {
+            active += BinaryOps::popcount(nonzero[w]);
+            mismatches += BinaryOps::popcount(nonzero[w] & (signs[w] ^ input_bits[w - word_begin]));
+        }
+    }
+    return static_cast<int32_t>(active) - 2 * static_cast<int32_t>(mismatches);
+}
+
+} // namespace
+
+// ============================================================================
+// BinaryOps
+// ============================================================================
+
+float BinaryOps::pack_signs(const float* input, size_t size, uint32_t* bits) {
+    float sum_abs = 0.0f;
+    for (size_t w = 0; w < words(size); ++w) {
+        uint32_t word = 0;
+        const size_t end = std::min(size - w * kWordBits, kWordBits);
+        for (size_t b = 0; b < end; ++b) {
+            uint32_t raw;
+            std::memcpy(&raw, &input[w * kWordBits + b], sizeof(raw));
+            word |= (raw >> 31) << b;
+
+            // |x| by clearing the sign bit
+            raw &= ~kSignMask;
+            float magnitude;
+            std::memcpy(&magnitude, &raw, sizeof(magnitude));
+            sum_abs += magnitude;
+        }
+        bits[w] = word;
+    }
+    return sum_abs;
+}
+
+void BinaryOps::accumulate_dots(const BinaryDense& layer, const uint32_t* input_bits,
+                                size_t word_begin, size_t word_end, int32_t* dots) {
+    for (size_t j = 0; j < layer.output_size; ++j) {
+        dots[j] += row_dot(layer, j, input_bits, word_begin, word_end);
+    }
+}
+
+void BinaryOps::dense_forward(const BinaryDense& layer, const float* input, float* output) {
+    const size_t total_words = words(layer.input_size);
+    std::fill(output, output + layer.output_size, 0.0f);
+
+    // Pack kBlockWords words of input signs at a time on the stack; the
+    // integer partial dots are exact in the float outputs (|dot| < 2^24)
+    uint32_t bits[kBlockWords];
+    float sum_abs = 0.0f;
+    for (size_t word_begin = 0; word_begin < total_words; word_begin += kBlockWords) {
+        const size_t word_end = std::min(word_begin + kBlockWords, total_words);
+        const size_t first = word_begin * kWordBits;
+        sum_abs += pack_signs(input + first,
+                              std::min(layer.input_size - first, kBlockWords * kWordBits), bits);
+        for (size_t j = 0; j < layer.output_size; ++j) {
+            output[j] += static_cast<float>(row_dot(layer, j, bits, word_begin, word_end));
+        }
+    }
+
+    // alpha * beta once per sample, then one multiply-add per output
+    const float unit = (layer.input_size > 0)
+        ? layer.scale * sum_abs / static_cast<float>(layer.input_size) : 0.0f;
+    const bool relu = (layer.activation == ActivationType::ReLU);
+    for (size_t j = 0; j < layer.output_size; ++j) {
+        const float value = layer.bias[j] + unit * output[j];
+        output[j] = (relu && !(value > 0.0f)) ? 0.0f : value;
+    }
+}
+
+void BinaryOps::dense_forward_fixed(const BinaryDense& layer, const int16_t* input,
+                                    int32_t input_frac, int16_t* output, int32_t output_frac,
+                                    int32_t* dots) {
+    const size_t total_words = words(layer.input_size);
+    std::fill(dots, dots + layer.output_size, 0);
+
+    uint32_t bits[kBlockWords];
+    int64_t sum_abs = 0;
+    for (size_t word_begin = 0; word_begin < total_words; word_begin += kBlockWords) {
+        const size_t word_end = std::min(word_begin + kBlockWords, total_words);
+        for (size_t w = word_begin; w < word_end; ++w) {
+            uint32_t word = 0;
+            const size_t end = std::min(layer.input_size - w * kWordBits, kWordBits);
+            for (size_t b = 0; b < end; ++b) {
+                const int32_t x = input[w * kWordBits + b];
+                word |= static_cast<uint32_t>(x < 0) << b;
+                sum_abs += (x < 0) ? -x : x;
+            }
+            bits[w - word_begin] = word;
+        }
+        accumulate_dots(layer, bits, word_begin, word_end, dots);
+    }
+
+    // beta in the input format, alpha * beta in Q(16 + input_frac)
+    const int64_t n = static_cast<int64_t>(std::max<size_t>(layer.input_size, 1));
+    const int64_t unit = static_cast<int64_t>(layer.scale_q16) * ((sum_abs + n / 2) / n);
+    const int32_t shift = 16 + input_frac - output_frac;
+    const bool relu = (layer.activation == ActivationType::ReLU);
+    for (size_t j = 0; j < layer.output_size; ++j) {
+        int64_t value = shift_round_wide(unit * dots[j], shift) +
+                        shift_round_wide(layer.bias_q16[j], 16 - output_frac);
+        if (relu && value < 0) {
+            value = 0;
+        }
+        output[j] = static_cast<int16_t>(std::min<int64_t>(
+            std::max<int64_t>(value, std::numeric_limits<int16_t>::min()),
+            std::numeric_limits<int16_t>::max()));
+    }
+}
+
+size_t BinaryOps::storage_bytes(size_t input_size, size_t output_size, bool ternary) {
+    const size_t planes = ternary ? 2 : 1;
+    return planes * output_size * words(input_size) * sizeof(uint32_t) +
+           output_size * (sizeof(float) + sizeof(int32_t));
+}
+
+// ============================================================================
+// Layers
+// ============================================================================
+
+void BinaryLayer::forward(const float* input, float* output) const {
+    BinaryOps::dense_forward(params_, input, output);
+}
+
+BinaryDenseLayer::BinaryDenseLayer(
+    const float* weights,
+    const float* bias,
+    size_t input_size,
+    size_t output_size,
+    ActivationType activation,
+    Mode mode
+) : signs_(new uint32_t[output_size * BinaryOps::words(input_size)]()),
+    nonzero_((mode == Mode::Ternary)
+             ? new uint32_t[output_size * BinaryOps::words(input_size)]() : nullptr),
+    bias_q16_(new int32_t[output_size]),
+    params_{signs_, nonzero_, bias, bias_q16_, input_size, output_size, 0.0f, 0, activation}
+{
+    const size_t count = input_size * output_size;
+    double sum_abs = 0.0;
+    for (size_t k = 0; k < count; ++k) {
+        sum_abs += std::fabs(static_cast<double>(weights[k]));
+    }
+    const double mean_abs = (count > 0) ? sum_abs / static_cast<double>(count) : 0.0;
+
+    // Ternary: weights at or below the threshold become 0
+    const double threshold = (mode == Mode::Ternary) ? 0.7 * mean_abs : -1.0;
+    double kept_abs = 0.0;
+    size_t kept = 0;
+
+    const size_t row_words = BinaryOps::words(input_size);
+    for (size_t j = 0; j < output_size; ++j) {
+        // Transpose to output-major bit rows while converting
+        for (size_t i = 0; i < input_size; ++i) {
+            const float w = weights[i * output_size + j];
+            const double magnitude = std::fabs(static_cast<double>(w));
+            if (magnitude <= threshold) {
+                continue;
+            }
+            const uint32_t bit = uint32_t{1} << (i % BinaryOps::kWordBits);
+            const size_t word = j * row_words + i / BinaryOps::kWordBits;
+            if (w < 0.0f) {
+                signs_[word] |= bit;
+            }
+            if (nonzero_ != nullptr) {
+                nonzero_[word] |= bit;
+            }
+            kept_abs += magnitude;
+            ++kept;
+        }
+        bias_q16_[j] = to_q16(bias[j]);
+    }
+
+    params_.scale = (kept > 0) ? static_cast<float>(kept_abs / static_cast<double>(kept)) : 0.0f;
+    params_.scale_q16 = to_q16(params_.scale);
+}
+
+BinaryDenseLayer::~BinaryDenseLayer() {
+    delete[] bias_q16_;
+    delete[] nonzero_;
+    delete[] signs_;
+}
+
+BinaryDenseLayer::BinaryDenseLayer(BinaryDenseLayer&& other) noexcept
+  : signs_(other.signs_),
+    nonzero_(other.nonzero_),
+    bias_q16_(other.bias_q16_),
+    params_(other.params_)
+{
+    other.signs_ = nullptr;
+    other.nonzero_ = nullptr;
+    other.bias_q16_ = nullptr;
+}
+
+void BinaryDenseLayer::forward(const float* input, float* output) const {
+    BinaryOps::dense_forward(params_, input, output);
+}
+
+} // namespace CustomNN
@@ -0,0 +1,202 @@
+/**
+ * Binary / Ternary Weight Layers
+ * 1-bit and 2-bit dense layers evaluated with XOR/AND and popcount
+ *
+ * Weights are reduced to their sign (binary) or to {-1, 0, +1} (ternary)
+ * times one per-layer scale alpha, and packed 32 per uint32_t word: a sign
+ * plane, plus a non-zero plane for ternary weights. The input is binarized
+ * the same way on the fly, x ~= beta * sign(x) with beta = mean |x|
+ * (XNOR-Net), so each dot product is integer bit arithmetic:
+ *
+ *   binary:  dot = n - 2 * popcount(w_sign ^ x_sign)
+ *   ternary: dot = popcount(nz) - 2 * popcount(nz & (w_sign ^ x_sign))
+ *   output   = bias + alpha * beta * dot
+ *
+ * Weight memory drops 32x (binary) or 16x (ternary) against float, and the
+ * inner loop is a handful of integer ops per 32 weights instead of 32
+ * soft-float multiply-adds on the M0+. The binarization is lossy: models
+ * must be trained for it (sign activations, not ReLU, feeding each binary
+ * layer), so these layers are for new models rather than the bundled ones.
+ *
+ * Usage:
+ *   BinaryDenseLayer hidden(w2, b2, 256, 64, ActivationType::ReLU,
+ *                           BinaryDenseLayer::Mode::Ternary);
+ *   const Layer* layers[] = {&input_layer, &hidden, &output_layer};
+ *   Sequential model(layers, 3, scratch_a, scratch_b, 256);
+ */
+
+#ifndef BINARY_H
+#define BINARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include "neural_network.h"
+
+namespace CustomNN {
+
+/**
+ * Bit-packed dense layer as plain data, so it can be a constexpr in flash
+ *
+ * Row j of each plane is words(input_size) words; bit (i % 32) of word
+ * i / 32 belongs to input i. Padding bits are zero.
+ */
+struct BinaryDense {
+    const uint32_t* signs;     // [output_size][words], bit set = weight < 0
+    const uint32_t* nonzero;   // [output_size][words], bit set = weight != 0;
+                               // nullptr for binary (every weight non-zero)
+    const float* bias;         // [output_size]
+    const int32_t* bias_q16;   // [output_size], bias in Q16 for the integer path
+    size_t input_size;
+    size_t output_size;
+    float scale;               // alpha: magnitude of every non-zero weight
+    int32_t scale_q16;         // alpha in Q16
+    ActivationType activation; // ReLU is fused; Softmax is left to the caller
+};
+
+/**
+ * Bit packing, popcount and the XOR-popcount kernels
+ */
+class BinaryOps {
+public:
+    static constexpr size_t kWordBits = 32;
+
+    // Inputs packed per pass of the float kernel (kept on the stack)
+    static constexpr size_t kBlockWords = 8;
+
+    /**
+     * uint32_t words holding size bits
+     */
+    static constexpr size_t words(size_t size) { return (size + kWordBits - 1) / kWordBits; }
+
+    /**
+     * Set bits in a word. SWAR, so the M0+ (no popcount instruction) needs
+     * 12 ALU ops and one single-cycle multiply; hosts built with -mpopcnt
+     * use the instruction.
+     */
+    static inline uint32_t popcount(uint32_t v) {
+#if defined(__POPCNT__)
+        return static_cast<uint32_t>(__builtin_popcount(v));
+#else
+        v = v - ((v >> 1) & 0x55555555u);
+        v = (v & 0x33333333u) + ((v >> 2) & 0x33333333u);
+        v = (v + (v >> 4)) & 0x0F0F0F0Fu;
+        return (v * 0x01010101u) >> 24;
+#endif
+    }
+
+    /**
+     * Sign bits of input[0..size) into bits[words(size)], bit set = negative
+     * (read from the float sign bit, so no float compare)
+     * @return sum of |input[i]|
+     */
+    static float pack_signs(const float* input, size_t size, uint32_t* bits);
+
+    /**
+     * Integer dot products of the layer's weight signs with packed input
+     * signs over words [word_begin, word_end)
+     * @param input_bits Packed input signs for those words
+     * @param dots Output [layer.output_size], accumulated into
+     */
+    static void accumulate_dots(const BinaryDense& layer, const uint32_t* input_bits,
+                                size_t word_begin, size_t word_end, int32_t* dots);
+
+    /**
+     * Float forward pass: output = act(bias + alpha * beta * dot)
+     * @param input Input vector [layer.input_size]
+     * @param output Output vector [layer.output_size]
+     */
+    static void dense_forward(const BinaryDense& layer, const float* input, float* output);
+
+    /**
+     * Integer-only forward pass on Q-format activations (see fixed_point.h)
+     * @param input Input [layer.input_size] with input_frac fractional bits
+     * @param output Output [layer.output_size] with output_frac fractional
+     *               bits, saturated to int16
+     * @param dots Working buffer [layer.output_size]
+     */
+    static void dense_forward_fixed(const BinaryDense& layer, const int16_t* input,
+                                    int32_t input_frac, int16_t* output, int32_t output_frac,
+                                    int32_t* dots);
+
+    /**
+     * Bytes of a packed layer: sign (and non-zero) planes, float and Q16 bias
+     */
+    static size_t storage_bytes(size_t input_size, size_t output_size, bool ternary);
+};
+
+/**
+ * Layer over borrowed bit-packed data (e.g. a constexpr in flash)
+ */
+class BinaryLayer : public Layer {
+private:
+    const BinaryDense& params_;
+
+public:
+    explicit BinaryLayer(const BinaryDense& params) : params_(params) {}
+
+    size_t input_size() const override { return params_.input_size; }
+    size_t output_size() const override { return params_.output_size; }
+    ActivationType activation() const override { return params_.activation; }
+
+    void forward(const float* input, float* output) const override;
+};
+
+/**
+ * Owning binary or ternary conversion of a float dense layer
+ *
+ * Binary keeps sign(w) with alpha = mean |w|. Ternary zeroes weights with
+ * |w| <= 0.7 * mean |w| (the usual ternary-weight-network threshold) and
+ * sets alpha to the mean magnitude of the rest.
+ */
+class BinaryDenseLayer : public Layer {
+public:
+    enum class Mode {
+        Binary,
+        Ternary
+    };
+
+private:
+    uint32_t* signs_;
+    uint32_t* nonzero_;      // nullptr in Binary mode
+    int32_t* bias_q16_;
+    BinaryDense params_;
+
+public:
+    /**
+     * Constructor
+     * @param weights Float weights as 1D array [input_size * output_size]
+     * @param bias Float bias [output_size] (borrowed)
+     * @param input_size Layer input size
+     * @param output_size Layer output size
+     * @param activation Activation applied to the output
+     * @param mode Binary (1 bit per weight) or Ternary (2 bits)
+     */
+    BinaryDenseLayer(
+        const float* weights,
+        const float* bias,
+        size_t input_size,
+        size_t output_size,
+        ActivationType activation,
+        Mode mode
+    );
+
+    ~BinaryDenseLayer() override;
+
+    BinaryDenseLayer(BinaryDenseLayer&& other) noexcept;
+    BinaryDenseLayer(const BinaryDenseLayer&) = delete;
+    BinaryDenseLayer& operator=(const BinaryDenseLayer&) = delete;
+    BinaryDenseLayer& operator=(BinaryDenseLayer&&) = delete;
+
+    const BinaryDense& params() const { return params_; }
+    Mode mode() const { return (nonzero_ != nullptr) ? Mode::Ternary : Mode::Binary; }
+
+    size_t input_size() const override { return params_.input_size; }
+    size_t output_size() const override { return params_.output_size; }
+    ActivationType activation() const override { return params_.activation; }
+
+    void forward(const float* input, float* output) const override;
+};
+
+} // namespace CustomNN
+
+#endif // BINARY_H
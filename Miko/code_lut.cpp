@@ -0,0 +1,149 @@
+/**
+ * Code-Domain Input Layer Implementation
+ */
+
+#include "code_lut.h"
+#include <cmath>
+
+namespace CustomNN {
+
+namespace {
+
+// Worst-case sums stay below 2^30, leaving a bit of int32 headroom
+constexpr double kSumLimit = 1073741824.0;
+constexpr int32_t kMinFracBits = -15;
+constexpr int32_t kMaxFracBits = 30;
+
+// Outputs accumulated together in forward()
+constexpr size_t kBlock = 8;
+
+int32_t to_fixed32(double value, int32_t frac_bits) {
+    return static_cast<int32_t>(std::llround(std::ldexp(value, frac_bits)));
+}
+
+} // namespace
+
+CodeLutDenseLayer::CodeLutDenseLayer(
+    const float* weights,
+    const float* bias,
+    size_t input_size,
+    size_t output_size,
+    ActivationType activation,
+    uint16_t code_min,
+    uint16_t code_max,
+    Decode decode
+)
+    : table_(nullptr),
+      bias_(nullptr),
+      input_size_(input_size),
+      output_size_(output_size),
+      codes_(0),
+      code_min_(code_min),
+      code_max_(code_max),
+      frac_bits_(0),
+      scale_(1.0f),
+      activation_(activation)
+{
+    if (weights == nullptr || decode == nullptr || input_size == 0 || output_size == 0 ||
+        code_min > code_max) {
+        return;
+    }
+    codes_ = static_cast<size_t>(code_max - code_min) + 1;
+
+    // Decode once; the worst case per output is |b| + sum_i max_code |w * x|
+    double* values = new double[codes_];
+    double max_abs_value = 0.0;
+    for (size_t c = 0; c < codes_; ++c) {
+        values[c] = static_cast<double>(decode(static_cast<uint16_t>(code_min + c)));
+        max_abs_value = std::fmax(max_abs_value, std::fabs(values[c]));
+    }
+    double bound = 0.0;
+    for (size_t j = 0; j < output_size; ++j) {
+        double sum = (bias != nullptr) ? std::fabs(static_cast<double>(bias[j])) : 0.0;
+        for (size_t i = 0; i < input_size; ++i) {
+            sum += std::fabs(static_cast<double>(weights[i * output_size + j])) * max_abs_value;
+        }
+        bound = std::fmax(bound, sum);
+    }
+    frac_bits_ = kMaxFracBits;
+    while (frac_bits_ > kMinFracBits && std::ldexp(bound, frac_bits_) >= kSumLimit) {
+        --frac_bits_;
+    }
+    scale_ = std::ldexp(1.0f, -frac_bits_);
+
+    table_ = new int32_t[input_size * codes_ * output_size];
+    bias_ = new int32_t[output_size];
+    for (size_t j = 0; j < output_size; ++j) {
+        bias_[j] = (bias != nullptr) ? to_fixed32(static_cast<double>(bias[j]), frac_bits_) : 0;
+    }
+    for (size_t i = 0; i < input_size; ++i) {
+        const float* w = weights + i * output_size;
+        for (size_t c = 0; c < codes_; ++c) {
+            int32_t* row = table_ + (i * codes_ + c) * output_size;
+            for (size_t j = 0; j < output_size; ++j) {
+                row[j] = to_fixed32(static_cast<double>(w[j]) * values[c], frac_bits_);
+            }
+        }
+    }
+    delete[] values;
+}
+
+CodeLutDenseLayer::~CodeLutDenseLayer() {
+    delete[] table_;
+    delete[] bias_;
+}
+
+CodeLutDenseLayer::CodeLutDenseLayer(CodeLutDenseLayer&& other) noexcept
+    : table_(other.table_),
+      bias_(other.bias_),
+      input_size_(other.input_size_),
+      output_size_(other.output_size_),
+      codes_(other.codes_),
+      code_min_(other.code_min_),
+      code_max_(other.code_max_),
+      frac_bits_(other.frac_bits_),
+      scale_(other.scale_),
+      activation_(other.activation_)
+{
+    other.table_ = nullptr;
+    other.bias_ = nullptr;
+}
+
+size_t CodeLutDenseLayer::table_bytes() const {
+    return is_valid() ? (input_size_ * codes_ + 1) * output_size_ * sizeof(int32_t) : 0;
+}
+
+float CodeLutDenseLayer::max_error() const {
+    return static_cast<float>(input_size_ + 1) * 0.5f * scale_;
+}
+
+void CodeLutDenseLayer::forward(const uint16_t* codes, float* output) const {
+    if (table_ == nullptr) {
+        return;
+    }
+    const bool relu = (activation_ == ActivationType::ReLU);
+    const size_t plane = codes_ * output_size_;   // One position's table
+    // Outputs in register-sized blocks: each position's code is clamped and
+    // its row found once per block, then the block's entries are added
+    for (size_t j0 = 0; j0 < output_size_; j0 += kBlock) {
+        const size_t width = (output_size_ - j0 < kBlock) ? output_size_ - j0 : kBlock;
+        int32_t acc[kBlock];
+        for (size_t j = 0; j < width; ++j) {
+            acc[j] = bias_[j0 + j];
+        }
+        const int32_t* table = table_ + j0;
+        for (size_t i = 0; i < input_size_; ++i, table += plane) {
+            const uint16_t code = (codes[i] < code_min_) ? code_min_
+                                : (codes[i] > code_max_) ? code_max_ : codes[i];
+            const int32_t* row = table + static_cast<size_t>(code - code_min_) * output_size_;
+            for (size_t j = 0; j < width; ++j) {
+                acc[j] += row[j];
+            }
+        }
+        for (size_t j = 0; j < width; ++j) {
+            output[j0 + j] = (relu && acc[j] < 0) ? 0.0f : static_cast<float>(acc[j]) * scale_;
+        }
+    }
+}
+
+} // namespace CustomNN
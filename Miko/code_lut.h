@@ -0,0 +1,124 @@
+/**
+ * Code-Domain Input Layer
+ * A first Dense layer that takes raw sensor codes through lookup tables
+ *
+ * The float path converts every ADC reading to °C (on the FPU-less RP2040 a
+ * soft-float multiply, adds and a divide) and the first Dense layer then
+ * multiplies each reading by a weight per output. Both steps depend only
+ * on the reading's code and its position in the window, and the sensor
+ * produces a few hundred distinct codes over its operating range, so they
+ * can be done once, at load time, for every code:
+ *
+ *   table[i][code][j] = weights[i][j] * decode(code)
+ *   output[j]         = act(bias[j] + sum_i table[i][codes[i]][j])
+ *
+ * The window then holds raw codes and the layer costs one table row of
+ * integer adds per position: no conversion and no multiplies. The entries
+ * are int32 with frac_bits() fractional bits, the most that keep the worst
+ * case sum within int32, so the only error is one rounding per entry
+ * (max_error() bounds it; well under 1e-4 for the temperature model).
+ * ReLU is applied to the integer sums; each output then costs one
+ * int-to-float conversion and a multiply.
+ *
+ * decode() can be any conversion, not only the datasheet line, so a
+ * per-device calibration folds in at no cost. Codes outside
+ * [code_min, code_max] are clamped to the nearest end, like readings beyond
+ * a fixed-point input range saturate. The tables take
+ * input_size * (code_max - code_min + 1) * output_size * 4 bytes of RAM.
+ *
+ * Usage:
+ *   CodeLutDenseLayer layer1(&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, 10, 8,
+ *                            ActivationType::ReLU, 806, 934, temperature_from_adc);
+ *   uint16_t codes[10];   // read_temperature_raw(), oldest first
+ *   float hidden[8];
+ *   layer1.forward(codes, hidden);
+ */
+
+#ifndef CODE_LUT_H
+#define CODE_LUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include "neural_network.h"
+
+namespace CustomNN {
+
+/**
+ * Owning conversion of a float Dense layer to per-position code tables
+ */
+class CodeLutDenseLayer {
+public:
+    // Code -> model input value (e.g. temperature_from_adc)
+    using Decode = float (*)(uint16_t code);
+
+private:
+    int32_t* table_;   // Owned: [input_size][codes][output_size]
+    int32_t* bias_;    // Owned: [output_size]
+    size_t input_size_;
+    size_t output_size_;
+    size_t codes_;
+    uint16_t code_min_;
+    uint16_t code_max_;
+    int32_t frac_bits_;
+    float scale_;      // 2^-frac_bits
+    ActivationType activation_;
+
+public:
+    /**
+     * @param weights Float weights [input_size][output_size] (read during
+     *                construction only)
+     * @param bias Float bias [output_size]
+     * @param activation ReLU or None (Softmax is left to the caller)
+     * @param code_min Lowest code with a table row
+     * @param code_max Highest code with a table row
+     * @param decode Conversion of a code to the layer's float input
+     * An empty layer or code_min > code_max gives an invalid layer.
+     */
+    CodeLutDenseLayer(
+        const float* weights,
+        const float* bias,
+        size_t input_size,
+        size_t output_size,
+        ActivationType activation,
+        uint16_t code_min,
+        uint16_t code_max,
+        Decode decode
+    );
+
+    ~CodeLutDenseLayer();
+
+    CodeLutDenseLayer(CodeLutDenseLayer&& other) noexcept;
+    CodeLutDenseLayer(const CodeLutDenseLayer&) = delete;
+    CodeLutDenseLayer& operator=(const CodeLutDenseLayer&) = delete;
+    CodeLutDenseLayer& operator=(CodeLutDenseLayer&&) = delete;
+
+    bool is_valid() const { return table_ != nullptr; }
+
+    size_t input_size() const { return input_size_; }
+    size_t output_size() const { return output_size_; }
+    uint16_t code_min() const { return code_min_; }
+    uint16_t code_max() const { return code_max_; }
+    int32_t frac_bits() const { return frac_bits_; }
+
+    /**
+     * Bytes of tables and bias
+     */
+    size_t table_bytes() const;
+
+    /**
+     * Bound on the table rounding per output: (input_size + 1) / 2 units
+     * of 2^-frac_bits (the float layer adds its own rounding on top)
+     */
+    float max_error() const;
+
+    /**
+     * Table lookups and integer adds only
+     * @param codes Input codes [input_size()], clamped to the table range
+     * @param output Output [output_size()]
+     */
+    void forward(const uint16_t* codes, float* output) const;
+};
+
+} // namespace CustomNN
+
+#endif // CODE_LUT_H
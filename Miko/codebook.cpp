@@ -0,0 +1,271 @@
+/**
+ * Weight-Clustered (Codebook) Dense Layers Implementation
+ */
+
+#include "codebook.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace CustomNN {
+
+namespace {
+
+// value * 2^-shift rounded half up (shift >= 0), or a left shift, on the
+// 64-bit sums of the integer path
+int64_t shift_round_wide(int64_t value, int32_t shift) {
+    if (shift > 0) {
+        shift = std::min(shift, 62);
+        return (value >> shift) + ((value >> (shift - 1)) & 1);
+    }
+    return value * (int64_t{1} << std::min(-shift, 30));
+}
+
+int32_t to_q16(float value) {
+    const double q = std::round(std::ldexp(static_cast<double>(value), 16));
+    return static_cast<int32_t>(std::min<double>(
+        std::max<double>(q, std::numeric_limits<int32_t>::min()),
+        std::numeric_limits<int32_t>::max()));
+}
+
+} // namespace
+
+// ============================================================================
+// CodebookOps
+// ============================================================================
+
+size_t CodebookOps::cluster(const float* values, size_t count, float* codebook,
+                            size_t max_iterations) {
+    if (count == 0) {
+        std::fill(codebook, codebook + kEntries, 0.0f);
+        return 0;
+    }
+
+    float* sorted = new float[count];
+    std::copy(values, values + count, sorted);
+    std::sort(sorted, sorted + count);
+
+    // Few distinct values: each is its own centroid, padded with the last
+    size_t distinct = 0;
+    for (size_t k = 0; k < count && distinct <= kEntries; ++k) {
+        if (k == 0 || sorted[k] != sorted[k - 1]) {
+            if (distinct < kEntries) {
+                codebook[distinct] = sorted[k];
+            }
+            ++distinct;
+        }
+    }
+    if (distinct <= kEntries) {
+        std::fill(codebook + distinct, codebook + kEntries, codebook[distinct - 1]);
+        delete[] sorted;
+        return 0;
+    }
+
+    // Centroids start at the midpoints of kEntries equal-count slices
+    for (size_t k = 0; k < kEntries; ++k) {
+        codebook[k] = sorted[(2 * k + 1) * count / (2 * kEntries)];
+    }
+
+    uint8_t* assignment = new uint8_t[count];
+    std::fill(assignment, assignment + count, uint8_t{0xFF});
+    size_t iteration = 0;
+    while (iteration < max_iterations) {
+        ++iteration;
+        bool changed = false;
+        double sum[kEntries] = {};
+        size_t members[kEntries] = {};
+        for (size_t k = 0; k < count; ++k) {
+            const uint8_t index = nearest(codebook, sorted[k]);
+            changed = changed || (index != assignment[k]);
+            assignment[k] = index;
+            sum[index] += static_cast<double>(sorted[k]);
+            ++members[index];
+        }
+        if (!changed) {
+            break;
+        }
+        // An empty cluster keeps its centroid
+        for (size_t k = 0; k < kEntries; ++k) {
+            if (members[k] > 0) {
+                codebook[k] = static_cast<float>(sum[k] / static_cast<double>(members[k]));
+            }
+        }
+    }
+
+    // 1-D Lloyd keeps the centroids ordered; sort anyway for duplicates
+    std::sort(codebook, codebook + kEntries);
+    delete[] assignment;
+    delete[] sorted;
+    return iteration;
+}
+
+uint8_t CodebookOps::nearest(const float* codebook, float value) {
+    uint8_t best = 0;
+    float best_distance = std::fabs(value - codebook[0]);
+    for (size_t k = 1; k < kEntries; ++k) {
+        const float distance = std::fabs(value - codebook[k]);
+        if (distance < best_distance) {
+            best_distance = distance;
+            best = static_cast<uint8_t>(k);
+        }
+    }
+    return best;
+}
+
+uint8_t CodebookOps::index_at(const CodebookDense& layer, size_t j, size_t i) {
+    const uint8_t byte = layer.indices[j * row_bytes(layer.input_size) + i / 2];
+    return static_cast<uint8_t>(((i % 2) == 0) ? (byte & 0x0Fu) : (byte >> 4));
+}
+
+void CodebookOps::dense_forward(const CodebookDense& layer, const float* input, float* output) {
+    const size_t rb = row_bytes(layer.input_size);
+    const size_t pairs = layer.input_size / 2;
+    const bool relu = (layer.activation == ActivationType::ReLU);
+
+    for (size_t j = 0; j < layer.output_size; ++j) {
+        const uint8_t* row = layer.indices + j * rb;
+
+        if (layer.input_size <= kEntries) {
+            // No more inputs than entries: bucketing would not save a multiply
+            float acc = layer.bias[j];
+            for (size_t i = 0; i < layer.input_size; ++i) {
+                const uint8_t byte = row[i / 2];
+                acc += layer.codebook[((i % 2) == 0) ? (byte & 0x0Fu) : (byte >> 4)] * input[i];
+            }
+            output[j] = (relu && !(acc > 0.0f)) ? 0.0f : acc;
+            continue;
+        }
+
+        // Bucket the inputs by weight index: additions only
+        float sums[kEntries] = {};
+        for (size_t p = 0; p < pairs; ++p) {
+            const uint8_t byte = row[p];
+            sums[byte & 0x0Fu] += input[2 * p];
+            sums[byte >> 4] += input[2 * p + 1];
+        }
+        if ((layer.input_size % 2) != 0) {
+            sums[row[pairs] & 0x0Fu] += input[layer.input_size - 1];
+        }
+
+        // One multiply per codebook entry
+        float acc = layer.bias[j];
+        for (size_t k = 0; k < kEntries; ++k) {
+            acc += layer.codebook[k] * sums[k];
+        }
+        output[j] = (relu && !(acc > 0.0f)) ? 0.0f : acc;
+    }
+}
+
+void CodebookOps::dense_forward_fixed(const CodebookDense& layer, const int16_t* input,
+                                      int32_t input_frac, int16_t* output, int32_t output_frac) {
+    const size_t rb = row_bytes(layer.input_size);
+    const size_t pairs = layer.input_size / 2;
+    const bool relu = (layer.activation == ActivationType::ReLU);
+    const int32_t shift = 16 + input_frac - output_frac;
+    const int32_t bias_shift = 16 - output_frac;
+
+    for (size_t j = 0; j < layer.output_size; ++j) {
+        const uint8_t* row = layer.indices + j * rb;
+
+        // Q(16 + input_frac) products, summed in 64 bits (exact, so the
+        // direct and bucketed forms give the same result)
+        int64_t acc = 0;
+        if (layer.input_size <= kEntries) {
+            for (size_t i = 0; i < layer.input_size; ++i) {
+                const uint8_t byte = row[i / 2];
+                const uint8_t k = static_cast<uint8_t>(((i % 2) == 0) ? (byte & 0x0Fu) : (byte >> 4));
+                acc += static_cast<int64_t>(layer.codebook_q16[k]) * input[i];
+            }
+        } else {
+            int32_t sums[kEntries] = {};
+            for (size_t p = 0; p < pairs; ++p) {
+                const uint8_t byte = row[p];
+                sums[byte & 0x0Fu] += input[2 * p];
+                sums[byte >> 4] += input[2 * p + 1];
+            }
+            if ((layer.input_size % 2) != 0) {
+                sums[row[pairs] & 0x0Fu] += input[layer.input_size - 1];
+            }
+            for (size_t k = 0; k < kEntries; ++k) {
+                acc += static_cast<int64_t>(layer.codebook_q16[k]) * sums[k];
+            }
+        }
+        int64_t value = shift_round_wide(acc, shift) +
+                        shift_round_wide(layer.bias_q16[j], bias_shift);
+        if (relu && value < 0) {
+            value = 0;
+        }
+        output[j] = static_cast<int16_t>(std::min<int64_t>(
+            std::max<int64_t>(value, std::numeric_limits<int16_t>::min()),
+            std::numeric_limits<int16_t>::max()));
+    }
+}
+
+size_t CodebookOps::storage_bytes(size_t input_size, size_t output_size) {
+    return output_size * row_bytes(input_size) +
+           kEntries * (sizeof(float) + sizeof(int32_t)) +
+           output_size * (sizeof(float) + sizeof(int32_t));
+}
+
+// ============================================================================
+// Layers
+// ============================================================================
+
+void CodebookLayer::forward(const float* input, float* output) const {
+    CodebookOps::dense_forward(params_, input, output);
+}
+
+CodebookDenseLayer::CodebookDenseLayer(
+    const float* weights,
+    const float* bias,
+    size_t input_size,
+    size_t output_size,
+    ActivationType activation
+) : indices_(new uint8_t[output_size * CodebookOps::row_bytes(input_size)]()),
+    codebook_(new float[CodebookOps::kEntries]),
+    codebook_q16_(new int32_t[CodebookOps::kEntries]),
+    bias_q16_(new int32_t[output_size]),
+    params_{indices_, codebook_, codebook_q16_, bias, bias_q16_, input_size, output_size,
+            activation}
+{
+    CodebookOps::cluster(weights, input_size * output_size, codebook_);
+    for (size_t k = 0; k < CodebookOps::kEntries; ++k) {
+        codebook_q16_[k] = to_q16(codebook_[k]);
+    }
+
+    // Transpose to output-major packed rows while assigning
+    const size_t rb = CodebookOps::row_bytes(input_size);
+    for (size_t j = 0; j < output_size; ++j) {
+        for (size_t i = 0; i < input_size; ++i) {
+            const uint8_t index = CodebookOps::nearest(codebook_, weights[i * output_size + j]);
+            indices_[j * rb + i / 2] |= static_cast<uint8_t>(((i % 2) == 0) ? index : index << 4);
+        }
+        bias_q16_[j] = to_q16(bias[j]);
+    }
+}
+
+CodebookDenseLayer::~CodebookDenseLayer() {
+    delete[] bias_q16_;
+    delete[] codebook_q16_;
+    delete[] codebook_;
+    delete[] indices_;
+}
+
+CodebookDenseLayer::CodebookDenseLayer(CodebookDenseLayer&& other) noexcept
+  : indices_(other.indices_),
+    codebook_(other.codebook_),
+    codebook_q16_(other.codebook_q16_),
+    bias_q16_(other.bias_q16_),
+    params_(other.params_)
+{
+    other.indices_ = nullptr;
+    other.codebook_ = nullptr;
+    other.codebook_q16_ = nullptr;
+    other.bias_q16_ = nullptr;
+}
+
+void CodebookDenseLayer::forward(const float* input, float* output) const {
+    CodebookOps::dense_forward(params_, input, output);
+}
+
+} // namespace CustomNN
@@ -0,0 +1,178 @@
+/**
+ * Weight-Clustered (Codebook) Dense Layers
+ * Each weight is a 4-bit index into a per-layer table of 16 values
+ *
+ * The trained weights of a layer are clustered with 1-D k-means into 16
+ * centroids (the codebook); every weight is replaced by the index of its
+ * nearest centroid, packed two per byte. Since a row only ever multiplies
+ * by 16 distinct values, the kernel first adds each input into the bucket
+ * of its weight's index, then multiplies the 16 bucket sums by the
+ * codebook:
+ *
+ *   output[j] = bias[j] + sum_k codebook[k] * sum_{i : index[j][i] == k} input[i]
+ *
+ * That is input_size additions but only 16 multiplies per output instead
+ * of input_size multiply-adds, which is what costs on the M0+ (a soft-float
+ * multiply is ~55 cycles). Layers with at most 16 inputs would not save a
+ * multiply, so they look the entry up per weight instead. Weight storage
+ * is 4 bits instead of 32.
+ *
+ * Usage:
+ *   CodebookDenseLayer hidden(w1, b1, 10, 8, ActivationType::ReLU);
+ *   const Layer* layers[] = {&hidden, &output_layer};
+ *   Sequential model(layers, 2, scratch_a, scratch_b, 8);
+ *
+ * The generated headers (temp_model_weights_codebook.h,
+ * model_weights_codebook.h) come from tools/cluster_weights; see
+ * `make cluster`.
+ */
+
+#ifndef CODEBOOK_H
+#define CODEBOOK_H
+
+#include <cstddef>
+#include <cstdint>
+#include "neural_network.h"
+
+namespace CustomNN {
+
+/**
+ * Codebook dense layer as plain data, so it can be a constexpr in flash
+ *
+ * Row j of indices is row_bytes(input_size) bytes; input i is the low
+ * nibble of byte i / 2 when i is even, the high nibble when odd.
+ */
+struct CodebookDense {
+    const uint8_t* indices;      // Output-major: [output_size][row_bytes]
+    const float* codebook;       // [kEntries]
+    const int32_t* codebook_q16; // [kEntries], codebook in Q16 for the integer path
+    const float* bias;           // [output_size]
+    const int32_t* bias_q16;     // [output_size]
+    size_t input_size;
+    size_t output_size;
+    ActivationType activation;   // ReLU is fused; Softmax is left to the caller
+};
+
+/**
+ * K-means clustering and the bucket-sum kernels
+ */
+class CodebookOps {
+public:
+    static constexpr size_t kEntries = 16;
+
+    /**
+     * Bytes per packed row of size indices
+     */
+    static constexpr size_t row_bytes(size_t size) { return (size + 1) / 2; }
+
+    /**
+     * 1-D k-means of values into kEntries centroids (ascending). Starts
+     * from evenly spaced quantiles and runs Lloyd iterations until no
+     * assignment changes, so the result is deterministic. With kEntries or
+     * fewer distinct values every value is its own centroid.
+     * @param values Input [count]
+     * @param codebook Output centroids [kEntries]
+     * @param max_iterations Iteration cap
+     * @return Iterations run
+     */
+    static size_t cluster(const float* values, size_t count, float* codebook,
+                          size_t max_iterations = 100);
+
+    /**
+     * Index of the centroid nearest to value (lowest on ties)
+     */
+    static uint8_t nearest(const float* codebook, float value);
+
+    static uint8_t index_at(const CodebookDense& layer, size_t j, size_t i);
+
+    /**
+     * Float forward pass: bucket sums, then 16 multiplies per output (or
+     * one per weight when input_size <= kEntries)
+     * @param input Input vector [layer.input_size]
+     * @param output Output vector [layer.output_size]
+     */
+    static void dense_forward(const CodebookDense& layer, const float* input, float* output);
+
+    /**
+     * Integer-only forward pass on Q-format activations (see fixed_point.h).
+     * Bucket sums are int32, so input_size must stay below 65536.
+     * @param input Input [layer.input_size] with input_frac fractional bits
+     * @param output Output [layer.output_size] with output_frac fractional
+     *               bits, saturated to int16
+     */
+    static void dense_forward_fixed(const CodebookDense& layer, const int16_t* input,
+                                    int32_t input_frac, int16_t* output, int32_t output_frac);
+
+    /**
+     * Bytes of a layer: packed indices, float and Q16 codebook and bias
+     */
+    static size_t storage_bytes(size_t input_size, size_t output_size);
+};
+
+/**
+ * Layer over borrowed codebook data (e.g. a constexpr in flash)
+ */
+class CodebookLayer : public Layer {
+private:
+    const CodebookDense& params_;
+
+public:
+    explicit CodebookLayer(const CodebookDense& params) : params_(params) {}
+
+    size_t input_size() const override { return params_.input_size; }
+    size_t output_size() const override { return params_.output_size; }
+    ActivationType activation() const override { return params_.activation; }
+
+    void forward(const float* input, float* output) const override;
+};
+
+/**
+ * Owning codebook conversion of a float dense layer
+ *
+ * Clusters all weights of the layer into one codebook and transposes the
+ * indices to output-major packed rows.
+ */
+class CodebookDenseLayer : public Layer {
+private:
+    uint8_t* indices_;
+    float* codebook_;
+    int32_t* codebook_q16_;
+    int32_t* bias_q16_;
+    CodebookDense params_;
+
+public:
+    /**
+     * Constructor
+     * @param weights Float weights as 1D array [input_size * output_size]
+     * @param bias Float bias [output_size] (borrowed)
+     * @param input_size Layer input size
+     * @param output_size Layer output size
+     * @param activation Activation applied to the output
+     */
+    CodebookDenseLayer(
+        const float* weights,
+        const float* bias,
+        size_t input_size,
+        size_t output_size,
+        ActivationType activation
+    );
+
+    ~CodebookDenseLayer() override;
+
+    CodebookDenseLayer(CodebookDenseLayer&& other) noexcept;
+    CodebookDenseLayer(const CodebookDenseLayer&) = delete;
+    CodebookDenseLayer& operator=(const CodebookDenseLayer&) = delete;
+    CodebookDenseLayer& operator=(CodebookDenseLayer&&) = delete;
+
+    const CodebookDense& params() const { return params_; }
+
+    size_t input_size() const override { return params_.input_size; }
+    size_t output_size() const override { return params_.output_size; }
+    ActivationType activation() const override { return params_.activation; }
+
+    void forward(const float* input, float* output) const override;
+};
+
+} // namespace CustomNN
+
+#endif // CODEBOOK_H
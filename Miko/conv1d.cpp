@@ -0,0 +1,142 @@
+/**
+ * Temporal Convolution and Pooling Layers Implementation
+ */
+
+#include "conv1d.h"
+
+namespace CustomNN {
+
+// ============================================================================
+// ConvOps
+// ============================================================================
+
+size_t ConvOps::output_length(size_t input_length, size_t kernel_size, size_t stride,
+                              size_t dilation) {
+    if (kernel_size == 0 || stride == 0 || dilation == 0) {
+        return 0;
+    }
+    const size_t span = dilation * (kernel_size - 1) + 1;
+    if (span > input_length) {
+        return 0;
+    }
+    return (input_length - span) / stride + 1;
+}
+
+size_t ConvOps::output_length(const Conv1D& conv) {
+    if (conv.in_channels == 0 || conv.out_channels == 0) {
+        return 0;
+    }
+    return output_length(conv.input_length, conv.kernel_size, conv.stride, conv.dilation);
+}
+
+size_t ConvOps::macs(const Conv1D& conv) {
+    return output_length(conv) * conv.kernel_size * conv.in_channels * conv.out_channels;
+}
+
+void ConvOps::conv1d_forward(const Conv1D& conv, const float* input, float* output) {
+    const size_t out_length = output_length(conv);
+    const size_t in_ch = conv.in_channels;
+    const size_t out_ch = conv.out_channels;
+    const size_t tap_stride = conv.dilation * in_ch;
+    const bool relu = (conv.activation == ActivationType::ReLU);
+
+    // kPositions output positions at a time: independent accumulators keep
+    // the FPU busy instead of waiting on one chain of dependent adds. Each
+    // output still adds its taps, then channels, in order.
+    constexpr size_t kPositions = 4;
+    const size_t position_stride = conv.stride * in_ch;
+    size_t t = 0;
+    for (; t + kPositions <= out_length; t += kPositions) {
+        const float* x = input + t * position_stride;
+        for (size_t o = 0; o < out_ch; ++o) {
+            const float bias = (conv.bias != nullptr) ? conv.bias[o] : 0.0f;
+            float acc[kPositions];
+            for (size_t p = 0; p < kPositions; ++p) {
+                acc[p] = bias;
+            }
+            const float* w = conv.weights + o;
+            const float* tap = x;
+            for (size_t k = 0; k < conv.kernel_size; ++k, tap += tap_stride) {
+                for (size_t c = 0; c < in_ch; ++c, w += out_ch) {
+                    const float wc = *w;
+                    for (size_t p = 0; p < kPositions; ++p) {
+                        acc[p] += tap[p * position_stride + c] * wc;
+                    }
+                }
+            }
+            for (size_t p = 0; p < kPositions; ++p) {
+                output[(t + p) * out_ch + o] = (relu && !(acc[p] > 0.0f)) ? 0.0f : acc[p];
+            }
+        }
+    }
+
+    // Remaining positions, one register accumulator per output
+    for (; t < out_length; ++t) {
+        const float* x = input + t * position_stride;
+        float* out = output + t * out_ch;
+        for (size_t o = 0; o < out_ch; ++o) {
+            float acc = (conv.bias != nullptr) ? conv.bias[o] : 0.0f;
+            const float* w = conv.weights + o;
+            const float* tap = x;
+            for (size_t k = 0; k < conv.kernel_size; ++k, tap += tap_stride) {
+                for (size_t c = 0; c < in_ch; ++c, w += out_ch) {
+                    acc += tap[c] * *w;
+                }
+            }
+            out[o] = (relu && !(acc > 0.0f)) ? 0.0f : acc;
+        }
+    }
+}
+
+void ConvOps::max_pool1d(const float* input, float* output, size_t length, size_t channels,
+                         size_t pool_size, size_t stride) {
+    const size_t out_length = output_length(length, pool_size, stride, 1);
+    for (size_t t = 0; t < out_length; ++t) {
+        const float* x = input + t * stride * channels;
+        float* out = output + t * channels;
+        for (size_t c = 0; c < channels; ++c) {
+            out[c] = x[c];
+        }
+        for (size_t k = 1; k < pool_size; ++k) {
+            const float* row = x + k * channels;
+            for (size_t c = 0; c < channels; ++c) {
+                out[c] = (row[c] > out[c]) ? row[c] : out[c];
+            }
+        }
+    }
+}
+
+void ConvOps::global_average_pool(const float* input, float* output, size_t length,
+                                  size_t channels) {
+    for (size_t c = 0; c < channels; ++c) {
+        output[c] = 0.0f;
+    }
+    for (size_t t = 0; t < length; ++t) {
+        const float* row = input + t * channels;
+        for (size_t c = 0; c < channels; ++c) {
+            output[c] += row[c];
+        }
+    }
+    const float scale = 1.0f / static_cast<float>(length);
+    for (size_t c = 0; c < channels; ++c) {
+        output[c] *= scale;
+    }
+}
+
+// ============================================================================
+// Layers
+// ============================================================================
+
+void Conv1DLayer::forward(const float* input, float* output) const {
+    ConvOps::conv1d_forward(params_, input, output);
+}
+
+void MaxPool1DLayer::forward(const float* input, float* output) const {
+    ConvOps::max_pool1d(input, output, length_, channels_, pool_size_, stride_);
+}
+
+void GlobalAveragePoolLayer::forward(const float* input, float* output) const {
+    ConvOps::global_average_pool(input, output, length_, channels_);
+}
+
+} // namespace CustomNN
@@ -0,0 +1,179 @@
+/**
+ * Temporal Convolution and Pooling Layers
+ * Conv1D (stride, dilation), MaxPool1D and GlobalAveragePool over windows
+ *
+ * A Dense first layer needs one weight per window position and output, so
+ * its size and cost grow with the window. A Conv1D layer slides one small
+ * kernel along the window instead: parameters depend only on the kernel
+ * size and channel counts, and each output costs kernel_size * in_channels
+ * multiply-adds however long the window is. Pooling then shrinks the
+ * sequence (MaxPool1D) or collapses it to one value per channel
+ * (GlobalAveragePool) before a small Dense head, so a 100- or 1000-sample
+ * window runs through the same few hundred weights as a 10-sample one.
+ *
+ * Tensors are channels-last, [length][channels] flattened, as in Keras: a
+ * window of temperature readings is [length][1], i.e. the plain array the
+ * Dense models already take. Conv1D weights use the Keras kernel layout
+ * [kernel_size][in_channels][out_channels].
+ *
+ * The convolution is direct: each output value is one register
+ * accumulator that starts at the bias and adds, tap by tap and channel by
+ * channel, input[t * stride + k * dilation] times its kernel weight. There
+ * is no im2col copy and no scratch beyond the layer's output. Padding is "valid" (no padding): the output has
+ * (length - dilation * (kernel_size - 1) - 1) / stride + 1 positions.
+ *
+ * Usage:
+ *   // 100 readings -> Conv1D(5 taps, 8 filters) -> MaxPool1D(2) ->
+ *   //   Conv1D(3 taps, dilation 2) -> GlobalAveragePool -> Dense(8 -> 2)
+ *   const Conv1D c1 = {w1, b1, 100, 1, 8, 5, 1, 1, ActivationType::ReLU};
+ *   Conv1DLayer conv1(c1);                      // 96 x 8
+ *   MaxPool1DLayer pool(96, 8, 2);              // 48 x 8
+ *   const Conv1D c2 = {w2, b2, 48, 8, 8, 3, 1, 2, ActivationType::ReLU};
+ *   Conv1DLayer conv2(c2);                      // 44 x 8
+ *   GlobalAveragePoolLayer gap(44, 8);          // 8
+ *   DenseLayer head(w3, b3, 8, 2, ActivationType::Softmax);
+ *   const Layer* layers[] = {&conv1, &pool, &conv2, &gap, &head};
+ *   Sequential model(layers, 5, scratch_a, scratch_b, 768);
+ */
+
+#ifndef CONV1D_H
+#define CONV1D_H
+
+#include <cstddef>
+#include "neural_network.h"
+
+namespace CustomNN {
+
+/**
+ * Conv1D layer as plain data, so it can be a constexpr in flash
+ */
+struct Conv1D {
+    const float* weights;        // [kernel_size][in_channels][out_channels]
+    const float* bias;           // [out_channels], or nullptr for none
+    size_t input_length;
+    size_t in_channels;
+    size_t out_channels;
+    size_t kernel_size;
+    size_t stride;               // >= 1
+    size_t dilation;             // >= 1; gap between taps
+    ActivationType activation;   // ReLU is fused; Softmax is left to the caller
+};
+
+/**
+ * Convolution and pooling kernels on [length][channels] tensors
+ */
+class ConvOps {
+public:
+    /**
+     * Output positions of a valid window of kernel_size taps spaced
+     * dilation apart, moved stride at a time
+     * @return 0 if the parameters are invalid or the kernel does not fit
+     */
+    static size_t output_length(size_t input_length, size_t kernel_size, size_t stride,
+                                size_t dilation);
+    static size_t output_length(const Conv1D& conv);
+
+    /**
+     * Multiply-adds per forward pass
+     */
+    static size_t macs(const Conv1D& conv);
+
+    /**
+     * Direct convolution (see the file comment)
+     * @param input Input [input_length][in_channels]
+     * @param output Output [output_length(conv)][out_channels]
+     */
+    static void conv1d_forward(const Conv1D& conv, const float* input, float* output);
+
+    /**
+     * Largest value per channel over each window of pool_size positions
+     * @param output Output [output_length(length, pool_size, stride, 1)][channels]
+     */
+    static void max_pool1d(const float* input, float* output, size_t length, size_t channels,
+                           size_t pool_size, size_t stride);
+
+    /**
+     * Mean per channel over all positions
+     * @param output Output [channels]
+     */
+    static void global_average_pool(const float* input, float* output, size_t length,
+                                    size_t channels);
+};
+
+/**
+ * Conv1D over borrowed weights
+ */
+class Conv1DLayer : public Layer {
+private:
+    Conv1D params_;
+    size_t output_length_;
+
+public:
+    explicit Conv1DLayer(const Conv1D& params)
+        : params_(params), output_length_(ConvOps::output_length(params)) {}
+
+    /**
+     * False if the kernel does not fit the input (output_size() is then 0)
+     */
+    bool valid() const { return output_length_ > 0; }
+
+    const Conv1D& params() const { return params_; }
+    size_t output_length() const { return output_length_; }
+
+    size_t input_size() const override { return params_.input_length * params_.in_channels; }
+    size_t output_size() const override { return output_length_ * params_.out_channels; }
+    ActivationType activation() const override { return params_.activation; }
+
+    void forward(const float* input, float* output) const override;
+};
+
+/**
+ * MaxPool1D over [length][channels]; stride defaults to pool_size
+ * (non-overlapping windows, the Keras default)
+ */
+class MaxPool1DLayer : public Layer {
+private:
+    size_t length_;
+    size_t channels_;
+    size_t pool_size_;
+    size_t stride_;
+    size_t output_length_;
+
+public:
+    MaxPool1DLayer(size_t length, size_t channels, size_t pool_size, size_t stride = 0)
+        : length_(length), channels_(channels), pool_size_(pool_size),
+          stride_((stride == 0) ? pool_size : stride),
+          output_length_(ConvOps::output_length(length, pool_size, stride_, 1)) {}
+
+    bool valid() const { return output_length_ > 0 && channels_ > 0; }
+    size_t output_length() const { return output_length_; }
+
+    size_t input_size() const override { return length_ * channels_; }
+    size_t output_size() const override { return output_length_ * channels_; }
+
+    void forward(const float* input, float* output) const override;
+};
+
+/**
+ * GlobalAveragePool: [length][channels] -> [channels]
+ */
+class GlobalAveragePoolLayer : public Layer {
+private:
+    size_t length_;
+    size_t channels_;
+
+public:
+    GlobalAveragePoolLayer(size_t length, size_t channels)
+        : length_(length), channels_(channels) {}
+
+    bool valid() const { return length_ > 0 && channels_ > 0; }
+
+    size_t input_size() const override { return length_ * channels_; }
+    size_t output_size() const override { return channels_; }
+
+    void forward(const float* input, float* output) const override;
+};
+
+} // namespace CustomNN
+
+#endif // CONV1D_H
@@ -0,0 +1,868 @@
+/**
+ * Dense Kernel Dispatch Implementation
+ * Scalar reference kernels plus SSE2 / AVX2 / AVX-512 variants for x86
+ */
+
+#include "dense_kernels.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CUSTOMNN_X86_KERNELS 1
+#include <immintrin.h>
+#else
+#define CUSTOMNN_X86_KERNELS 0
+#endif
+
+// Tail helpers are inlined into each ISA variant so a whole kernel runs in
+// one instruction encoding (no SSE/AVX transition stalls between calls)
+#if defined(__GNUC__)
+#define KERNEL_INLINE inline __attribute__((always_inline))
+#else
+#define KERNEL_INLINE inline
+#endif
+
+namespace CustomNN {
+namespace Kernels {
+
+namespace {
+
+// ============================================================================
+// Scalar (portable reference)
+// ============================================================================
+
+// Same result as Activation::relu: max(0, x), with NaN mapped to 0
+KERNEL_INLINE float relu_if(float value, bool relu) {
+    return (relu && !(value > 0.0f)) ? 0.0f : value;
+}
+
+KERNEL_INLINE float bias_or_zero(const float* bias, size_t j) {
+    return (bias != nullptr) ? bias[j] : 0.0f;
+}
+
+// Columns [j_begin, cols) of the input-major dense kernel, one column at a
+// time so each accumulator stays in a register until its single store.
+// Also used for the tails the vector kernels leave behind.
+KERNEL_INLINE void dense_scalar_from(
+    const float* weights,
+    const float* bias,
+    const float* input,
+    float* output,
+    size_t rows,
+    size_t cols,
+    bool relu,
+    size_t j_begin
+) {
+    for (size_t j = j_begin; j < cols; ++j) {
+        float acc = bias_or_zero(bias, j);
+        for (size_t i = 0; i < rows; ++i) {
+            // Access weights as 1D array: weights[i][j] = weights[i * cols + j]
+            acc += weights[i * cols + j] * input[i];
+        }
+        output[j] = relu_if(acc, relu);
+    }
+}
+
+void dense_scalar(
+    const float* weights,  // weights[rows][cols]
+    const float* bias,     // bias[cols] or nullptr
+    const float* input,    // input[rows]
+    float* output,         // output[cols]
+    size_t rows,
+    size_t cols,
+    bool relu
+) {
+    dense_scalar_from(weights, bias, input, output, rows, cols, relu, 0);
+}
+
+// Sequential dot product continuing from acc: the same order as one column
+// of the input-major kernel
+KERNEL_INLINE float dot_scalar_from(const float* a, const float* b, size_t n,
+                                   size_t i_begin, float acc) {
+    for (size_t i = i_begin; i < n; ++i) {
+        acc += a[i] * b[i];
+    }
+    return acc;
+}
+
+void dense_packed_scalar(
+    const float* packed,    // packed[output_size][stride]
+    const float* bias,      // bias[output_size] or nullptr
+    const float* input,     // input[input_size]
+    float* output,          // output[output_size]
+    size_t input_size,
+    size_t output_size,
+    size_t stride,
+    bool relu
+) {
+    for (size_t j = 0; j < output_size; ++j) {
+        const float acc = dot_scalar_from(packed + j * stride, input, input_size, 0,
+                                          bias_or_zero(bias, j));
+        output[j] = relu_if(acc, relu);
+    }
+}
+
+KERNEL_INLINE void vector_add_scalar_from(const float* a, const float* b, float* output,
+                                          size_t size, size_t i_begin) {
+    for (size_t i = i_begin; i < size; ++i) {
+        output[i] = a[i] + b[i];
+    }
+}
+
+void vector_add_scalar(const float* a, const float* b, float* output, size_t size) {
+    vector_add_scalar_from(a, b, output, size, 0);
+}
+
+// GEMM tile width of the scalar and SSE2 kernels
+constexpr size_t kScalarGemmCols = 8;
+
+// A kGemmRows x cols scalar tile. Inlined with a constant cols the
+// accumulators stay in registers; the SSE2 kernel uses it for narrow tiles.
+KERNEL_INLINE void gemm_tile_scalar_cols(
+    const float* inputs,
+    const float* weights,
+    const float* bias,
+    float* outputs,
+    size_t input_size,
+    size_t output_size,
+    size_t cols,
+    size_t k_begin,
+    size_t k_end,
+    bool relu
+) {
+    float acc[kGemmRows][kScalarGemmCols];
+
+    for (size_t m = 0; m < kGemmRows; ++m) {
+        for (size_t t = 0; t < cols; ++t) {
+            acc[m][t] = (k_begin == 0) ? bias[t] : outputs[m * output_size + t];
+        }
+    }
+
+    for (size_t k = k_begin; k < k_end; ++k) {
+        const float* w = weights + k * output_size;
+        for (size_t m = 0; m < kGemmRows; ++m) {
+            const float a = inputs[m * input_size + k];
+            for (size_t t = 0; t < cols; ++t) {
+                acc[m][t] += a * w[t];
+            }
+        }
+    }
+
+    const bool apply_relu = relu && (k_end == input_size);
+    for (size_t m = 0; m < kGemmRows; ++m) {
+        for (size_t t = 0; t < cols; ++t) {
+            outputs[m * output_size + t] = relu_if(acc[m][t], apply_relu);
+        }
+    }
+}
+
+void gemm_tile_scalar(const float* inputs, const float* weights, const float* bias,
+                      float* outputs, size_t input_size, size_t output_size, size_t cols,
+                      size_t k_begin, size_t k_end, bool relu) {
+    if (cols == kScalarGemmCols) {
+        gemm_tile_scalar_cols(inputs, weights, bias, outputs, input_size, output_size,
+                              kScalarGemmCols, k_begin, k_end, relu);
+    } else {
+        gemm_tile_scalar_cols(inputs, weights, bias, outputs, input_size, output_size,
+                              cols, k_begin, k_end, relu);
+    }
+}
+
+constexpr DenseKernels kScalarKernels = {
+    Isa::Scalar, "scalar", dense_scalar, dense_packed_scalar, vector_add_scalar,
+    gemm_tile_scalar, kScalarGemmCols
+};
+
+#if CUSTOMNN_X86_KERNELS
+
+// ============================================================================
+// SSE2 (4 floats per register)
+// ============================================================================
+
+// maxps returns its second operand for NaN and for +/-0, so this matches
+// relu_if exactly
+__attribute__((target("sse2")))
+KERNEL_INLINE __m128 relu_if_sse2(__m128 v, bool relu) {
+    return relu ? _mm_max_ps(v, _mm_setzero_ps()) : v;
+}
+
+__attribute__((target("sse2")))
+KERNEL_INLINE __m128 bias_or_zero_sse2(const float* bias, size_t j) {
+    return (bias != nullptr) ? _mm_loadu_ps(bias + j) : _mm_setzero_ps();
+}
+
+__attribute__((target("sse2")))
+KERNEL_INLINE void dense_sse2_from(const float* weights, const float* bias,
+                                   const float* input, float* output, size_t rows,
+                                   size_t cols, bool relu, size_t j) {
+    // Four independent accumulators hide the add latency
+    for (; j + 16 <= cols; j += 16) {
+        __m128 acc0 = bias_or_zero_sse2(bias, j);
+        __m128 acc1 = bias_or_zero_sse2(bias, j + 4);
+        __m128 acc2 = bias_or_zero_sse2(bias, j + 8);
+        __m128 acc3 = bias_or_zero_sse2(bias, j + 12);
+        for (size_t i = 0; i < rows; ++i) {
+            const float* w = weights + i * cols + j;
+            const __m128 x = _mm_set1_ps(input[i]);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(w), x));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(w + 4), x));
+            acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(w + 8), x));
+            acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(w + 12), x));
+        }
+        _mm_storeu_ps(output + j, relu_if_sse2(acc0, relu));
+        _mm_storeu_ps(output + j + 4, relu_if_sse2(acc1, relu));
+        _mm_storeu_ps(output + j + 8, relu_if_sse2(acc2, relu));
+        _mm_storeu_ps(output + j + 12, relu_if_sse2(acc3, relu));
+    }
+    for (; j + 4 <= cols; j += 4) {
+        __m128 acc = bias_or_zero_sse2(bias, j);
+        for (size_t i = 0; i < rows; ++i) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(weights + i * cols + j),
+                                             _mm_set1_ps(input[i])));
+        }
+        _mm_storeu_ps(output + j, relu_if_sse2(acc, relu));
+    }
+    dense_scalar_from(weights, bias, input, output, rows, cols, relu, j);
+}
+
+__attribute__((target("sse2")))
+void dense_sse2(const float* weights, const float* bias, const float* input, float* output,
+                size_t rows, size_t cols, bool relu) {
+    dense_sse2_from(weights, bias, input, output, rows, cols, relu, 0);
+}
+
+// Lanes are reduced as (l0 + l2) + (l1 + l3)
+__attribute__((target("sse2")))
+KERNEL_INLINE float hsum_sse2(__m128 v) {
+    const __m128 pairs = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+}
+
+// Packed rows start with the bias in lane 0 and zeros elsewhere
+__attribute__((target("sse2")))
+KERNEL_INLINE __m128 packed_start_sse2(const float* bias, size_t j) {
+    return _mm_set_ss(bias_or_zero(bias, j));
+}
+
+// Rows are aligned (see MatrixOps::pack_weights); the input need not be
+__attribute__((target("sse2")))
+KERNEL_INLINE float dot_sse2_from(const float* row, const float* input, size_t n, size_t i,
+                                  __m128 acc) {
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_load_ps(row + i), _mm_loadu_ps(input + i)));
+    }
+    return dot_scalar_from(row, input, n, i, hsum_sse2(acc));
+}
+
+// Four rows at once: each input load feeds four independent accumulators.
+// Every row sees exactly the operations of dot_sse2_from.
+__attribute__((target("sse2")))
+void dense_packed_sse2(const float* packed, const float* bias, const float* input,
+                       float* output, size_t input_size, size_t output_size,
+                       size_t stride, bool relu) {
+    size_t j = 0;
+    for (; j + 4 <= output_size; j += 4) {
+        const float* r0 = packed + j * stride;
+        const float* r1 = r0 + stride;
+        const float* r2 = r1 + stride;
+        const float* r3 = r2 + stride;
+        __m128 a0 = packed_start_sse2(bias, j);
+        __m128 a1 = packed_start_sse2(bias, j + 1);
+        __m128 a2 = packed_start_sse2(bias, j + 2);
+        __m128 a3 = packed_start_sse2(bias, j + 3);
+        size_t i = 0;
+        for (; i + 4 <= input_size; i += 4) {
+            const __m128 x = _mm_loadu_ps(input + i);
+            a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_load_ps(r0 + i), x));
+            a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_load_ps(r1 + i), x));
+            a2 = _mm_add_ps(a2, _mm_mul_ps(_mm_load_ps(r2 + i), x));
+            a3 = _mm_add_ps(a3, _mm_mul_ps(_mm_load_ps(r3 + i), x));
+        }
+        output[j] = relu_if(dot_scalar_from(r0, input, input_size, i, hsum_sse2(a0)), relu);
+        output[j + 1] = relu_if(dot_scalar_from(r1, input, input_size, i, hsum_sse2(a1)), relu);
+        output[j + 2] = relu_if(dot_scalar_from(r2, input, input_size, i, hsum_sse2(a2)), relu);
+        output[j + 3] = relu_if(dot_scalar_from(r3, input, input_size, i, hsum_sse2(a3)), relu);
+    }
+    for (; j < output_size; ++j) {
+        output[j] = relu_if(dot_sse2_from(packed + j * stride, input, input_size, 0,
+                                          packed_start_sse2(bias, j)), relu);
+    }
+}
+
+__attribute__((target("sse2")))
+KERNEL_INLINE void vector_add_sse2_from(const float* a, const float* b, float* output,
+                                        size_t size, size_t i) {
+    for (; i + 4 <= size; i += 4) {
+        _mm_storeu_ps(output + i, _mm_add_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    vector_add_scalar_from(a, b, output, size, i);
+}
+
+__attribute__((target("sse2")))
+void vector_add_sse2(const float* a, const float* b, float* output, size_t size) {
+    vector_add_sse2_from(a, b, output, size, 0);
+}
+
+__attribute__((target("sse2")))
+void gemm_tile_sse2(const float* inputs, const float* weights, const float* bias,
+                    float* outputs, size_t input_size, size_t output_size, size_t cols,
+                    size_t k_begin, size_t k_end, bool relu) {
+    // SSE2 has no masked loads: narrow tiles take the scalar loop
+    if (cols != kScalarGemmCols) {
+        gemm_tile_scalar_cols(inputs, weights, bias, outputs, input_size, output_size,
+                              cols, k_begin, k_end, relu);
+        return;
+    }
+
+    // Each row of the 4x8 tile is two registers
+    __m128 lo[kGemmRows];
+    __m128 hi[kGemmRows];
+    for (size_t m = 0; m < kGemmRows; ++m) {
+        if (k_begin == 0) {
+            lo[m] = _mm_loadu_ps(bias);
+            hi[m] = _mm_loadu_ps(bias + 4);
+        } else {
+            lo[m] = _mm_loadu_ps(outputs + m * output_size);
+            hi[m] = _mm_loadu_ps(outputs + m * output_size + 4);
+        }
+    }
+
+    for (size_t k = k_begin; k < k_end; ++k) {
+        const __m128 w_lo = _mm_loadu_ps(weights + k * output_size);
+        const __m128 w_hi = _mm_loadu_ps(weights + k * output_size + 4);
+        for (size_t m = 0; m < kGemmRows; ++m) {
+            const __m128 a = _mm_set1_ps(inputs[m * input_size + k]);
+            lo[m] = _mm_add_ps(lo[m], _mm_mul_ps(a, w_lo));
+            hi[m] = _mm_add_ps(hi[m], _mm_mul_ps(a, w_hi));
+        }
+    }
+
+    const bool apply_relu = relu && (k_end == input_size);
+    for (size_t m = 0; m < kGemmRows; ++m) {
+        _mm_storeu_ps(outputs + m * output_size, relu_if_sse2(lo[m], apply_relu));
+        _mm_storeu_ps(outputs + m * output_size + 4, relu_if_sse2(hi[m], apply_relu));
+    }
+}
+
+// ============================================================================
+// AVX2 (8 floats per register, no FMA)
+// ============================================================================
+
+__attribute__((target("avx2")))
+KERNEL_INLINE __m256 relu_if_avx2(__m256 v, bool relu) {
+    return relu ? _mm256_max_ps(v, _mm256_setzero_ps()) : v;
+}
+
+__attribute__((target("avx2")))
+KERNEL_INLINE __m256 bias_or_zero_avx2(const float* bias, size_t j) {
+    return (bias != nullptr) ? _mm256_loadu_ps(bias + j) : _mm256_setzero_ps();
+}
+
+__attribute__((target("avx2")))
+KERNEL_INLINE void dense_avx2_from(const float* weights, const float* bias,
+                                   const float* input, float* output, size_t rows,
+                                   size_t cols, bool relu, size_t j) {
+    for (; j + 32 <= cols; j += 32) {
+        __m256 acc0 = bias_or_zero_avx2(bias, j);
+        __m256 acc1 = bias_or_zero_avx2(bias, j + 8);
+        __m256 acc2 = bias_or_zero_avx2(bias, j + 16);
+        __m256 acc3 = bias_or_zero_avx2(bias, j + 24);
+        for (size_t i = 0; i < rows; ++i) {
+            const float* w = weights + i * cols + j;
+            const __m256 x = _mm256_set1_ps(input[i]);
+            acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(w), x));
+            acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(w + 8), x));
+            acc2 = _mm256_add_ps(acc2, _mm256_mul_ps(_mm256_loadu_ps(w + 16), x));
+            acc3 = _mm256_add_ps(acc3, _mm256_mul_ps(_mm256_loadu_ps(w + 24), x));
+        }
+        _mm256_storeu_ps(output + j, relu_if_avx2(acc0, relu));
+        _mm256_storeu_ps(output + j + 8, relu_if_avx2(acc1, relu));
+        _mm256_storeu_ps(output + j + 16, relu_if_avx2(acc2, relu));
+        _mm256_storeu_ps(output + j + 24, relu_if_avx2(acc3, relu));
+    }
+    for (; j + 8 <= cols; j += 8) {
+        __m256 acc = bias_or_zero_avx2(bias, j);
+        for (size_t i = 0; i < rows; ++i) {
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(weights + i * cols + j),
+                                                   _mm256_set1_ps(input[i])));
+        }
+        _mm256_storeu_ps(output + j, relu_if_avx2(acc, relu));
+    }
+    dense_sse2_from(weights, bias, input, output, rows, cols, relu, j);
+}
+
+__attribute__((target("avx2")))
+void dense_avx2(const float* weights, const float* bias, const float* input, float* output,
+                size_t rows, size_t cols, bool relu) {
+    dense_avx2_from(weights, bias, input, output, rows, cols, relu, 0);
+}
+
+__attribute__((target("avx2")))
+KERNEL_INLINE float hsum_avx2(__m256 v) {
+    return hsum_sse2(_mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+}
+
+__attribute__((target("avx2")))
+KERNEL_INLINE __m256 packed_start_avx2(const float* bias, size_t j) {
+    return _mm256_zextps128_ps256(packed_start_sse2(bias, j));
+}
+
+// Finish a row from index i: a remaining block of 4 is folded into the low
+// half of the accumulator, which is then reduced and the scalar tail added
+__attribute__((target("avx2")))
+KERNEL_INLINE float dot_avx2_finish(const float* row, const float* input, size_t n,
+                                    size_t i, __m256 acc) {
+    if (i + 4 <= n) {
+        const __m128 part = _mm_mul_ps(_mm_load_ps(row + i), _mm_loadu_ps(input + i));
+        acc = _mm256_add_ps(acc, _mm256_zextps128_ps256(part));
+        i += 4;
+    }
+    return dot_scalar_from(row, input, n, i, hsum_avx2(acc));
+}
+
+__attribute__((target("avx2")))
+KERNEL_INLINE float dot_avx2_from(const float* row, const float* input, size_t n, size_t i,
+                                  __m256 acc) {
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_load_ps(row + i),
+                                               _mm256_loadu_ps(input + i)));
+    }
+    return dot_avx2_finish(row, input, n, i, acc);
+}
+
+__attribute__((target("avx2")))
+void dense_packed_avx2(const float* packed, const float* bias, const float* input,
+                       float* output, size_t input_size, size_t output_size,
+                       size_t stride, bool relu) {
+    size_t j = 0;
+    for (; j + 4 <= output_size; j += 4) {
+        const float* r0 = packed + j * stride;
+        const float* r1 = r0 + stride;
+        const float* r2 = r1 + stride;
+        const float* r3 = r2 + stride;
+        __m256 a0 = packed_start_avx2(bias, j);
+        __m256 a1 = packed_start_avx2(bias, j + 1);
+        __m256 a2 = packed_start_avx2(bias, j + 2);
+        __m256 a3 = packed_start_avx2(bias, j + 3);
+        size_t i = 0;
+        for (; i + 8 <= input_size; i += 8) {
+            const __m256 x = _mm256_loadu_ps(input + i);
+            a0 = _mm256_add_ps(a0, _mm256_mul_ps(_mm256_load_ps(r0 + i), x));
+            a1 = _mm256_add_ps(a1, _mm256_mul_ps(_mm256_load_ps(r1 + i), x));
+            a2 = _mm256_add_ps(a2, _mm256_mul_ps(_mm256_load_ps(r2 + i), x));
+            a3 = _mm256_add_ps(a3, _mm256_mul_ps(_mm256_load_ps(r3 + i), x));
+        }
+        output[j] = relu_if(dot_avx2_finish(r0, input, input_size, i, a0), relu);
+        output[j + 1] = relu_if(dot_avx2_finish(r1, input, input_size, i, a1), relu);
+        output[j + 2] = relu_if(dot_avx2_finish(r2, input, input_size, i, a2), relu);
+        output[j + 3] = relu_if(dot_avx2_finish(r3, input, input_size, i, a3), relu);
+    }
+    for (; j < output_size; ++j) {
+        output[j] = relu_if(dot_avx2_from(packed + j * stride, input, input_size, 0,
+                                          packed_start_avx2(bias, j)), relu);
+    }
+}
+
+__attribute__((target("avx2")))
+KERNEL_INLINE void vector_add_avx2_from(const float* a, const float* b, float* output,
+                                        size_t size, size_t i) {
+    for (; i + 8 <= size; i += 8) {
+        _mm256_storeu_ps(output + i,
+                         _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    }
+    vector_add_sse2_from(a, b, output, size, i);
+}
+
+__attribute__((target("avx2")))
+void vector_add_avx2(const float* a, const float* b, float* output, size_t size) {
+    vector_add_avx2_from(a, b, output, size, 0);
+}
+
+// GEMM tile width of the AVX2 kernel: two registers per sample
+constexpr size_t kAvx2GemmRegs = 2;
+
+// Lanes [0, n) of a maskload / maskstore (n <= 8)
+__attribute__((target("avx2")))
+KERNEL_INLINE __m256i lane_mask_avx2(size_t n) {
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(n)),
+                              _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+template <bool Masked>
+__attribute__((target("avx2")))
+KERNEL_INLINE __m256 load_lanes_avx2(const float* p, __m256i mask) {
+    return Masked ? _mm256_maskload_ps(p, mask) : _mm256_loadu_ps(p);
+}
+
+// A kGemmRows x cols tile in Regs registers per row, the last one masked
+// to the lanes in the tile when Masked. The row and register loops are
+// unrolled so the accumulators live in registers (-O2 keeps them as loops).
+template <size_t Regs, bool Masked>
+__attribute__((target("avx2")))
+KERNEL_INLINE void gemm_tile_avx2_regs(const float* inputs, const float* weights,
+                                       const float* bias, float* outputs, size_t input_size,
+                                       size_t output_size, size_t cols, size_t k_begin,
+                                       size_t k_end, bool relu) {
+    constexpr size_t kLast = Regs - 1;
+    const __m256i mask = lane_mask_avx2(Masked ? cols - 8 * kLast : 8);
+
+    __m256 acc[kGemmRows][Regs];
+    #pragma GCC unroll 16
+    for (size_t m = 0; m < kGemmRows; ++m) {
+        const float* start = (k_begin == 0) ? bias : outputs + m * output_size;
+        #pragma GCC unroll 16
+        for (size_t r = 0; r < Regs; ++r) {
+            acc[m][r] = (r == kLast) ? load_lanes_avx2<Masked>(start + 8 * r, mask)
+                                     : _mm256_loadu_ps(start + 8 * r);
+        }
+    }
+
+    for (size_t k = k_begin; k < k_end; ++k) {
+        const float* row = weights + k * output_size;
+        __m256 w[Regs];
+        #pragma GCC unroll 16
+        for (size_t r = 0; r < Regs; ++r) {
+            w[r] = (r == kLast) ? load_lanes_avx2<Masked>(row + 8 * r, mask)
+                                : _mm256_loadu_ps(row + 8 * r);
+        }
+        #pragma GCC unroll 16
+        for (size_t m = 0; m < kGemmRows; ++m) {
+            const __m256 a = _mm256_set1_ps(inputs[m * input_size + k]);
+            #pragma GCC unroll 16
+            for (size_t r = 0; r < Regs; ++r) {
+                acc[m][r] = _mm256_add_ps(acc[m][r], _mm256_mul_ps(a, w[r]));
+            }
+        }
+    }
+
+    const bool apply_relu = relu && (k_end == input_size);
+    #pragma GCC unroll 16
+    for (size_t m = 0; m < kGemmRows; ++m) {
+        float* out = outputs + m * output_size;
+        #pragma GCC unroll 16
+        for (size_t r = 0; r < Regs; ++r) {
+            const __m256 v = relu_if_avx2(acc[m][r], apply_relu);
+            if (Masked && r == kLast) {
+                _mm256_maskstore_ps(out + 8 * r, mask, v);
+            } else {
+                _mm256_storeu_ps(out + 8 * r, v);
+            }
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+void gemm_tile_avx2(const float* inputs, const float* weights, const float* bias,
+                    float* outputs, size_t input_size, size_t output_size, size_t cols,
+                    size_t k_begin, size_t k_end, bool relu) {
+    if (cols == 8 * kAvx2GemmRegs) {
+        gemm_tile_avx2_regs<kAvx2GemmRegs, false>(inputs, weights, bias, outputs, input_size,
+                                                  output_size, cols, k_begin, k_end, relu);
+    } else if (cols > 8) {
+        gemm_tile_avx2_regs<kAvx2GemmRegs, true>(inputs, weights, bias, outputs, input_size,
+                                                 output_size, cols, k_begin, k_end, relu);
+    } else if (cols == 8) {
+        gemm_tile_avx2_regs<1, false>(inputs, weights, bias, outputs, input_size,
+                                      output_size, cols, k_begin, k_end, relu);
+    } else {
+        gemm_tile_avx2_regs<1, true>(inputs, weights, bias, outputs, input_size,
+                                     output_size, cols, k_begin, k_end, relu);
+    }
+}
+
+// ============================================================================
+// AVX-512 (16 floats per register, no FMA)
+// ============================================================================
+
+// Zero-masked form: plain _mm512_max_ps trips GCC 12's
+// -Wmaybe-uninitialized like the extract intrinsics below
+__attribute__((target("avx512f")))
+KERNEL_INLINE __m512 relu_if_avx512(__m512 v, bool relu) {
+    return relu ? _mm512_maskz_max_ps(0xFFFF, v, _mm512_setzero_ps()) : v;
+}
+
+__attribute__((target("avx512f")))
+KERNEL_INLINE __m512 bias_or_zero_avx512(const float* bias, size_t j) {
+    return (bias != nullptr) ? _mm512_loadu_ps(bias + j) : _mm512_setzero_ps();
+}
+
+__attribute__((target("avx512f")))
+void dense_avx512(const float* weights, const float* bias, const float* input, float* output,
+                  size_t rows, size_t cols, bool relu) {
+    size_t j = 0;
+    for (; j + 64 <= cols; j += 64) {
+        __m512 acc0 = bias_or_zero_avx512(bias, j);
+        __m512 acc1 = bias_or_zero_avx512(bias, j + 16);
+        __m512 acc2 = bias_or_zero_avx512(bias, j + 32);
+        __m512 acc3 = bias_or_zero_avx512(bias, j + 48);
+        for (size_t i = 0; i < rows; ++i) {
+            const float* w = weights + i * cols + j;
+            const __m512 x = _mm512_set1_ps(input[i]);
+            acc0 = _mm512_add_ps(acc0, _mm512_mul_ps(_mm512_loadu_ps(w), x));
+            acc1 = _mm512_add_ps(acc1, _mm512_mul_ps(_mm512_loadu_ps(w + 16), x));
+            acc2 = _mm512_add_ps(acc2, _mm512_mul_ps(_mm512_loadu_ps(w + 32), x));
+            acc3 = _mm512_add_ps(acc3, _mm512_mul_ps(_mm512_loadu_ps(w + 48), x));
+        }
+        _mm512_storeu_ps(output + j, relu_if_avx512(acc0, relu));
+        _mm512_storeu_ps(output + j + 16, relu_if_avx512(acc1, relu));
+        _mm512_storeu_ps(output + j + 32, relu_if_avx512(acc2, relu));
+        _mm512_storeu_ps(output + j + 48, relu_if_avx512(acc3, relu));
+    }
+    for (; j + 16 <= cols; j += 16) {
+        __m512 acc = bias_or_zero_avx512(bias, j);
+        for (size_t i = 0; i < rows; ++i) {
+            acc = _mm512_add_ps(acc, _mm512_mul_ps(_mm512_loadu_ps(weights + i * cols + j),
+                                                   _mm512_set1_ps(input[i])));
+        }
+        _mm512_storeu_ps(output + j, relu_if_avx512(acc, relu));
+    }
+    dense_avx2_from(weights, bias, input, output, rows, cols, relu, j);
+}
+
+__attribute__((target("avx512f")))
+KERNEL_INLINE __m512 packed_start_avx512(const float* bias, size_t j) {
+    return _mm512_zextps128_ps512(packed_start_sse2(bias, j));
+}
+
+// Fold 16 lanes to 8, then finish the row like the AVX2 kernel.
+// (Spilled rather than extracted: GCC 12's extract intrinsics trip
+// -Wmaybe-uninitialized.)
+__attribute__((target("avx512f")))
+KERNEL_INLINE float dot_avx512_finish(const float* row, const float* input, size_t n,
+                                      size_t i, __m512 acc) {
+    alignas(64) float lanes[16];
+    _mm512_store_ps(lanes, acc);
+    const __m256 folded = _mm256_add_ps(_mm256_load_ps(lanes), _mm256_load_ps(lanes + 8));
+    return dot_avx2_from(row, input, n, i, folded);
+}
+
+__attribute__((target("avx512f")))
+void dense_packed_avx512(const float* packed, const float* bias, const float* input,
+                         float* output, size_t input_size, size_t output_size,
+                         size_t stride, bool relu) {
+    size_t j = 0;
+    for (; j + 4 <= output_size; j += 4) {
+        const float* r0 = packed + j * stride;
+        const float* r1 = r0 + stride;
+        const float* r2 = r1 + stride;
+        const float* r3 = r2 + stride;
+        __m512 a0 = packed_start_avx512(bias, j);
+        __m512 a1 = packed_start_avx512(bias, j + 1);
+        __m512 a2 = packed_start_avx512(bias, j + 2);
+        __m512 a3 = packed_start_avx512(bias, j + 3);
+        size_t i = 0;
+        for (; i + 16 <= input_size; i += 16) {
+            const __m512 x = _mm512_loadu_ps(input + i);
+            a0 = _mm512_add_ps(a0, _mm512_mul_ps(_mm512_load_ps(r0 + i), x));
+            a1 = _mm512_add_ps(a1, _mm512_mul_ps(_mm512_load_ps(r1 + i), x));
+            a2 = _mm512_add_ps(a2, _mm512_mul_ps(_mm512_load_ps(r2 + i), x));
+            a3 = _mm512_add_ps(a3, _mm512_mul_ps(_mm512_load_ps(r3 + i), x));
+        }
+        output[j] = relu_if(dot_avx512_finish(r0, input, input_size, i, a0), relu);
+        output[j + 1] = relu_if(dot_avx512_finish(r1, input, input_size, i, a1), relu);
+        output[j + 2] = relu_if(dot_avx512_finish(r2, input, input_size, i, a2), relu);
+        output[j + 3] = relu_if(dot_avx512_finish(r3, input, input_size, i, a3), relu);
+    }
+    for (; j < output_size; ++j) {
+        const float* row = packed + j * stride;
+        __m512 acc = packed_start_avx512(bias, j);
+        size_t i = 0;
+        for (; i + 16 <= input_size; i += 16) {
+            acc = _mm512_add_ps(acc, _mm512_mul_ps(_mm512_load_ps(row + i),
+                                                   _mm512_loadu_ps(input + i)));
+        }
+        output[j] = relu_if(dot_avx512_finish(row, input, input_size, i, acc), relu);
+    }
+}
+
+__attribute__((target("avx512f")))
+void vector_add_avx512(const float* a, const float* b, float* output, size_t size) {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        _mm512_storeu_ps(output + i,
+                         _mm512_add_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+    }
+    vector_add_avx2_from(a, b, output, size, i);
+}
+
+// GEMM tile width of the AVX-512 kernel: four registers per sample, so the
+// 4 x 64 tile keeps 16 accumulators and 4 weight registers of the 32
+constexpr size_t kAvx512GemmRegs = 4;
+
+// A kGemmRows x cols tile in Regs registers per row, the last one masked to
+// the lanes in the tile (masked loads and stores cost the same as plain ones)
+template <size_t Regs>
+__attribute__((target("avx512f")))
+KERNEL_INLINE void gemm_tile_avx512_regs(const float* inputs, const float* weights,
+                                         const float* bias, float* outputs, size_t input_size,
+                                         size_t output_size, size_t cols, size_t k_begin,
+                                         size_t k_end, bool relu) {
+    constexpr size_t kLast = Regs - 1;
+    const size_t tail = cols - 16 * kLast;
+    const __mmask16 mask = static_cast<__mmask16>((tail < 16) ? (1u << tail) - 1u : 0xFFFFu);
+
+    __m512 acc[kGemmRows][Regs];
+    #pragma GCC unroll 16
+    for (size_t m = 0; m < kGemmRows; ++m) {
+        const float* start = (k_begin == 0) ? bias : outputs + m * output_size;
+        #pragma GCC unroll 16
+        for (size_t r = 0; r < Regs; ++r) {
+            acc[m][r] = (r == kLast) ? _mm512_maskz_loadu_ps(mask, start + 16 * r)
+                                     : _mm512_loadu_ps(start + 16 * r);
+        }
+    }
+
+    for (size_t k = k_begin; k < k_end; ++k) {
+        const float* row = weights + k * output_size;
+        __m512 w[Regs];
+        #pragma GCC unroll 16
+        for (size_t r = 0; r < Regs; ++r) {
+            w[r] = (r == kLast) ? _mm512_maskz_loadu_ps(mask, row + 16 * r)
+                                : _mm512_loadu_ps(row + 16 * r);
+        }
+        #pragma GCC unroll 16
+        for (size_t m = 0; m < kGemmRows; ++m) {
+            const __m512 a = _mm512_set1_ps(inputs[m * input_size + k]);
+            #pragma GCC unroll 16
+            for (size_t r = 0; r < Regs; ++r) {
+                acc[m][r] = _mm512_add_ps(acc[m][r], _mm512_mul_ps(a, w[r]));
+            }
+        }
+    }
+
+    const bool apply_relu = relu && (k_end == input_size);
+    #pragma GCC unroll 16
+    for (size_t m = 0; m < kGemmRows; ++m) {
+        float* out = outputs + m * output_size;
+        #pragma GCC unroll 16
+        for (size_t r = 0; r < Regs; ++r) {
+            const __m512 v = relu_if_avx512(acc[m][r], apply_relu);
+            if (r == kLast) {
+                _mm512_mask_storeu_ps(out + 16 * r, mask, v);
+            } else {
+                _mm512_storeu_ps(out + 16 * r, v);
+            }
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+void gemm_tile_avx512(const float* inputs, const float* weights, const float* bias,
+                      float* outputs, size_t input_size, size_t output_size, size_t cols,
+                      size_t k_begin, size_t k_end, bool relu) {
+    // Only as many registers per row as the tile needs
+    switch ((cols + 15) / 16) {
+    case 1:
+        gemm_tile_avx512_regs<1>(inputs, weights, bias, outputs, input_size, output_size,
+                                 cols, k_begin, k_end, relu);
+        break;
+    case 2:
+        gemm_tile_avx512_regs<2>(inputs, weights, bias, outputs, input_size, output_size,
+                                 cols, k_begin, k_end, relu);
+        break;
+    case 3:
+        gemm_tile_avx512_regs<3>(inputs, weights, bias, outputs, input_size, output_size,
+                                 cols, k_begin, k_end, relu);
+        break;
+    default:
+        gemm_tile_avx512_regs<kAvx512GemmRegs>(inputs, weights, bias, outputs, input_size,
+                                               output_size, cols, k_begin, k_end, relu);
+        break;
+    }
+}
+
+constexpr DenseKernels kSse2Kernels = {
+    Isa::SSE2, "sse2", dense_sse2, dense_packed_sse2, vector_add_sse2, gemm_tile_sse2,
+    kScalarGemmCols
+};
+
+constexpr DenseKernels kAvx2Kernels = {
+    Isa::AVX2, "avx2", dense_avx2, dense_packed_avx2, vector_add_avx2, gemm_tile_avx2,
+    8 * kAvx2GemmRegs
+};
+
+constexpr DenseKernels kAvx512Kernels = {
+    Isa::AVX512, "avx512", dense_avx512, dense_packed_avx512, vector_add_avx512,
+    gemm_tile_avx512, 16 * kAvx512GemmRegs
+};
+
+#endif // CUSTOMNN_X86_KERNELS
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+const DenseKernels* best_kernels() {
+    const Isa order[] = {Isa::AVX512, Isa::AVX2, Isa::SSE2};
+    for (Isa isa : order) {
+        if (is_supported(isa)) {
+            return kernels_for(isa);
+        }
+    }
+    return &kScalarKernels;
+}
+
+const DenseKernels*& active_slot() {
+    static const DenseKernels* slot = best_kernels();
+    return slot;
+}
+
+} // namespace
+
+bool is_supported(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar:
+            return true;
+#if CUSTOMNN_X86_KERNELS
+        // __builtin_cpu_supports reads cpuid (and the OS-enabled XSAVE
+        // state for the AVX families)
+        case Isa::SSE2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2");
+        case Isa::AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+        case Isa::AVX512:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx512f");
+#else
+        case Isa::SSE2:
+        case Isa::AVX2:
+        case Isa::AVX512:
+            return false;
+#endif
+    }
+    return false;
+}
+
+const DenseKernels* kernels_for(Isa isa) {
+    if (!is_supported(isa)) {
+        return nullptr;
+    }
+    switch (isa) {
+#if CUSTOMNN_X86_KERNELS
+        case Isa::SSE2:
+            return &kSse2Kernels;
+        case Isa::AVX2:
+            return &kAvx2Kernels;
+        case Isa::AVX512:
+            return &kAvx512Kernels;
+#endif
+        default:
+            return &kScalarKernels;
+    }
+}
+
+const DenseKernels& active() {
+    return *active_slot();
+}
+
+bool select(Isa isa) {
+    const DenseKernels* kernels = kernels_for(isa);
+    if (kernels == nullptr) {
+        return false;
+    }
+    active_slot() = kernels;
+    return true;
+}
+
+} // namespace Kernels
+} // namespace CustomNN
@@ -0,0 +1,102 @@
+/**
+ * Dense Kernel Dispatch
+ * Instruction-set specific implementations of the inner dense loops used
+ * by MatrixOps. On x86 hosts the best of AVX-512, AVX2 and SSE2 is picked
+ * once, on first use, from the CPU's cpuid feature bits. Every other
+ * target (including the RP2040) only has the portable scalar kernels.
+ *
+ * No variant contracts multiply + add into FMA. The input-major dense,
+ * vector_add and GEMM kernels keep the scalar summation order, so their
+ * results are bit-identical across ISAs. The packed dot-product kernels
+ * sum across SIMD lanes and reduce in a fixed order: deterministic for a
+ * given ISA, and within float rounding of the sequential scalar reference.
+ */
+
+#ifndef DENSE_KERNELS_H
+#define DENSE_KERNELS_H
+
+#include <cstddef>
+
+namespace CustomNN {
+namespace Kernels {
+
+// Samples per register tile of the batched GEMM (the tile's width in
+// outputs is per ISA: DenseKernels::gemm_cols)
+constexpr size_t kGemmRows = 4;
+
+/**
+ * Instruction set a kernel table targets
+ */
+enum class Isa {
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+/**
+ * Table of kernels for one instruction set
+ *
+ * The dense kernels are fused: each output's accumulator starts at its
+ * bias (or zero when bias is nullptr), the products are added in input
+ * order, and ReLU (when requested) is applied in registers before the
+ * single store.
+ */
+struct DenseKernels {
+    Isa isa;
+    const char* name;
+
+    // output[j] = relu?(bias[j] + sum_i(weights[i][j] * input[i])),
+    // weights[rows][cols]
+    void (*dense)(const float* weights, const float* bias, const float* input,
+                  float* output, size_t rows, size_t cols, bool relu);
+
+    // output[j] = relu?(bias[j] + dot(packed[j][0..input_size), input)),
+    // packed[output_size][stride] with every row kPackedAlignment-aligned
+    // (see MatrixOps::pack_weights)
+    void (*dense_packed)(const float* packed, const float* bias, const float* input,
+                         float* output, size_t input_size, size_t output_size,
+                         size_t stride, bool relu);
+
+    // output = a + b (output may alias a or b)
+    void (*vector_add)(const float* a, const float* b, float* output, size_t size);
+
+    // One kGemmRows x cols tile (cols <= gemm_cols) of
+    // MatrixOps::dense_forward_batch over inputs [k_begin, k_end): starts
+    // from the bias when k_begin == 0 and applies ReLU (if requested) when
+    // k_end == input_size. Narrower tiles are masked, not padded.
+    void (*gemm_tile)(const float* inputs, const float* weights, const float* bias,
+                      float* outputs, size_t input_size, size_t output_size, size_t cols,
+                      size_t k_begin, size_t k_end, bool relu);
+
+    // Outputs per gemm_tile call: as many accumulator registers per sample
+    // as leave room for the weights (a divisor of 64)
+    size_t gemm_cols;
+};
+
+/**
+ * Kernels in use. Resolved to the best supported ISA on first call.
+ */
+const DenseKernels& active();
+
+/**
+ * True if this build and CPU can run the given ISA
+ */
+bool is_supported(Isa isa);
+
+/**
+ * Force a specific ISA (e.g. for benchmarking). Not thread-safe: call it
+ * before any other thread runs inference.
+ * @return false (and no change) if the ISA is not supported
+ */
+bool select(Isa isa);
+
+/**
+ * Kernel table for the given ISA, or nullptr if not supported
+ */
+const DenseKernels* kernels_for(Isa isa);
+
+} // namespace Kernels
+} // namespace CustomNN
+
+#endif // DENSE_KERNELS_H
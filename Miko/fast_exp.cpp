@@ -0,0 +1,196 @@
+/**
+ * Fast exp Approximations Implementation
+ */
+
+#include "fast_exp.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace CustomNN {
+
+namespace {
+
+constexpr float kLog2e = 1.44269504f;
+
+// ln 2 split so that k * kLn2Hi is exact for |k| < 2^9 (Cody-Waite)
+constexpr float kLn2Hi = 0.693359375f;
+constexpr float kLn2Lo = -2.12194440e-4f;
+
+// Schraudolph: 2^23 / ln 2, the float exponent bias and the shift that
+// minimizes the maximum relative error of the linear mantissa
+constexpr float kSchraudolphScale = 12102203.0f;
+constexpr float kSchraudolphOffset = static_cast<float>((127 << 23) - 366500);
+
+// exp(r) ~= 1 + r * (c1 + r * (c2 + r * (c3 + r * (c4 + r * c5)))) on
+// [-ln2/2, ln2/2] (least squares on the relative error)
+constexpr float kPolyC1 = 9.999995317e-01f;
+constexpr float kPolyC2 = 4.999914103e-01f;
+constexpr float kPolyC3 = 1.666811426e-01f;
+constexpr float kPolyC4 = 4.189873203e-02f;
+constexpr float kPolyC5 = 8.261531036e-03f;
+
+// 2^(j / 64) for j = 0..63
+constexpr int kTableBits = 6;
+constexpr float kTableScale = 64.0f * kLog2e;
+constexpr float kTableStep = 0.693147181f / 64.0f;
+constexpr float kExp2Table[64] = {
+    1.000000000e+00f, 1.010889286e+00f, 1.021897149e+00f, 1.033024879e+00f, 1.044273782e+00f, 1.055645178e+00f, 1.067140401e+00f, 1.078760798e+00f,
+    1.090507733e+00f, 1.102382583e+00f, 1.114386743e+00f, 1.126521619e+00f, 1.138788635e+00f, 1.151189230e+00f, 1.163724859e+00f, 1.176396992e+00f,
+    1.189207115e+00f, 1.202156731e+00f, 1.215247360e+00f, 1.228480536e+00f, 1.241857812e+00f, 1.255380757e+00f, 1.269050957e+00f, 1.282870016e+00f,
+    1.296839555e+00f, 1.310961212e+00f, 1.325236643e+00f, 1.339667524e+00f, 1.354255547e+00f, 1.369002423e+00f, 1.383909882e+00f, 1.398979673e+00f,
+    1.414213562e+00f, 1.429613338e+00f, 1.445180807e+00f, 1.460917794e+00f, 1.476826146e+00f, 1.492907728e+00f, 1.509164428e+00f, 1.525598151e+00f,
+    1.542210825e+00f, 1.559004400e+00f, 1.575980845e+00f, 1.593142151e+00f, 1.610490332e+00f, 1.628027422e+00f, 1.645755478e+00f, 1.663676580e+00f,
+    1.681792831e+00f, 1.700106354e+00f, 1.718619298e+00f, 1.737333835e+00f, 1.756252160e+00f, 1.775376493e+00f, 1.794709075e+00f, 1.814252176e+00f,
+    1.834008086e+00f, 1.853979125e+00f, 1.874167634e+00f, 1.894575982e+00f, 1.915206561e+00f, 1.936061793e+00f, 1.957144124e+00f, 1.978456026e+00f
+};
+
+float from_bits(int32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+int32_t to_bits(float value) {
+    int32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// value * 2^k as an integer add on the exponent field (the results below
+// stay normal, so no float multiply is needed)
+float scale_pow2(float value, int32_t k) {
+    return from_bits(to_bits(value) + k * (1 << 23));
+}
+
+// Adding 1.5 * 2^23 pushes the fraction out of the mantissa: the sum is
+// round-to-nearest(value) both as a float and in its low mantissa bits, so
+// no float-to-int conversion is needed. Exact for |value| < 2^22.
+constexpr float kRoundMagic = 12582912.0f;
+
+float clamp_input(float x) {
+    x = (x < FastExp::kMinInput) ? FastExp::kMinInput : x;
+    return (x > FastExp::kMaxInput) ? FastExp::kMaxInput : x;
+}
+
+// Branch-free apart from the clamps and the underflow select, which
+// compile to min/max/blend on the host
+
+inline float exp_schraudolph(float x) {
+    const float c = clamp_input(x);
+    // Always positive here, so the conversion truncates like floor
+    const float y = from_bits(static_cast<int32_t>(kSchraudolphScale * c + kSchraudolphOffset));
+    return (x < FastExp::kMinInput) ? 0.0f : y;
+}
+
+inline float exp_polynomial(float x) {
+    const float c = clamp_input(x);
+
+    // x = k * ln2 + r with |r| <= ln2 / 2
+    const float shifted = c * kLog2e + kRoundMagic;
+    const int32_t k = to_bits(shifted) - to_bits(kRoundMagic);
+    const float kf = shifted - kRoundMagic;
+    const float r = (c - kf * kLn2Hi) - kf * kLn2Lo;
+
+    const float p = 1.0f + r * (kPolyC1 + r * (kPolyC2 + r * (kPolyC3 + r * (kPolyC4 + r * kPolyC5))));
+    const float y = scale_pow2(p, k);
+    return (x < FastExp::kMinInput) ? 0.0f : y;
+}
+
+inline float exp_table(float x) {
+    const float c = clamp_input(x);
+
+    // x * 64 / ln2 = 64 * n + j + f with j in [0, 64) and |f| <= 1/2
+    const float t = c * kTableScale;
+    const float shifted = t + kRoundMagic;
+    const int32_t k = to_bits(shifted) - to_bits(kRoundMagic);
+    const float r = (t - (shifted - kRoundMagic)) * kTableStep;
+    const int32_t j = k & ((1 << kTableBits) - 1);
+    const int32_t n = (k - j) / (1 << kTableBits);
+
+    const float y = scale_pow2(kExp2Table[j] * (1.0f + r), n);
+    return (x < FastExp::kMinInput) ? 0.0f : y;
+}
+
+} // namespace
+
+float FastExp::schraudolph(float x) {
+    return exp_schraudolph(x);
+}
+
+float FastExp::polynomial(float x) {
+    return exp_polynomial(x);
+}
+
+float FastExp::table(float x) {
+    return exp_table(x);
+}
+
+float FastExp::exp(float x, ExpApprox method) {
+    switch (method) {
+        case ExpApprox::Schraudolph:
+            return exp_schraudolph(x);
+        case ExpApprox::Polynomial:
+            return exp_polynomial(x);
+        case ExpApprox::Table:
+            return exp_table(x);
+        case ExpApprox::Exact:
+            break;
+    }
+    return expf(x);
+}
+
+void FastExp::exp_inplace(float* data, size_t size, ExpApprox method) {
+    switch (method) {
+        case ExpApprox::Schraudolph:
+            for (size_t i = 0; i < size; ++i) {
+                data[i] = exp_schraudolph(data[i]);
+            }
+            return;
+        case ExpApprox::Polynomial:
+            for (size_t i = 0; i < size; ++i) {
+                data[i] = exp_polynomial(data[i]);
+            }
+            return;
+        case ExpApprox::Table:
+            for (size_t i = 0; i < size; ++i) {
+                data[i] = exp_table(data[i]);
+            }
+            return;
+        case ExpApprox::Exact:
+            break;
+    }
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = expf(data[i]);
+    }
+}
+
+float FastExp::max_rel_error(ExpApprox method) {
+    switch (method) {
+        case ExpApprox::Schraudolph:
+            return kSchraudolphMaxRelError;
+        case ExpApprox::Polynomial:
+            return kPolynomialMaxRelError;
+        case ExpApprox::Table:
+            return kTableMaxRelError;
+        case ExpApprox::Exact:
+            break;
+    }
+    return 0.0f;
+}
+
+const char* FastExp::name(ExpApprox method) {
+    switch (method) {
+        case ExpApprox::Schraudolph:
+            return "schraudolph";
+        case ExpApprox::Polynomial:
+            return "polynomial";
+        case ExpApprox::Table:
+            return "table";
+        case ExpApprox::Exact:
+            break;
+    }
+    return "expf";
+}
+
+} // namespace CustomNN
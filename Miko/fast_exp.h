@@ -0,0 +1,76 @@
+/**
+ * Fast exp Approximations
+ * Bounded-error replacements for expf in softmax
+ *
+ * expf is one of the most expensive soft-float calls on the RP2040. Each
+ * approximation trades accuracy for fewer float operations; the maximum
+ * relative errors below hold over [kMinInput, kMaxInput] and are checked
+ * by the tester's "exp" section.
+ *
+ *   Method       Float ops (+ 3 compares)                        Max rel error
+ *   Exact        expf                                            (libm)
+ *   Schraudolph  1 fmul + 1 fadd written into the float bits     3.0e-2
+ *   Polynomial   8 fmul + 9 fadd: 2^k * degree 5 on |r| <= ln2/2  2.5e-7
+ *   Table        3 fmul + 4 fadd: 2^n * 2^(j/64) * (1 + r)       2.0e-5
+ *
+ * Powers of two go straight into the exponent bits and rounding uses the
+ * 1.5 * 2^23 trick, so the only float work is the listed ops. Whether that
+ * beats expf depends on the soft-float routine costs; the tester models it.
+ *
+ * Inputs below kMinInput return 0 and inputs above kMaxInput are clamped,
+ * so no approximation produces denormals, infinities or NaN from finite
+ * input.
+ */
+
+#ifndef FAST_EXP_H
+#define FAST_EXP_H
+
+#include <cstddef>
+
+namespace CustomNN {
+
+/**
+ * exp implementation used by softmax
+ */
+enum class ExpApprox {
+    Exact,
+    Schraudolph,
+    Polynomial,
+    Table
+};
+
+/**
+ * exp approximations, scalar and over arrays
+ */
+class FastExp {
+public:
+    static constexpr float kMinInput = -87.0f;
+    static constexpr float kMaxInput = 88.0f;
+
+    static constexpr float kSchraudolphMaxRelError = 3.0e-2f;
+    static constexpr float kPolynomialMaxRelError = 2.5e-7f;
+    static constexpr float kTableMaxRelError = 2.0e-5f;
+
+    static float schraudolph(float x);
+    static float polynomial(float x);
+    static float table(float x);
+
+    static float exp(float x, ExpApprox method);
+
+    /**
+     * data[i] = exp(data[i]) for every element
+     * The method is resolved once, outside the loop.
+     */
+    static void exp_inplace(float* data, size_t size, ExpApprox method);
+
+    /**
+     * Documented maximum relative error (0 for Exact)
+     */
+    static float max_rel_error(ExpApprox method);
+
+    static const char* name(ExpApprox method);
+};
+
+} // namespace CustomNN
+
+#endif // FAST_EXP_H
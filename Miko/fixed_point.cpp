@@ -0,0 +1,401 @@
+/**
+ * Q15 Fixed-Point Inference Implementation
+ */
+
+#include "fixed_point.h"
+#include <cmath>
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+namespace CustomNN {
+
+namespace {
+
+constexpr int32_t kInt16Min = std::numeric_limits<int16_t>::min();
+constexpr int32_t kInt16Max = std::numeric_limits<int16_t>::max();
+constexpr int32_t kMinFracBits = -15;
+constexpr int32_t kMaxFracBits = 30;
+
+// log2(e) in Q14, so logit * log2(e) fits int32 for any int16 logit
+constexpr int32_t kLog2eQ14 = 23637;
+
+// 2^f ~= 1 + f * (c1 + f * (c2 + f * c3)) on [0, 1), coefficients in Q15
+// (least squares on the relative error)
+constexpr int32_t kExp2C1 = 22778;
+constexpr int32_t kExp2C2 = 7459;
+constexpr int32_t kExp2C3 = 2525;
+
+// Converts a weight or bias with exact power-of-two scaling
+int64_t to_fixed_wide(float value, int32_t frac_bits) {
+    return std::llround(std::ldexp(static_cast<double>(value), frac_bits));
+}
+
+// (a * b) >> 15 with rounding, for the non-negative polynomial terms
+int32_t mul_q15(int32_t a, int32_t b) {
+    return (a * b + (1 << 14)) >> 15;
+}
+
+} // namespace
+
+// ============================================================================
+// Q-Format Helpers
+// ============================================================================
+
+int32_t FixedOps::frac_bits_for(float max_abs) {
+    if (!(max_abs > 0.0f)) {
+        return kMaxFracBits;
+    }
+    int32_t frac_bits = kMaxFracBits;
+    while (frac_bits > kMinFracBits &&
+           std::ldexp(static_cast<double>(max_abs), frac_bits) > kInt16Max) {
+        --frac_bits;
+    }
+    return frac_bits;
+}
+
+QFormat FixedOps::format_for(float max_abs) {
+    return QFormat{frac_bits_for(max_abs), max_abs};
+}
+
+QFormat FixedOps::output_bound(const float* weights, const float* bias,
+                               size_t input_size, size_t output_size, QFormat input) {
+    float max_abs = 0.0f;
+    for (size_t j = 0; j < output_size; ++j) {
+        float bound = std::fabs(bias[j]);
+        for (size_t i = 0; i < input_size; ++i) {
+            bound += std::fabs(weights[i * output_size + j]) * input.max_abs;
+        }
+        max_abs = std::max(max_abs, bound);
+    }
+    return format_for(max_abs);
+}
+
+int16_t FixedOps::saturate(int32_t value) {
+    return static_cast<int16_t>(std::min(std::max(value, kInt16Min), kInt16Max));
+}
+
+int16_t FixedOps::to_fixed(float value, int32_t frac_bits) {
+    const int64_t q = to_fixed_wide(value, frac_bits);
+    return static_cast<int16_t>(std::min<int64_t>(std::max<int64_t>(q, kInt16Min), kInt16Max));
+}
+
+float FixedOps::to_float(int32_t value, int32_t frac_bits) {
+    return std::ldexp(static_cast<float>(value), -frac_bits);
+}
+
+int32_t FixedOps::shift_round(int32_t value, int32_t shift) {
+    if (shift > 0) {
+        shift = std::min(shift, 31);
+        // floor(value / 2^shift) plus the first dropped bit: no overflow
+        return (value >> shift) + ((value >> (shift - 1)) & 1);
+    }
+    if (shift < 0) {
+        const int64_t wide = static_cast<int64_t>(value) * (int64_t{1} << std::min(-shift, 31));
+        return static_cast<int32_t>(std::min<int64_t>(
+            std::max<int64_t>(wide, std::numeric_limits<int32_t>::min()),
+            std::numeric_limits<int32_t>::max()));
+    }
+    return value;
+}
+
+// ============================================================================
+// Kernels
+// ============================================================================
+
+void FixedOps::dense_forward(const FixedDense& layer, const int16_t* input, int16_t* output) {
+    const int32_t shift = layer.input_frac + layer.weight_frac - layer.output_frac;
+    const bool relu = (layer.activation == ActivationType::ReLU);
+
+    for (size_t j = 0; j < layer.output_size; ++j) {
+        const int16_t* row = layer.weights + j * layer.input_size;
+
+        // Weight frac bits were chosen so this cannot overflow
+        int32_t acc = layer.bias[j];
+        for (size_t i = 0; i < layer.input_size; ++i) {
+            acc += static_cast<int32_t>(row[i]) * static_cast<int32_t>(input[i]);
+        }
+
+        int32_t value = shift_round(acc, shift);
+        if (relu && value < 0) {
+            value = 0;
+        }
+        output[j] = FixedOps::saturate(value);
+    }
+}
+
+int32_t FixedOps::exp2_q15(int32_t x) {
+    // x = n + f with integer n <= 0 and f in [0, 1)
+    const int32_t n = x >> 15;
+    const int32_t f = x & 0x7FFF;
+    if (n <= -16) {
+        return 0;
+    }
+
+    int32_t p = mul_q15(f, kExp2C3);
+    p = mul_q15(f, kExp2C2 + p);
+    p = mul_q15(f, kExp2C1 + p);
+    return shift_round((1 << 15) + p, -n);
+}
+
+namespace {
+
+// exp(-a) in Q15 for a >= 0 with frac_bits fractional bits (|a| <= 65535,
+// so a * log2(e) in Q14 fits int32)
+int32_t exp_neg_q15(int32_t a, int32_t frac_bits) {
+    return FixedOps::exp2_q15(-FixedOps::shift_round(a * kLog2eQ14, frac_bits + 14 - 15));
+}
+
+} // namespace
+
+int16_t FixedOps::sigmoid_q15(int32_t x, int32_t frac_bits) {
+    // 1 / (1 + e^-|x|), mirrored for negative x: e^-|x| / (1 + e^-|x|)
+    const int32_t e = exp_neg_q15((x < 0) ? -x : x, frac_bits);
+    const int32_t denominator = (1 << 15) + e;
+    const int32_t numerator = (x < 0) ? e : (1 << 15);
+    return saturate(((numerator << 15) + denominator / 2) / denominator);
+}
+
+int16_t FixedOps::tanh_q15(int32_t x, int32_t frac_bits) {
+    // (1 - e^-2|x|) / (1 + e^-2|x|), sign of x
+    const int32_t e = exp_neg_q15((x < 0) ? -x : x, frac_bits - 1);
+    const int32_t denominator = (1 << 15) + e;
+    const int32_t magnitude = saturate((((1 << 15) - e) * (1 << 15) + denominator / 2) /
+                                       denominator);
+    return static_cast<int16_t>((x < 0) ? -magnitude : magnitude);
+}
+
+void FixedOps::softmax(const int16_t* logits, int32_t frac_bits, int16_t* probs, size_t size) {
+    int32_t max_val = logits[0];
+    for (size_t i = 1; i < size; ++i) {
+        max_val = std::max<int32_t>(max_val, logits[i]);
+    }
+
+    // exp(d) = 2^(d * log2(e)); d * log2(e) has frac_bits + 14 bits, brought
+    // to Q15. Each term is at most 2^15, so the sum fits for 65535 classes.
+    const int32_t to_q15 = frac_bits + 14 - 15;
+    int32_t sum = 0;
+    for (size_t i = 0; i < size; ++i) {
+        const int32_t d = static_cast<int32_t>(logits[i]) - max_val;
+        sum += exp2_q15(shift_round(d * kLog2eQ14, to_q15));
+    }
+
+    // Second pass instead of a wider buffer: the terms are cheap to redo and
+    // 2^15 itself does not fit the int16 output
+    for (size_t i = 0; i < size; ++i) {
+        const int32_t d = static_cast<int32_t>(logits[i]) - max_val;
+        const int32_t e = exp2_q15(shift_round(d * kLog2eQ14, to_q15));
+        probs[i] = FixedOps::saturate(((e << kProbFracBits) + sum / 2) / sum);
+    }
+}
+
+size_t FixedOps::argmax(const int16_t* values, size_t size) {
+    size_t best = 0;
+    for (size_t i = 1; i < size; ++i) {
+        if (values[i] > values[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+// ============================================================================
+// Fixed-Point Dense Layer
+// ============================================================================
+
+FixedDenseLayer::FixedDenseLayer(
+    const float* weights,
+    const float* bias,
+    size_t input_size,
+    size_t output_size,
+    ActivationType activation,
+    QFormat input,
+    QFormat output
+) : weights_(new int16_t[input_size * output_size]),
+    bias_(new int32_t[output_size]),
+    params_{weights_, bias_, input_size, output_size,
+            input.frac_bits, 0, output.frac_bits, activation}
+{
+    float max_abs = 0.0f;
+    for (size_t k = 0; k < input_size * output_size; ++k) {
+        max_abs = std::max(max_abs, std::fabs(weights[k]));
+    }
+
+    // Start from the finest weight format that fits int16, then give up
+    // bits until the worst case (every input at -32768) fits the int32
+    // accumulator
+    int32_t weight_frac = FixedOps::frac_bits_for(max_abs);
+    for (; weight_frac > kMinFracBits; --weight_frac) {
+        int64_t worst = 0;
+        for (size_t j = 0; j < output_size; ++j) {
+            int64_t acc = std::llabs(to_fixed_wide(bias[j], input.frac_bits + weight_frac));
+            for (size_t i = 0; i < input_size; ++i) {
+                acc += std::llabs(to_fixed_wide(weights[i * output_size + j], weight_frac)) *
+                       -int64_t{kInt16Min};
+            }
+            worst = std::max(worst, acc);
+        }
+        if (worst <= std::numeric_limits<int32_t>::max()) {
+            break;
+        }
+    }
+    params_.weight_frac = weight_frac;
+
+    for (size_t j = 0; j < output_size; ++j) {
+        // Transpose to output-major rows while converting
+        int16_t* row = weights_ + j * input_size;
+        for (size_t i = 0; i < input_size; ++i) {
+            row[i] = FixedOps::to_fixed(weights[i * output_size + j], weight_frac);
+        }
+        bias_[j] = static_cast<int32_t>(to_fixed_wide(bias[j], input.frac_bits + weight_frac));
+    }
+}
+
+FixedDenseLayer::~FixedDenseLayer() {
+    delete[] bias_;
+    delete[] weights_;
+}
+
+FixedDenseLayer::FixedDenseLayer(FixedDenseLayer&& other) noexcept
+  : weights_(other.weights_),
+    bias_(other.bias_),
+    params_(other.params_)
+{
+    other.weights_ = nullptr;
+    other.bias_ = nullptr;
+}
+
+// ============================================================================
+// Fixed-Point Sequential
+// ============================================================================
+
+FixedSequential::FixedSequential(
+    const FixedDense* const* layers,
+    size_t num_layers,
+    int16_t* scratch_a,
+    int16_t* scratch_b,
+    size_t scratch_size
+) : layers_(layers),
+    num_layers_(num_layers),
+    scratch_a_(scratch_a),
+    scratch_b_(scratch_b),
+    scratch_size_(scratch_size),
+    valid_(false)
+{
+    if (layers_ == nullptr || num_layers_ == 0) {
+        return;
+    }
+
+    // Consecutive layers must agree on width and on the format of the
+    // tensor they share
+    for (size_t i = 0; i < num_layers_; ++i) {
+        if (layers_[i] == nullptr) {
+            return;
+        }
+        if (i > 0) {
+            const FixedDense& prev = *layers_[i - 1];
+            const FixedDense& cur = *layers_[i];
+            if (prev.output_size != cur.input_size || prev.output_frac != cur.input_frac) {
+                return;
+            }
+        }
+    }
+
+    // predict() stages the input and output in scratch as well
+    if (scratch_a_ == nullptr || scratch_b_ == nullptr) {
+        return;
+    }
+    if (scratch_size_ < scratch_size_for(layers_, num_layers_)) {
+        return;
+    }
+
+    valid_ = true;
+}
+
+size_t FixedSequential::scratch_size_for(const FixedDense* const* layers, size_t num_layers) {
+    size_t max_width = (num_layers > 0) ? layers[0]->input_size : 0;
+    for (size_t i = 0; i < num_layers; ++i) {
+        max_width = std::max(max_width, layers[i]->output_size);
+    }
+    return max_width;
+}
+
+size_t FixedSequential::input_size() const {
+    return valid_ ? layers_[0]->input_size : 0;
+}
+
+size_t FixedSequential::output_size() const {
+    return valid_ ? layers_[num_layers_ - 1]->output_size : 0;
+}
+
+int32_t FixedSequential::input_frac() const {
+    return valid_ ? layers_[0]->input_frac : 0;
+}
+
+int32_t FixedSequential::output_frac() const {
+    return valid_ ? layers_[num_layers_ - 1]->output_frac : 0;
+}
+
+bool FixedSequential::predict_fixed(const int16_t* input, int16_t* output) {
+    if (!valid_) {
+        return false;
+    }
+
+    const int16_t* current = input;
+    for (size_t i = 0; i < num_layers_; ++i) {
+        const bool is_last = (i + 1 == num_layers_);
+        int16_t* next = is_last ? output : ((i % 2 == 0) ? scratch_a_ : scratch_b_);
+        FixedOps::dense_forward(*layers_[i], current, next);
+        current = next;
+    }
+
+    return true;
+}
+
+int FixedSequential::predict_class(const int16_t* input) {
+    if (!valid_) {
+        return -1;
+    }
+
+    // The last layer writes into whichever buffer predict_fixed() did not
+    // leave its final hidden activations in
+    int16_t* logits = (num_layers_ % 2 == 0) ? scratch_b_ : scratch_a_;
+    predict_fixed(input, logits);
+    return static_cast<int>(FixedOps::argmax(logits, output_size()));
+}
+
+bool FixedSequential::predict(const float* input, float* output) {
+    if (!valid_) {
+        return false;
+    }
+
+    const int32_t in_frac = input_frac();
+    for (size_t k = 0; k < input_size(); ++k) {
+        scratch_a_[k] = FixedOps::to_fixed(input[k], in_frac);
+    }
+
+    // Integer-only from here: ping-pong A -> B -> A ...
+    int16_t* current = scratch_a_;
+    for (size_t i = 0; i < num_layers_; ++i) {
+        int16_t* next = (current == scratch_a_) ? scratch_b_ : scratch_a_;
+        FixedOps::dense_forward(*layers_[i], current, next);
+        current = next;
+    }
+
+    const size_t width = output_size();
+    int32_t out_frac = output_frac();
+    if (layers_[num_layers_ - 1]->activation == ActivationType::Softmax) {
+        int16_t* probs = (current == scratch_a_) ? scratch_b_ : scratch_a_;
+        FixedOps::softmax(current, out_frac, probs, width);
+        current = probs;
+        out_frac = FixedOps::kProbFracBits;
+    }
+
+    for (size_t k = 0; k < width; ++k) {
+        output[k] = FixedOps::to_float(current[k], out_frac);
+    }
+
+    return true;
+}
+
+} // namespace CustomNN
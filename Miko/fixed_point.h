@@ -0,0 +1,251 @@
+/**
+ * Q15 Fixed-Point Inference
+ * Integer-only dense layers, softmax and argmax for the FPU-less RP2040
+ *
+ * Activations and weights are int16 in a Q format per tensor (value =
+ * q * 2^-frac_bits; Q15 when the range is below 1), accumulators are Q31-
+ * style int32. Frac bits are powers of two, so requantization is a rounding
+ * shift and every step is plain integer arithmetic: the same input gives
+ * the same bits on the host and on the Cortex-M0+.
+ *
+ * Weight frac bits are chosen per layer so that no int16 input can overflow
+ * the int32 accumulator. Activation formats come either from worst-case
+ * bounds (output_bound, never saturates) or from calibrated ranges.
+ *
+ * Usage:
+ *   QFormat in = FixedOps::format_for(128.0f);               // Input range
+ *   QFormat h = FixedOps::output_bound(w1, b1, 10, 8, in);
+ *   FixedDenseLayer l1(w1, b1, 10, 8, ActivationType::ReLU, in, h);
+ *   FixedDenseLayer l2(w2, b2, 8, 2, ActivationType::Softmax, h,
+ *                      FixedOps::output_bound(w2, b2, 8, 2, h));
+ *   const FixedDense* layers[] = {&l1.params(), &l2.params()};
+ *   FixedSequential model(layers, 2, scratch_a, scratch_b, size);
+ *   model.predict_fixed(input_q, logits_q);
+ *   FixedOps::softmax(logits_q, model.output_frac(), probs_q15, 2);
+ */
+
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include "neural_network.h"
+
+namespace CustomNN {
+
+/**
+ * Q format of an int16 tensor: real = q * 2^-frac_bits, |real| <= max_abs
+ */
+struct QFormat {
+    int32_t frac_bits;
+    float max_abs;
+};
+
+/**
+ * Fixed-point dense layer as plain data
+ *
+ * output[j] = saturate16(round((bias[j] + sum_i(weights[j][i] * input[i]))
+ *                              * 2^(output_frac - input_frac - weight_frac)))
+ */
+struct FixedDense {
+    const int16_t* weights;      // Output-major: [output_size][input_size], weight_frac
+    const int32_t* bias;         // [output_size], input_frac + weight_frac
+    size_t input_size;
+    size_t output_size;
+    int32_t input_frac;
+    int32_t weight_frac;
+    int32_t output_frac;
+    ActivationType activation;   // ReLU is max(0); Softmax is left to the caller
+};
+
+/**
+ * Q-format helpers and the fixed-point kernels
+ */
+class FixedOps {
+public:
+    // Softmax probabilities are Q15: 32767 ~= 1.0
+    static constexpr int32_t kProbFracBits = 15;
+
+    /**
+     * Largest frac bits (in [-15, 30]) that keep max_abs within int16
+     */
+    static int32_t frac_bits_for(float max_abs);
+
+    static QFormat format_for(float max_abs);
+
+    /**
+     * Worst-case output format of a dense layer: |b| + sum_i |w| * in.max_abs
+     * per channel. Activations in this format never saturate.
+     * @param weights Float weights [input_size][output_size]
+     */
+    static QFormat output_bound(const float* weights, const float* bias,
+                                size_t input_size, size_t output_size, QFormat input);
+
+    static int16_t saturate(int32_t value);
+
+    /**
+     * round(value * 2^frac_bits), saturated to int16
+     */
+    static int16_t to_fixed(float value, int32_t frac_bits);
+    static float to_float(int32_t value, int32_t frac_bits);
+
+    /**
+     * value * 2^-shift, rounded half up; a negative shift is a saturating
+     * left shift
+     */
+    static int32_t shift_round(int32_t value, int32_t shift);
+
+    /**
+     * Fixed-point dense layer forward pass (int32 accumulation)
+     * @param input Input vector [layer.input_size]
+     * @param output Output vector [layer.output_size]
+     */
+    static void dense_forward(const FixedDense& layer, const int16_t* input, int16_t* output);
+
+    /**
+     * 2^x for x <= 0, both Q15 (cubic polynomial on the fraction, max
+     * relative error 9e-5)
+     */
+    static int32_t exp2_q15(int32_t x);
+
+    /**
+     * Logistic sigmoid and tanh of x (frac_bits fractional bits, |x| <=
+     * 65535) as Q15, from exp2_q15 and one integer divide; saturated to
+     * 32767 at 1.0. For the gates of recurrent layers.
+     */
+    static int16_t sigmoid_q15(int32_t x, int32_t frac_bits);
+    static int16_t tanh_q15(int32_t x, int32_t frac_bits);
+
+    /**
+     * Fixed-point softmax
+     * @param logits Input logits [size] with frac_bits fractional bits
+     * @param probs Output probabilities [size], Q15
+     * @param size Number of classes (at most 65535)
+     */
+    static void softmax(const int16_t* logits, int32_t frac_bits, int16_t* probs, size_t size);
+
+    /**
+     * Index of the largest value (first one on ties)
+     */
+    static size_t argmax(const int16_t* values, size_t size);
+};
+
+/**
+ * Owning fixed-point conversion of a float dense layer
+ *
+ * Transposes weights [input_size][output_size] (the layout of the float
+ * weight headers) to int16 output-major rows. Conversion is exact float
+ * scaling by powers of two, so it gives the same tables on every target.
+ */
+class FixedDenseLayer {
+private:
+    int16_t* weights_;
+    int32_t* bias_;
+    FixedDense params_;
+
+public:
+    /**
+     * Constructor
+     * @param weights Float weights as 1D array [input_size * output_size]
+     * @param bias Float bias [output_size]
+     * @param input_size Layer input size
+     * @param output_size Layer output size
+     * @param activation Activation applied to the output
+     * @param input Format of the layer input
+     * @param output Format of the layer output
+     */
+    FixedDenseLayer(
+        const float* weights,
+        const float* bias,
+        size_t input_size,
+        size_t output_size,
+        ActivationType activation,
+        QFormat input,
+        QFormat output
+    );
+
+    ~FixedDenseLayer();
+
+    FixedDenseLayer(FixedDenseLayer&& other) noexcept;
+    FixedDenseLayer(const FixedDenseLayer&) = delete;
+    FixedDenseLayer& operator=(const FixedDenseLayer&) = delete;
+    FixedDenseLayer& operator=(FixedDenseLayer&&) = delete;
+
+    const FixedDense& params() const { return params_; }
+};
+
+/**
+ * Sequential fixed-point model
+ *
+ * Mirrors QuantizedSequential: int16 activations ping-pong between two
+ * caller-owned scratch buffers. Each layer's input frac bits must equal
+ * the previous layer's output frac bits.
+ */
+class FixedSequential {
+private:
+    const FixedDense* const* layers_;
+    size_t num_layers_;
+    int16_t* scratch_a_;
+    int16_t* scratch_b_;
+    size_t scratch_size_;   // Capacity of each scratch buffer (elements)
+    bool valid_;
+
+public:
+    /**
+     * Constructor
+     * @param layers Array of layer pointers [num_layers] (borrowed)
+     * @param num_layers Number of layers
+     * @param scratch_a First scratch buffer [scratch_size]
+     * @param scratch_b Second scratch buffer [scratch_size]
+     * @param scratch_size Capacity of each scratch buffer,
+     *                     at least scratch_size_for(layers, num_layers)
+     */
+    FixedSequential(
+        const FixedDense* const* layers,
+        size_t num_layers,
+        int16_t* scratch_a,
+        int16_t* scratch_b,
+        size_t scratch_size
+    );
+
+    /**
+     * Elements each scratch buffer needs: the widest of the model input and
+     * every layer output (the float predict() stages both ends in scratch)
+     */
+    static size_t scratch_size_for(const FixedDense* const* layers, size_t num_layers);
+
+    bool is_valid() const { return valid_; }
+
+    size_t num_layers() const { return num_layers_; }
+    size_t input_size() const;
+    size_t output_size() const;
+    int32_t input_frac() const;
+    int32_t output_frac() const;
+
+    /**
+     * Integer-only inference
+     * @param input Input [input_size()] with input_frac() fractional bits
+     * @param output Output logits [output_size()] with output_frac() bits
+     * @return false if the model is invalid
+     */
+    bool predict_fixed(const int16_t* input, int16_t* output);
+
+    /**
+     * Integer-only classification: argmax of the logits (softmax does not
+     * change the order, so it is skipped)
+     * @return Predicted class index, or -1 if the model is invalid
+     */
+    int predict_class(const int16_t* input);
+
+    /**
+     * Float in, float out: converts the input, runs the fixed-point layers
+     * and the fixed-point softmax if the last layer asks for it, then
+     * converts the output
+     * @return false if the model is invalid
+     */
+    bool predict(const float* input, float* output);
+};
+
+} // namespace CustomNN
+
+#endif // FIXED_POINT_H
@@ -0,0 +1,439 @@
+/**
+ * Half-Precision Weight Storage Implementation
+ */
+
+#include "half.h"
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CUSTOMNN_X86_HALF 1
+#include <immintrin.h>
+#else
+#define CUSTOMNN_X86_HALF 0
+#endif
+
+// Scalar helpers are inlined into the AVX2 kernels: a call (or tail call)
+// from AVX code into SSE code would skip vzeroupper and pay the AVX-SSE
+// transition penalty on every instruction after it
+#if defined(__GNUC__)
+#define HALF_INLINE inline __attribute__((always_inline))
+#else
+#define HALF_INLINE inline
+#endif
+
+namespace CustomNN {
+
+namespace {
+
+HALF_INLINE uint32_t float_bits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+HALF_INLINE float bits_float(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Integer-only, so the M0+ needs no soft-float call per weight
+HALF_INLINE float fp16_widen(uint16_t value) {
+    const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    uint32_t exponent = (value >> 10) & 0x1Fu;
+    uint32_t mantissa = value & 0x3FFu;
+
+    if (exponent == 0x1Fu) {
+        // Inf, or NaN with its payload kept and made quiet (as F16C does)
+        const uint32_t quiet = (mantissa != 0) ? 0x400000u : 0u;
+        return bits_float(sign | 0x7F800000u | quiet | (mantissa << 13));
+    }
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            return bits_float(sign);
+        }
+        // Subnormal: normalize into a float normal
+        exponent = 1;
+        while ((mantissa & 0x400u) == 0) {
+            mantissa <<= 1;
+            --exponent;
+        }
+        mantissa &= 0x3FFu;
+    }
+    // Rebias 15 -> 127
+    return bits_float(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+}
+
+HALF_INLINE float bf16_widen(uint16_t value) {
+    return bits_float(static_cast<uint32_t>(value) << 16);
+}
+
+HALF_INLINE float widen_one(uint16_t value, HalfFormat format) {
+    return (format == HalfFormat::FP16) ? fp16_widen(value) : bf16_widen(value);
+}
+
+// Same result as Activation::relu: max(0, x), with NaN mapped to 0
+HALF_INLINE float relu_if(float value, bool relu) {
+    return (relu && !(value > 0.0f)) ? 0.0f : value;
+}
+
+// Columns [j_begin, output_size) one at a time, in the float kernel's order
+template <HalfFormat Format>
+HALF_INLINE void dense_scalar_from(const HalfDense& layer, const float* input, float* output,
+                       size_t j_begin) {
+    const size_t cols = layer.output_size;
+    const bool relu = (layer.activation == ActivationType::ReLU);
+    for (size_t j = j_begin; j < cols; ++j) {
+        float acc = layer.bias[j];
+        for (size_t i = 0; i < layer.input_size; ++i) {
+            acc += widen_one(layer.weights[i * cols + j], Format) * input[i];
+        }
+        output[j] = relu_if(acc, relu);
+    }
+}
+
+void dense_scalar(const HalfDense& layer, const float* input, float* output) {
+    if (layer.format == HalfFormat::FP16) {
+        dense_scalar_from<HalfFormat::FP16>(layer, input, output, 0);
+    } else {
+        dense_scalar_from<HalfFormat::BF16>(layer, input, output, 0);
+    }
+}
+
+HALF_INLINE void widen_scalar_from(const uint16_t* input, float* output, size_t n,
+                                   HalfFormat format) {
+    for (size_t k = 0; k < n; ++k) {
+        output[k] = widen_one(input[k], format);
+    }
+}
+
+void widen_scalar(const uint16_t* input, float* output, size_t n, HalfFormat format) {
+    widen_scalar_from(input, output, n, format);
+}
+
+#if CUSTOMNN_X86_HALF
+
+// Output widths from which the AVX2 kernel streams rows, and the outputs
+// it keeps in L1 per pass (2 KiB of accumulators, 1 KiB of each row)
+constexpr size_t kStreamMinCols = 512;
+constexpr size_t kStreamBlockCols = 512;
+
+// 8 stored weights -> 8 floats
+template <HalfFormat Format>
+__attribute__((target("avx2,f16c"))) HALF_INLINE __m256 load8_avx2(const uint16_t* p) {
+    const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    if constexpr (Format == HalfFormat::FP16) {
+        return _mm256_cvtph_ps(raw);
+    } else {
+        return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(raw), 16));
+    }
+}
+
+__attribute__((target("avx2,f16c")))
+HALF_INLINE __m256 relu_if_avx2(__m256 v, bool relu) {
+    // max_ps returns the second operand for NaN, like relu_if
+    return relu ? _mm256_max_ps(v, _mm256_setzero_ps()) : v;
+}
+
+// Wide layers: accumulate a block of outputs in place, one weight row at a
+// time, so the weights stream contiguously instead of one cache line per
+// row per column tile. Each output still sums bias + w0 x0 + w1 x1 + ...
+template <HalfFormat Format>
+__attribute__((target("avx2,f16c")))
+HALF_INLINE void dense_avx2_rows(const HalfDense& layer, const float* input, float* output) {
+    const size_t rows = layer.input_size;
+    const size_t cols = layer.output_size;
+    const bool relu = (layer.activation == ActivationType::ReLU);
+
+    for (size_t j_begin = 0; j_begin < cols; j_begin += kStreamBlockCols) {
+        const size_t j_end = (cols - j_begin < kStreamBlockCols) ? cols : j_begin + kStreamBlockCols;
+        std::memcpy(output + j_begin, layer.bias + j_begin, (j_end - j_begin) * sizeof(float));
+
+        // Four rows per pass over the block, added in row order, so each
+        // accumulator is loaded and stored once per four rows
+        size_t i = 0;
+        for (; i + 4 <= rows; i += 4) {
+            const uint16_t* row0 = layer.weights + i * cols;
+            const uint16_t* row1 = row0 + cols;
+            const uint16_t* row2 = row1 + cols;
+            const uint16_t* row3 = row2 + cols;
+            const __m256 x0 = _mm256_set1_ps(input[i]);
+            const __m256 x1 = _mm256_set1_ps(input[i + 1]);
+            const __m256 x2 = _mm256_set1_ps(input[i + 2]);
+            const __m256 x3 = _mm256_set1_ps(input[i + 3]);
+            size_t j = j_begin;
+            for (; j + 8 <= j_end; j += 8) {
+                __m256 acc = _mm256_loadu_ps(output + j);
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(load8_avx2<Format>(row0 + j), x0));
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(load8_avx2<Format>(row1 + j), x1));
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(load8_avx2<Format>(row2 + j), x2));
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(load8_avx2<Format>(row3 + j), x3));
+                _mm256_storeu_ps(output + j, acc);
+            }
+            for (; j < j_end; ++j) {
+                float acc = output[j];
+                acc += widen_one(row0[j], Format) * input[i];
+                acc += widen_one(row1[j], Format) * input[i + 1];
+                acc += widen_one(row2[j], Format) * input[i + 2];
+                acc += widen_one(row3[j], Format) * input[i + 3];
+                output[j] = acc;
+            }
+        }
+        for (; i < rows; ++i) {
+            const uint16_t* row = layer.weights + i * cols;
+            const __m256 x = _mm256_set1_ps(input[i]);
+            size_t j = j_begin;
+            for (; j + 8 <= j_end; j += 8) {
+                const __m256 acc = _mm256_loadu_ps(output + j);
+                _mm256_storeu_ps(output + j,
+                                 _mm256_add_ps(acc, _mm256_mul_ps(load8_avx2<Format>(row + j), x)));
+            }
+            for (; j < j_end; ++j) {
+                output[j] += widen_one(row[j], Format) * input[i];
+            }
+        }
+        for (size_t j = j_begin; j < j_end; ++j) {
+            output[j] = relu_if(output[j], relu);
+        }
+    }
+}
+
+template <HalfFormat Format>
+__attribute__((target("avx2,f16c")))
+void dense_avx2_format(const HalfDense& layer, const float* input, float* output) {
+    const size_t rows = layer.input_size;
+    const size_t cols = layer.output_size;
+    const uint16_t* weights = layer.weights;
+    const bool relu = (layer.activation == ActivationType::ReLU);
+
+    if (cols >= kStreamMinCols) {
+        dense_avx2_rows<Format>(layer, input, output);
+        return;
+    }
+
+    // 32 columns in four registers, then 8, then the scalar tail; each
+    // column still sums bias + w0 x0 + w1 x1 + ... in order
+    size_t j = 0;
+    for (; j + 32 <= cols; j += 32) {
+        __m256 acc0 = _mm256_loadu_ps(layer.bias + j);
+        __m256 acc1 = _mm256_loadu_ps(layer.bias + j + 8);
+        __m256 acc2 = _mm256_loadu_ps(layer.bias + j + 16);
+        __m256 acc3 = _mm256_loadu_ps(layer.bias + j + 24);
+        for (size_t i = 0; i < rows; ++i) {
+            const __m256 x = _mm256_set1_ps(input[i]);
+            const uint16_t* row = weights + i * cols + j;
+            acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(load8_avx2<Format>(row), x));
+            acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(load8_avx2<Format>(row + 8), x));
+            acc2 = _mm256_add_ps(acc2, _mm256_mul_ps(load8_avx2<Format>(row + 16), x));
+            acc3 = _mm256_add_ps(acc3, _mm256_mul_ps(load8_avx2<Format>(row + 24), x));
+        }
+        _mm256_storeu_ps(output + j, relu_if_avx2(acc0, relu));
+        _mm256_storeu_ps(output + j + 8, relu_if_avx2(acc1, relu));
+        _mm256_storeu_ps(output + j + 16, relu_if_avx2(acc2, relu));
+        _mm256_storeu_ps(output + j + 24, relu_if_avx2(acc3, relu));
+    }
+    for (; j + 8 <= cols; j += 8) {
+        __m256 acc = _mm256_loadu_ps(layer.bias + j);
+        for (size_t i = 0; i < rows; ++i) {
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(load8_avx2<Format>(weights + i * cols + j),
+                                                   _mm256_set1_ps(input[i])));
+        }
+        _mm256_storeu_ps(output + j, relu_if_avx2(acc, relu));
+    }
+    dense_scalar_from<Format>(layer, input, output, j);
+}
+
+void dense_avx2(const HalfDense& layer, const float* input, float* output) {
+    if (layer.format == HalfFormat::FP16) {
+        dense_avx2_format<HalfFormat::FP16>(layer, input, output);
+    } else {
+        dense_avx2_format<HalfFormat::BF16>(layer, input, output);
+    }
+}
+
+__attribute__((target("avx2,f16c")))
+void widen_avx2(const uint16_t* input, float* output, size_t n, HalfFormat format) {
+    size_t k = 0;
+    if (format == HalfFormat::FP16) {
+        for (; k + 8 <= n; k += 8) {
+            _mm256_storeu_ps(output + k, load8_avx2<HalfFormat::FP16>(input + k));
+        }
+    } else {
+        for (; k + 8 <= n; k += 8) {
+            _mm256_storeu_ps(output + k, load8_avx2<HalfFormat::BF16>(input + k));
+        }
+    }
+    widen_scalar_from(input + k, output + k, n - k, format);
+}
+
+bool simd_supported() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c");
+}
+
+#else
+
+bool simd_supported() {
+    return false;
+}
+
+#endif // CUSTOMNN_X86_HALF
+
+struct HalfKernels {
+    const char* name;
+    void (*dense)(const HalfDense& layer, const float* input, float* output);
+    void (*widen)(const uint16_t* input, float* output, size_t n, HalfFormat format);
+};
+
+constexpr HalfKernels kScalarKernels = {"scalar", dense_scalar, widen_scalar};
+#if CUSTOMNN_X86_HALF
+constexpr HalfKernels kSimdKernels = {"avx2+f16c", dense_avx2, widen_avx2};
+#endif
+
+const HalfKernels*& active_slot() {
+#if CUSTOMNN_X86_HALF
+    static const HalfKernels* active = simd_supported() ? &kSimdKernels : &kScalarKernels;
+#else
+    static const HalfKernels* active = &kScalarKernels;
+#endif
+    return active;
+}
+
+} // namespace
+
+// ============================================================================
+// HalfOps
+// ============================================================================
+
+float HalfOps::fp16_to_float(uint16_t value) {
+    return fp16_widen(value);
+}
+
+uint16_t HalfOps::float_to_fp16(float value) {
+    uint32_t bits = float_bits(value);
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    bits &= 0x7FFFFFFFu;
+
+    if (bits >= 0x7F800000u) {
+        // Inf stays Inf; NaN stays a (quiet) NaN
+        return static_cast<uint16_t>(sign | 0x7C00u | ((bits > 0x7F800000u) ? 0x200u : 0u));
+    }
+    if (bits >= 0x477FF000u) {
+        // 65520 and up round past the largest fp16 (65504)
+        return static_cast<uint16_t>(sign | 0x7C00u);
+    }
+    if (bits < 0x38800000u) {
+        // Below 2^-14: fp16 subnormal (or zero), in units of 2^-24
+        if (bits < 0x33000000u) {
+            return sign;   // At most 2^-25, which ties to even (0)
+        }
+        const uint32_t exponent = bits >> 23;
+        const uint32_t mantissa = (bits & 0x7FFFFFu) | 0x800000u;
+        const uint32_t shift = 126u - exponent;
+        uint32_t result = mantissa >> shift;
+        const uint32_t rest = mantissa & ((1u << shift) - 1u);
+        const uint32_t halfway = 1u << (shift - 1u);
+        if (rest > halfway || (rest == halfway && (result & 1u) != 0)) {
+            ++result;   // May carry into the smallest normal, which is right
+        }
+        return static_cast<uint16_t>(sign | result);
+    }
+    // Normal: round the 13 dropped mantissa bits to nearest even, then rebias
+    bits += 0xFFFu + ((bits >> 13) & 1u);
+    return static_cast<uint16_t>(sign | ((bits - (112u << 23)) >> 13));
+}
+
+float HalfOps::bf16_to_float(uint16_t value) {
+    return bf16_widen(value);
+}
+
+uint16_t HalfOps::float_to_bf16(float value) {
+    const uint32_t bits = float_bits(value);
+    if ((bits & 0x7FFFFFFFu) > 0x7F800000u) {
+        // NaN: truncate and force quiet so the payload cannot round to Inf
+        return static_cast<uint16_t>((bits >> 16) | 0x40u);
+    }
+    return static_cast<uint16_t>((bits + 0x7FFFu + ((bits >> 16) & 1u)) >> 16);
+}
+
+float HalfOps::to_float(uint16_t value, HalfFormat format) {
+    return widen_one(value, format);
+}
+
+uint16_t HalfOps::from_float(float value, HalfFormat format) {
+    return (format == HalfFormat::FP16) ? float_to_fp16(value) : float_to_bf16(value);
+}
+
+void HalfOps::widen(const uint16_t* input, float* output, size_t n, HalfFormat format) {
+    active_slot()->widen(input, output, n, format);
+}
+
+void HalfOps::narrow(const float* input, uint16_t* output, size_t n, HalfFormat format) {
+    for (size_t k = 0; k < n; ++k) {
+        output[k] = from_float(input[k], format);
+    }
+}
+
+void HalfOps::dense_forward(const HalfDense& layer, const float* input, float* output) {
+    active_slot()->dense(layer, input, output);
+}
+
+const char* HalfOps::kernel_name() {
+    return active_slot()->name;
+}
+
+bool HalfOps::use_simd(bool enabled) {
+    if (!enabled) {
+        active_slot() = &kScalarKernels;
+        return true;
+    }
+#if CUSTOMNN_X86_HALF
+    if (simd_supported()) {
+        active_slot() = &kSimdKernels;
+        return true;
+    }
+#endif
+    return false;
+}
+
+size_t HalfOps::storage_bytes(size_t input_size, size_t output_size) {
+    return input_size * output_size * sizeof(uint16_t) + output_size * sizeof(float);
+}
+
+// ============================================================================
+// Layers
+// ============================================================================
+
+void HalfLayer::forward(const float* input, float* output) const {
+    HalfOps::dense_forward(params_, input, output);
+}
+
+HalfDenseLayer::HalfDenseLayer(
+    const float* weights,
+    const float* bias,
+    size_t input_size,
+    size_t output_size,
+    ActivationType activation,
+    HalfFormat format
+) : weights_(new uint16_t[input_size * output_size]),
+    params_{weights_, bias, input_size, output_size, format, activation}
+{
+    HalfOps::narrow(weights, weights_, input_size * output_size, format);
+}
+
+HalfDenseLayer::~HalfDenseLayer() {
+    delete[] weights_;
+}
+
+HalfDenseLayer::HalfDenseLayer(HalfDenseLayer&& other) noexcept
+  : weights_(other.weights_),
+    params_(other.params_)
+{
+    other.weights_ = nullptr;
+}
+
+void HalfDenseLayer::forward(const float* input, float* output) const {
+    HalfOps::dense_forward(params_, input, output);
+}
+
+} // namespace CustomNN
@@ -0,0 +1,168 @@
+/**
+ * Half-Precision Weight Storage
+ * Dense layers whose weights are stored as fp16 or bf16 and widened to
+ * float inside the kernel
+ *
+ * Both formats are 16 bits, so weight flash/RAM and the bytes the matvec
+ * streams are halved; all arithmetic stays float, in the same order as
+ * the input-major float kernel. fp16 (IEEE binary16: 5-bit exponent,
+ * 10-bit mantissa) keeps ~3.3 significant digits over +-65504, which
+ * suits trained weights; bf16 (the top half of a float: 8-bit exponent,
+ * 7-bit mantissa) keeps the float range but only ~2.4 digits.
+ *
+ * Conversions round to nearest even. On x86 hosts with AVX2 and F16C the
+ * widening runs 8 weights per instruction; everywhere else (including the
+ * RP2040) it is a few integer ops per weight.
+ *
+ * Usage:
+ *   // Offline: see tools/half_weights (`make half`)
+ *   HalfLayer l1(TEMP_LAYER1_FP16);
+ *   HalfLayer l2(TEMP_LAYER2_FP16);
+ *   const Layer* layers[] = {&l1, &l2};
+ *   Sequential model(layers, 2, scratch_a, scratch_b, 8);
+ *
+ * The generated headers (temp_model_weights_half.h, model_weights_half.h)
+ * hold both formats of each layer.
+ */
+
+#ifndef HALF_H
+#define HALF_H
+
+#include <cstddef>
+#include <cstdint>
+#include "neural_network.h"
+
+namespace CustomNN {
+
+/**
+ * 16-bit float encoding of stored weights
+ */
+enum class HalfFormat {
+    FP16,   // IEEE 754 binary16
+    BF16    // bfloat16
+};
+
+/**
+ * Half-precision dense layer as plain data, so it can be a constexpr in flash
+ */
+struct HalfDense {
+    const uint16_t* weights;   // [input_size][output_size], the float headers' layout
+    const float* bias;         // [output_size]
+    size_t input_size;
+    size_t output_size;
+    HalfFormat format;
+    ActivationType activation; // ReLU is fused; Softmax is left to the caller
+};
+
+/**
+ * Conversions and the widening dense kernel
+ */
+class HalfOps {
+public:
+    static float fp16_to_float(uint16_t value);
+    static uint16_t float_to_fp16(float value);
+    static float bf16_to_float(uint16_t value);
+    static uint16_t float_to_bf16(float value);
+
+    static float to_float(uint16_t value, HalfFormat format);
+    static uint16_t from_float(float value, HalfFormat format);
+
+    /**
+     * Widen n values to float (SIMD on x86 hosts with AVX2 + F16C)
+     */
+    static void widen(const uint16_t* input, float* output, size_t n, HalfFormat format);
+
+    /**
+     * Round n floats to the given format
+     */
+    static void narrow(const float* input, uint16_t* output, size_t n, HalfFormat format);
+
+    /**
+     * output = act(bias + input * widen(weights)), bit-identical to the
+     * float input-major kernel run on the widened weights
+     * @param input Input vector [layer.input_size]
+     * @param output Output vector [layer.output_size]
+     */
+    static void dense_forward(const HalfDense& layer, const float* input, float* output);
+
+    /**
+     * Name of the kernels in use: "avx2+f16c" or "scalar"
+     */
+    static const char* kernel_name();
+
+    /**
+     * Enable or disable the SIMD kernels (e.g. for benchmarking). Not
+     * thread-safe, like Kernels::select().
+     * @return false (and no change) if enabling and the CPU lacks them
+     */
+    static bool use_simd(bool enabled);
+
+    /**
+     * Bytes of a layer: 16-bit weights plus float bias
+     */
+    static size_t storage_bytes(size_t input_size, size_t output_size);
+};
+
+/**
+ * Layer over borrowed half-precision data (e.g. a constexpr in flash)
+ */
+class HalfLayer : public Layer {
+private:
+    const HalfDense& params_;
+
+public:
+    explicit HalfLayer(const HalfDense& params) : params_(params) {}
+
+    size_t input_size() const override { return params_.input_size; }
+    size_t output_size() const override { return params_.output_size; }
+    ActivationType activation() const override { return params_.activation; }
+
+    void forward(const float* input, float* output) const override;
+};
+
+/**
+ * Owning fp16 or bf16 conversion of a float dense layer
+ */
+class HalfDenseLayer : public Layer {
+private:
+    uint16_t* weights_;
+    HalfDense params_;
+
+public:
+    /**
+     * Constructor
+     * @param weights Float weights as 1D array [input_size * output_size]
+     * @param bias Float bias [output_size] (borrowed)
+     * @param input_size Layer input size
+     * @param output_size Layer output size
+     * @param activation Activation applied to the output
+     * @param format Storage format of the weights
+     */
+    HalfDenseLayer(
+        const float* weights,
+        const float* bias,
+        size_t input_size,
+        size_t output_size,
+        ActivationType activation,
+        HalfFormat format
+    );
+
+    ~HalfDenseLayer() override;
+
+    HalfDenseLayer(HalfDenseLayer&& other) noexcept;
+    HalfDenseLayer(const HalfDenseLayer&) = delete;
+    HalfDenseLayer& operator=(const HalfDenseLayer&) = delete;
+    HalfDenseLayer& operator=(HalfDenseLayer&&) = delete;
+
+    const HalfDense& params() const { return params_; }
+
+    size_t input_size() const override { return params_.input_size; }
+    size_t output_size() const override { return params_.output_size; }
+    ActivationType activation() const override { return params_.activation; }
+
+    void forward(const float* input, float* output) const override;
+};
+
+} // namespace CustomNN
+
+#endif // HALF_H
@@ -0,0 +1,202 @@
+/**
+ * Inference Cache Implementation
+ */
+
+#include "inference_cache.h"
+
+namespace CustomNN {
+
+namespace {
+
+// Codes saturate here, well inside int32 (NaN goes to the top)
+constexpr float kCodeLimit = 1.0e9f;
+
+constexpr uint32_t kFnvOffset = 2166136261u;
+constexpr uint32_t kFnvPrime = 16777619u;
+
+} // namespace
+
+InferenceCache::InferenceCache(size_t input_size, size_t output_size, size_t capacity,
+                               float quantum)
+    : input_size_(input_size),
+      output_size_(output_size),
+      capacity_(0),
+      inv_quantum_(0.0f),
+      tags_(nullptr),
+      keys_(nullptr),
+      values_(nullptr),
+      pending_(nullptr),
+      pending_tag_(0),
+      victim_(0),
+      size_(0),
+      hits_(0),
+      misses_(0),
+      evictions_(0)
+{
+    if (input_size == 0 || output_size == 0 || capacity == 0 || !(quantum > 0.0f)) {
+        return;
+    }
+    capacity_ = 1;
+    while (capacity_ < capacity) {
+        capacity_ *= 2;
+    }
+    inv_quantum_ = 1.0f / quantum;
+    tags_ = new uint32_t[capacity_];
+    keys_ = new int32_t[capacity_ * input_size];
+    values_ = new float[capacity_ * output_size];
+    pending_ = new int32_t[input_size];
+    clear();
+}
+
+InferenceCache::~InferenceCache() {
+    delete[] tags_;
+    delete[] keys_;
+    delete[] values_;
+    delete[] pending_;
+}
+
+InferenceCache::InferenceCache(InferenceCache&& other) noexcept
+    : input_size_(other.input_size_),
+      output_size_(other.output_size_),
+      capacity_(other.capacity_),
+      inv_quantum_(other.inv_quantum_),
+      tags_(other.tags_),
+      keys_(other.keys_),
+      values_(other.values_),
+      pending_(other.pending_),
+      pending_tag_(other.pending_tag_),
+      victim_(other.victim_),
+      size_(other.size_),
+      hits_(other.hits_),
+      misses_(other.misses_),
+      evictions_(other.evictions_)
+{
+    other.capacity_ = 0;
+    other.tags_ = nullptr;
+    other.keys_ = nullptr;
+    other.values_ = nullptr;
+    other.pending_ = nullptr;
+    other.pending_tag_ = 0;
+    other.size_ = 0;
+}
+
+float InferenceCache::hit_rate() const {
+    const size_t lookups = hits_ + misses_;
+    return (lookups == 0) ? 0.0f : static_cast<float>(hits_) / static_cast<float>(lookups);
+}
+
+void InferenceCache::reset_stats() {
+    hits_ = 0;
+    misses_ = 0;
+    evictions_ = 0;
+}
+
+void InferenceCache::clear() {
+    for (size_t s = 0; s < capacity_; ++s) {
+        tags_[s] = 0;
+    }
+    pending_tag_ = 0;
+    victim_ = 0;
+    size_ = 0;
+}
+
+uint32_t InferenceCache::make_key(const float* input) {
+    uint32_t hash = kFnvOffset;
+    for (size_t i = 0; i < input_size_; ++i) {
+        float v = input[i] * inv_quantum_;
+        v = (v < kCodeLimit) ? v : kCodeLimit;
+        v = (v > -kCodeLimit) ? v : -kCodeLimit;
+        const int32_t code = static_cast<int32_t>(v + ((v >= 0.0f) ? 0.5f : -0.5f));
+        pending_[i] = code;
+        // FNV-1a a word at a time: one multiply per code
+        hash = (hash ^ static_cast<uint32_t>(code)) * kFnvPrime;
+    }
+    // Fold the high bits, which the multiplies mix best, into the slot bits
+    hash ^= hash >> 16;
+    return hash | 1u;
+}
+
+const float* InferenceCache::find(const float* input) {
+    if (tags_ == nullptr) {
+        return nullptr;
+    }
+    const uint32_t tag = make_key(input);
+    const size_t mask = capacity_ - 1;
+    const size_t probes = (capacity_ < kMaxProbe) ? capacity_ : kMaxProbe;
+    const size_t home = tag & mask;
+    for (size_t p = 0; p < probes; ++p) {
+        const size_t slot = (home + p) & mask;
+        if (tags_[slot] == 0) {
+            break;   // Nothing is ever removed, so the key is not further on
+        }
+        if (tags_[slot] != tag) {
+            continue;
+        }
+        const int32_t* key = keys_ + slot * input_size_;
+        size_t i = 0;
+        while (i < input_size_ && key[i] == pending_[i]) {
+            ++i;
+        }
+        if (i == input_size_) {
+            ++hits_;
+            pending_tag_ = 0;
+            return values_ + slot * output_size_;
+        }
+    }
+    ++misses_;
+    pending_tag_ = tag;
+    return nullptr;
+}
+
+void InferenceCache::insert(const float* output) {
+    if (pending_tag_ == 0) {
+        return;
+    }
+    const size_t mask = capacity_ - 1;
+    const size_t probes = (capacity_ < kMaxProbe) ? capacity_ : kMaxProbe;
+    const size_t home = pending_tag_ & mask;
+    size_t slot = capacity_;
+    for (size_t p = 0; p < probes; ++p) {
+        if (tags_[(home + p) & mask] == 0) {
+            slot = (home + p) & mask;
+            break;
+        }
+    }
+    if (slot == capacity_) {
+        // Every probed slot is taken: overwrite one in turn (the slot stays
+        // occupied, so other keys' probe runs are not cut short)
+        slot = (home + victim_ % probes) & mask;
+        ++victim_;
+        ++evictions_;
+    } else {
+        ++size_;
+    }
+
+    tags_[slot] = pending_tag_;
+    int32_t* key = keys_ + slot * input_size_;
+    for (size_t i = 0; i < input_size_; ++i) {
+        key[i] = pending_[i];
+    }
+    float* value = values_ + slot * output_size_;
+    for (size_t o = 0; o < output_size_; ++o) {
+        value[o] = output[o];
+    }
+    pending_tag_ = 0;
+}
+
+bool InferenceCache::predict(NeuralNetwork& model, const float* input, float* output) {
+    if (const float* hit = find(input)) {
+        for (size_t o = 0; o < output_size_; ++o) {
+            output[o] = hit[o];
+        }
+        return true;
+    }
+    if (model.predict(input, output)) {
+        insert(output);
+    } else {
+        pending_tag_ = 0;   // Nothing valid to remember
+    }
+    return false;
+}
+
+} // namespace CustomNN
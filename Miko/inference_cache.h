@@ -0,0 +1,136 @@
+/**
+ * Inference Cache
+ * Memoizes model outputs keyed on the quantized input window
+ *
+ * The RP2040 temperature sensor reads in ADC codes about 0.47 C apart, so
+ * a sliding window of readings mostly repeats: a chip at rest produces the
+ * same ten codes over and over, and the model is recomputed on identical
+ * input every sample. InferenceCache sits in front of the model and returns
+ * the stored output when the window's codes have been seen before.
+ *
+ * The key is the window quantized to integer codes, round(x / quantum).
+ * With quantum set to the ADC step, windows built from the same ADC codes
+ * give the same key and windows from different codes give different keys,
+ * so a hit returns exactly what the model computed (for inputs that are not
+ * ADC readings, inputs within quantum / 2 share an output).
+ *
+ * The table is fixed-capacity open addressing: a power-of-two number of
+ * slots, probed linearly from the key's hash for at most kMaxProbe slots.
+ * Each slot stores its full key (collisions are resolved exactly) and a
+ * nonzero tag, the hash with the low bit set, so most mismatches are
+ * rejected without comparing keys. When every probed slot is taken, one of
+ * them is overwritten, round-robin. All memory is allocated once in the
+ * constructor: capacity * (4 * input_size + 4 * output_size + 4) bytes.
+ *
+ * Usage:
+ *   InferenceCache cache(10, 2, 64, 0.4681f);
+ *   // Every sample:
+ *   float probs[2];
+ *   cache.predict(model, window, probs);   // model: NeuralNetwork
+ *   // Or around any other predict:
+ *   if (const float* hit = cache.find(window)) { ... } else { ...; cache.insert(out); }
+ */
+
+#ifndef INFERENCE_CACHE_H
+#define INFERENCE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include "neural_network.h"
+
+namespace CustomNN {
+
+class InferenceCache {
+private:
+    size_t input_size_;
+    size_t output_size_;
+    size_t capacity_;       // Slots, a power of two
+    float inv_quantum_;
+    uint32_t* tags_;        // Owned: [capacity], 0 for an empty slot
+    int32_t* keys_;         // Owned: [capacity][input_size]
+    float* values_;         // Owned: [capacity][output_size]
+    int32_t* pending_;      // Owned: [input_size], key of the last miss
+    uint32_t pending_tag_;  // 0 if there is no miss to insert
+    size_t victim_;         // Round-robin offset for evictions
+    size_t size_;
+    size_t hits_;
+    size_t misses_;
+    size_t evictions_;
+
+    /**
+     * Quantize `input` into pending_ and return its tag
+     */
+    uint32_t make_key(const float* input);
+
+public:
+    // Slots probed per lookup before evicting
+    static constexpr size_t kMaxProbe = 8;
+
+    /**
+     * @param input_size Floats per input window
+     * @param output_size Floats per stored output
+     * @param capacity Slots, rounded up to a power of two
+     * @param quantum Input step that maps to one key code (the ADC step)
+     * An empty size or a non-positive quantum gives an invalid cache.
+     */
+    InferenceCache(size_t input_size, size_t output_size, size_t capacity, float quantum);
+    ~InferenceCache();
+
+    InferenceCache(InferenceCache&& other) noexcept;
+    InferenceCache(const InferenceCache&) = delete;
+    InferenceCache& operator=(const InferenceCache&) = delete;
+
+    bool is_valid() const { return tags_ != nullptr; }
+
+    size_t input_size() const { return input_size_; }
+    size_t output_size() const { return output_size_; }
+    size_t capacity() const { return capacity_; }
+    size_t size() const { return size_; }
+
+    size_t hits() const { return hits_; }
+    size_t misses() const { return misses_; }
+    size_t evictions() const { return evictions_; }
+
+    /**
+     * Fraction of lookups that hit, 0 before the first lookup
+     */
+    float hit_rate() const;
+
+    /**
+     * Zero the hit, miss and eviction counters (entries are kept)
+     */
+    void reset_stats();
+
+    /**
+     * Drop every entry (counters are kept)
+     */
+    void clear();
+
+    /**
+     * Look up an input window
+     * @param input Input [input_size()]
+     * @return The stored output [output_size()], or nullptr on a miss (the
+     *         key is then remembered for insert())
+     */
+    const float* find(const float* input);
+
+    /**
+     * Store the output for the input of the last find() that missed; does
+     * nothing if there was none
+     * @param output Output [output_size()]
+     */
+    void insert(const float* output);
+
+    /**
+     * model.predict() through the cache (nothing is stored if the model
+     * reports failure)
+     * @param input Input [input_size()]
+     * @param output Output [output_size()]
+     * @return true on a hit
+     */
+    bool predict(NeuralNetwork& model, const float* input, float* output);
+};
+
+} // namespace CustomNN
+
+#endif // INFERENCE_CACHE_H
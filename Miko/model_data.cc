@@ -1,6 +1,7 @@
 #include "model_data.h"
 
-const unsigned char scripts_model_tflite[] = {
+// Aligned so float tensor data can be read in place (TfliteModel, TFLM)
+alignas(16) const unsigned char scripts_model_tflite[] = {
   0x1c, 0x00, 0x00, 0x00, 0x54, 0x46, 0x4c, 0x33, 0x14, 0x00, 0x20, 0x00,
   0x1c, 0x00, 0x18, 0x00, 0x14, 0x00, 0x10, 0x00, 0x0c, 0x00, 0x00, 0x00,
   0x08, 0x00, 0x04, 0x00, 0x14, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x00,
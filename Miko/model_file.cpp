@@ -0,0 +1,381 @@
+/**
+ * Binary Model Files Implementation
+ */
+
+#include "model_file.h"
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#if CUSTOMNN_HAS_MODEL_FILE_IO
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CustomNN {
+
+namespace {
+
+constexpr char kMagic[4] = {'C', 'N', 'N', 'M'};
+
+size_t align_up(size_t bytes) {
+    return (bytes + ModelFile::kAlignment - 1) / ModelFile::kAlignment * ModelFile::kAlignment;
+}
+
+// Stable on-disk activation codes, independent of the enum's order
+uint8_t activation_code(ActivationType activation) {
+    switch (activation) {
+        case ActivationType::ReLU: return 1;
+        case ActivationType::Softmax: return 2;
+        case ActivationType::None: break;
+    }
+    return 0;
+}
+
+bool activation_from_code(uint8_t code, ActivationType& activation) {
+    switch (code) {
+        case 0: activation = ActivationType::None; return true;
+        case 1: activation = ActivationType::ReLU; return true;
+        case 2: activation = ActivationType::Softmax; return true;
+        default: return false;
+    }
+}
+
+bool known_dtype(uint8_t dtype) {
+    return dtype == static_cast<uint8_t>(ModelDType::F32) ||
+           dtype == static_cast<uint8_t>(ModelDType::FP16) ||
+           dtype == static_cast<uint8_t>(ModelDType::BF16);
+}
+
+// Floats per stored row and weight bytes of a layer in the given dtype
+size_t row_stride(ModelDType dtype, size_t input_size, size_t output_size) {
+    return (dtype == ModelDType::F32) ? MatrixOps::packed_stride(input_size) : output_size;
+}
+
+size_t weight_bytes(ModelDType dtype, size_t input_size, size_t output_size) {
+    return (dtype == ModelDType::F32)
+        ? output_size * MatrixOps::packed_stride(input_size) * sizeof(float)
+        : input_size * output_size * sizeof(uint16_t);
+}
+
+HalfFormat half_format(ModelDType dtype) {
+    return (dtype == ModelDType::BF16) ? HalfFormat::BF16 : HalfFormat::FP16;
+}
+
+// True if [offset, offset + bytes) lies within limit
+bool in_bounds(uint64_t offset, uint64_t bytes, size_t limit) {
+    return offset <= limit && bytes <= limit - offset;
+}
+
+} // namespace
+
+// ============================================================================
+// PackedDenseLayer
+// ============================================================================
+
+void PackedDenseLayer::forward(const float* input, float* output) const {
+    MatrixOps::dense_forward_packed(input, packed_, bias_, output, input_size_, output_size_,
+                                    stride_, activation_);
+}
+
+// ============================================================================
+// ModelFile
+// ============================================================================
+
+ModelFile::ModelFile()
+  : data_(nullptr),
+    size_(0),
+    mapped_(false),
+    num_layers_(0),
+    layers_(nullptr),
+    halves_(nullptr),
+    model_(nullptr),
+    error_(ModelFileError::None)
+{
+}
+
+ModelFile::~ModelFile() {
+    close();
+}
+
+void ModelFile::close() {
+    delete model_;
+    model_ = nullptr;
+    if (layers_ != nullptr) {
+        for (size_t k = 0; k < num_layers_; ++k) {
+            delete layers_[k];
+        }
+    }
+    delete[] layers_;
+    layers_ = nullptr;
+    delete[] halves_;
+    halves_ = nullptr;
+    num_layers_ = 0;
+
+#if CUSTOMNN_HAS_MODEL_FILE_IO
+    if (mapped_) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+#endif
+    mapped_ = false;
+    data_ = nullptr;
+    size_ = 0;
+    error_ = ModelFileError::None;
+}
+
+bool ModelFile::fail(ModelFileError error) {
+    close();
+    error_ = error;
+    return false;
+}
+
+const char* ModelFile::error_name(ModelFileError error) {
+    switch (error) {
+        case ModelFileError::None: return "none";
+        case ModelFileError::Open: return "cannot open or map the file";
+        case ModelFileError::Truncated: return "truncated";
+        case ModelFileError::Magic: return "not a model file";
+        case ModelFileError::Version: return "unsupported version";
+        case ModelFileError::Alignment: return "misaligned";
+        case ModelFileError::Layer: return "bad layer record";
+        case ModelFileError::Shape: return "layer shapes do not chain";
+    }
+    return "unknown";
+}
+
+#if CUSTOMNN_HAS_MODEL_FILE_IO
+bool ModelFile::open(const char* path) {
+    close();
+
+    const int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        return fail(ModelFileError::Open);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return fail(ModelFileError::Open);
+    }
+    const size_t size = static_cast<size_t>(info.st_size);
+    if (size < sizeof(FileHeader)) {
+        ::close(fd);
+        return fail(ModelFileError::Truncated);
+    }
+
+    // The mapping outlives the descriptor; pages are read on first touch
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return fail(ModelFileError::Open);
+    }
+
+    data_ = static_cast<const uint8_t*>(mapping);
+    size_ = size;
+    mapped_ = true;
+    return load(data_, size_);
+}
+
+bool ModelFile::write(const char* path, const ModelExportLayer* layers, size_t num_layers) {
+    const size_t size = serialized_size(layers, num_layers);
+    if (size == 0) {
+        return false;
+    }
+    uint8_t* buffer = new uint8_t[size];
+    bool ok = (serialize(layers, num_layers, buffer, size) == size);
+
+    std::FILE* file = ok ? std::fopen(path, "wb") : nullptr;
+    ok = (file != nullptr) && (std::fwrite(buffer, 1, size, file) == size);
+    if (file != nullptr) {
+        ok = (std::fclose(file) == 0) && ok;
+    }
+    delete[] buffer;
+    return ok;
+}
+#endif
+
+bool ModelFile::attach(const void* data, size_t size) {
+    close();
+    data_ = static_cast<const uint8_t*>(data);
+    size_ = size;
+    return load(data_, size_);
+}
+
+bool ModelFile::load(const uint8_t* data, size_t size) {
+    if (data == nullptr || size < sizeof(FileHeader)) {
+        return fail(ModelFileError::Truncated);
+    }
+    if (reinterpret_cast<uintptr_t>(data) % kAlignment != 0) {
+        return fail(ModelFileError::Alignment);
+    }
+
+    // Header and records are copied out (they are small); weights never are
+    FileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        return fail(ModelFileError::Magic);
+    }
+    if (header.version_major != kVersionMajor ||
+        header.header_bytes < sizeof(FileHeader) || header.record_bytes < sizeof(LayerRecord)) {
+        return fail(ModelFileError::Version);
+    }
+    if (header.file_bytes > size) {
+        return fail(ModelFileError::Truncated);
+    }
+    const size_t limit = static_cast<size_t>(header.file_bytes);
+    if (header.num_layers == 0) {
+        return fail(ModelFileError::Layer);
+    }
+    if (header.header_bytes > limit ||
+        header.num_layers > (limit - header.header_bytes) / header.record_bytes) {
+        return fail(ModelFileError::Truncated);
+    }
+
+    num_layers_ = header.num_layers;
+    layers_ = new Layer*[num_layers_]();
+    halves_ = new HalfDense[num_layers_];
+
+    size_t previous_output = header.input_size;
+    for (size_t k = 0; k < num_layers_; ++k) {
+        LayerRecord record;
+        std::memcpy(&record, data + header.header_bytes + k * header.record_bytes,
+                    sizeof(record));
+
+        ActivationType activation = ActivationType::None;
+        if (record.kind != static_cast<uint16_t>(ModelLayerKind::Dense) ||
+            !known_dtype(record.dtype) || !activation_from_code(record.activation, activation) ||
+            record.input_size == 0 || record.output_size == 0) {
+            return fail(ModelFileError::Layer);
+        }
+        const ModelDType dtype = static_cast<ModelDType>(record.dtype);
+        const size_t in = record.input_size;
+        const size_t out = record.output_size;
+        if (record.stride != row_stride(dtype, in, out) ||
+            record.weights_bytes != weight_bytes(dtype, in, out) ||
+            record.bias_bytes != out * sizeof(float)) {
+            return fail(ModelFileError::Layer);
+        }
+        if (record.weights_offset % kAlignment != 0 || record.bias_offset % kAlignment != 0) {
+            return fail(ModelFileError::Alignment);
+        }
+        if (!in_bounds(record.weights_offset, record.weights_bytes, limit) ||
+            !in_bounds(record.bias_offset, record.bias_bytes, limit)) {
+            return fail(ModelFileError::Truncated);
+        }
+        if (in != previous_output) {
+            return fail(ModelFileError::Shape);
+        }
+        previous_output = out;
+
+        const uint8_t* weights = data + record.weights_offset;
+        const float* bias = reinterpret_cast<const float*>(data + record.bias_offset);
+        if (dtype == ModelDType::F32) {
+            layers_[k] = new PackedDenseLayer(reinterpret_cast<const float*>(weights), bias,
+                                              in, out, record.stride, activation);
+        } else {
+            halves_[k] = HalfDense{reinterpret_cast<const uint16_t*>(weights), bias, in, out,
+                                   half_format(dtype), activation};
+            layers_[k] = new HalfLayer(halves_[k]);
+        }
+    }
+    if (previous_output != header.output_size) {
+        return fail(ModelFileError::Shape);
+    }
+
+    model_ = new Sequential(layers_, num_layers_, nullptr, nullptr, 0);
+    return true;
+}
+
+bool ModelFile::predict(const float* input, float* output, Scratch& scratch) const {
+    return is_loaded() && model_->predict(input, output, scratch);
+}
+
+bool ModelFile::predict_logits(const float* input, float* output, Scratch& scratch) const {
+    return is_loaded() && model_->predict_logits(input, output, scratch);
+}
+
+// ============================================================================
+// Serialization
+// ============================================================================
+
+size_t ModelFile::serialized_size(const ModelExportLayer* layers, size_t num_layers) {
+    if (layers == nullptr || num_layers == 0 ||
+        num_layers > std::numeric_limits<uint32_t>::max()) {
+        return 0;
+    }
+    size_t size = sizeof(FileHeader) + num_layers * sizeof(LayerRecord);
+    for (size_t k = 0; k < num_layers; ++k) {
+        const ModelExportLayer& layer = layers[k];
+        if (layer.input_size == 0 || layer.output_size == 0 ||
+            layer.input_size > std::numeric_limits<uint32_t>::max() ||
+            layer.output_size > std::numeric_limits<uint32_t>::max() ||
+            !known_dtype(static_cast<uint8_t>(layer.dtype)) ||
+            (k > 0 && layers[k - 1].output_size != layer.input_size)) {
+            return 0;
+        }
+        size += align_up(weight_bytes(layer.dtype, layer.input_size, layer.output_size));
+        size += align_up(layer.output_size * sizeof(float));
+    }
+    return size;
+}
+
+size_t ModelFile::serialize(const ModelExportLayer* layers, size_t num_layers,
+                            uint8_t* out, size_t capacity) {
+    const size_t size = serialized_size(layers, num_layers);
+    if (size == 0 || out == nullptr || capacity < size) {
+        return 0;
+    }
+    std::memset(out, 0, size);
+
+    FileHeader header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version_major = kVersionMajor;
+    header.version_minor = kVersionMinor;
+    header.header_bytes = sizeof(FileHeader);
+    header.record_bytes = sizeof(LayerRecord);
+    header.num_layers = static_cast<uint32_t>(num_layers);
+    header.input_size = static_cast<uint32_t>(layers[0].input_size);
+    header.output_size = static_cast<uint32_t>(layers[num_layers - 1].output_size);
+    header.file_bytes = size;
+    std::memcpy(out, &header, sizeof(header));
+
+    size_t offset = sizeof(FileHeader) + num_layers * sizeof(LayerRecord);
+    for (size_t k = 0; k < num_layers; ++k) {
+        const ModelExportLayer& layer = layers[k];
+        const size_t in = layer.input_size;
+        const size_t cols = layer.output_size;
+
+        LayerRecord record = {};
+        record.kind = static_cast<uint16_t>(ModelLayerKind::Dense);
+        record.dtype = static_cast<uint8_t>(layer.dtype);
+        record.activation = activation_code(layer.activation);
+        record.input_size = static_cast<uint32_t>(in);
+        record.output_size = static_cast<uint32_t>(cols);
+        record.stride = static_cast<uint32_t>(row_stride(layer.dtype, in, cols));
+        record.weights_offset = offset;
+        record.weights_bytes = weight_bytes(layer.dtype, in, cols);
+        record.bias_offset = offset + align_up(record.weights_bytes);
+        record.bias_bytes = cols * sizeof(float);
+
+        // Converted through a temporary so out needs no particular alignment
+        if (layer.dtype == ModelDType::F32) {
+            float* packed = new float[cols * record.stride]();
+            MatrixOps::pack_weights(layer.weights, packed, in, cols);
+            std::memcpy(out + offset, packed, record.weights_bytes);
+            delete[] packed;
+        } else {
+            uint16_t* narrowed = new uint16_t[in * cols];
+            HalfOps::narrow(layer.weights, narrowed, in * cols, half_format(layer.dtype));
+            std::memcpy(out + offset, narrowed, record.weights_bytes);
+            delete[] narrowed;
+        }
+        std::memcpy(out + record.bias_offset, layer.bias, record.bias_bytes);
+
+        std::memcpy(out + sizeof(FileHeader) + k * sizeof(LayerRecord), &record, sizeof(record));
+        offset = record.bias_offset + align_up(record.bias_bytes);
+    }
+    return size;
+}
+
+} // namespace CustomNN
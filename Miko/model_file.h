@@ -0,0 +1,244 @@
+/**
+ * Binary Model Files
+ * A versioned container for Sequential models that loads without copying
+ * or parsing the weights
+ *
+ * Layout (little-endian, every section on a 64-byte boundary):
+ *
+ *   offset 0    FileHeader          magic "CNNM", version, layer count, shapes
+ *   offset 64   LayerRecord[n]      kind, dtype, activation, shape, and the
+ *                                   offset/size of the layer's weights and bias
+ *   ...         weights, bias, ...  raw arrays, zero padded to 64 bytes
+ *
+ * F32 weights are stored already packed for MatrixOps::dense_forward_packed
+ * (output-major, rows padded to 64 bytes), so a mapped layer runs the
+ * packed kernel straight from the file. FP16/BF16 weights are stored in
+ * HalfDense's input-major layout. Bias is always float.
+ *
+ * Loading reads the header and the layer table and points the layers at
+ * the weights in place: the cost depends on the number of layers, not on
+ * their size. On hosts, open() mmaps the file, so weights are paged in on
+ * first use. The same bytes can be compiled into firmware flash (see
+ * tools/export_model, which also emits them as a header) and used with
+ * attach().
+ *
+ * Version: readers accept any minor version of their major version. Minor
+ * versions may only use reserved fields (zero in older files) or grow
+ * header_bytes / record_bytes; anything else bumps the major version.
+ *
+ * Usage:
+ *   ModelFile file;
+ *   if (!file.open("temp_model.cnnm")) { ... file.error() ... }
+ *   float work[64];
+ *   Scratch scratch{work, 64};   // at least file.required_scratch()
+ *   file.predict(input, output, scratch);
+ *
+ *   // Firmware: the file embedded in flash (temp_model_file.h)
+ *   file.attach(TEMP_MODEL_FILE, sizeof(TEMP_MODEL_FILE));
+ */
+
+#ifndef MODEL_FILE_H
+#define MODEL_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include "neural_network.h"
+#include "half.h"
+
+// File-backed open() and write() on POSIX hosts; firmware only has attach()
+#if defined(__unix__) || defined(__APPLE__)
+#define CUSTOMNN_HAS_MODEL_FILE_IO 1
+#else
+#define CUSTOMNN_HAS_MODEL_FILE_IO 0
+#endif
+
+namespace CustomNN {
+
+/**
+ * On-disk header (64 bytes at offset 0)
+ */
+struct FileHeader {
+    char magic[4];           // "CNNM"
+    uint16_t version_major;
+    uint16_t version_minor;
+    uint32_t header_bytes;   // Size of this header (>= 64)
+    uint32_t record_bytes;   // Size of each LayerRecord (>= 64)
+    uint32_t num_layers;
+    uint32_t input_size;     // Input width of the first layer
+    uint32_t output_size;    // Output width of the last layer
+    uint32_t flags;          // None defined; 0
+    uint64_t file_bytes;     // Total size including trailing padding
+    uint32_t reserved[6];
+};
+
+/**
+ * On-disk layer table entry (64 bytes each, right after the header)
+ */
+struct LayerRecord {
+    uint16_t kind;           // ModelLayerKind
+    uint8_t dtype;           // ModelDType
+    uint8_t activation;      // 0 none, 1 ReLU, 2 softmax
+    uint32_t input_size;
+    uint32_t output_size;
+    uint32_t stride;         // Floats per packed row (F32); output_size otherwise
+    uint64_t weights_offset; // From the start of the file, 64-byte aligned
+    uint64_t weights_bytes;
+    uint64_t bias_offset;    // 64-byte aligned, output_size floats
+    uint64_t bias_bytes;
+    uint32_t reserved[4];
+};
+
+static_assert(sizeof(FileHeader) == 64, "FileHeader must stay 64 bytes");
+static_assert(sizeof(LayerRecord) == 64, "LayerRecord must stay 64 bytes");
+
+enum class ModelLayerKind : uint16_t {
+    Dense = 1
+};
+
+enum class ModelDType : uint8_t {
+    F32 = 1,    // Packed output-major float rows
+    FP16 = 2,   // IEEE binary16, input-major
+    BF16 = 3    // bfloat16, input-major
+};
+
+/**
+ * Why the last open() / attach() failed
+ */
+enum class ModelFileError {
+    None,
+    Open,        // Could not open or map the file
+    Truncated,   // Shorter than its header, table or a section
+    Magic,       // Not a model file
+    Version,     // Unsupported major version
+    Alignment,   // Base address or a section not 64-byte aligned
+    Layer,       // Unknown kind, dtype or activation, or inconsistent sizes
+    Shape        // Layer widths do not chain
+};
+
+/**
+ * One layer to serialize: float weights in the stored input-major layout
+ * [input_size][output_size], narrowed to dtype on the way out
+ */
+struct ModelExportLayer {
+    const float* weights;
+    const float* bias;
+    size_t input_size;
+    size_t output_size;
+    ActivationType activation;
+    ModelDType dtype;
+};
+
+/**
+ * Dense layer over borrowed, already packed weights (see
+ * MatrixOps::pack_weights), e.g. a mapped model file or flash
+ */
+class PackedDenseLayer : public Layer {
+private:
+    const float* packed_;   // [output_size][stride], 64-byte aligned rows
+    const float* bias_;     // [output_size]
+    size_t input_size_;
+    size_t output_size_;
+    size_t stride_;
+    ActivationType activation_;
+
+public:
+    PackedDenseLayer(const float* packed, const float* bias, size_t input_size,
+                     size_t output_size, size_t stride, ActivationType activation)
+        : packed_(packed), bias_(bias), input_size_(input_size), output_size_(output_size),
+          stride_(stride), activation_(activation) {}
+
+    size_t input_size() const override { return input_size_; }
+    size_t output_size() const override { return output_size_; }
+    ActivationType activation() const override { return activation_; }
+
+    void forward(const float* input, float* output) const override;
+};
+
+/**
+ * A model file opened (mmap) or attached (borrowed bytes) as a Sequential
+ */
+class ModelFile {
+public:
+    static constexpr uint16_t kVersionMajor = 1;
+    static constexpr uint16_t kVersionMinor = 0;
+    static constexpr size_t kAlignment = 64;
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    bool mapped_;           // data_ is our mmap (unmapped on close)
+    size_t num_layers_;
+    Layer** layers_;        // Owned objects over borrowed weights [num_layers_]
+    HalfDense* halves_;     // Params of the half-precision layers [num_layers_]
+    Sequential* model_;     // Over layers_, no scratch of its own
+    ModelFileError error_;
+
+public:
+    ModelFile();
+    ~ModelFile();
+
+    ModelFile(const ModelFile&) = delete;
+    ModelFile& operator=(const ModelFile&) = delete;
+
+#if CUSTOMNN_HAS_MODEL_FILE_IO
+    /**
+     * Map a model file read-only and load it
+     * @return false on failure (see error()); any previous model is closed
+     */
+    bool open(const char* path);
+
+    /**
+     * Serialize layers into a file
+     * @return false if the layers do not chain or the file cannot be written
+     */
+    static bool write(const char* path, const ModelExportLayer* layers, size_t num_layers);
+#endif
+
+    /**
+     * Load a model from bytes that outlive this object (flash, a buffer)
+     * @param data File contents, 64-byte aligned
+     * @param size Bytes available at data
+     * @return false on failure (see error()); any previous model is closed
+     */
+    bool attach(const void* data, size_t size);
+
+    void close();
+
+    bool is_loaded() const { return model_ != nullptr; }
+    ModelFileError error() const { return error_; }
+    static const char* error_name(ModelFileError error);
+
+    size_t num_layers() const { return num_layers_; }
+    const Layer* const* layers() const { return layers_; }
+    size_t input_size() const { return is_loaded() ? model_->input_size() : 0; }
+    size_t output_size() const { return is_loaded() ? model_->output_size() : 0; }
+    size_t required_scratch() const { return is_loaded() ? model_->required_scratch() : 0; }
+
+    /**
+     * Reentrant inference, as Sequential::predict(input, output, scratch)
+     * @return false if nothing is loaded or scratch is too small
+     */
+    bool predict(const float* input, float* output, Scratch& scratch) const;
+    bool predict_logits(const float* input, float* output, Scratch& scratch) const;
+
+    /**
+     * Bytes serialize() writes for these layers (0 if they do not chain)
+     */
+    static size_t serialized_size(const ModelExportLayer* layers, size_t num_layers);
+
+    /**
+     * Serialize layers into out, zero-filling all padding
+     * @param out Destination [capacity]
+     * @return Bytes written, or 0 if the layers do not chain or out is too small
+     */
+    static size_t serialize(const ModelExportLayer* layers, size_t num_layers,
+                            uint8_t* out, size_t capacity);
+
+private:
+    bool load(const uint8_t* data, size_t size);
+    bool fail(ModelFileError error);
+};
+
+} // namespace CustomNN
+
+#endif // MODEL_FILE_H
@@ -0,0 +1,97 @@
+// Weight-clustered (codebook) weights for model_weights.h
+// Generated by tools/cluster_weights (make cluster)
+// DO NOT EDIT MANUALLY
+//
+// 16-entry k-means codebook per layer, 4-bit indices packed two per
+// byte (even input in the low nibble), output-major rows.
+
+#ifndef MODEL_WEIGHTS_CODEBOOK_H
+#define MODEL_WEIGHTS_CODEBOOK_H
+
+#include <cstdint>
+#include "codebook.h"
+
+// Layer 1: Dense(18, ReLU), 4-bit indices [18][2]
+constexpr uint8_t LAYER1_CB_INDICES[18] = {
+    0x7E,
+    0x79,
+    0x2C,
+    0xC6,
+    0xDC,
+    0x5E,
+    0xAF,
+    0xF3,
+    0x97,
+    0x31,
+    0x81,
+    0x49,
+    0xBF,
+    0x35,
+    0xCB,
+    0x74,
+    0x05,
+    0x02
+};
+
+constexpr float LAYER1_CB_CODEBOOK[16] = {
+    -6.549817920e-01f, -5.766928196e-01f, -4.986992478e-01f, -4.588658214e-01f,
+    -3.986462355e-01f, -3.493956327e-01f, -2.417652011e-01f, -9.181919508e-03f,
+    1.246299595e-01f, 1.779162735e-01f, 2.714640498e-01f, 3.181464374e-01f,
+    3.765277267e-01f, 4.742133021e-01f, 5.025526285e-01f, 5.816023350e-01f
+};
+
+constexpr int32_t LAYER1_CB_CODEBOOK_Q16[16] = {
+    -42925, -37794, -32683, -30072, -26126, -22898, -15844, -602,
+    8168, 11660, 17791, 20850, 24676, 31078, 32935, 38116
+};
+
+constexpr float LAYER1_CB_BIAS[18] = {
+    1.704006344e-01f, 1.926742792e-01f, -1.054601595e-01f, -2.796196938e-02f, -9.872523695e-02f, 1.792767048e-01f, 1.902372390e-01f, 4.616174102e-02f, 6.906521320e-02f, 1.382656842e-01f, 1.918824315e-01f, -2.683812007e-02f, 2.124507129e-01f, 1.217754036e-01f, -5.203858018e-02f, -1.089880913e-01f, 1.628317088e-01f, 1.366488636e-01f
+};
+
+constexpr int32_t LAYER1_CB_BIAS_Q16[18] = {
+    11167, 12627, -6911, -1833, -6470, 11749, 12467, 3025, 4526, 9061, 12575, -1759, 13923, 7981, -3410, -7143, 10671, 8955
+};
+
+constexpr CustomNN::CodebookDense LAYER1_CB = {
+    LAYER1_CB_INDICES, LAYER1_CB_CODEBOOK, LAYER1_CB_CODEBOOK_Q16,
+    LAYER1_CB_BIAS, LAYER1_CB_BIAS_Q16,
+    2, 18,
+    CustomNN::ActivationType::ReLU
+};
+
+// Layer 2: Dense(3, Softmax), 4-bit indices [3][18]
+constexpr uint8_t LAYER2_CB_INDICES[27] = {
+    0x63, 0xDC, 0x57, 0xC6, 0xC2, 0x9B, 0x2A, 0xBD, 0x16,
+    0xFF, 0x35, 0x85, 0x0D, 0x87, 0xA3, 0x0E, 0xDC, 0x51,
+    0x4B, 0x28, 0xA9, 0x23, 0xE6, 0xEC, 0x81, 0x40, 0x7B
+};
+
+constexpr float LAYER2_CB_CODEBOOK[16] = {
+    -6.511936188e-01f, -5.404490829e-01f, -4.373715222e-01f, -3.885442317e-01f,
+    -3.231242299e-01f, -2.760100961e-01f, -2.192198336e-01f, -1.992974728e-01f,
+    -9.045668691e-02f, -7.122372091e-02f, -4.601063579e-02f, 1.500381250e-02f,
+    1.342331171e-01f, 2.787927985e-01f, 3.811326027e-01f, 7.030956149e-01f
+};
+
+constexpr int32_t LAYER2_CB_CODEBOOK_Q16[16] = {
+    -42677, -35419, -28664, -25464, -21176, -18089, -14367, -13061,
+    -5928, -4668, -3015, 983, 8797, 18271, 24978, 46078
+};
+
+constexpr float LAYER2_CB_BIAS[3] = {
+    -4.807712883e-02f, 4.498968273e-02f, -4.696793854e-02f
+};
+
+constexpr int32_t LAYER2_CB_BIAS_Q16[3] = {
+    -3151, 2948, -3078
+};
+
+constexpr CustomNN::CodebookDense LAYER2_CB = {
+    LAYER2_CB_INDICES, LAYER2_CB_CODEBOOK, LAYER2_CB_CODEBOOK_Q16,
+    LAYER2_CB_BIAS, LAYER2_CB_BIAS_Q16,
+    18, 3,
+    CustomNN::ActivationType::Softmax
+};
+
+#endif // MODEL_WEIGHTS_CODEBOOK_H
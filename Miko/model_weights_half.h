@@ -0,0 +1,84 @@
+// Half-precision weights for model_weights.h
+// Generated by tools/half_weights (make half)
+// DO NOT EDIT MANUALLY
+//
+// Each layer in fp16 (_FP16) and bf16 (_BF16), rounded to nearest even;
+// unused arrays are dropped by the linker. Biases stay float.
+
+#ifndef MODEL_WEIGHTS_HALF_H
+#define MODEL_WEIGHTS_HALF_H
+
+#include <cstdint>
+#include "half.h"
+
+// Layer 1: Dense(18, ReLU), weights [2][18]
+constexpr uint16_t LAYER1_FP16_WEIGHTS[36] = {
+    0x37F2, 0x31EC, 0x35DA, 0xB3BD, 0x35F4, 0x3811, 0x3882, 0xB77A, 0x9D06, 0xB8A2,
+    0xB899, 0x31FA, 0x38E8, 0xB5CE, 0x3546, 0xB68A, 0xB51A, 0xB7D0, 0xAC4F, 0x26E4,
+    0xB812, 0x35F3, 0x3796, 0xB5DD, 0x3458, 0x388B, 0x312F, 0xB71A, 0x2FFA, 0xB638,
+    0x34E8, 0xB772, 0x3659, 0x2068, 0xB949, 0xB932
+};
+
+constexpr uint16_t LAYER1_BF16_WEIGHTS[36] = {
+    0x3EFE, 0x3E3D, 0x3EBB, 0xBE78, 0x3EBE, 0x3F02, 0x3F10, 0xBEEF, 0xBBA1, 0xBF14,
+    0xBF13, 0x3E3F, 0x3F1D, 0xBEBA, 0x3EA9, 0xBED1, 0xBEA3, 0xBEFA, 0xBD8A, 0x3CDC,
+    0xBF02, 0x3EBE, 0x3EF3, 0xBEBC, 0x3E8B, 0x3F11, 0x3E26, 0xBEE3, 0x3DFF, 0xBEC7,
+    0x3E9D, 0xBEEE, 0x3ECB, 0x3C0D, 0xBF29, 0xBF26
+};
+
+constexpr float LAYER1_HALF_BIAS[18] = {
+    1.704006344e-01f, 1.926742792e-01f, -1.054601595e-01f, -2.796196938e-02f, -9.872523695e-02f, 1.792767048e-01f, 1.902372390e-01f, 4.616174102e-02f, 6.906521320e-02f, 1.382656842e-01f, 1.918824315e-01f, -2.683812007e-02f, 2.124507129e-01f, 1.217754036e-01f, -5.203858018e-02f, -1.089880913e-01f, 1.628317088e-01f, 1.366488636e-01f
+};
+
+constexpr CustomNN::HalfDense LAYER1_FP16 = {
+    LAYER1_FP16_WEIGHTS, LAYER1_HALF_BIAS,
+    2, 18,
+    CustomNN::HalfFormat::FP16,
+    CustomNN::ActivationType::ReLU
+};
+
+constexpr CustomNN::HalfDense LAYER1_BF16 = {
+    LAYER1_BF16_WEIGHTS, LAYER1_HALF_BIAS,
+    2, 18,
+    CustomNN::HalfFormat::BF16,
+    CustomNN::ActivationType::ReLU
+};
+
+// Layer 2: Dense(3, Softmax), weights [18][3]
+constexpr uint16_t LAYER2_FP16_WEIGHTS[54] = {
+    0xB5CB, 0x392A, 0x9D14, 0xB2EC, 0x3A16, 0xB500, 0x2CE2, 0xB41F, 0xAE2C, 0x34AB,
+    0xB62D, 0xB6E3, 0xB2A9, 0xB4A6, 0xACD4, 0xB456, 0xAD4E, 0xAA9F, 0xB31E, 0x3448,
+    0xB67C, 0x3130, 0xB96D, 0xB74E, 0xB6AD, 0xB28C, 0xB2E1, 0x3081, 0xADF4, 0x369D,
+    0x2AB8, 0xB66A, 0x30E0, 0xAC4A, 0xA8A1, 0x364C, 0xAA6B, 0x3562, 0xB893, 0xB71F,
+    0xB8D1, 0xADB9, 0x3405, 0x3079, 0xB963, 0x2052, 0x34E0, 0xB557, 0xB324, 0xB839,
+    0x1C26, 0xB82D, 0xB48F, 0xB1EC
+};
+
+constexpr uint16_t LAYER2_BF16_WEIGHTS[54] = {
+    0xBEB9, 0x3F25, 0xBBA2, 0xBE5D, 0x3F43, 0xBEA0, 0x3D9C, 0xBE84, 0xBDC6, 0x3E95,
+    0xBEC6, 0xBEDC, 0xBE55, 0xBE95, 0xBD9A, 0xBE8B, 0xBDAA, 0xBD54, 0xBE64, 0x3E89,
+    0xBECF, 0x3E26, 0xBF2E, 0xBEEA, 0xBED6, 0xBE52, 0xBE5C, 0x3E10, 0xBDBF, 0x3ED4,
+    0x3D57, 0xBECD, 0x3E1C, 0xBD89, 0xBD14, 0x3ECA, 0xBD4D, 0x3EAC, 0xBF12, 0xBEE4,
+    0xBF1A, 0xBDB7, 0x3E81, 0x3E0F, 0xBF2C, 0x3C0A, 0x3E9C, 0xBEAB, 0xBE65, 0xBF07,
+    0x3B85, 0xBF06, 0xBE92, 0xBE3E
+};
+
+constexpr float LAYER2_HALF_BIAS[3] = {
+    -1.264858395e-01f, 1.383370161e-01f, 4.595609009e-02f
+};
+
+constexpr CustomNN::HalfDense LAYER2_FP16 = {
+    LAYER2_FP16_WEIGHTS, LAYER2_HALF_BIAS,
+    18, 3,
+    CustomNN::HalfFormat::FP16,
+    CustomNN::ActivationType::Softmax
+};
+
+constexpr CustomNN::HalfDense LAYER2_BF16 = {
+    LAYER2_BF16_WEIGHTS, LAYER2_HALF_BIAS,
+    18, 3,
+    CustomNN::HalfFormat::BF16,
+    CustomNN::ActivationType::Softmax
+};
+
+#endif // MODEL_WEIGHTS_HALF_H
@@ -0,0 +1,84 @@
+// Int8 quantized weights for model_weights.h
+// Generated by tools/quantize_weights (make quantize)
+// DO NOT EDIT MANUALLY
+//
+// Symmetric per-channel int8 weights, int32 bias with the input zero
+// point folded in, Q31 requantization multipliers.
+// Calibration: 2401 samples (grid over [-12, 12]^2, step 0.5)
+
+#ifndef MODEL_WEIGHTS_INT8_H
+#define MODEL_WEIGHTS_INT8_H
+
+#include <cstdint>
+#include "quantized.h"
+
+// Layer 1: Dense(18, ReLU) - int8 weights [18][2], output-major
+constexpr int8_t LAYER1_Q8_WEIGHTS[18][2] = {
+    {127, -17},
+    {127, 18},
+    {91, -127},
+    {-83, 127},
+    {100, 127},
+    {127, -92},
+    {127, 61},
+    {-105, 127},
+    {-4, 127},
+    {-127, -97},
+    {-127, 28},
+    {61, -127},
+    {127, 64},
+    {-99, -127},
+    {105, 127},
+    {-127, 3},
+    {-61, -127},
+    {-96, -127}
+};
+
+constexpr int32_t LAYER1_Q8_BIAS[18] = {
+    463, 1405, -280, -102, -281, 476, 455, 110, 575, 322, 451, -93, 467, 353, -177, -360, 333, 284
+};
+
+constexpr int32_t LAYER1_Q8_MULTIPLIER[18] = {
+    1870784116, 1393957877, 1917645808, 1400372535, 1786555945, 1915859614, 2123340407, 2139753696, 1220858032, 1090463419, 1082175007, 1464127206, 1155154522, 1752833930, 1494801752, 1539600309, 1244624082, 1222960826
+};
+
+constexpr int32_t LAYER1_Q8_SHIFT[18] = {
+    -7, -8, -7, -7, -7, -7, -7, -7, -8, -6, -6, -7, -6, -7, -7, -7, -6, -6
+};
+
+constexpr CustomNN::QuantizedDense LAYER1_Q8 = {
+    &LAYER1_Q8_WEIGHTS[0][0], LAYER1_Q8_BIAS, LAYER1_Q8_MULTIPLIER, LAYER1_Q8_SHIFT,
+    2, 18,
+    {9.411764890e-02f, 0},   // input: scale, zero point
+    {5.407098681e-02f, -128},   // output: scale, zero point
+    CustomNN::ActivationType::ReLU
+};
+
+// Layer 2: Dense(3, Softmax) - int8 weights [3][18], output-major
+constexpr int8_t LAYER2_Q8_WEIGHTS[3][18] = {
+    {-88, -53, 19, 71, -51, -66, -54, 39, -102, 34, 13, -16, -12, -108, 61, 2, -54, -127},
+    {108, 127, -43, -64, -48, -14, 45, -113, -34, -16, -67, -6, 56, -101, 23, 51, -88, -48},
+    {-1, -59, -18, -81, -14, -10, -76, -86, -41, 78, 29, 74, -108, -17, -127, -63, 1, -35}
+};
+
+constexpr int32_t LAYER2_Q8_BIAS[3] = {
+    -63545, -29269, -70752
+};
+
+constexpr int32_t LAYER2_Q8_MULTIPLIER[3] = {
+    2123953985, 1547609446, 1370069059
+};
+
+constexpr int32_t LAYER2_Q8_SHIFT[3] = {
+    -9, -8, -8
+};
+
+constexpr CustomNN::QuantizedDense LAYER2_Q8 = {
+    &LAYER2_Q8_WEIGHTS[0][0], LAYER2_Q8_BIAS, LAYER2_Q8_MULTIPLIER, LAYER2_Q8_SHIFT,
+    18, 3,
+    {5.407098681e-02f, -128},   // input: scale, zero point
+    {1.150204539e-01f, 44},   // output: scale, zero point
+    CustomNN::ActivationType::Softmax
+};
+
+#endif // MODEL_WEIGHTS_INT8_H
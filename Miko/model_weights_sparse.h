@@ -0,0 +1,69 @@
+// Pruned CSR weights for model_weights.h
+// Generated by tools/prune_weights (make prune)
+// DO NOT EDIT MANUALLY
+//
+// Magnitude pruning to density 0.5 per layer; each bias absorbs the
+// mean contribution of its dropped weights on grid over [-12, 12]^2, step 0.5.
+// Argmax agreement with the unpruned model: 96.58% on grid over [-12, 12]^2, step 0.5
+
+#ifndef MODEL_WEIGHTS_SPARSE_H
+#define MODEL_WEIGHTS_SPARSE_H
+
+#include <cstdint>
+#include "sparse.h"
+
+// Layer 1: Dense(18, ReLU) - 18 of 36 weights kept, CSR by output
+constexpr float LAYER1_SPARSE_VALUES[18] = {
+    4.965703785e-01f, -5.090090632e-01f, 4.742133021e-01f, 5.085349083e-01f, 5.636074543e-01f, -4.673897624e-01f,
+    5.679641366e-01f, -5.788928866e-01f, -4.439453483e-01f, -5.744928122e-01f, -3.886296451e-01f, 6.132353544e-01f,
+    -4.652623236e-01f, 3.967717290e-01f, -4.086627960e-01f, -6.607319713e-01f, -4.883894622e-01f, -6.492316127e-01f
+};
+
+constexpr int16_t LAYER1_SPARSE_INDICES[18] = {
+    0, 1, 1, 0, 0, 0, 1, 0, 1, 0, 1, 0, 1, 1, 0, 1,
+    0, 1
+};
+
+constexpr float LAYER1_SPARSE_BIAS[18] = {
+    1.704006344e-01f, 1.926742792e-01f, -1.054601595e-01f, -2.796196938e-02f, -9.872523695e-02f, 1.792767048e-01f, 1.902372390e-01f, 4.616174102e-02f, 6.906521320e-02f, 1.382656842e-01f, 1.918824315e-01f, -2.683812007e-02f, 2.124507129e-01f, 1.217754036e-01f, -5.203858018e-02f, -1.089880913e-01f, 1.628317088e-01f, 1.366488636e-01f
+};
+
+constexpr uint16_t LAYER1_SPARSE_ROW_START[19] = {
+    0, 1, 1, 2, 2, 3, 4, 5, 7, 7, 9, 10, 11, 12, 13, 14, 15, 16, 18
+};
+
+constexpr CustomNN::SparseDense LAYER1_SPARSE = {
+    LAYER1_SPARSE_VALUES, LAYER1_SPARSE_INDICES, LAYER1_SPARSE_ROW_START, LAYER1_SPARSE_BIAS,
+    2, 18,
+    CustomNN::ActivationType::ReLU
+};
+
+// Layer 2: Dense(3, Softmax) - 27 of 54 weights kept, CSR by output
+constexpr float LAYER2_SPARSE_VALUES[27] = {
+    -3.620085120e-01f, 2.918137014e-01f, -2.710238099e-01f, -4.172920883e-01f, -4.451573193e-01f, -5.218669176e-01f,
+    6.456792951e-01f, 7.605119348e-01f, -3.860611618e-01f, -2.904268503e-01f, 2.676288784e-01f, -6.781185269e-01f,
+    -4.008543491e-01f, 3.365094066e-01f, -6.021956801e-01f, 3.046195507e-01f, -5.276719928e-01f, -2.849295735e-01f,
+    -3.126188815e-01f, -4.304720759e-01f, -4.052528739e-01f, -4.565646052e-01f, 4.132754505e-01f, 3.936129510e-01f,
+    -5.718083382e-01f, -6.732667089e-01f, -3.336295485e-01f
+};
+
+constexpr int16_t LAYER2_SPARSE_INDICES[27] = {
+    0, 3, 5, 8, 13, 17, 0, 1, 3, 4, 6, 7, 10, 12, 13, 15,
+    16, 17, 1, 3, 6, 7, 9, 11, 12, 14, 15
+};
+
+constexpr float LAYER2_SPARSE_BIAS[3] = {
+    -3.355306685e-01f, -4.806592464e-01f, -6.049844623e-01f
+};
+
+constexpr uint16_t LAYER2_SPARSE_ROW_START[4] = {
+    0, 6, 18, 27
+};
+
+constexpr CustomNN::SparseDense LAYER2_SPARSE = {
+    LAYER2_SPARSE_VALUES, LAYER2_SPARSE_INDICES, LAYER2_SPARSE_ROW_START, LAYER2_SPARSE_BIAS,
+    18, 3,
+    CustomNN::ActivationType::Softmax
+};
+
+#endif // MODEL_WEIGHTS_SPARSE_H
@@ -4,8 +4,10 @@
  */
 
 #include "neural_network.h"
+#include "dense_kernels.h"
 #include <cmath>
 #include <algorithm>
+#include <new>
 
 namespace CustomNN {
 
@@ -21,6 +23,10 @@ void Activation::relu(float* data, size_t size) {
 }
 
 void Activation::softmax(float* data, size_t size) {
+    softmax(data, size, kDefaultExp);
+}
+
+void Activation::softmax(float* data, size_t size, ExpApprox exp) {
     // Find max value for numerical stability
     float max_val = data[0];
     for (size_t i = 1; i < size; ++i) {
@@ -30,9 +36,13 @@ void Activation::softmax(float* data, size_t size) {
     }
 
     // Compute exp(x - max) and sum
+    for (size_t i = 0; i < size; ++i) {
+        data[i] -= max_val;  // Subtract max for stability
+    }
+    FastExp::exp_inplace(data, size, exp);
+
     float sum = 0.0f;
     for (size_t i = 0; i < size; ++i) {
-        data[i] = expf(data[i] - max_val);  // Subtract max for stability
         sum += data[i];
     }
 
@@ -42,6 +52,60 @@ void Activation::softmax(float* data, size_t size) {
     }
 }
 
+void Activation::apply(ActivationType type, float* data, size_t size) {
+    switch (type) {
+        case ActivationType::ReLU:
+            relu(data, size);
+            break;
+        case ActivationType::Softmax:
+            softmax(data, size);
+            break;
+        case ActivationType::None:
+            break;
+    }
+}
+
+// ============================================================================
+// Class Decisions
+// ============================================================================
+
+size_t Classify::argmax(const float* values, size_t size) {
+    size_t best = 0;
+    for (size_t i = 1; i < size; ++i) {
+        if (values[i] > values[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+size_t Classify::topk(const float* values, size_t size, size_t k, size_t* indices) {
+    k = std::min(k, size);
+    if (k == 0) {
+        return 0;
+    }
+
+    // Insertion into a sorted list of at most k indices: O(size * k) with
+    // no allocation, and k is small in practice
+    size_t count = 0;
+    for (size_t i = 0; i < size; ++i) {
+        size_t pos;
+        if (count < k) {
+            pos = count++;
+        } else if (values[i] > values[indices[k - 1]]) {
+            pos = k - 1;
+        } else {
+            continue;
+        }
+        while (pos > 0 && values[i] > values[indices[pos - 1]]) {
+            indices[pos] = indices[pos - 1];
+            --pos;
+        }
+        indices[pos] = i;
+    }
+    return k;
+}
+
 // ============================================================================
 // Matrix Operations
 // ============================================================================
@@ -53,18 +117,9 @@ void MatrixOps::matvec_multiply(
     size_t rows,
     size_t cols
 ) {
-    // Initialize output to zero
-    for (size_t j = 0; j < cols; ++j) {
-        output[j] = 0.0f;
-    }
-
     // Compute: output[j] = sum_i(weights[i][j] * input[i])
-    for (size_t i = 0; i < rows; ++i) {
-        for (size_t j = 0; j < cols; ++j) {
-            // Access weights as 1D array: weights[i][j] = weights[i * cols + j]
-            output[j] += weights[i * cols + j] * input[i];
-        }
-    }
+    // using the best kernel for this CPU (scalar on the RP2040)
+    Kernels::active().dense(weights, nullptr, input, output, rows, cols, false);
 }
 
 void MatrixOps::vector_add(
@@ -73,25 +128,415 @@ void MatrixOps::vector_add(
     float* output,
     size_t size
 ) {
-    for (size_t i = 0; i < size; ++i) {
-        output[i] = a[i] + b[i];
+    Kernels::active().vector_add(a, b, output, size);
+}
+
+size_t MatrixOps::packed_stride(size_t input_size) {
+    constexpr size_t floats_per_line = kPackedAlignment / sizeof(float);
+    return (input_size + floats_per_line - 1) / floats_per_line * floats_per_line;
+}
+
+void MatrixOps::pack_weights(
+    const float* weights,  // weights[input_size][output_size]
+    float* packed,         // packed[output_size][stride]
+    size_t input_size,
+    size_t output_size
+) {
+    const size_t stride = packed_stride(input_size);
+    for (size_t j = 0; j < output_size; ++j) {
+        float* row = packed + j * stride;
+        for (size_t i = 0; i < input_size; ++i) {
+            row[i] = weights[i * output_size + j];
+        }
+        for (size_t i = input_size; i < stride; ++i) {
+            row[i] = 0.0f;
+        }
     }
 }
 
+float* MatrixOps::allocate_packed(size_t count) {
+    return static_cast<float*>(
+        ::operator new[](count * sizeof(float), std::align_val_t(kPackedAlignment)));
+}
+
+void MatrixOps::free_packed(float* packed) {
+    ::operator delete[](packed, std::align_val_t(kPackedAlignment));
+}
+
+void MatrixOps::dense_forward_packed(
+    const float* input,     // input[input_size]
+    const float* packed,    // packed[output_size][stride]
+    const float* bias,      // bias[output_size]
+    float* output,          // output[output_size]
+    size_t input_size,
+    size_t output_size,
+    size_t stride,
+    ActivationType activation
+) {
+    Kernels::active().dense_packed(packed, bias, input, output, input_size, output_size,
+                                   stride, activation == ActivationType::ReLU);
+}
+
 void MatrixOps::dense_forward(
     const float* input,
     const float* weights,  // weights[input_size][output_size]
     const float* bias,
     float* output,
     size_t input_size,
-    size_t output_size
+    size_t output_size,
+    ActivationType activation
 ) {
-    // Step 1: Matrix-vector multiply: output = weights^T * input
-    matvec_multiply(weights, input, output, input_size, output_size);
+    // output = act(bias + weights^T * input) in one pass over the output
+    Kernels::active().dense(weights, bias, input, output, input_size, output_size,
+                            activation == ActivationType::ReLU);
+}
+
+// ----------------------------------------------------------------------------
+// Blocked GEMM for batched dense layers
+// ----------------------------------------------------------------------------
+
+namespace {
+
+using Kernels::kGemmRows;
+
+// Cache tile: kGemmDepth x kGemmWidth weights (16 KB) stay in L1 while
+// every sample of the batch streams past them. kGemmWidth is a multiple of
+// every kernel table's gemm_cols.
+constexpr size_t kGemmDepth = 64;
+constexpr size_t kGemmWidth = 64;
+
+} // namespace
+
+void MatrixOps::dense_forward_batch(
+    const float* inputs,
+    const float* weights,  // weights[input_size][output_size]
+    const float* bias,
+    float* outputs,
+    size_t batch,
+    size_t input_size,
+    size_t output_size,
+    ActivationType activation
+) {
+    const Kernels::DenseKernels& kernels = Kernels::active();
+    const bool relu = (activation == ActivationType::ReLU);
+    const size_t tiled = batch - batch % kGemmRows;
+
+    for (size_t jc = 0; jc < output_size; jc += kGemmWidth) {
+        const size_t jc_end = std::min(jc + kGemmWidth, output_size);
+
+        for (size_t kc = 0; kc < input_size; kc += kGemmDepth) {
+            const size_t kc_end = std::min(kc + kGemmDepth, input_size);
+
+            // The weight block [kc, kc_end) x [jc, jc_end) is reused by all rows
+            for (size_t r = 0; r < tiled; r += kGemmRows) {
+                for (size_t j = jc; j < jc_end; j += kernels.gemm_cols) {
+                    const size_t cols = std::min(kernels.gemm_cols, jc_end - j);
+                    kernels.gemm_tile(inputs + r * input_size, weights + j, bias + j,
+                                      outputs + r * output_size + j, input_size, output_size,
+                                      cols, kc, kc_end, relu);
+                }
+            }
+        }
+    }
+
+    // Rows short of a full tile take the single-sample input-major kernel,
+    // which sums in the same order
+    for (size_t r = tiled; r < batch; ++r) {
+        kernels.dense(weights, bias, inputs + r * input_size, outputs + r * output_size,
+                      input_size, output_size, relu);
+    }
+
+    // A layer with no inputs is just its (activated) bias
+    if (input_size == 0) {
+        for (size_t r = 0; r < batch; ++r) {
+            for (size_t j = 0; j < output_size; ++j) {
+                outputs[r * output_size + j] = bias[j];
+            }
+            if (relu) {
+                Activation::relu(outputs + r * output_size, output_size);
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Layers
+// ============================================================================
+
+void Layer::forward_batch(const float* inputs, float* outputs, size_t batch) const {
+    const size_t in = input_size();
+    const size_t out = output_size();
+    for (size_t r = 0; r < batch; ++r) {
+        forward(inputs + r * in, outputs + r * out);
+    }
+}
+
+DenseLayer::DenseLayer(
+    const float* weights,
+    const float* bias,
+    size_t input_size,
+    size_t output_size,
+    ActivationType activation
+) : weights_(weights),
+    bias_(bias),
+    input_size_(input_size),
+    output_size_(output_size),
+    activation_(activation),
+    packed_stride_(kPacked ? MatrixOps::packed_stride(input_size) : 0),
+    packed_(kPacked ? MatrixOps::allocate_packed(output_size * packed_stride_) : nullptr)
+{
+    // One-time conversion to output-major rows
+    if (packed_ != nullptr) {
+        MatrixOps::pack_weights(weights_, packed_, input_size_, output_size_);
+    }
+}
+
+DenseLayer::~DenseLayer() {
+    if (packed_ != nullptr) {
+        MatrixOps::free_packed(packed_);
+    }
+}
+
+DenseLayer::DenseLayer(DenseLayer&& other) noexcept
+  : weights_(other.weights_),
+    bias_(other.bias_),
+    input_size_(other.input_size_),
+    output_size_(other.output_size_),
+    activation_(other.activation_),
+    packed_stride_(other.packed_stride_),
+    packed_(other.packed_)
+{
+    other.packed_ = nullptr;
+}
+
+void DenseLayer::forward(const float* input, float* output) const {
+    // Bias and ReLU are fused into the kernel; Softmax is left to
+    // Sequential (see Layer)
+    if (packed_ == nullptr) {
+        MatrixOps::dense_forward(input, weights_, bias_, output, input_size_, output_size_,
+                                 activation_);
+        return;
+    }
+    MatrixOps::dense_forward_packed(input, packed_, bias_, output, input_size_, output_size_,
+                                    packed_stride_, activation_);
+}
+
+void DenseLayer::forward_batch(const float* inputs, float* outputs, size_t batch) const {
+    // Whole register tiles go through the GEMM; the rows left over take the
+    // packed single-sample kernel, so they cost (and give) what forward() does
+    const size_t tiled = batch - batch % Kernels::kGemmRows;
+    MatrixOps::dense_forward_batch(inputs, weights_, bias_, outputs, tiled,
+                                   input_size_, output_size_, activation_);
+    for (size_t r = tiled; r < batch; ++r) {
+        forward(inputs + r * input_size_, outputs + r * output_size_);
+    }
+}
+
+// ============================================================================
+// Sequential
+// ============================================================================
+
+Sequential::Sequential(
+    const Layer* const* layers,
+    size_t num_layers,
+    float* scratch_a,
+    float* scratch_b,
+    size_t scratch_size
+) : layers_(layers),
+    num_layers_(num_layers),
+    scratch_a_(scratch_a),
+    scratch_b_(scratch_b),
+    scratch_size_(scratch_size),
+    tile_rows_(0),
+    chained_(false),
+    valid_(false)
+{
+    if (layers_ == nullptr || num_layers_ == 0) {
+        return;
+    }
+
+    // Consecutive layers must agree on their shared width
+    for (size_t i = 0; i < num_layers_; ++i) {
+        if (layers_[i] == nullptr) {
+            return;
+        }
+        if (i > 0 && layers_[i - 1]->output_size() != layers_[i]->input_size()) {
+            return;
+        }
+    }
+    chained_ = true;
+
+    // Layer 0 writes to A, layer 1 to B, ... the last layer writes to output
+    if (num_layers_ >= 2 && scratch_a_ == nullptr) {
+        return;
+    }
+    if (num_layers_ >= 3 && scratch_b_ == nullptr) {
+        return;
+    }
+    const size_t hidden_width = scratch_size_for(layers_, num_layers_);
+    if (scratch_size_ < hidden_width) {
+        return;
+    }
+
+    // As many rows as both scratch buffers hold (single-layer models need
+    // none), in whole register tiles
+    const size_t rows = (hidden_width == 0) ? static_cast<size_t>(-1)
+                                            : scratch_size_ / hidden_width;
+    tile_rows_ = rows - rows % Kernels::kGemmRows;
+
+    valid_ = true;
+}
+
+size_t Sequential::scratch_size_for(const Layer* const* layers, size_t num_layers) {
+    size_t max_width = 0;
+    for (size_t i = 0; i + 1 < num_layers; ++i) {
+        max_width = std::max(max_width, layers[i]->output_size());
+    }
+    return max_width;
+}
+
+size_t Sequential::scratch_size_for(const Layer* const* layers, size_t num_layers,
+                                    size_t batch_tile) {
+    return scratch_size_for(layers, num_layers) * batch_tile;
+}
+
+size_t Sequential::required_scratch_for(const Layer* const* layers, size_t num_layers) {
+    // Layer 0 writes to the first buffer, layer 1 to the second, and so on;
+    // the last layer writes to the output
+    const size_t buffers = std::min<size_t>((num_layers > 0) ? num_layers - 1 : 0, 2);
+    return scratch_size_for(layers, num_layers) * buffers;
+}
+
+size_t Sequential::required_scratch() const {
+    return chained_ ? required_scratch_for(layers_, num_layers_) : 0;
+}
+
+size_t Sequential::input_size() const {
+    return chained_ ? layers_[0]->input_size() : 0;
+}
+
+size_t Sequential::output_size() const {
+    return chained_ ? layers_[num_layers_ - 1]->output_size() : 0;
+}
+
+bool Sequential::predict(const float* input, float* output) {
+    if (!valid_) {
+        return false;
+    }
+    run(input, output, true, scratch_a_, scratch_b_);
+    return true;
+}
+
+bool Sequential::predict_logits(const float* input, float* output) {
+    if (!valid_) {
+        return false;
+    }
+    run(input, output, false, scratch_a_, scratch_b_);
+    return true;
+}
+
+int Sequential::predict_class(const float* input, float* logits) {
+    if (!valid_) {
+        return -1;
+    }
+    run(input, logits, false, scratch_a_, scratch_b_);
+    return static_cast<int>(Classify::argmax(logits, output_size()));
+}
+
+size_t Sequential::predict_topk(const float* input, size_t k, size_t* classes, float* logits) {
+    if (!valid_) {
+        return 0;
+    }
+    run(input, logits, false, scratch_a_, scratch_b_);
+    return Classify::topk(logits, output_size(), k, classes);
+}
 
-    // Step 2: Add bias: output = output + bias
-    for (size_t i = 0; i < output_size; ++i) {
-        output[i] += bias[i];
+bool Sequential::predict(const float* input, float* output, Scratch& scratch) const {
+    if (!chained_ || scratch.size < required_scratch()) {
+        return false;
+    }
+    const size_t width = scratch_size_for(layers_, num_layers_);
+    run(input, output, true, scratch.data, scratch.data + width);
+    return true;
+}
+
+bool Sequential::predict_logits(const float* input, float* output, Scratch& scratch) const {
+    if (!chained_ || scratch.size < required_scratch()) {
+        return false;
+    }
+    const size_t width = scratch_size_for(layers_, num_layers_);
+    run(input, output, false, scratch.data, scratch.data + width);
+    return true;
+}
+
+void Sequential::run(const float* input, float* output, bool final_softmax,
+                     float* scratch_a, float* scratch_b) const {
+    const float* current = input;
+    for (size_t i = 0; i < num_layers_; ++i) {
+        const Layer* layer = layers_[i];
+        const bool is_last = (i + 1 == num_layers_);
+
+        // Alternate between the two scratch buffers; the last layer goes
+        // straight to the caller's output
+        float* next = is_last ? output : ((i % 2 == 0) ? scratch_a : scratch_b);
+
+        layer->forward(current, next);
+
+        if (layer->activation() == ActivationType::Softmax && (final_softmax || !is_last)) {
+            Activation::softmax(next, layer->output_size());
+        }
+
+        current = next;
+    }
+}
+
+bool Sequential::predict_batch(const float* inputs, size_t n, float* outputs) {
+    if (!valid_) {
+        return false;
+    }
+
+    // Rows short of a GEMM register tile gain nothing from batching, and
+    // no row does if the scratch cannot hold a tile: they take the
+    // per-sample path (and match predict() exactly)
+    const size_t tiled = (tile_rows_ > 0) ? n - n % Kernels::kGemmRows : 0;
+    if (tiled < n) {
+        const size_t in_width = input_size();
+        const size_t out_width = output_size();
+        for (size_t r = tiled; r < n; ++r) {
+            run(inputs + r * in_width, outputs + r * out_width, true, scratch_a_, scratch_b_);
+        }
+    }
+    if (tiled > 0) {
+        run_tiled(inputs, tiled, outputs);
+    }
+    return true;
+}
+
+void Sequential::run_tiled(const float* inputs, size_t n, float* outputs) {
+    const size_t in_width = input_size();
+    const size_t out_width = output_size();
+
+    for (size_t start = 0; start < n; start += tile_rows_) {
+        const size_t rows = std::min(tile_rows_, n - start);
+        const float* current = inputs + start * in_width;
+
+        for (size_t i = 0; i < num_layers_; ++i) {
+            const Layer* layer = layers_[i];
+            const bool is_last = (i + 1 == num_layers_);
+            float* next = is_last ? outputs + start * out_width
+                                  : ((i % 2 == 0) ? scratch_a_ : scratch_b_);
+
+            layer->forward_batch(current, next, rows);
+
+            if (layer->activation() == ActivationType::Softmax) {
+                const size_t width = layer->output_size();
+                for (size_t r = 0; r < rows; ++r) {
+                    Activation::softmax(next + r * width, width);
+                }
+            }
+
+            current = next;
+        }
     }
 }
 
@@ -108,65 +553,111 @@ NeuralNetwork::NeuralNetwork(
     const float* l2_bias,
     size_t l2_in,
     size_t l2_out
-) : layer1_weights_(l1_weights),
-    layer1_bias_(l1_bias),
-    layer1_input_size_(l1_in),
-    layer1_output_size_(l1_out),
-    layer2_weights_(l2_weights),
-    layer2_bias_(l2_bias),
-    layer2_input_size_(l2_in),
-    layer2_output_size_(l2_out)
+) : layer1_(l1_weights, l1_bias, l1_in, l1_out, ActivationType::ReLU),
+    layer2_(l2_weights, l2_bias, l2_in, l2_out, ActivationType::Softmax),
+    layers_{&layer1_, &layer2_},
+    hidden_(new float[l1_out * CUSTOMNN_BATCH_TILE]()),
+    logits_(new float[l2_out]()),
+    engine_(layers_, 2, hidden_, nullptr, l1_out * CUSTOMNN_BATCH_TILE)
 {
-    // Initialize intermediate buffers to zero
-    for (size_t i = 0; i < 18; ++i) {
-        layer1_output_[i] = 0.0f;
-    }
 }
 
-void NeuralNetwork::predict(const float* input, float* output) {
-    // Layer 1: Dense + ReLU
-    MatrixOps::dense_forward(
-        input,
-        layer1_weights_,
-        layer1_bias_,
-        layer1_output_,
-        layer1_input_size_,
-        layer1_output_size_
-    );
+NeuralNetwork::~NeuralNetwork() {
+    delete[] logits_;
+    delete[] hidden_;
+}
 
-    // Apply ReLU activation
-    Activation::relu(layer1_output_, layer1_output_size_);
+bool NeuralNetwork::predict(const float* input, float* output) {
+    // Layer 1: Dense + ReLU, Layer 2: Dense + Softmax
+    return engine_.predict(input, output);
+}
 
-    // Layer 2: Dense + Softmax
-    MatrixOps::dense_forward(
-        layer1_output_,
-        layer2_weights_,
-        layer2_bias_,
-        output,
-        layer2_input_size_,
-        layer2_output_size_
-    );
+bool NeuralNetwork::predict(const float* input, float* output, Scratch& scratch) const {
+    return engine_.predict(input, output, scratch);
+}
 
-    // Apply Softmax activation
-    Activation::softmax(output, layer2_output_size_);
+bool NeuralNetwork::predict_batch(const float* inputs, size_t n, float* outputs) {
+    return engine_.predict_batch(inputs, n, outputs);
 }
 
 int NeuralNetwork::predict_class(const float* input) {
-    float output[3];
-    predict(input, output);
+    // Argmax on the logits: softmax would not change the winner
+    return engine_.predict_class(input, logits_);
+}
 
-    // Find argmax
-    int predicted_class = 0;
-    float max_prob = output[0];
+size_t NeuralNetwork::predict_topk(const float* input, size_t k, size_t* classes) {
+    return engine_.predict_topk(input, k, classes, logits_);
+}
 
-    for (int i = 1; i < 3; ++i) {
-        if (output[i] > max_prob) {
-            max_prob = output[i];
-            predicted_class = i;
-        }
+// ============================================================================
+// Binary Classifier
+// ============================================================================
+
+namespace {
+
+// w[:, 1] - w[:, 0] of a [rows][2] matrix, or nullptr for other widths
+float* fold_margin(const float* weights, size_t rows, size_t cols) {
+    if (cols != 2) {
+        return nullptr;
+    }
+    float* margin = new float[rows];
+    for (size_t i = 0; i < rows; ++i) {
+        margin[i] = weights[i * 2 + 1] - weights[i * 2];
+    }
+    return margin;
+}
+
+} // namespace
+
+BinaryClassifier::BinaryClassifier(
+    const float* l1_weights,
+    const float* l1_bias,
+    size_t l1_in,
+    size_t l1_out,
+    const float* l2_weights,
+    const float* l2_bias,
+    size_t l2_in,
+    size_t l2_out,
+    float threshold
+) : margin_weights_(fold_margin(l2_weights, l2_in, l2_out)),
+    margin_bias_{(l2_out == 2) ? l2_bias[1] - l2_bias[0] : 0.0f},
+    layer1_(l1_weights, l1_bias, l1_in, l1_out, ActivationType::ReLU),
+    margin_layer_(margin_weights_, margin_bias_, (l2_out == 2) ? l2_in : 0, 1,
+                  ActivationType::None),
+    layers_{&layer1_, &margin_layer_},
+    hidden_(new float[l1_out]()),
+    engine_(layers_, 2, hidden_, nullptr, l1_out),
+    threshold_(threshold),
+    margin_threshold_(margin_for(threshold)),
+    valid_(l2_out == 2 && engine_.is_valid())
+{
+}
+
+BinaryClassifier::~BinaryClassifier() {
+    delete[] hidden_;
+    delete[] margin_weights_;
+}
+
+float BinaryClassifier::margin(const float* input) {
+    float value = 0.0f;
+    engine_.predict_logits(input, &value);
+    return value;
+}
+
+bool BinaryClassifier::decide(const float* input, float* margin_out) {
+    const float value = margin(input);
+    if (margin_out != nullptr) {
+        *margin_out = value;
     }
+    return valid_ && value > margin_threshold_;
+}
+
+float BinaryClassifier::margin_for(float threshold) {
+    return logf(threshold / (1.0f - threshold));
+}
 
-    return predicted_class;
+float BinaryClassifier::probability(float margin) {
+    return 1.0f / (1.0f + expf(-margin));
 }
 
 } // namespace CustomNN
@@ -2,7 +2,9 @@
  * Custom Neural Network Inference Engine
  * Replaces TensorFlow Lite for simple feedforward networks
  *
- * Architecture: Input(2) -> Dense(18, ReLU) -> Dense(3, Softmax)
+ * Models are a Sequential stack of Dense layers, each followed by an
+ * activation (ReLU, Softmax or none). NeuralNetwork wraps the classic
+ * two-layer Input -> Dense(ReLU) -> Dense(Softmax) shape on top of it.
  */
 
 #ifndef NEURAL_NETWORK_H
@@ -10,9 +12,46 @@
 
 #include <cstddef>
 #include <cmath>
+#include "fast_exp.h"
+
+// std::span overloads on C++20 builds (the host); the RP2040 firmware is
+// built as C++17 and uses the pointer forms
+#if __cplusplus >= 202002L
+#include <span>
+#define CUSTOMNN_HAS_SPAN 1
+#else
+#define CUSTOMNN_HAS_SPAN 0
+#endif
+
+/**
+ * Samples processed per tile by the batched predict paths. NeuralNetwork
+ * sizes its hidden buffer to hold this many rows; firmware builds set it
+ * to 1 to keep RAM at a single sample.
+ */
+#ifndef CUSTOMNN_BATCH_TILE
+#define CUSTOMNN_BATCH_TILE 64
+#endif
+
+/**
+ * exp used by Activation::softmax: one of the ExpApprox names (Exact,
+ * Schraudolph, Polynomial, Table). Exact keeps results bit-identical to
+ * expf; see fast_exp.h for the error bounds of the others.
+ */
+#ifndef CUSTOMNN_EXP_APPROX
+#define CUSTOMNN_EXP_APPROX Exact
+#endif
 
 namespace CustomNN {
 
+/**
+ * Activation applied to a layer's output
+ */
+enum class ActivationType {
+    None,     // Identity (raw logits)
+    ReLU,     // max(0, x)
+    Softmax   // exp(x_i) / sum(exp(x_j))
+};
+
 /**
  * Activation Functions
  */
@@ -21,8 +60,38 @@ public:
     // ReLU: max(0, x)
     static void relu(float* data, size_t size);
 
+    // exp used by softmax(data, size), set with CUSTOMNN_EXP_APPROX
+    static constexpr ExpApprox kDefaultExp = ExpApprox::CUSTOMNN_EXP_APPROX;
+
     // Softmax: exp(x_i) / sum(exp(x_j))
     static void softmax(float* data, size_t size);
+
+    // Softmax with the given exp implementation
+    static void softmax(float* data, size_t size, ExpApprox exp);
+
+    // Apply the given activation in place
+    static void apply(ActivationType type, float* data, size_t size);
+};
+
+/**
+ * Class decisions on raw logits
+ * Softmax is monotonic, so the ranking of the logits is the ranking of
+ * the probabilities and neither exp nor the normalization is needed.
+ */
+class Classify {
+public:
+    /**
+     * Index of the largest value (first one on ties)
+     */
+    static size_t argmax(const float* values, size_t size);
+
+    /**
+     * Indices of the k largest values, largest first (lower index first
+     * on ties)
+     * @param indices Output [min(k, size)]
+     * @return Number of indices written, min(k, size)
+     */
+    static size_t topk(const float* values, size_t size, size_t k, size_t* indices);
 };
 
 /**
@@ -30,8 +99,14 @@ public:
  */
 class MatrixOps {
 public:
+    // Byte alignment (one cache line) of every row in a packed weight matrix
+    static constexpr size_t kPackedAlignment = 64;
+
     /**
-     * Dense layer forward pass: output = input * weights + bias
+     * Dense layer forward pass: output = act(input * weights + bias)
+     * Fused into one kernel: each accumulator starts at its bias and ReLU
+     * is applied before the single store, so the output is written once.
+     * Softmax needs the whole vector and is left to the caller.
      *
      * @param input Input vector [input_size]
      * @param weights Weight matrix [input_size][output_size]
@@ -39,6 +114,7 @@ public:
      * @param output Output vector [output_size]
      * @param input_size Size of input vector
      * @param output_size Size of output vector
+     * @param activation Activation fused into the store (only ReLU applies)
      */
     static void dense_forward(
         const float* input,
@@ -46,7 +122,8 @@ public:
         const float* bias,
         float* output,
         size_t input_size,
-        size_t output_size
+        size_t output_size,
+        ActivationType activation = ActivationType::None
     );
 
     /**
@@ -62,6 +139,74 @@ public:
         size_t cols
     );
 
+    /**
+     * Batched dense layer: outputs = inputs * weights + bias
+     * Register- and cache-blocked GEMM: each weight tile is loaded once per
+     * batch and reused for every sample instead of once per sample. The
+     * per-element summation order matches dense_forward, so every row is
+     * bit-identical to calling dense_forward on it.
+     *
+     * @param inputs Input matrix [batch][input_size]
+     * @param weights Weight matrix [input_size][output_size]
+     * @param bias Bias vector [output_size]
+     * @param outputs Output matrix [batch][output_size]
+     * @param activation Activation fused into the final store (only ReLU applies)
+     */
+    static void dense_forward_batch(
+        const float* inputs,
+        const float* weights,
+        const float* bias,
+        float* outputs,
+        size_t batch,
+        size_t input_size,
+        size_t output_size,
+        ActivationType activation = ActivationType::None
+    );
+
+    /**
+     * Row stride (in floats) of a packed weight matrix: input_size rounded
+     * up so every row starts on a kPackedAlignment boundary
+     */
+    static size_t packed_stride(size_t input_size);
+
+    /**
+     * Convert weights from the stored input-major layout
+     * weights[input_size][output_size] to the output-major packed layout
+     * packed[output_size][stride]. Padding is zero-filled.
+     *
+     * @param packed Destination [output_size * packed_stride(input_size)],
+     *               kPackedAlignment-aligned
+     */
+    static void pack_weights(
+        const float* weights,
+        float* packed,
+        size_t input_size,
+        size_t output_size
+    );
+
+    /**
+     * Allocate / free a kPackedAlignment-aligned buffer of floats
+     */
+    static float* allocate_packed(size_t count);
+    static void free_packed(float* packed);
+
+    /**
+     * Dense layer forward pass on packed weights:
+     * output[j] = act(bias[j] + dot(packed[j][0..input_size), input))
+     * Each output is one contiguous dot product accumulated in registers,
+     * biased and activated there, and stored once.
+     */
+    static void dense_forward_packed(
+        const float* input,     // input[input_size]
+        const float* packed,    // packed[output_size][stride]
+        const float* bias,      // bias[output_size]
+        float* output,          // output[output_size]
+        size_t input_size,
+        size_t output_size,
+        size_t stride,
+        ActivationType activation = ActivationType::None
+    );
+
     /**
      * Vector addition: output = a + b
      */
@@ -73,26 +218,287 @@ public:
     );
 };
 
+/**
+ * Layer interface
+ * A layer reads input[input_size()] and writes output[output_size()].
+ * Input and output never alias.
+ *
+ * Element-wise activations (ReLU) are applied by the layer itself. Softmax
+ * normalizes across the whole vector and is applied by Sequential instead,
+ * so the layer output is always the pre-softmax logits.
+ */
+class Layer {
+public:
+    virtual ~Layer() = default;
+
+    virtual size_t input_size() const = 0;
+    virtual size_t output_size() const = 0;
+    virtual ActivationType activation() const { return ActivationType::None; }
+
+    virtual void forward(const float* input, float* output) const = 0;
+
+    /**
+     * Run the layer on a batch of samples
+     * @param inputs Input matrix [batch][input_size()]
+     * @param outputs Output matrix [batch][output_size()]
+     * The default calls forward() once per row.
+     */
+    virtual void forward_batch(const float* inputs, float* outputs, size_t batch) const;
+};
+
+/**
+ * Dense (fully connected) layer followed by an activation
+ *
+ * The weights are given in the stored input-major layout
+ * [input_size][output_size] and borrowed (they can stay in flash). On
+ * construction they are pre-packed once into an owned, output-major,
+ * cache-line aligned copy so single-sample inference runs one contiguous
+ * dot product per neuron. The batched path keeps using the original
+ * layout, which suits the GEMM's row broadcasts.
+ *
+ * Builds with CUSTOMNN_BATCH_TILE == 1 (the firmware) have no batched path
+ * to share the original layout with, so they skip the packed copy and run
+ * forward() on the borrowed weights with MatrixOps::dense_forward(): the
+ * weights are held once, in flash, instead of also in RAM.
+ */
+class DenseLayer : public Layer {
+private:
+    const float* weights_;  // Stored as 1D array: [input_size * output_size]
+    const float* bias_;     // [output_size]
+    size_t input_size_;
+    size_t output_size_;
+    ActivationType activation_;
+    size_t packed_stride_;  // Row stride of packed_ (floats), 0 if unpacked
+    float* packed_;         // Owned: [output_size][packed_stride_], or nullptr
+
+public:
+    // Whether the constructor makes the packed copy
+    static constexpr bool kPacked = (CUSTOMNN_BATCH_TILE > 1);
+
+    /**
+     * Constructor
+     * @param weights Weights as 1D array [input_size * output_size]
+     * @param bias Bias [output_size]
+     * @param input_size Layer input size
+     * @param output_size Layer output size
+     * @param activation Activation applied to the output
+     */
+    DenseLayer(
+        const float* weights,
+        const float* bias,
+        size_t input_size,
+        size_t output_size,
+        ActivationType activation
+    );
+
+    ~DenseLayer() override;
+
+    DenseLayer(DenseLayer&& other) noexcept;
+    DenseLayer(const DenseLayer&) = delete;
+    DenseLayer& operator=(const DenseLayer&) = delete;
+    DenseLayer& operator=(DenseLayer&&) = delete;
+
+    size_t input_size() const override { return input_size_; }
+    size_t output_size() const override { return output_size_; }
+    ActivationType activation() const override { return activation_; }
+
+    void forward(const float* input, float* output) const override;
+    void forward_batch(const float* inputs, float* outputs, size_t batch) const override;
+};
+
+/**
+ * Caller-owned workspace for the const, reentrant predict overloads
+ *
+ * The model itself stays immutable, so one instance can serve any number
+ * of threads as long as each passes its own Scratch (stack, arena or
+ * heap). Size it with required_scratch().
+ */
+struct Scratch {
+    float* data;    // [size]
+    size_t size;    // Capacity in floats
+};
+
+/**
+ * Sequential model: runs an arbitrary list of layers in order
+ *
+ * Intermediate results ping-pong between two caller-owned scratch buffers,
+ * so peak activation memory is 2 * max(hidden width) no matter how deep the
+ * model is. The first layer reads the caller's input and the last layer
+ * writes straight into the caller's output.
+ */
+class Sequential {
+private:
+    const Layer* const* layers_;
+    size_t num_layers_;
+    float* scratch_a_;
+    float* scratch_b_;
+    size_t scratch_size_;   // Capacity of each scratch buffer (floats)
+    size_t tile_rows_;      // predict_batch() rows per tile, whole register tiles (0: none fit)
+    bool chained_;          // Layer shapes chain (the const overloads need no more)
+    bool valid_;
+
+public:
+    /**
+     * Constructor
+     * @param layers Array of layer pointers [num_layers] (borrowed)
+     * @param num_layers Number of layers
+     * @param scratch_a First scratch buffer [scratch_size]
+     * @param scratch_b Second scratch buffer [scratch_size]
+     *                  (may be nullptr for models with at most two layers)
+     * @param scratch_size Capacity of each scratch buffer in floats,
+     *                     at least scratch_size_for(layers, num_layers)
+     */
+    Sequential(
+        const Layer* const* layers,
+        size_t num_layers,
+        float* scratch_a,
+        float* scratch_b,
+        size_t scratch_size
+    );
+
+    /**
+     * Size (in floats) each scratch buffer needs for the given layers:
+     * the widest intermediate (non-final) layer output.
+     */
+    static size_t scratch_size_for(const Layer* const* layers, size_t num_layers);
+
+    /**
+     * Size (in floats) each scratch buffer needs to run predict_batch()
+     * batch_tile samples at a time.
+     */
+    static size_t scratch_size_for(const Layer* const* layers, size_t num_layers,
+                                   size_t batch_tile);
+
+    /**
+     * Floats of Scratch the const predict overloads need: the widest
+     * intermediate output, twice for models of three or more layers
+     */
+    static size_t required_scratch_for(const Layer* const* layers, size_t num_layers);
+
+    size_t required_scratch() const;
+
+    /**
+     * True if the layer shapes chain together and the scratch buffers are
+     * large enough. predict() refuses to run an invalid model.
+     */
+    bool is_valid() const { return valid_; }
+
+    size_t num_layers() const { return num_layers_; }
+    size_t input_size() const;
+    size_t output_size() const;
+
+    /**
+     * Run inference on input data
+     * @param input Input vector [input_size()]
+     * @param output Output vector [output_size()]
+     * @return false if the model is invalid (output is left untouched)
+     */
+    bool predict(const float* input, float* output);
+
+    /**
+     * Run inference without the final layer's softmax
+     * @param input Input vector [input_size()]
+     * @param output Raw logits [output_size()]
+     * @return false if the model is invalid (output is left untouched)
+     */
+    bool predict_logits(const float* input, float* output);
+
+    /**
+     * Reentrant inference: only reads the model and writes scratch and
+     * output, so concurrent calls with separate Scratch are safe. Works
+     * without constructor scratch buffers (pass nullptr, 0 there).
+     * @param input Input vector [input_size()]
+     * @param output Output vector [output_size()]
+     * @param scratch Workspace of at least required_scratch() floats
+     * @return false if the layers do not chain or scratch is too small
+     */
+    bool predict(const float* input, float* output, Scratch& scratch) const;
+
+    /**
+     * Reentrant predict_logits(): no softmax on the final layer
+     */
+    bool predict_logits(const float* input, float* output, Scratch& scratch) const;
+
+#if CUSTOMNN_HAS_SPAN
+    /**
+     * Reentrant predict() with size checks
+     * @return false if a span is too short or the model cannot run
+     */
+    bool predict(std::span<const float> input, std::span<float> output, Scratch& scratch) const {
+        if (input.size() < input_size() || output.size() < output_size()) {
+            return false;
+        }
+        return predict(input.data(), output.data(), scratch);
+    }
+#endif
+
+    /**
+     * Predicted class: argmax of the logits, no softmax
+     * @param input Input vector [input_size()]
+     * @param logits Working buffer [output_size()], holds the logits after
+     * @return Class index, or -1 if the model is invalid
+     */
+    int predict_class(const float* input, float* logits);
+
+    /**
+     * The k most likely classes, most likely first, ranked on the logits
+     * @param input Input vector [input_size()]
+     * @param k Number of classes wanted
+     * @param classes Output class indices [min(k, output_size())]
+     * @param logits Working buffer [output_size()], holds the logits after
+     * @return Number of classes written (0 if the model is invalid)
+     */
+    size_t predict_topk(const float* input, size_t k, size_t* classes, float* logits);
+
+    /**
+     * Run inference on a batch of samples
+     * Samples are processed in tiles of as many whole GEMM register tiles
+     * as the scratch buffers hold. The n % Kernels::kGemmRows rows that do
+     * not fill a register tile, and every row if the scratch holds less
+     * than one (CUSTOMNN_BATCH_TILE == 1), run through predict()'s
+     * per-sample path; every other row matches predict() to within float
+     * rounding, and exactly with the scalar kernels.
+     *
+     * @param inputs Input matrix [n][input_size()]
+     * @param n Number of samples
+     * @param outputs Output matrix [n][output_size()]
+     * @return false if the model is invalid
+     */
+    bool predict_batch(const float* inputs, size_t n, float* outputs);
+
+private:
+    void run(const float* input, float* output, bool final_softmax,
+             float* scratch_a, float* scratch_b) const;
+
+    /**
+     * predict_batch() on n rows, a multiple of Kernels::kGemmRows (kept out
+     * of line so short batches skip its setup)
+     */
+    void run_tiled(const float* inputs, size_t n, float* outputs);
+};
+
 /**
  * Neural Network Model
- * Simple 2-layer feedforward network with configurable weights
+ * Simple 2-layer feedforward network with configurable weights,
+ * implemented as a two-layer Sequential model
  */
 class NeuralNetwork {
 private:
     // Layer 1: Dense layer with ReLU
-    const float* layer1_weights_;  // Stored as 1D array: [input_size * output_size]
-    const float* layer1_bias_;     // [output_size]
-    size_t layer1_input_size_;
-    size_t layer1_output_size_;
+    DenseLayer layer1_;
 
     // Layer 2: Dense layer with Softmax
-    const float* layer2_weights_;  // Stored as 1D array: [input_size * output_size]
-    const float* layer2_bias_;     // [output_size]
-    size_t layer2_input_size_;
-    size_t layer2_output_size_;
+    DenseLayer layer2_;
+
+    const Layer* layers_[2];
 
-    // Intermediate buffers for layer outputs (max size: 18 for compatibility)
-    float layer1_output_[18];  // Output of layer 1 (after ReLU)
+    // Hidden activations: CUSTOMNN_BATCH_TILE rows of layer 1's output
+    float* hidden_;
+
+    // Layer 2 logits for predict_class() / predict_topk()
+    float* logits_;
+
+    Sequential engine_;
 
 public:
     /**
@@ -117,19 +523,151 @@ public:
         size_t l2_out
     );
 
+    ~NeuralNetwork();
+
+    NeuralNetwork(const NeuralNetwork&) = delete;
+    NeuralNetwork& operator=(const NeuralNetwork&) = delete;
+
+    /**
+     * False if the layer sizes do not chain (l1_out != l2_in); every
+     * predict then returns false and leaves its output untouched
+     */
+    bool is_valid() const { return engine_.is_valid(); }
+
     /**
      * Run inference on input data
-     * @param input Input vector [2]
-     * @param output Output probabilities [3] (after softmax)
+     * @param input Input vector [l1_in]
+     * @param output Output probabilities [l2_out] (after softmax)
+     * @return false if the model is invalid
+     */
+    bool predict(const float* input, float* output);
+
+    /**
+     * Floats of Scratch the const predict() needs for a hidden layer of
+     * this width, for sizing stack buffers at compile time
+     */
+    static constexpr size_t required_scratch_for(size_t hidden_size) { return hidden_size; }
+
+    size_t required_scratch() const { return engine_.required_scratch(); }
+
+    /**
+     * Reentrant inference: the model is only read, so one instance can be
+     * shared by any number of threads, each with its own Scratch
+     * @param input Input vector [l1_in]
+     * @param output Output probabilities [l2_out] (after softmax)
+     * @param scratch Workspace of at least required_scratch() floats
+     * @return false if scratch is too small
+     */
+    bool predict(const float* input, float* output, Scratch& scratch) const;
+
+#if CUSTOMNN_HAS_SPAN
+    /**
+     * Reentrant predict() with size checks
+     * @return false if a span or scratch is too short
+     */
+    bool predict(std::span<const float> input, std::span<float> output, Scratch& scratch) const {
+        return engine_.predict(input, output, scratch);
+    }
+#endif
+
+    /**
+     * Run inference on a batch of samples
+     * @param inputs Input matrix [n][l1_in]
+     * @param n Number of samples
+     * @param outputs Output probabilities [n][l2_out] (after softmax)
+     * @return false if the model is invalid
      */
-    void predict(const float* input, float* output);
+    bool predict_batch(const float* inputs, size_t n, float* outputs);
 
     /**
-     * Get the predicted class (argmax of output)
-     * @param input Input vector [2]
-     * @return Predicted class index (0, 1, or 2)
+     * Get the predicted class (argmax of the logits; softmax is skipped)
+     * @param input Input vector [l1_in]
+     * @return Predicted class index in [0, l2_out)
      */
     int predict_class(const float* input);
+
+    /**
+     * Get the k most likely classes, most likely first (softmax is skipped)
+     * @param input Input vector [l1_in]
+     * @param k Number of classes wanted
+     * @param classes Output class indices [min(k, l2_out)]
+     * @return Number of classes written, min(k, l2_out)
+     */
+    size_t predict_topk(const float* input, size_t k, size_t* classes);
+};
+
+/**
+ * Two-class model decided on the logit margin
+ *
+ * For two classes softmax(z)[1] > t exactly when z1 - z0 > log(t / (1 - t)).
+ * The output layer is folded at construction into a single difference
+ * vector (w[:, 1] - w[:, 0], b1 - b0), so a decision costs the hidden layer
+ * plus one dot product and one compare: no exp, no division. probability()
+ * recovers the class-1 probability only where it is wanted (logging).
+ */
+class BinaryClassifier {
+private:
+    float* margin_weights_;  // Owned: [l2_in] as a [l2_in][1] matrix
+    float margin_bias_[1];
+    DenseLayer layer1_;
+    DenseLayer margin_layer_;
+    const Layer* layers_[2];
+    float* hidden_;          // Layer 1 output [l1_out]
+    Sequential engine_;
+    float threshold_;
+    float margin_threshold_;
+    bool valid_;
+
+public:
+    /**
+     * Constructor (same layer arguments as NeuralNetwork)
+     * @param l2_out Must be 2; any other width gives an invalid model
+     * @param threshold Class-1 probability above which decide() is true
+     */
+    BinaryClassifier(
+        const float* l1_weights,
+        const float* l1_bias,
+        size_t l1_in,
+        size_t l1_out,
+        const float* l2_weights,
+        const float* l2_bias,
+        size_t l2_in,
+        size_t l2_out,
+        float threshold
+    );
+
+    ~BinaryClassifier();
+
+    BinaryClassifier(const BinaryClassifier&) = delete;
+    BinaryClassifier& operator=(const BinaryClassifier&) = delete;
+
+    bool is_valid() const { return valid_; }
+
+    float threshold() const { return threshold_; }
+    float margin_threshold() const { return margin_threshold_; }
+
+    /**
+     * Logit margin z1 - z0 (0 if the model is invalid)
+     * @param input Input vector [l1_in]
+     */
+    float margin(const float* input);
+
+    /**
+     * True if the class-1 probability exceeds the threshold
+     * @param input Input vector [l1_in]
+     * @param margin Optional output: the logit margin, for probability()
+     */
+    bool decide(const float* input, float* margin = nullptr);
+
+    /**
+     * log(t / (1 - t)): the margin equivalent of probability threshold t
+     */
+    static float margin_for(float threshold);
+
+    /**
+     * Class-1 probability for a logit margin: 1 / (1 + exp(-margin))
+     */
+    static float probability(float margin);
 };
 
 } // namespace CustomNN
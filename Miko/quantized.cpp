@@ -0,0 +1,380 @@
+/**
+ * Int8 Quantized Inference Implementation
+ */
+
+#include "quantized.h"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+namespace CustomNN {
+
+namespace {
+
+constexpr int32_t kInt8Min = std::numeric_limits<int8_t>::min();
+constexpr int32_t kInt8Max = std::numeric_limits<int8_t>::max();
+
+int32_t saturate_int32(int64_t value) {
+    const int64_t lo = std::numeric_limits<int32_t>::min();
+    const int64_t hi = std::numeric_limits<int32_t>::max();
+    return static_cast<int32_t>(std::min(std::max(value, lo), hi));
+}
+
+int8_t saturate_int8(int32_t value, int32_t lo) {
+    return static_cast<int8_t>(std::min(std::max(value, lo), kInt8Max));
+}
+
+} // namespace
+
+// ============================================================================
+// Quantization Helpers
+// ============================================================================
+
+QuantParams QuantOps::choose_params(float min_value, float max_value, bool include_zero) {
+    if (include_zero) {
+        min_value = std::min(min_value, 0.0f);
+        max_value = std::max(max_value, 0.0f);
+    }
+
+    QuantParams params;
+    params.scale = (max_value - min_value) / static_cast<float>(kInt8Max - kInt8Min);
+    if (!(params.scale > 0.0f)) {
+        params.scale = 1.0f;
+    }
+
+    // min_value maps to -128
+    params.zero_point = kInt8Min - static_cast<int32_t>(std::lround(min_value / params.scale));
+    if (include_zero) {
+        params.zero_point = std::min(std::max(params.zero_point, kInt8Min), kInt8Max);
+    }
+    return params;
+}
+
+int8_t QuantOps::quantize(float value, QuantParams params) {
+    const long q = std::lround(value / params.scale) + params.zero_point;
+    return static_cast<int8_t>(std::min<long>(std::max<long>(q, kInt8Min), kInt8Max));
+}
+
+float QuantOps::dequantize(int8_t value, QuantParams params) {
+    return params.scale * static_cast<float>(static_cast<int32_t>(value) - params.zero_point);
+}
+
+void QuantOps::quantize_multiplier(double real_multiplier, int32_t* multiplier,
+                                   int32_t* shift) {
+    if (!(real_multiplier > 0.0)) {
+        *multiplier = 0;
+        *shift = 0;
+        return;
+    }
+
+    // real_multiplier = fraction * 2^exponent with fraction in [0.5, 1)
+    int exponent = 0;
+    const double fraction = std::frexp(real_multiplier, &exponent);
+    int64_t q = std::llround(fraction * static_cast<double>(int64_t{1} << 31));
+    if (q == (int64_t{1} << 31)) {
+        q /= 2;
+        ++exponent;
+    }
+
+    *multiplier = static_cast<int32_t>(q);
+    *shift = static_cast<int32_t>(exponent);
+}
+
+int32_t QuantOps::requantize(int32_t acc, int32_t multiplier, int32_t shift) {
+    const int32_t left = (shift > 0) ? shift : 0;
+    const int32_t right = (shift > 0) ? 0 : -shift;
+
+    // Saturating left shift for multipliers >= 1
+    const int32_t x = saturate_int32(static_cast<int64_t>(acc) * (int64_t{1} << left));
+
+    // Rounding doubling high multiply: round(x * multiplier / 2^31)
+    const int64_t product = static_cast<int64_t>(x) * multiplier;
+    const int64_t nudge = (product >= 0) ? (int64_t{1} << 30) : (1 - (int64_t{1} << 30));
+    int64_t high = (product + nudge) / (int64_t{1} << 31);
+
+    // Rounding arithmetic right shift (ties away from zero)
+    if (right > 0) {
+        const int64_t mask = (int64_t{1} << right) - 1;
+        const int64_t remainder = high & mask;
+        const int64_t threshold = (mask >> 1) + ((high < 0) ? 1 : 0);
+        high = (high >> right) + ((remainder > threshold) ? 1 : 0);
+    }
+
+    return saturate_int32(high);
+}
+
+void QuantOps::dense_forward(const QuantizedDense& layer, const int8_t* input,
+                             int8_t* output) {
+    // ReLU is a clamp at the quantized zero
+    const int32_t lo = (layer.activation == ActivationType::ReLU)
+                           ? std::max(layer.output.zero_point, kInt8Min)
+                           : kInt8Min;
+
+    for (size_t j = 0; j < layer.output_size; ++j) {
+        const int8_t* row = layer.weights + j * layer.input_size;
+
+        // The input zero point is already folded into the bias
+        int32_t acc = layer.bias[j];
+        for (size_t i = 0; i < layer.input_size; ++i) {
+            acc += static_cast<int32_t>(row[i]) * static_cast<int32_t>(input[i]);
+        }
+
+        const int32_t q = requantize(acc, layer.multiplier[j], layer.shift[j]) +
+                          layer.output.zero_point;
+        output[j] = saturate_int8(q, lo);
+    }
+}
+
+bool QuantOps::calibrate(const Layer* const* layers, size_t num_layers,
+                         const float* samples, size_t count, QuantParams* params) {
+    if (layers == nullptr || num_layers == 0 || count == 0) {
+        return false;
+    }
+
+    size_t max_width = layers[0]->input_size();
+    for (size_t i = 0; i < num_layers; ++i) {
+        if (i > 0 && layers[i - 1]->output_size() != layers[i]->input_size()) {
+            return false;
+        }
+        max_width = std::max(max_width, layers[i]->output_size());
+    }
+
+    // Running [min, max] for the input and for every layer output
+    float* mins = new float[num_layers + 1];
+    float* maxs = new float[num_layers + 1];
+    for (size_t i = 0; i <= num_layers; ++i) {
+        mins[i] = std::numeric_limits<float>::max();
+        maxs[i] = std::numeric_limits<float>::lowest();
+    }
+
+    float* scratch_a = new float[max_width];
+    float* scratch_b = new float[max_width];
+    const size_t input_size = layers[0]->input_size();
+
+    for (size_t s = 0; s < count; ++s) {
+        const float* current = samples + s * input_size;
+        for (size_t k = 0; k < input_size; ++k) {
+            mins[0] = std::min(mins[0], current[k]);
+            maxs[0] = std::max(maxs[0], current[k]);
+        }
+
+        for (size_t i = 0; i < num_layers; ++i) {
+            // Layer outputs are pre-softmax, which is what the int8 path stores
+            float* next = (i % 2 == 0) ? scratch_a : scratch_b;
+            layers[i]->forward(current, next);
+            for (size_t k = 0; k < layers[i]->output_size(); ++k) {
+                mins[i + 1] = std::min(mins[i + 1], next[k]);
+                maxs[i + 1] = std::max(maxs[i + 1], next[k]);
+            }
+            current = next;
+        }
+    }
+
+    // Only the input may keep a zero point outside int8: every later tensor
+    // is fed through ReLU or softmax, which need an exact zero
+    params[0] = choose_params(mins[0], maxs[0], false);
+    for (size_t i = 1; i <= num_layers; ++i) {
+        params[i] = choose_params(mins[i], maxs[i]);
+    }
+
+    delete[] scratch_b;
+    delete[] scratch_a;
+    delete[] maxs;
+    delete[] mins;
+    return true;
+}
+
+// ============================================================================
+// Quantized Dense Layer
+// ============================================================================
+
+QuantizedDenseLayer::QuantizedDenseLayer(
+    const float* weights,
+    const float* bias,
+    size_t input_size,
+    size_t output_size,
+    ActivationType activation,
+    QuantParams input,
+    QuantParams output
+) : weights_(new int8_t[input_size * output_size]),
+    bias_(new int32_t[output_size]),
+    multiplier_(new int32_t[output_size]),
+    shift_(new int32_t[output_size]),
+    weight_scale_(new float[output_size]),
+    params_{weights_, bias_, multiplier_, shift_, input_size, output_size,
+            input, output, activation}
+{
+    for (size_t j = 0; j < output_size; ++j) {
+        // Symmetric per-channel scale: the largest |weight| maps to 127
+        float max_abs = 0.0f;
+        for (size_t i = 0; i < input_size; ++i) {
+            max_abs = std::max(max_abs, std::fabs(weights[i * output_size + j]));
+        }
+        const float scale = (max_abs > 0.0f) ? max_abs / static_cast<float>(kInt8Max) : 1.0f;
+        weight_scale_[j] = scale;
+
+        // Transpose to output-major rows while quantizing
+        int8_t* row = weights_ + j * input_size;
+        int64_t row_sum = 0;
+        for (size_t i = 0; i < input_size; ++i) {
+            const long q = std::lround(weights[i * output_size + j] / scale);
+            row[i] = static_cast<int8_t>(std::min<long>(std::max<long>(q, -kInt8Max), kInt8Max));
+            row_sum += row[i];
+        }
+
+        // Bias in the accumulator's scale, minus the input zero point term:
+        // sum_i w * (x - zp) = sum_i w * x - zp * sum_i w
+        const double acc_scale = static_cast<double>(input.scale) * static_cast<double>(scale);
+        const int64_t q_bias = std::llround(static_cast<double>(bias[j]) / acc_scale);
+        bias_[j] = saturate_int32(q_bias - static_cast<int64_t>(input.zero_point) * row_sum);
+
+        QuantOps::quantize_multiplier(acc_scale / static_cast<double>(output.scale),
+                                      &multiplier_[j], &shift_[j]);
+    }
+}
+
+QuantizedDenseLayer::~QuantizedDenseLayer() {
+    delete[] weight_scale_;
+    delete[] shift_;
+    delete[] multiplier_;
+    delete[] bias_;
+    delete[] weights_;
+}
+
+QuantizedDenseLayer::QuantizedDenseLayer(QuantizedDenseLayer&& other) noexcept
+  : weights_(other.weights_),
+    bias_(other.bias_),
+    multiplier_(other.multiplier_),
+    shift_(other.shift_),
+    weight_scale_(other.weight_scale_),
+    params_(other.params_)
+{
+    other.weights_ = nullptr;
+    other.bias_ = nullptr;
+    other.multiplier_ = nullptr;
+    other.shift_ = nullptr;
+    other.weight_scale_ = nullptr;
+}
+
+// ============================================================================
+// Quantized Sequential
+// ============================================================================
+
+QuantizedSequential::QuantizedSequential(
+    const QuantizedDense* const* layers,
+    size_t num_layers,
+    int8_t* scratch_a,
+    int8_t* scratch_b,
+    size_t scratch_size
+) : layers_(layers),
+    num_layers_(num_layers),
+    scratch_a_(scratch_a),
+    scratch_b_(scratch_b),
+    scratch_size_(scratch_size),
+    valid_(false)
+{
+    if (layers_ == nullptr || num_layers_ == 0) {
+        return;
+    }
+
+    // Consecutive layers must agree on width and on the quantization of
+    // the tensor they share
+    for (size_t i = 0; i < num_layers_; ++i) {
+        if (layers_[i] == nullptr) {
+            return;
+        }
+        if (i > 0) {
+            const QuantizedDense& prev = *layers_[i - 1];
+            const QuantizedDense& cur = *layers_[i];
+            if (prev.output_size != cur.input_size ||
+                prev.output.scale != cur.input.scale ||
+                prev.output.zero_point != cur.input.zero_point) {
+                return;
+            }
+        }
+    }
+
+    // predict() stages the input and output in scratch as well
+    if (scratch_a_ == nullptr || scratch_b_ == nullptr) {
+        return;
+    }
+    if (scratch_size_ < scratch_size_for(layers_, num_layers_)) {
+        return;
+    }
+
+    valid_ = true;
+}
+
+size_t QuantizedSequential::scratch_size_for(const QuantizedDense* const* layers,
+                                             size_t num_layers) {
+    size_t max_width = (num_layers > 0) ? layers[0]->input_size : 0;
+    for (size_t i = 0; i < num_layers; ++i) {
+        max_width = std::max(max_width, layers[i]->output_size);
+    }
+    return max_width;
+}
+
+size_t QuantizedSequential::input_size() const {
+    return valid_ ? layers_[0]->input_size : 0;
+}
+
+size_t QuantizedSequential::output_size() const {
+    return valid_ ? layers_[num_layers_ - 1]->output_size : 0;
+}
+
+QuantParams QuantizedSequential::input_params() const {
+    return valid_ ? layers_[0]->input : QuantParams{1.0f, 0};
+}
+
+QuantParams QuantizedSequential::output_params() const {
+    return valid_ ? layers_[num_layers_ - 1]->output : QuantParams{1.0f, 0};
+}
+
+bool QuantizedSequential::predict_quantized(const int8_t* input, int8_t* output) {
+    if (!valid_) {
+        return false;
+    }
+
+    const int8_t* current = input;
+    for (size_t i = 0; i < num_layers_; ++i) {
+        const bool is_last = (i + 1 == num_layers_);
+        int8_t* next = is_last ? output : ((i % 2 == 0) ? scratch_a_ : scratch_b_);
+        QuantOps::dense_forward(*layers_[i], current, next);
+        current = next;
+    }
+
+    return true;
+}
+
+bool QuantizedSequential::predict(const float* input, float* output) {
+    if (!valid_) {
+        return false;
+    }
+
+    const QuantParams in_params = input_params();
+    for (size_t k = 0; k < input_size(); ++k) {
+        scratch_a_[k] = QuantOps::quantize(input[k], in_params);
+    }
+
+    // Integer-only from here: ping-pong A -> B -> A ...
+    int8_t* current = scratch_a_;
+    for (size_t i = 0; i < num_layers_; ++i) {
+        int8_t* next = (current == scratch_a_) ? scratch_b_ : scratch_a_;
+        QuantOps::dense_forward(*layers_[i], current, next);
+        current = next;
+    }
+
+    const QuantParams out_params = output_params();
+    const size_t width = output_size();
+    for (size_t k = 0; k < width; ++k) {
+        output[k] = QuantOps::dequantize(current[k], out_params);
+    }
+
+    if (layers_[num_layers_ - 1]->activation == ActivationType::Softmax) {
+        Activation::softmax(output, width);
+    }
+
+    return true;
+}
+
+} // namespace CustomNN
@@ -0,0 +1,232 @@
+/**
+ * Int8 Quantized Inference
+ * Integer-only dense layers for cores without an FPU (the RP2040's M0+)
+ *
+ * Weights are int8, symmetric and per output channel. Activations are int8
+ * with a per-tensor scale and zero point. Each neuron accumulates in int32
+ * and is requantized to the next layer's int8 scale with a fixed-point
+ * multiplier and shift, so no float is touched between the input
+ * quantization and the final dequantization.
+ *
+ * Usage:
+ *   // Offline (host): calibrate activation ranges, convert and emit a header
+ *   QuantOps::calibrate(layers, 2, samples, count, params);
+ *   QuantizedDenseLayer l1(w1, b1, 10, 8, ActivationType::ReLU, params[0], params[1]);
+ *   // On the device: run the generated constexpr layers
+ *   const QuantizedDense* layers[] = {&TEMP_LAYER1_Q8, &TEMP_LAYER2_Q8};
+ *   QuantizedSequential model(layers, 2, scratch_a, scratch_b, size);
+ *   model.predict(input, output);
+ *
+ * The generated headers (temp_model_weights_int8.h, model_weights_int8.h)
+ * come from tools/quantize_weights; see `make quantize`.
+ */
+
+#ifndef QUANTIZED_H
+#define QUANTIZED_H
+
+#include <cstddef>
+#include <cstdint>
+#include "neural_network.h"
+
+namespace CustomNN {
+
+/**
+ * Affine int8 quantization of a tensor: real = scale * (q - zero_point)
+ */
+struct QuantParams {
+    float scale;
+    int32_t zero_point;
+};
+
+/**
+ * Int8 dense layer as plain data, so it can be a constexpr in flash
+ *
+ * output[j] = clamp(requantize(bias[j] + sum_i(weights[j][i] * input[i]),
+ *                              multiplier[j], shift[j]) + output.zero_point)
+ *
+ * The input zero point is folded into bias at conversion time, so the inner
+ * loop is a plain int8 dot product.
+ */
+struct QuantizedDense {
+    const int8_t* weights;       // Output-major: [output_size][input_size]
+    const int32_t* bias;         // [output_size], scale input.scale * weight_scale[j]
+    const int32_t* multiplier;   // [output_size], Q31 fixed point
+    const int32_t* shift;        // [output_size], power-of-two exponent
+    size_t input_size;
+    size_t output_size;
+    QuantParams input;
+    QuantParams output;
+    ActivationType activation;   // ReLU is a clamp; Softmax is left to the caller
+};
+
+/**
+ * Quantization helpers and the int8 dense kernel
+ */
+class QuantOps {
+public:
+    /**
+     * Asymmetric int8 parameters covering [min_value, max_value]
+     * @param include_zero Widen the range to include 0 so that zero (and
+     *        ReLU's clamp) is exact. Model inputs that never reach 0 (e.g.
+     *        temperatures) can skip this; their zero point then lies outside
+     *        the int8 range, which the folded bias absorbs.
+     */
+    static QuantParams choose_params(float min_value, float max_value,
+                                     bool include_zero = true);
+
+    static int8_t quantize(float value, QuantParams params);
+    static float dequantize(int8_t value, QuantParams params);
+
+    /**
+     * Split a positive real multiplier into multiplier * 2^(shift - 31)
+     * with multiplier in [2^30, 2^31)
+     */
+    static void quantize_multiplier(double real_multiplier, int32_t* multiplier,
+                                    int32_t* shift);
+
+    /**
+     * round(acc * multiplier * 2^(shift - 31)), saturated to int32
+     * (rounding doubling high multiply, then rounding right shift)
+     */
+    static int32_t requantize(int32_t acc, int32_t multiplier, int32_t shift);
+
+    /**
+     * Int8 dense layer forward pass (int32 accumulation)
+     * @param input Input vector [layer.input_size]
+     * @param output Output vector [layer.output_size]
+     */
+    static void dense_forward(const QuantizedDense& layer, const int8_t* input, int8_t* output);
+
+    /**
+     * Measure activation ranges by running the float model over samples
+     * @param layers Float layers [num_layers]
+     * @param samples Calibration inputs [count][input_size]
+     * @param params Output: params[0] for the model input (its observed
+     *               range, not widened to 0) and params[i + 1] for layer
+     *               i's output (pre-softmax logits for the last)
+     * @return false if the layers do not chain or count is 0
+     */
+    static bool calibrate(const Layer* const* layers, size_t num_layers,
+                          const float* samples, size_t count, QuantParams* params);
+};
+
+/**
+ * Owning int8 conversion of a float dense layer
+ *
+ * Quantizes weights [input_size][output_size] (the layout of the float
+ * weight headers) per output channel and derives the int32 bias and
+ * requantization multipliers for the given activation parameters.
+ */
+class QuantizedDenseLayer {
+private:
+    int8_t* weights_;
+    int32_t* bias_;
+    int32_t* multiplier_;
+    int32_t* shift_;
+    float* weight_scale_;
+    QuantizedDense params_;
+
+public:
+    /**
+     * Constructor
+     * @param weights Float weights as 1D array [input_size * output_size]
+     * @param bias Float bias [output_size]
+     * @param input_size Layer input size
+     * @param output_size Layer output size
+     * @param activation Activation applied to the output
+     * @param input Quantization of the layer input
+     * @param output Quantization of the layer output
+     */
+    QuantizedDenseLayer(
+        const float* weights,
+        const float* bias,
+        size_t input_size,
+        size_t output_size,
+        ActivationType activation,
+        QuantParams input,
+        QuantParams output
+    );
+
+    ~QuantizedDenseLayer();
+
+    QuantizedDenseLayer(QuantizedDenseLayer&& other) noexcept;
+    QuantizedDenseLayer(const QuantizedDenseLayer&) = delete;
+    QuantizedDenseLayer& operator=(const QuantizedDenseLayer&) = delete;
+    QuantizedDenseLayer& operator=(QuantizedDenseLayer&&) = delete;
+
+    const QuantizedDense& params() const { return params_; }
+
+    /**
+     * Per-channel weight scale: weight[i][j] ~= weight_scale(j) * q[j][i]
+     */
+    float weight_scale(size_t channel) const { return weight_scale_[channel]; }
+};
+
+/**
+ * Sequential int8 model
+ *
+ * Mirrors Sequential: int8 activations ping-pong between two caller-owned
+ * scratch buffers. Each layer's input parameters must equal the previous
+ * layer's output parameters.
+ */
+class QuantizedSequential {
+private:
+    const QuantizedDense* const* layers_;
+    size_t num_layers_;
+    int8_t* scratch_a_;
+    int8_t* scratch_b_;
+    size_t scratch_size_;   // Capacity of each scratch buffer (bytes)
+    bool valid_;
+
+public:
+    /**
+     * Constructor
+     * @param layers Array of layer pointers [num_layers] (borrowed)
+     * @param num_layers Number of layers
+     * @param scratch_a First scratch buffer [scratch_size]
+     * @param scratch_b Second scratch buffer [scratch_size]
+     * @param scratch_size Capacity of each scratch buffer,
+     *                     at least scratch_size_for(layers, num_layers)
+     */
+    QuantizedSequential(
+        const QuantizedDense* const* layers,
+        size_t num_layers,
+        int8_t* scratch_a,
+        int8_t* scratch_b,
+        size_t scratch_size
+    );
+
+    /**
+     * Bytes each scratch buffer needs: the widest of the model input and
+     * every layer output (the float predict() stages both ends in scratch)
+     */
+    static size_t scratch_size_for(const QuantizedDense* const* layers, size_t num_layers);
+
+    bool is_valid() const { return valid_; }
+
+    size_t num_layers() const { return num_layers_; }
+    size_t input_size() const;
+    size_t output_size() const;
+    QuantParams input_params() const;
+    QuantParams output_params() const;
+
+    /**
+     * Integer-only inference
+     * @param input Quantized input [input_size()] (see input_params())
+     * @param output Quantized output logits [output_size()] (see output_params())
+     * @return false if the model is invalid
+     */
+    bool predict_quantized(const int8_t* input, int8_t* output);
+
+    /**
+     * Float in, float out: quantizes the input, runs the int8 layers,
+     * dequantizes the output and applies softmax if the last layer asks
+     * for it
+     * @return false if the model is invalid
+     */
+    bool predict(const float* input, float* output);
+};
+
+} // namespace CustomNN
+
+#endif // QUANTIZED_H
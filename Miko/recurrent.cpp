@@ -0,0 +1,140 @@
+/**
+ * Recurrent Layers Implementation
+ */
+
+#include "recurrent.h"
+#include <algorithm>
+#include <cmath>
+
+namespace CustomNN {
+
+namespace {
+
+float sigmoid(float x) {
+    return 1.0f / (1.0f + std::exp(-x));
+}
+
+// Q15 state: |h| < 1
+constexpr QFormat kStateFormat = {FixedGRULayer::kStateFracBits, 1.0f};
+
+// One format for both gate matvecs, wide enough for either's worst case, so
+// their outputs add without rescaling
+QFormat gate_format(const GRU& gru, QFormat input) {
+    const size_t width = 3 * gru.units;
+    const QFormat from_input = FixedOps::output_bound(gru.kernel, gru.bias, gru.input_size,
+                                                      width, input);
+    const QFormat from_state = FixedOps::output_bound(gru.recurrent, gru.bias + width, gru.units,
+                                                      width, kStateFormat);
+    return FixedOps::format_for(std::max(from_input.max_abs, from_state.max_abs));
+}
+
+} // namespace
+
+// ============================================================================
+// RecurrentOps
+// ============================================================================
+
+size_t RecurrentOps::macs(const GRU& gru) {
+    return 3 * gru.units * (gru.input_size + gru.units);
+}
+
+size_t RecurrentOps::macs(const SimpleRNN& rnn) {
+    return rnn.units * (rnn.input_size + rnn.units);
+}
+
+void RecurrentOps::gru_step(const GRU& gru, const float* input, float* hidden, float* work) {
+    const size_t units = gru.units;
+    const size_t width = 3 * units;
+    float* gx = work;           // x W + b, all three gates
+    float* gh = work + width;   // h U + b', all three gates
+    MatrixOps::dense_forward(input, gru.kernel, gru.bias, gx, gru.input_size, width);
+    MatrixOps::dense_forward(hidden, gru.recurrent, gru.bias + width, gh, units, width);
+
+    for (size_t j = 0; j < units; ++j) {
+        const float z = sigmoid(gx[j] + gh[j]);
+        const float r = sigmoid(gx[units + j] + gh[units + j]);
+        const float candidate = std::tanh(gx[2 * units + j] + r * gh[2 * units + j]);
+        hidden[j] = z * hidden[j] + (1.0f - z) * candidate;
+    }
+}
+
+void RecurrentOps::rnn_step(const SimpleRNN& rnn, const float* input, float* hidden,
+                            float* work) {
+    const size_t units = rnn.units;
+    float* gx = work;
+    float* pre = work + units;
+    MatrixOps::dense_forward(input, rnn.kernel, rnn.bias, gx, rnn.input_size, units);
+    // x W + b serves as the bias of the recurrent matvec
+    MatrixOps::dense_forward(hidden, rnn.recurrent, gx, pre, units, units);
+    for (size_t j = 0; j < units; ++j) {
+        hidden[j] = std::tanh(pre[j]);
+    }
+}
+
+// ============================================================================
+// Streaming layers
+// ============================================================================
+
+bool StreamingGRULayer::valid() const {
+    return params_.kernel != nullptr && params_.recurrent != nullptr &&
+           params_.bias != nullptr && params_.input_size > 0 && params_.units > 0;
+}
+
+bool StreamingGRULayer::push(const float* input, float* output, StreamState& state) const {
+    float* hidden = state.buffer;
+    RecurrentOps::gru_step(params_, input, hidden, hidden + params_.units);
+    std::copy(hidden, hidden + params_.units, output);
+    return true;
+}
+
+bool StreamingRNNLayer::valid() const {
+    return params_.kernel != nullptr && params_.recurrent != nullptr &&
+           params_.bias != nullptr && params_.input_size > 0 && params_.units > 0;
+}
+
+bool StreamingRNNLayer::push(const float* input, float* output, StreamState& state) const {
+    float* hidden = state.buffer;
+    RecurrentOps::rnn_step(params_, input, hidden, hidden + params_.units);
+    std::copy(hidden, hidden + params_.units, output);
+    return true;
+}
+
+// ============================================================================
+// Fixed-point GRU
+// ============================================================================
+
+FixedGRULayer::FixedGRULayer(const GRU& gru, QFormat input)
+  : input_(gru.kernel, gru.bias, gru.input_size, 3 * gru.units, ActivationType::None, input,
+           gate_format(gru, input)),
+    recurrent_(gru.recurrent, gru.bias + 3 * gru.units, gru.units, 3 * gru.units,
+               ActivationType::None, kStateFormat, gate_format(gru, input)),
+    units_(gru.units),
+    gate_frac_(input_.params().output_frac)
+{
+}
+
+void FixedGRULayer::reset(int16_t* hidden) const {
+    std::fill(hidden, hidden + units_, int16_t{0});
+}
+
+void FixedGRULayer::step(const int16_t* input, int16_t* hidden, int16_t* work) const {
+    const size_t units = units_;
+    int16_t* gx = work;
+    int16_t* gh = work + 3 * units;
+    FixedOps::dense_forward(input_.params(), input, gx);
+    FixedOps::dense_forward(recurrent_.params(), hidden, gh);
+
+    constexpr int32_t kOne = int32_t{1} << kStateFracBits;
+    for (size_t j = 0; j < units; ++j) {
+        const int32_t z = FixedOps::sigmoid_q15(int32_t{gx[j]} + gh[j], gate_frac_);
+        const int32_t r = FixedOps::sigmoid_q15(int32_t{gx[units + j]} + gh[units + j],
+                                                gate_frac_);
+        const int32_t reset_part = FixedOps::shift_round(r * gh[2 * units + j], 15);
+        const int32_t candidate = FixedOps::tanh_q15(int32_t{gx[2 * units + j]} + reset_part,
+                                                     gate_frac_);
+        hidden[j] = FixedOps::saturate(
+            FixedOps::shift_round(z * hidden[j] + (kOne - z) * candidate, 15));
+    }
+}
+
+} // namespace CustomNN
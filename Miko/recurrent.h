@@ -0,0 +1,198 @@
+/**
+ * Recurrent Layers
+ * Stateful GRU and SimpleRNN cells: one reading per step, fixed-size state
+ *
+ * A windowed model needs the last N readings and N-proportional compute to
+ * look N samples back. A recurrent cell folds all history into a hidden
+ * state of `units` values instead: each reading costs the same, and the
+ * memory is the state, however far back the detector needs to remember.
+ *
+ * The layers plug into StreamingSequential (streaming.h), which owns the
+ * hidden state per stream, carries it from one push() to the next and
+ * clears it with reset(). A Dense head goes after them through
+ * StreamingPointwiseLayer.
+ *
+ * GRU, Keras layout (GRU(units), reset_after=True, the TF2 default):
+ *   kernel [input_size][3 * units], recurrent [units][3 * units], gate
+ *   blocks in z, r, h order; bias [2][3 * units] (input, recurrent)
+ *
+ *   z  = sigmoid(x Wz + bz + h Uz + bz')
+ *   r  = sigmoid(x Wr + br + h Ur + br')
+ *   h~ = tanh(x Wh + bh + r * (h Uh + bh'))
+ *   h  = z * h + (1 - z) * h~
+ *
+ * The gates are fused: x W for all three gates is one matvec of width
+ * 3 * units, h U is one more, and a single elementwise pass then produces
+ * z, r, h~ and the new state. Per step: 3 * units * (input_size + units)
+ * multiply-adds and 3 * units exp/tanh.
+ *
+ * SimpleRNN (Keras SimpleRNN, tanh): h = tanh(x W + h U + b).
+ *
+ * FixedGRULayer runs the same cell in Q15 for the FPU-less RP2040: the two
+ * matvecs are FixedDense layers, the gates use FixedOps::sigmoid_q15 and
+ * tanh_q15, and the state stays Q15 (a GRU state is always in (-1, 1)).
+ *
+ * Usage:
+ *   const GRU gru = {kernel, recurrent, bias, 1, 16};
+ *   StreamingGRULayer cell(gru);
+ *   DenseLayer dense(w_head, b_head, 16, 2, ActivationType::Softmax);
+ *   StreamingPointwiseLayer head(dense);
+ *   const StreamingLayer* layers[] = {&cell, &head};
+ *   StreamingSequential model(layers, 2);
+ *   // Every reading:
+ *   float probs[2];
+ *   model.push(&temperature, probs);
+ *   // New session:
+ *   model.reset();
+ */
+
+#ifndef RECURRENT_H
+#define RECURRENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include "fixed_point.h"
+#include "neural_network.h"
+#include "streaming.h"
+
+namespace CustomNN {
+
+/**
+ * GRU cell as plain data, so it can be a constexpr in flash
+ */
+struct GRU {
+    const float* kernel;      // [input_size][3 * units]
+    const float* recurrent;   // [units][3 * units]
+    const float* bias;        // [2][3 * units]: input bias, then recurrent bias
+    size_t input_size;
+    size_t units;
+};
+
+/**
+ * SimpleRNN cell as plain data
+ */
+struct SimpleRNN {
+    const float* kernel;      // [input_size][units]
+    const float* recurrent;   // [units][units]
+    const float* bias;        // [units]
+    size_t input_size;
+    size_t units;
+};
+
+/**
+ * GRU and SimpleRNN step kernels
+ */
+class RecurrentOps {
+public:
+    /**
+     * Multiply-adds per step
+     */
+    static size_t macs(const GRU& gru);
+    static size_t macs(const SimpleRNN& rnn);
+
+    /**
+     * One GRU step, state updated in place
+     * @param input Input [input_size]
+     * @param hidden State [units], read and overwritten
+     * @param work Scratch [6 * units]
+     */
+    static void gru_step(const GRU& gru, const float* input, float* hidden, float* work);
+
+    /**
+     * One SimpleRNN step, state updated in place
+     * @param work Scratch [2 * units]
+     */
+    static void rnn_step(const SimpleRNN& rnn, const float* input, float* hidden, float* work);
+};
+
+/**
+ * GRU over borrowed weights; outputs the new state every step
+ */
+class StreamingGRULayer : public StreamingLayer {
+private:
+    GRU params_;
+
+public:
+    explicit StreamingGRULayer(const GRU& params) : params_(params) {}
+
+    bool valid() const override;
+
+    const GRU& params() const { return params_; }
+
+    size_t input_channels() const override { return params_.input_size; }
+    size_t output_channels() const override { return params_.units; }
+    size_t state_size() const override { return 7 * params_.units; }
+
+    bool push(const float* input, float* output, StreamState& state) const override;
+};
+
+/**
+ * SimpleRNN over borrowed weights; outputs the new state every step
+ */
+class StreamingRNNLayer : public StreamingLayer {
+private:
+    SimpleRNN params_;
+
+public:
+    explicit StreamingRNNLayer(const SimpleRNN& params) : params_(params) {}
+
+    bool valid() const override;
+
+    size_t input_channels() const override { return params_.input_size; }
+    size_t output_channels() const override { return params_.units; }
+    size_t state_size() const override { return 3 * params_.units; }
+
+    bool push(const float* input, float* output, StreamState& state) const override;
+};
+
+/**
+ * Owning Q15 conversion of a float GRU
+ *
+ * The caller keeps the state: int16 hidden[units] in Q15 (zero to reset)
+ * and int16 work[6 * units], so one converted layer can serve several
+ * streams.
+ */
+class FixedGRULayer {
+private:
+    FixedDenseLayer input_;       // x -> [3 * units] gate pre-activations
+    FixedDenseLayer recurrent_;   // h -> [3 * units], same format
+    size_t units_;
+    int32_t gate_frac_;
+
+public:
+    // The hidden state format
+    static constexpr int32_t kStateFracBits = 15;
+
+    /**
+     * @param gru Float cell (weights read during construction only)
+     * @param input Format of the input
+     */
+    FixedGRULayer(const GRU& gru, QFormat input);
+
+    FixedGRULayer(FixedGRULayer&& other) noexcept = default;
+    FixedGRULayer(const FixedGRULayer&) = delete;
+    FixedGRULayer& operator=(const FixedGRULayer&) = delete;
+
+    size_t units() const { return units_; }
+    size_t input_size() const { return input_.params().input_size; }
+    int32_t input_frac() const { return input_.params().input_frac; }
+    int32_t gate_frac() const { return gate_frac_; }
+
+    /**
+     * Clear a state for a new stream
+     * @param hidden State [units]
+     */
+    void reset(int16_t* hidden) const;
+
+    /**
+     * One step, integer arithmetic only
+     * @param input Input [input_size()] in input_frac()
+     * @param hidden State [units], Q15, read and overwritten
+     * @param work Scratch [6 * units]
+     */
+    void step(const int16_t* input, int16_t* hidden, int16_t* work) const;
+};
+
+} // namespace CustomNN
+
+#endif // RECURRENT_H
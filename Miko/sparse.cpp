@@ -0,0 +1,187 @@
+/**
+ * Sparse (Pruned) Dense Layers Implementation
+ */
+
+#include "sparse.h"
+#include <algorithm>
+#include <cmath>
+
+namespace CustomNN {
+
+// ============================================================================
+// SparseOps
+// ============================================================================
+
+size_t SparseOps::count_nonzero(const float* weights, size_t count) {
+    size_t nonzeros = 0;
+    for (size_t k = 0; k < count; ++k) {
+        nonzeros += (weights[k] != 0.0f) ? size_t{1} : size_t{0};
+    }
+    return nonzeros;
+}
+
+float SparseOps::density(const float* weights, size_t count) {
+    if (count == 0) {
+        return 1.0f;
+    }
+    return static_cast<float>(count_nonzero(weights, count)) / static_cast<float>(count);
+}
+
+size_t SparseOps::prune(const float* weights, float* pruned, size_t count, float density) {
+    density = std::min(std::max(density, 0.0f), 1.0f);
+    const size_t keep = std::min(
+        count, static_cast<size_t>(std::lround(density * static_cast<float>(count))));
+
+    // Rank by magnitude, earlier index first on ties, before writing (the
+    // buffers may alias)
+    size_t* order = new size_t[count];
+    bool* kept = new bool[count]();
+    for (size_t k = 0; k < count; ++k) {
+        order[k] = k;
+    }
+    std::sort(order, order + count, [weights](size_t a, size_t b) {
+        const float ma = std::fabs(weights[a]);
+        const float mb = std::fabs(weights[b]);
+        return (ma != mb) ? (ma > mb) : (a < b);
+    });
+    for (size_t r = 0; r < keep; ++r) {
+        kept[order[r]] = true;
+    }
+    for (size_t k = 0; k < count; ++k) {
+        pruned[k] = kept[k] ? weights[k] : 0.0f;
+    }
+
+    delete[] kept;
+    delete[] order;
+    return count_nonzero(pruned, count);
+}
+
+size_t SparseOps::storage_bytes(size_t nonzeros, size_t output_size) {
+    return nonzeros * (sizeof(float) + sizeof(int16_t)) +
+           (output_size + 1) * sizeof(uint16_t) + output_size * sizeof(float);
+}
+
+float SparseOps::dense_cost(size_t input_size, size_t output_size) {
+    return static_cast<float>(input_size * output_size) * kDenseWeightCost +
+           static_cast<float>(output_size) * kDenseRowCost;
+}
+
+float SparseOps::csr_cost(size_t nonzeros, size_t output_size) {
+    return static_cast<float>(nonzeros) * kCsrWeightCost +
+           static_cast<float>(output_size) * kCsrRowCost;
+}
+
+float SparseOps::crossover(size_t input_size, size_t output_size) {
+    const size_t count = input_size * output_size;
+    if (count == 0) {
+        return 0.0f;
+    }
+    // Non-zeros at which the two costs meet
+    const float nonzeros = (dense_cost(input_size, output_size) -
+                            static_cast<float>(output_size) * kCsrRowCost) / kCsrWeightCost;
+    const float density = nonzeros / static_cast<float>(count);
+    return (density < 0.0f) ? 0.0f : (density > 1.0f) ? 1.0f : density;
+}
+
+void SparseOps::dense_forward(const SparseDense& layer, const float* input, float* output) {
+    const bool relu = (layer.activation == ActivationType::ReLU);
+    for (size_t j = 0; j < layer.output_size; ++j) {
+        float acc = (layer.bias != nullptr) ? layer.bias[j] : 0.0f;
+        const size_t end = layer.row_start[j + 1];
+        for (size_t k = layer.row_start[j]; k < end; ++k) {
+            acc += layer.values[k] * input[static_cast<uint16_t>(layer.indices[k])];
+        }
+        output[j] = (relu && !(acc > 0.0f)) ? 0.0f : acc;
+    }
+}
+
+Layer* SparseOps::make_layer(
+    const float* weights,
+    const float* bias,
+    size_t input_size,
+    size_t output_size,
+    ActivationType activation
+) {
+    const size_t nonzeros = count_nonzero(weights, input_size * output_size);
+    if (prefer_sparse(input_size, output_size, nonzeros) && input_size <= kMaxInputSize &&
+        nonzeros <= kMaxNonZeros) {
+        return new SparseDenseLayer(weights, bias, input_size, output_size, activation);
+    }
+    return new DenseLayer(weights, bias, input_size, output_size, activation);
+}
+
+// ============================================================================
+// Layers
+// ============================================================================
+
+void SparseLayer::forward(const float* input, float* output) const {
+    SparseOps::dense_forward(params_, input, output);
+}
+
+SparseDenseLayer::SparseDenseLayer(
+    const float* weights,
+    const float* bias,
+    size_t input_size,
+    size_t output_size,
+    ActivationType activation
+) : values_(nullptr),
+    indices_(nullptr),
+    row_start_(new uint16_t[output_size + 1]()),
+    params_{nullptr, nullptr, row_start_, bias, input_size, output_size, activation},
+    valid_(false)
+{
+    const size_t nonzeros = SparseOps::count_nonzero(weights, input_size * output_size);
+    if (input_size > SparseOps::kMaxInputSize || nonzeros > SparseOps::kMaxNonZeros) {
+        return;
+    }
+
+    values_ = new float[nonzeros];
+    indices_ = new int16_t[nonzeros];
+    params_.values = values_;
+    params_.indices = indices_;
+
+    // Transpose to output-major rows, keeping only the non-zeros
+    size_t k = 0;
+    for (size_t j = 0; j < output_size; ++j) {
+        row_start_[j] = static_cast<uint16_t>(k);
+        for (size_t i = 0; i < input_size; ++i) {
+            const float w = weights[i * output_size + j];
+            if (w != 0.0f) {
+                values_[k] = w;
+                indices_[k] = static_cast<int16_t>(i);
+                ++k;
+            }
+        }
+    }
+    row_start_[output_size] = static_cast<uint16_t>(k);
+    valid_ = true;
+}
+
+SparseDenseLayer::~SparseDenseLayer() {
+    delete[] row_start_;
+    delete[] indices_;
+    delete[] values_;
+}
+
+SparseDenseLayer::SparseDenseLayer(SparseDenseLayer&& other) noexcept
+  : values_(other.values_),
+    indices_(other.indices_),
+    row_start_(other.row_start_),
+    params_(other.params_),
+    valid_(other.valid_)
+{
+    other.values_ = nullptr;
+    other.indices_ = nullptr;
+    other.row_start_ = nullptr;
+    other.valid_ = false;
+}
+
+void SparseDenseLayer::forward(const float* input, float* output) const {
+    if (!valid_) {
+        std::fill(output, output + params_.output_size, 0.0f);
+        return;
+    }
+    SparseOps::dense_forward(params_, input, output);
+}
+
+} // namespace CustomNN
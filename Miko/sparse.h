@@ -0,0 +1,235 @@
+/**
+ * Sparse (Pruned) Dense Layers
+ * CSR weights so that inference cost and flash size scale with the number
+ * of non-zero weights instead of input_size * output_size
+ *
+ * Each output neuron is one CSR row: its non-zero weights, the int16 input
+ * index of each, and a uint16 offset where the row starts. The kernel
+ * gathers input[index] per non-zero and adds the products in input order,
+ * so for finite inputs the result is bit-identical to the scalar dense
+ * kernel on the same (pruned) weights: the skipped terms are all +-0.
+ *
+ * Below a density crossover the gather loop beats the dense kernel; above
+ * it the dense kernel wins. The crossover depends on the layer's shape (on
+ * the host a 10 x 8 layer's per-row overhead dominates and CSR wins up to
+ * 30-50% density; from 64 x 64 up the SIMD dense kernel wins above 5-10%),
+ * so SparseOps::make_layer() compares the two kernels' costs for the
+ * shape and non-zero count, from per-target per-weight and per-row costs
+ * (the CUSTOMNN_SPARSE_*_COST macros below).
+ *
+ * Usage:
+ *   // Offline (host): prune and emit a constexpr CSR header
+ *   SparseOps::prune(w1, pruned, 10 * 8, 0.5f);
+ *   SparseDenseLayer l1(pruned, b1, 10, 8, ActivationType::ReLU);
+ *   // On the device: wrap the generated layers
+ *   SparseLayer l1(TEMP_LAYER1_SPARSE), l2(TEMP_LAYER2_SPARSE);
+ *   const Layer* layers[] = {&l1, &l2};
+ *   Sequential model(layers, 2, hidden, nullptr, 8);
+ *
+ * The generated headers (temp_model_weights_sparse.h,
+ * model_weights_sparse.h) come from tools/prune_weights; see `make prune`.
+ */
+
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include <cstddef>
+#include <cstdint>
+#include "neural_network.h"
+
+/**
+ * Kernel costs SparseOps::make_layer() compares, in any one unit:
+ *   dense: input_size * output_size * DENSE_WEIGHT + output_size * DENSE_ROW
+ *   CSR:   nonzeros * CSR_WEIGHT + output_size * CSR_ROW
+ * The host defaults are nanoseconds fitted by `pico_ml_tester sparse` to
+ * the AVX-512 packed kernel and the CSR kernel over 10 x 8 to 512 x 512
+ * layers (it prints the fit for the machine it runs on, and each shape's
+ * measured and modelled crossover). The RP2040 build sets its modelled
+ * soft-float cycles in Miko/CMakeLists.txt.
+ */
+#ifndef CUSTOMNN_SPARSE_DENSE_WEIGHT_COST
+#define CUSTOMNN_SPARSE_DENSE_WEIGHT_COST 0.03f
+#endif
+#ifndef CUSTOMNN_SPARSE_DENSE_ROW_COST
+#define CUSTOMNN_SPARSE_DENSE_ROW_COST 4.4f
+#endif
+#ifndef CUSTOMNN_SPARSE_CSR_WEIGHT_COST
+#define CUSTOMNN_SPARSE_CSR_WEIGHT_COST 0.6f
+#endif
+#ifndef CUSTOMNN_SPARSE_CSR_ROW_COST
+#define CUSTOMNN_SPARSE_CSR_ROW_COST 2.7f
+#endif
+
+namespace CustomNN {
+
+/**
+ * CSR dense layer as plain data, so it can be a constexpr in flash
+ *
+ * output[j] = act(bias[j] + sum_k(values[k] * input[indices[k]])),
+ * k in [row_start[j], row_start[j + 1])
+ */
+struct SparseDense {
+    const float* values;         // [nnz], row by row, increasing index within a row
+    const int16_t* indices;      // [nnz], input index of each value
+    const uint16_t* row_start;   // [output_size + 1], row_start[output_size] == nnz
+    const float* bias;           // [output_size]
+    size_t input_size;
+    size_t output_size;
+    ActivationType activation;   // ReLU is fused; Softmax is left to the caller
+};
+
+/**
+ * Pruning helpers and the CSR kernel
+ */
+class SparseOps {
+public:
+    // Limits of the int16 indices and uint16 row offsets
+    static constexpr size_t kMaxInputSize = 32768;
+    static constexpr size_t kMaxNonZeros = 65535;
+
+    // Per stored weight and per output row of each kernel (see above)
+    static constexpr float kDenseWeightCost = CUSTOMNN_SPARSE_DENSE_WEIGHT_COST;
+    static constexpr float kDenseRowCost = CUSTOMNN_SPARSE_DENSE_ROW_COST;
+    static constexpr float kCsrWeightCost = CUSTOMNN_SPARSE_CSR_WEIGHT_COST;
+    static constexpr float kCsrRowCost = CUSTOMNN_SPARSE_CSR_ROW_COST;
+
+    static size_t count_nonzero(const float* weights, size_t count);
+
+    /**
+     * Fraction of non-zero weights (1 for an empty matrix)
+     */
+    static float density(const float* weights, size_t count);
+
+    /**
+     * Magnitude pruning: copy weights, zeroing all but the
+     * round(density * count) largest magnitudes (earlier weights kept on
+     * ties). weights and pruned may alias.
+     * @param density Fraction of weights to keep, clamped to [0, 1]
+     * @return Number of non-zero weights left
+     */
+    static size_t prune(const float* weights, float* pruned, size_t count, float density);
+
+    /**
+     * Modelled cost of one forward pass of the dense kernel
+     */
+    static float dense_cost(size_t input_size, size_t output_size);
+
+    /**
+     * Modelled cost of one forward pass of the CSR kernel
+     */
+    static float csr_cost(size_t nonzeros, size_t output_size);
+
+    /**
+     * True if a layer of this shape with this many non-zeros runs faster
+     * as CSR
+     */
+    static bool prefer_sparse(size_t input_size, size_t output_size, size_t nonzeros) {
+        return csr_cost(nonzeros, output_size) < dense_cost(input_size, output_size);
+    }
+
+    /**
+     * Density below which prefer_sparse() holds for this shape, in [0, 1]
+     */
+    static float crossover(size_t input_size, size_t output_size);
+
+    /**
+     * Bytes of a CSR layer: values, indices, row offsets and bias
+     */
+    static size_t storage_bytes(size_t nonzeros, size_t output_size);
+
+    /**
+     * CSR dense layer forward pass
+     * @param input Input vector [layer.input_size]
+     * @param output Output vector [layer.output_size]
+     */
+    static void dense_forward(const SparseDense& layer, const float* input, float* output);
+
+    /**
+     * Dense layer in whichever form is cheaper for its shape and the
+     * weights' non-zeros: SparseDenseLayer when prefer_sparse() (and CSR
+     * can hold it), DenseLayer otherwise
+     * @param weights Weights [input_size][output_size], borrowed by the
+     *                DenseLayer form and copied by the CSR form
+     * @return New layer, owned by the caller (delete)
+     */
+    static Layer* make_layer(
+        const float* weights,
+        const float* bias,
+        size_t input_size,
+        size_t output_size,
+        ActivationType activation
+    );
+};
+
+/**
+ * Layer over borrowed CSR data (e.g. a generated constexpr in flash)
+ */
+class SparseLayer : public Layer {
+private:
+    const SparseDense& params_;
+
+public:
+    explicit SparseLayer(const SparseDense& params) : params_(params) {}
+
+    size_t input_size() const override { return params_.input_size; }
+    size_t output_size() const override { return params_.output_size; }
+    ActivationType activation() const override { return params_.activation; }
+
+    void forward(const float* input, float* output) const override;
+};
+
+/**
+ * Owning CSR conversion of a float dense layer
+ *
+ * Zero weights of [input_size][output_size] (the layout of the float weight
+ * headers) are dropped; prune first to make them zero. The layer is invalid
+ * (and outputs zeros) when input_size or the non-zero count exceed the
+ * index limits.
+ */
+class SparseDenseLayer : public Layer {
+private:
+    float* values_;
+    int16_t* indices_;
+    uint16_t* row_start_;
+    SparseDense params_;
+    bool valid_;
+
+public:
+    /**
+     * Constructor
+     * @param weights Weights as 1D array [input_size * output_size]
+     * @param bias Bias [output_size] (borrowed)
+     * @param input_size Layer input size
+     * @param output_size Layer output size
+     * @param activation Activation applied to the output
+     */
+    SparseDenseLayer(
+        const float* weights,
+        const float* bias,
+        size_t input_size,
+        size_t output_size,
+        ActivationType activation
+    );
+
+    ~SparseDenseLayer() override;
+
+    SparseDenseLayer(SparseDenseLayer&& other) noexcept;
+    SparseDenseLayer(const SparseDenseLayer&) = delete;
+    SparseDenseLayer& operator=(const SparseDenseLayer&) = delete;
+    SparseDenseLayer& operator=(SparseDenseLayer&&) = delete;
+
+    bool is_valid() const { return valid_; }
+
+    const SparseDense& params() const { return params_; }
+    size_t nonzeros() const { return params_.row_start[params_.output_size]; }
+
+    size_t input_size() const override { return params_.input_size; }
+    size_t output_size() const override { return params_.output_size; }
+    ActivationType activation() const override { return params_.activation; }
+
+    void forward(const float* input, float* output) const override;
+};
+
+} // namespace CustomNN
+
+#endif // SPARSE_H
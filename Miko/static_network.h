@@ -0,0 +1,226 @@
+/**
+ * Compile-time Specialized Neural Network
+ * Fully unrolled forward pass for models whose shapes and weights are
+ * known at compile time (e.g. the constexpr arrays in temp_model_weights.h)
+ *
+ * Usage:
+ *   using TempModel = StaticNetwork<
+ *       Dense<10, 8, ActivationType::ReLU, TEMP_LAYER1_WEIGHTS, TEMP_LAYER1_BIAS>,
+ *       Dense<8, 2, ActivationType::Softmax, TEMP_LAYER2_WEIGHTS, TEMP_LAYER2_BIAS>
+ *   >;
+ *   TempModel::predict(input, output);
+ *
+ * A two-class model can end in MarginDense<8, TEMP_LAYER2_WEIGHTS,
+ * TEMP_LAYER2_BIAS> instead, which outputs the single logit margin.
+ *
+ * Every multiply-add is expanded at compile time, the weights become
+ * immediate loads from flash and the hidden buffers are sized by the
+ * compiler, so the whole forward pass can be inlined into the caller.
+ * Results are bit-identical to the runtime Sequential/NeuralNetwork path
+ * running the scalar kernels (as on the RP2040).
+ *
+ * Full unrolling grows code size with input_size * output_size; use the
+ * runtime engine for large layers.
+ */
+
+#ifndef STATIC_NETWORK_H
+#define STATIC_NETWORK_H
+
+#include <cstddef>
+#include <utility>
+#include "neural_network.h"
+
+#if defined(__GNUC__)
+#define CUSTOMNN_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define CUSTOMNN_ALWAYS_INLINE inline
+#endif
+
+namespace CustomNN {
+
+/**
+ * Dense layer with compile-time shape, activation and weights
+ *
+ * @tparam In Input size
+ * @tparam Out Output size
+ * @tparam Act Activation applied to the output
+ * @tparam Weights Weight matrix [In][Out] with static storage
+ * @tparam Bias Bias vector [Out] with static storage
+ */
+template <size_t In, size_t Out, ActivationType Act,
+          const float (&Weights)[In][Out], const float (&Bias)[Out]>
+struct Dense {
+    static_assert(In > 0 && Out > 0, "Dense layer must have non-zero shape");
+
+    static constexpr size_t input_size = In;
+    static constexpr size_t output_size = Out;
+    static constexpr ActivationType activation = Act;
+
+    /**
+     * output = act(input * weights + bias)
+     * ReLU is applied in registers; Softmax is left to StaticNetwork.
+     */
+    static CUSTOMNN_ALWAYS_INLINE void forward(const float* input, float* output) {
+        forward_impl(input, output, std::make_index_sequence<Out>{});
+    }
+
+private:
+    // Same summation order as MatrixOps::dense_forward: start at the bias,
+    // then add the products in input order
+    template <size_t J, size_t... I>
+    static CUSTOMNN_ALWAYS_INLINE float neuron(const float* input, std::index_sequence<I...>) {
+        float acc = Bias[J];
+        ((acc += Weights[I][J] * input[I]), ...);
+
+        if constexpr (Act == ActivationType::ReLU) {
+            acc = (acc > 0.0f) ? acc : 0.0f;
+        }
+        return acc;
+    }
+
+    template <size_t... J>
+    static CUSTOMNN_ALWAYS_INLINE void forward_impl(const float* input, float* output,
+                                                    std::index_sequence<J...>) {
+        ((output[J] = neuron<J>(input, std::make_index_sequence<In>{})), ...);
+    }
+};
+
+/**
+ * Two-class output layer folded into its logit margin at compile time
+ * weights[i][0] = Weights[i][1] - Weights[i][0], bias[0] = Bias[1] - Bias[0]
+ * (see BinaryClassifier)
+ */
+template <size_t In, const float (&Weights)[In][2], const float (&Bias)[2],
+          typename Rows = std::make_index_sequence<In>>
+struct MarginFold;
+
+template <size_t In, const float (&Weights)[In][2], const float (&Bias)[2], size_t... I>
+struct MarginFold<In, Weights, Bias, std::index_sequence<I...>> {
+    static constexpr float weights[In][1] = {{Weights[I][1] - Weights[I][0]}...};
+    static constexpr float bias[1] = {Bias[1] - Bias[0]};
+};
+
+/**
+ * Dense layer computing the single logit margin z1 - z0 of a two-class
+ * output layer; use it in place of the final Dense to decide on
+ * margin > BinaryClassifier::margin_for(threshold)
+ */
+template <size_t In, const float (&Weights)[In][2], const float (&Bias)[2]>
+using MarginDense = Dense<In, 1, ActivationType::None,
+                          MarginFold<In, Weights, Bias>::weights,
+                          MarginFold<In, Weights, Bias>::bias>;
+
+/**
+ * Network built from a compile-time list of Dense layers
+ * Hidden activations ping-pong between two stack buffers whose size is the
+ * widest hidden layer, computed by the compiler.
+ */
+template <typename... Layers>
+class StaticNetwork {
+    static_assert(sizeof...(Layers) > 0, "StaticNetwork needs at least one layer");
+
+    template <typename First, typename... Rest>
+    struct Chain {
+        using Last = typename Chain<Rest...>::Last;
+        static constexpr size_t first_input = First::input_size;
+        static constexpr size_t max_hidden =
+            (First::output_size > Chain<Rest...>::max_hidden)
+                ? First::output_size : Chain<Rest...>::max_hidden;
+        static constexpr bool shapes_match =
+            (First::output_size == Chain<Rest...>::first_input) &&
+            Chain<Rest...>::shapes_match;
+    };
+
+    template <typename Only>
+    struct Chain<Only> {
+        using Last = Only;
+        static constexpr size_t first_input = Only::input_size;
+        static constexpr size_t max_hidden = 0;   // Final output is the caller's
+        static constexpr bool shapes_match = true;
+    };
+
+    using Info = Chain<Layers...>;
+
+    static_assert(Info::shapes_match,
+                  "Each layer's input_size must equal the previous layer's output_size");
+
+public:
+    static constexpr size_t num_layers = sizeof...(Layers);
+    static constexpr size_t input_size = Info::first_input;
+    static constexpr size_t output_size = Info::Last::output_size;
+
+    // Floats of stack scratch used by each of the two hidden buffers
+    static constexpr size_t scratch_size = (Info::max_hidden > 0) ? Info::max_hidden : 1;
+
+    /**
+     * Run inference on input data
+     * @param input Input vector [input_size]
+     * @param output Output vector [output_size]
+     */
+    static CUSTOMNN_ALWAYS_INLINE void predict(const float* input, float* output) {
+        float scratch_a[scratch_size];
+        float scratch_b[scratch_size];
+        run<0, true, Layers...>(input, output, scratch_a, scratch_b);
+    }
+
+    /**
+     * Run inference without the final layer's softmax
+     * @param input Input vector [input_size]
+     * @param output Raw logits [output_size]
+     */
+    static CUSTOMNN_ALWAYS_INLINE void predict_logits(const float* input, float* output) {
+        float scratch_a[scratch_size];
+        float scratch_b[scratch_size];
+        run<0, false, Layers...>(input, output, scratch_a, scratch_b);
+    }
+
+    /**
+     * Predicted class: argmax of the logits, no softmax
+     */
+    static CUSTOMNN_ALWAYS_INLINE int predict_class(const float* input) {
+        float logits[output_size];
+        predict_logits(input, logits);
+        return static_cast<int>(Classify::argmax(logits, output_size));
+    }
+
+    /**
+     * The k most likely classes, most likely first, ranked on the logits
+     * @param classes Output class indices [min(k, output_size)]
+     * @return Number of classes written, min(k, output_size)
+     */
+    static CUSTOMNN_ALWAYS_INLINE size_t predict_topk(const float* input, size_t k,
+                                                      size_t* classes) {
+        float logits[output_size];
+        predict_logits(input, logits);
+        return Classify::topk(logits, output_size, k, classes);
+    }
+
+private:
+    template <size_t Index, bool FinalSoftmax, typename L, typename... Rest>
+    static CUSTOMNN_ALWAYS_INLINE void run(const float* input, float* output,
+                                           float* scratch_a, float* scratch_b) {
+        if constexpr (sizeof...(Rest) == 0) {
+            L::forward(input, output);
+            if constexpr (FinalSoftmax) {
+                apply_softmax<L>(output);
+            }
+        } else {
+            // Even layers write A, odd layers write B
+            float* next = (Index % 2 == 0) ? scratch_a : scratch_b;
+            L::forward(input, next);
+            apply_softmax<L>(next);
+            run<Index + 1, FinalSoftmax, Rest...>(next, output, scratch_a, scratch_b);
+        }
+    }
+
+    template <typename L>
+    static CUSTOMNN_ALWAYS_INLINE void apply_softmax(float* data) {
+        if constexpr (L::activation == ActivationType::Softmax) {
+            Activation::softmax(data, L::output_size);
+        }
+    }
+};
+
+} // namespace CustomNN
+
+#endif // STATIC_NETWORK_H
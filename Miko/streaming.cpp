@@ -0,0 +1,251 @@
+/**
+ * Streaming Causal Inference Implementation
+ */
+
+#include "streaming.h"
+
+namespace CustomNN {
+
+namespace {
+
+/**
+ * Append one timestep to a doubled ring of `capacity` slots
+ * @return The newest `capacity` timesteps, oldest first
+ */
+const float* ring_push(StreamState& state, const float* input, size_t capacity,
+                       size_t channels) {
+    float* first = state.buffer + state.position * channels;
+    float* second = first + capacity * channels;
+    for (size_t c = 0; c < channels; ++c) {
+        first[c] = input[c];
+        second[c] = input[c];
+    }
+    state.position = (state.position + 1 == capacity) ? 0 : state.position + 1;
+    return state.buffer + state.position * channels;
+}
+
+/**
+ * Count an input for a layer that needs `span` inputs per output and
+ * produces one every `stride` inputs after that
+ * @return true if this input completes an output
+ */
+bool ready(StreamState& state, size_t span, size_t stride) {
+    if (state.filled < span) {
+        ++state.filled;
+        state.phase = 0;
+        return state.filled == span;
+    }
+    if (++state.phase < stride) {
+        return false;
+    }
+    state.phase = 0;
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// Layers
+// ============================================================================
+
+StreamingConv1DLayer::StreamingConv1DLayer(const Conv1D& params)
+    : params_(params), span_(0)
+{
+    if (params.kernel_size > 0 && params.stride > 0 && params.dilation > 0 &&
+        params.in_channels > 0 && params.out_channels > 0 && params.weights != nullptr) {
+        span_ = params.dilation * (params.kernel_size - 1) + 1;
+    }
+}
+
+bool StreamingConv1DLayer::push(const float* input, float* output, StreamState& state) const {
+    const size_t in_ch = params_.in_channels;
+    const size_t out_ch = params_.out_channels;
+    const float* window = ring_push(state, input, span_, in_ch);
+    if (!ready(state, span_, params_.stride)) {
+        return false;
+    }
+
+    // The newest output position of ConvOps::conv1d_forward, same order
+    const size_t tap_stride = params_.dilation * in_ch;
+    const bool relu = (params_.activation == ActivationType::ReLU);
+    for (size_t o = 0; o < out_ch; ++o) {
+        float acc = (params_.bias != nullptr) ? params_.bias[o] : 0.0f;
+        const float* w = params_.weights + o;
+        const float* tap = window;
+        for (size_t k = 0; k < params_.kernel_size; ++k, tap += tap_stride) {
+            for (size_t c = 0; c < in_ch; ++c, w += out_ch) {
+                acc += tap[c] * *w;
+            }
+        }
+        output[o] = (relu && !(acc > 0.0f)) ? 0.0f : acc;
+    }
+    return true;
+}
+
+bool StreamingMaxPool1DLayer::push(const float* input, float* output, StreamState& state) const {
+    const float* window = ring_push(state, input, pool_size_, channels_);
+    if (!ready(state, pool_size_, stride_)) {
+        return false;
+    }
+    for (size_t c = 0; c < channels_; ++c) {
+        output[c] = window[c];
+    }
+    for (size_t k = 1; k < pool_size_; ++k) {
+        const float* row = window + k * channels_;
+        for (size_t c = 0; c < channels_; ++c) {
+            output[c] = (row[c] > output[c]) ? row[c] : output[c];
+        }
+    }
+    return true;
+}
+
+bool StreamingAverageLayer::push(const float* input, float* output, StreamState& state) const {
+    float* sum = state.buffer + 2 * length_ * channels_;
+    const bool full = (state.filled == length_);
+    if (full) {
+        const float* oldest = state.buffer + state.position * channels_;
+        for (size_t c = 0; c < channels_; ++c) {
+            sum[c] -= oldest[c];
+        }
+    }
+    const float* window = ring_push(state, input, length_, channels_);
+    for (size_t c = 0; c < channels_; ++c) {
+        sum[c] += input[c];
+    }
+    if (!full) {
+        // Warming up: the sum so far was accumulated oldest first already
+        ++state.filled;
+        state.phase = 0;
+        if (state.filled < length_) {
+            return false;
+        }
+    } else if (++state.phase == length_) {
+        // Resync once per window length, oldest first as GlobalAveragePool sums
+        state.phase = 0;
+        for (size_t c = 0; c < channels_; ++c) {
+            sum[c] = 0.0f;
+        }
+        for (size_t t = 0; t < length_; ++t) {
+            const float* row = window + t * channels_;
+            for (size_t c = 0; c < channels_; ++c) {
+                sum[c] += row[c];
+            }
+        }
+    }
+
+    const float scale = 1.0f / static_cast<float>(length_);
+    for (size_t c = 0; c < channels_; ++c) {
+        output[c] = sum[c] * scale;
+    }
+    return true;
+}
+
+bool StreamingPointwiseLayer::push(const float* input, float* output, StreamState&) const {
+    layer_.forward(input, output);
+    if (layer_.activation() == ActivationType::Softmax) {
+        Activation::softmax(output, layer_.output_size());
+    }
+    return true;
+}
+
+// ============================================================================
+// StreamingSequential
+// ============================================================================
+
+StreamingSequential::StreamingSequential(const StreamingLayer* const* layers, size_t num_layers)
+    : layers_(layers),
+      num_layers_(num_layers),
+      states_(nullptr),
+      buffer_(nullptr),
+      buffer_size_(0),
+      work_a_(nullptr),
+      work_b_(nullptr),
+      valid_(false)
+{
+    if (layers == nullptr || num_layers == 0) {
+        return;
+    }
+    size_t widest = 0;
+    size_t state_total = 0;
+    for (size_t i = 0; i < num_layers; ++i) {
+        if (layers[i] == nullptr || !layers[i]->valid() || layers[i]->input_channels() == 0 ||
+            layers[i]->output_channels() == 0 ||
+            (i > 0 && layers[i]->input_channels() != layers[i - 1]->output_channels())) {
+            return;
+        }
+        widest = (layers[i]->output_channels() > widest) ? layers[i]->output_channels() : widest;
+        state_total += layers[i]->state_size();
+    }
+
+    buffer_size_ = state_total + 2 * widest;
+    buffer_ = new float[buffer_size_];
+    states_ = new StreamState[num_layers];
+    float* next = buffer_;
+    for (size_t i = 0; i < num_layers; ++i) {
+        states_[i].buffer = next;
+        next += layers[i]->state_size();
+    }
+    work_a_ = next;
+    work_b_ = next + widest;
+    reset();
+    valid_ = true;
+}
+
+StreamingSequential::~StreamingSequential() {
+    delete[] states_;
+    delete[] buffer_;
+}
+
+StreamingSequential::StreamingSequential(StreamingSequential&& other) noexcept
+    : layers_(other.layers_),
+      num_layers_(other.num_layers_),
+      states_(other.states_),
+      buffer_(other.buffer_),
+      buffer_size_(other.buffer_size_),
+      work_a_(other.work_a_),
+      work_b_(other.work_b_),
+      valid_(other.valid_)
+{
+    other.states_ = nullptr;
+    other.buffer_ = nullptr;
+    other.buffer_size_ = 0;
+    other.work_a_ = nullptr;
+    other.work_b_ = nullptr;
+    other.valid_ = false;
+}
+
+size_t StreamingSequential::input_channels() const {
+    return valid_ ? layers_[0]->input_channels() : 0;
+}
+
+size_t StreamingSequential::output_channels() const {
+    return valid_ ? layers_[num_layers_ - 1]->output_channels() : 0;
+}
+
+void StreamingSequential::reset() {
+    for (size_t k = 0; k < buffer_size_; ++k) {
+        buffer_[k] = 0.0f;
+    }
+    for (size_t i = 0; i < num_layers_ && states_ != nullptr; ++i) {
+        states_[i].position = 0;
+        states_[i].filled = 0;
+        states_[i].phase = 0;
+    }
+}
+
+bool StreamingSequential::push(const float* input, float* output) {
+    if (!valid_) {
+        return false;
+    }
+    const float* current = input;
+    for (size_t i = 0; i < num_layers_; ++i) {
+        float* out = (i + 1 == num_layers_) ? output : ((i % 2 == 0) ? work_a_ : work_b_);
+        if (!layers_[i]->push(current, out, states_[i])) {
+            return false;   // Nothing new for the layers after this one
+        }
+        current = out;
+    }
+    return true;
+}
+
+} // namespace CustomNN
@@ -0,0 +1,239 @@
+/**
+ * Streaming Causal Inference
+ * Runs temporal models one new sample at a time instead of per window
+ *
+ * A windowed model recomputes everything over the whole window each time
+ * one sample arrives, although all but the newest output position were
+ * already computed for the previous sample. StreamingSequential keeps, per
+ * layer, a ring buffer of the last few activations that layer needs and
+ * computes only the newest output timestep:
+ *
+ *   StreamingConv1DLayer     causal Conv1D (kernel, dilation, stride); keeps
+ *                            the last dilation * (kernel - 1) + 1 inputs
+ *   StreamingMaxPool1DLayer  keeps the last pool_size inputs
+ *   StreamingAverageLayer    mean of the last `length` inputs: the streaming
+ *                            GlobalAveragePool of a window, as a running sum
+ *   StreamingPointwiseLayer  any Layer applied to each timestep on its own
+ *                            (e.g. the Dense head), no state
+ *
+ * Per sample the cost is O(layers * kernel * channels) rather than
+ * O(window): a stack of dilated convolutions (dilation 1, 2, 4, ...) sees a
+ * context that doubles per layer at constant cost per sample. The outputs
+ * are the newest positions of the same layers run ("valid", no padding)
+ * over the whole input history, so after warm-up each push() matches the
+ * windowed model on the window ending at that sample (exactly for convs
+ * and pools; the running average only up to rounding).
+ *
+ * Ring buffers are stored twice over ([2][capacity][channels]): every
+ * sample is written to both halves, so the last `capacity` samples are
+ * always contiguous, oldest first, and taps are plain pointer offsets
+ * with no modulo in the inner loop.
+ *
+ * The layers are const and hold no state, so one set can serve several
+ * streams (e.g. several sensors), each with its own StreamingSequential.
+ *
+ * Usage (the Dense temperature model is a causal Conv1D with 10 taps):
+ *   const Conv1D c1 = {&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, 0, 1, 8, 10, 1, 1,
+ *                      ActivationType::ReLU};
+ *   StreamingConv1DLayer conv(c1);
+ *   DenseLayer dense2(&TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS, 8, 2,
+ *                     ActivationType::Softmax);
+ *   StreamingPointwiseLayer head(dense2);
+ *   const StreamingLayer* layers[] = {&conv, &head};
+ *   StreamingSequential stream(layers, 2);
+ *   // Every sample:
+ *   float probs[2];
+ *   if (stream.push(&temperature, probs)) { ... }   // false while warming up
+ */
+
+#ifndef STREAMING_H
+#define STREAMING_H
+
+#include <cstddef>
+#include "conv1d.h"
+#include "neural_network.h"
+
+namespace CustomNN {
+
+/**
+ * Per-stream state of one layer, owned by StreamingSequential
+ */
+struct StreamState {
+    float* buffer;     // The layer's state_size() floats
+    size_t position;   // Ring slot the next input goes to
+    size_t filled;     // Inputs seen, saturating at what the layer needs
+    size_t phase;      // Inputs since the last output, for strides
+};
+
+/**
+ * A causal layer that consumes one timestep of channels at a time
+ */
+class StreamingLayer {
+public:
+    virtual ~StreamingLayer() = default;
+
+    /**
+     * False if the parameters cannot run (StreamingSequential refuses it)
+     */
+    virtual bool valid() const { return true; }
+
+    virtual size_t input_channels() const = 0;
+    virtual size_t output_channels() const = 0;
+
+    /**
+     * Floats of state per stream
+     */
+    virtual size_t state_size() const = 0;
+
+    /**
+     * Consume one input timestep
+     * @param input Input [input_channels()]
+     * @param output Output [output_channels()], written only on true
+     * @return true if a new output timestep was produced (false while the
+     *         layer is warming up or between strided outputs)
+     */
+    virtual bool push(const float* input, float* output, StreamState& state) const = 0;
+};
+
+/**
+ * Causal Conv1D: each output is the convolution of the newest
+ * dilation * (kernel_size - 1) + 1 inputs (input_length is not used)
+ */
+class StreamingConv1DLayer : public StreamingLayer {
+private:
+    Conv1D params_;
+    size_t span_;   // Inputs one output depends on
+
+public:
+    explicit StreamingConv1DLayer(const Conv1D& params);
+
+    bool valid() const override { return span_ > 0; }
+    size_t span() const { return span_; }
+
+    size_t input_channels() const override { return params_.in_channels; }
+    size_t output_channels() const override { return params_.out_channels; }
+    size_t state_size() const override { return 2 * span_ * params_.in_channels; }
+
+    bool push(const float* input, float* output, StreamState& state) const override;
+};
+
+/**
+ * MaxPool1D over the newest pool_size inputs, one output every stride
+ * inputs (stride defaults to pool_size, as in MaxPool1DLayer)
+ */
+class StreamingMaxPool1DLayer : public StreamingLayer {
+private:
+    size_t channels_;
+    size_t pool_size_;
+    size_t stride_;
+
+public:
+    StreamingMaxPool1DLayer(size_t channels, size_t pool_size, size_t stride = 0)
+        : channels_(channels), pool_size_(pool_size),
+          stride_((stride == 0) ? pool_size : stride) {}
+
+    bool valid() const override { return channels_ > 0 && pool_size_ > 0 && stride_ > 0; }
+
+    size_t input_channels() const override { return channels_; }
+    size_t output_channels() const override { return channels_; }
+    size_t state_size() const override { return 2 * pool_size_ * channels_; }
+
+    bool push(const float* input, float* output, StreamState& state) const override;
+};
+
+/**
+ * Mean per channel of the newest `length` inputs, updated every input
+ *
+ * A running sum: add the newest, subtract the one leaving the window. The
+ * sum is recomputed from the ring every `length` inputs so rounding does
+ * not build up over a long stream.
+ */
+class StreamingAverageLayer : public StreamingLayer {
+private:
+    size_t length_;
+    size_t channels_;
+
+public:
+    StreamingAverageLayer(size_t length, size_t channels)
+        : length_(length), channels_(channels) {}
+
+    bool valid() const override { return length_ > 0 && channels_ > 0; }
+
+    size_t input_channels() const override { return channels_; }
+    size_t output_channels() const override { return channels_; }
+    size_t state_size() const override { return 2 * length_ * channels_ + channels_; }
+
+    bool push(const float* input, float* output, StreamState& state) const override;
+};
+
+/**
+ * A Layer applied to every timestep on its own (borrowed; its Softmax, if
+ * any, is applied here)
+ */
+class StreamingPointwiseLayer : public StreamingLayer {
+private:
+    const Layer& layer_;
+
+public:
+    explicit StreamingPointwiseLayer(const Layer& layer) : layer_(layer) {}
+
+    size_t input_channels() const override { return layer_.input_size(); }
+    size_t output_channels() const override { return layer_.output_size(); }
+    size_t state_size() const override { return 0; }
+
+    bool push(const float* input, float* output, StreamState& state) const override;
+};
+
+/**
+ * A chain of streaming layers with its own state (one stream)
+ */
+class StreamingSequential {
+private:
+    const StreamingLayer* const* layers_;
+    size_t num_layers_;
+    StreamState* states_;   // Owned: [num_layers_]
+    float* buffer_;         // Owned: every layer's state, then two work vectors
+    size_t buffer_size_;
+    float* work_a_;
+    float* work_b_;
+    bool valid_;
+
+public:
+    /**
+     * @param layers Array of layer pointers [num_layers] (borrowed)
+     * An invalid chain (channels do not match) gives an invalid model.
+     */
+    StreamingSequential(const StreamingLayer* const* layers, size_t num_layers);
+    ~StreamingSequential();
+
+    StreamingSequential(StreamingSequential&& other) noexcept;
+    StreamingSequential(const StreamingSequential&) = delete;
+    StreamingSequential& operator=(const StreamingSequential&) = delete;
+
+    bool is_valid() const { return valid_; }
+
+    size_t input_channels() const;
+    size_t output_channels() const;
+
+    /**
+     * Bytes of per-stream state (ring buffers, running sums, work vectors)
+     */
+    size_t state_bytes() const { return buffer_size_ * sizeof(float); }
+
+    /**
+     * Forget all history; the next outputs come after a new warm-up
+     */
+    void reset();
+
+    /**
+     * Feed one input timestep through every layer
+     * @param input Input [input_channels()]
+     * @param output Output [output_channels()], written only on true
+     * @return true if the last layer produced an output
+     */
+    bool push(const float* input, float* output);
+};
+
+} // namespace CustomNN
+
+#endif // STREAMING_H
@@ -0,0 +1,86 @@
+// Weight-clustered (codebook) weights for temp_model_weights.h
+// Generated by tools/cluster_weights (make cluster)
+// DO NOT EDIT MANUALLY
+//
+// 16-entry k-means codebook per layer, 4-bit indices packed two per
+// byte (even input in the low nibble), output-major rows.
+
+#ifndef TEMP_MODEL_WEIGHTS_CODEBOOK_H
+#define TEMP_MODEL_WEIGHTS_CODEBOOK_H
+
+#include <cstdint>
+#include "codebook.h"
+
+// Layer 1: Dense(8, ReLU), 4-bit indices [8][10]
+constexpr uint8_t TEMP_LAYER1_CB_INDICES[40] = {
+    0x49, 0x5C, 0x6D, 0x2A, 0x5E,
+    0xD0, 0xF5, 0xC3, 0xA1, 0xB6,
+    0x7B, 0x6E, 0x1A, 0x38, 0x5C,
+    0xF7, 0xC3, 0xA0, 0xD2, 0xD4,
+    0x5F, 0x18, 0x78, 0x5E, 0x2A,
+    0xD2, 0x91, 0xF4, 0x85, 0x81,
+    0x78, 0x3A, 0x4D, 0x08, 0x49,
+    0xC0, 0xE7, 0xB5, 0xA1, 0xD3
+};
+
+constexpr float TEMP_LAYER1_CB_CODEBOOK[16] = {
+    -2.224999964e-01f, -2.049999982e-01f, -1.899999976e-01f, -1.800000072e-01f,
+    -1.700000018e-01f, -1.550000012e-01f, -1.400000006e-01f, -1.239999980e-01f,
+    1.357142776e-01f, 1.500000060e-01f, 1.642857194e-01f, 1.800000072e-01f,
+    1.899999976e-01f, 2.057142854e-01f, 2.199999988e-01f, 2.399999946e-01f
+};
+
+constexpr int32_t TEMP_LAYER1_CB_CODEBOOK_Q16[16] = {
+    -14582, -13435, -12452, -11796, -11141, -10158, -9175, -8126,
+    8894, 9830, 10767, 11796, 12452, 13482, 14418, 15729
+};
+
+constexpr float TEMP_LAYER1_CB_BIAS[8] = {
+    2.538010180e-01f, 2.085667662e-02f, -2.559239864e-01f, 1.795075536e-01f, 1.268090755e-01f, -2.672932744e-01f, 1.431891918e-01f, -1.211156845e-01f
+};
+
+constexpr int32_t TEMP_LAYER1_CB_BIAS_Q16[8] = {
+    16633, 1367, -16772, 11764, 8311, -17517, 9384, -7937
+};
+
+constexpr CustomNN::CodebookDense TEMP_LAYER1_CB = {
+    TEMP_LAYER1_CB_INDICES, TEMP_LAYER1_CB_CODEBOOK, TEMP_LAYER1_CB_CODEBOOK_Q16,
+    TEMP_LAYER1_CB_BIAS, TEMP_LAYER1_CB_BIAS_Q16,
+    10, 8,
+    CustomNN::ActivationType::ReLU
+};
+
+// Layer 2: Dense(2, Softmax), 4-bit indices [2][8]
+constexpr uint8_t TEMP_LAYER2_CB_INDICES[8] = {
+    0x08, 0x2B, 0x3A, 0x6E,
+    0xF7, 0xD4, 0xC5, 0x91
+};
+
+constexpr float TEMP_LAYER2_CB_CODEBOOK[16] = {
+    -4.199999869e-01f, -4.099999964e-01f, -4.000000060e-01f, -3.899999857e-01f,
+    -3.799999952e-01f, -3.700000048e-01f, -3.600000143e-01f, -3.499999940e-01f,
+    3.499999940e-01f, 3.600000143e-01f, 3.700000048e-01f, 3.799999952e-01f,
+    3.899999857e-01f, 4.000000060e-01f, 4.099999964e-01f, 4.199999869e-01f
+};
+
+constexpr int32_t TEMP_LAYER2_CB_CODEBOOK_Q16[16] = {
+    -27525, -26870, -26214, -25559, -24904, -24248, -23593, -22938,
+    22938, 23593, 24248, 24904, 25559, 26214, 26870, 27525
+};
+
+constexpr float TEMP_LAYER2_CB_BIAS[2] = {
+    1.000000015e-01f, -1.000000015e-01f
+};
+
+constexpr int32_t TEMP_LAYER2_CB_BIAS_Q16[2] = {
+    6554, -6554
+};
+
+constexpr CustomNN::CodebookDense TEMP_LAYER2_CB = {
+    TEMP_LAYER2_CB_INDICES, TEMP_LAYER2_CB_CODEBOOK, TEMP_LAYER2_CB_CODEBOOK_Q16,
+    TEMP_LAYER2_CB_BIAS, TEMP_LAYER2_CB_BIAS_Q16,
+    8, 2,
+    CustomNN::ActivationType::Softmax
+};
+
+#endif // TEMP_MODEL_WEIGHTS_CODEBOOK_H
@@ -0,0 +1,76 @@
+// Model file for temp_model_weights.h (CNNM v1.0, F32 weights, 960 bytes)
+// Generated by tools/export_model (make export)
+// DO NOT EDIT MANUALLY
+//
+// Byte for byte the .cnnm file, so it can be used from flash with
+// ModelFile::attach(TEMP_MODEL_FILE, sizeof(TEMP_MODEL_FILE)).
+
+#ifndef TEMP_MODEL_WEIGHTS_FILE_H
+#define TEMP_MODEL_WEIGHTS_FILE_H
+
+#include <cstdint>
+
+alignas(64) constexpr uint8_t TEMP_MODEL_FILE[960] = {
+    0x43, 0x4E, 0x4E, 0x4D, 0x01, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x00, 0x00, 0x0A, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xC0, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x01, 0x01, 0x0A, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00,
+    0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xC0, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x01, 0x02, 0x08, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00,
+    0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x80, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x9A, 0x99, 0x19, 0x3E, 0x7B, 0x14, 0x2E, 0xBE, 0x5C, 0x8F, 0x42, 0x3E, 0x0A, 0xD7, 0x23, 0xBE,
+    0x3D, 0x0A, 0x57, 0x3E, 0x29, 0x5C, 0x0F, 0xBE, 0x7B, 0x14, 0x2E, 0x3E, 0x5C, 0x8F, 0x42, 0xBE,
+    0xAE, 0x47, 0x61, 0x3E, 0x9A, 0x99, 0x19, 0xBE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xAE, 0x47, 0x61, 0xBE, 0x3D, 0x0A, 0x57, 0x3E, 0x9A, 0x99, 0x19, 0xBE, 0x1F, 0x85, 0x6B, 0x3E,
+    0xEC, 0x51, 0x38, 0xBE, 0x5C, 0x8F, 0x42, 0x3E, 0xCD, 0xCC, 0x4C, 0xBE, 0x0A, 0xD7, 0x23, 0x3E,
+    0x29, 0x5C, 0x0F, 0xBE, 0xEC, 0x51, 0x38, 0x3E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xEC, 0x51, 0x38, 0x3E, 0xB8, 0x1E, 0x05, 0xBE, 0xAE, 0x47, 0x61, 0x3E, 0x29, 0x5C, 0x0F, 0xBE,
+    0x0A, 0xD7, 0x23, 0x3E, 0x3D, 0x0A, 0x57, 0xBE, 0x29, 0x5C, 0x0F, 0x3E, 0xEC, 0x51, 0x38, 0xBE,
+    0x5C, 0x8F, 0x42, 0x3E, 0x0A, 0xD7, 0x23, 0xBE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xAE, 0x47, 0xE1, 0xBD, 0x8F, 0xC2, 0x75, 0x3E, 0xEC, 0x51, 0x38, 0xBE, 0x5C, 0x8F, 0x42, 0x3E,
+    0xAE, 0x47, 0x61, 0xBE, 0x0A, 0xD7, 0x23, 0x3E, 0x5C, 0x8F, 0x42, 0xBE, 0x3D, 0x0A, 0x57, 0x3E,
+    0x7B, 0x14, 0x2E, 0xBE, 0xCD, 0xCC, 0x4C, 0x3E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x80, 0x3E, 0x0A, 0xD7, 0x23, 0xBE, 0x29, 0x5C, 0x0F, 0x3E, 0xCD, 0xCC, 0x4C, 0xBE,
+    0xB8, 0x1E, 0x05, 0x3E, 0xB8, 0x1E, 0x05, 0xBE, 0xAE, 0x47, 0x61, 0x3E, 0x9A, 0x99, 0x19, 0xBE,
+    0x0A, 0xD7, 0x23, 0x3E, 0x5C, 0x8F, 0x42, 0xBE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x5C, 0x8F, 0x42, 0xBE, 0xCD, 0xCC, 0x4C, 0x3E, 0x3D, 0x0A, 0x57, 0xBE, 0x9A, 0x99, 0x19, 0x3E,
+    0x7B, 0x14, 0x2E, 0xBE, 0x8F, 0xC2, 0x75, 0x3E, 0x0A, 0xD7, 0x23, 0xBE, 0x29, 0x5C, 0x0F, 0x3E,
+    0xCD, 0xCC, 0x4C, 0xBE, 0xB8, 0x1E, 0x05, 0x3E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x29, 0x5C, 0x0F, 0x3E, 0x8F, 0xC2, 0xF5, 0xBD, 0x7B, 0x14, 0x2E, 0x3E, 0xEC, 0x51, 0x38, 0xBE,
+    0xCD, 0xCC, 0x4C, 0x3E, 0x7B, 0x14, 0x2E, 0xBE, 0xB8, 0x1E, 0x05, 0x3E, 0xAE, 0x47, 0x61, 0xBE,
+    0x9A, 0x99, 0x19, 0x3E, 0x7B, 0x14, 0x2E, 0xBE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x1F, 0x85, 0x6B, 0xBE, 0x5C, 0x8F, 0x42, 0x3E, 0xB8, 0x1E, 0x05, 0xBE, 0xAE, 0x47, 0x61, 0x3E,
+    0x9A, 0x99, 0x19, 0xBE, 0xEC, 0x51, 0x38, 0x3E, 0x3D, 0x0A, 0x57, 0xBE, 0x7B, 0x14, 0x2E, 0x3E,
+    0xEC, 0x51, 0x38, 0xBE, 0x3D, 0x0A, 0x57, 0x3E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xCD, 0xCC, 0x4C, 0x3D, 0x8F, 0xC2, 0xF5, 0xBC, 0x29, 0x5C, 0x8F, 0x3D, 0x0A, 0xD7, 0x23, 0xBD,
+    0x8F, 0xC2, 0x75, 0x3D, 0x0A, 0xD7, 0xA3, 0xBC, 0x0A, 0xD7, 0x23, 0x3D, 0xCD, 0xCC, 0x4C, 0xBD,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x33, 0x33, 0xB3, 0x3E, 0x3D, 0x0A, 0xD7, 0xBE, 0x5C, 0x8F, 0xC2, 0x3E, 0xCD, 0xCC, 0xCC, 0xBE,
+    0xA4, 0x70, 0xBD, 0x3E, 0x14, 0xAE, 0xC7, 0xBE, 0x85, 0xEB, 0xD1, 0x3E, 0xEC, 0x51, 0xB8, 0xBE,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x33, 0x33, 0xB3, 0xBE, 0x3D, 0x0A, 0xD7, 0x3E, 0x5C, 0x8F, 0xC2, 0xBE, 0xCD, 0xCC, 0xCC, 0x3E,
+    0xA4, 0x70, 0xBD, 0xBE, 0x14, 0xAE, 0xC7, 0x3E, 0x85, 0xEB, 0xD1, 0xBE, 0xEC, 0x51, 0xB8, 0x3E,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xCD, 0xCC, 0xCC, 0x3D, 0xCD, 0xCC, 0xCC, 0xBD, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+#endif // TEMP_MODEL_WEIGHTS_FILE_H
@@ -0,0 +1,84 @@
+// Half-precision weights for temp_model_weights.h
+// Generated by tools/half_weights (make half)
+// DO NOT EDIT MANUALLY
+//
+// Each layer in fp16 (_FP16) and bf16 (_BF16), rounded to nearest even;
+// unused arrays are dropped by the linker. Biases stay float.
+
+#ifndef TEMP_MODEL_WEIGHTS_HALF_H
+#define TEMP_MODEL_WEIGHTS_HALF_H
+
+#include <cstdint>
+#include "half.h"
+
+// Layer 1: Dense(8, ReLU), weights [10][8]
+constexpr uint16_t TEMP_LAYER1_FP16_WEIGHTS[80] = {
+    0x30CD, 0xB30A, 0x31C3, 0xAF0A, 0x3400, 0xB214, 0x307B, 0xB35C, 0xB171, 0x32B8,
+    0xB029, 0x33AE, 0xB11F, 0x3266, 0xAFAE, 0x3214, 0x3214, 0xB0CD, 0x330A, 0xB1C3,
+    0x307B, 0xB2B8, 0x3171, 0xB029, 0xB11F, 0x335C, 0xB07B, 0x3214, 0xB266, 0x30CD,
+    0xB1C3, 0x330A, 0x32B8, 0xB1C3, 0x311F, 0xB30A, 0x3029, 0xB171, 0x3266, 0xB0CD,
+    0xB07B, 0x3214, 0xB2B8, 0x311F, 0xB029, 0x33AE, 0xB171, 0x31C3, 0x3171, 0xB266,
+    0x307B, 0xB214, 0x330A, 0xB11F, 0x3029, 0xB2B8, 0xB214, 0x311F, 0xB1C3, 0x32B8,
+    0xB0CD, 0x307B, 0xB30A, 0x3171, 0x330A, 0xB07B, 0x3214, 0xB171, 0x311F, 0xB266,
+    0x30CD, 0xB1C3, 0xB0CD, 0x31C3, 0xB11F, 0x3266, 0xB214, 0x3029, 0xB171, 0x32B8
+};
+
+constexpr uint16_t TEMP_LAYER1_BF16_WEIGHTS[80] = {
+    0x3E1A, 0xBE61, 0x3E38, 0xBDE1, 0x3E80, 0xBE43, 0x3E0F, 0xBE6C, 0xBE2E, 0x3E57,
+    0xBE05, 0x3E76, 0xBE24, 0x3E4D, 0xBDF6, 0x3E43, 0x3E43, 0xBE1A, 0x3E61, 0xBE38,
+    0x3E0F, 0xBE57, 0x3E2E, 0xBE05, 0xBE24, 0x3E6C, 0xBE0F, 0x3E43, 0xBE4D, 0x3E1A,
+    0xBE38, 0x3E61, 0x3E57, 0xBE38, 0x3E24, 0xBE61, 0x3E05, 0xBE2E, 0x3E4D, 0xBE1A,
+    0xBE0F, 0x3E43, 0xBE57, 0x3E24, 0xBE05, 0x3E76, 0xBE2E, 0x3E38, 0x3E2E, 0xBE4D,
+    0x3E0F, 0xBE43, 0x3E61, 0xBE24, 0x3E05, 0xBE57, 0xBE43, 0x3E24, 0xBE38, 0x3E57,
+    0xBE1A, 0x3E0F, 0xBE61, 0x3E2E, 0x3E61, 0xBE0F, 0x3E43, 0xBE2E, 0x3E24, 0xBE4D,
+    0x3E1A, 0xBE38, 0xBE1A, 0x3E38, 0xBE24, 0x3E4D, 0xBE43, 0x3E05, 0xBE2E, 0x3E57
+};
+
+constexpr float TEMP_LAYER1_HALF_BIAS[8] = {
+    5.000000075e-02f, -2.999999933e-02f, 7.000000030e-02f, -3.999999911e-02f, 5.999999866e-02f, -1.999999955e-02f, 3.999999911e-02f, -5.000000075e-02f
+};
+
+constexpr CustomNN::HalfDense TEMP_LAYER1_FP16 = {
+    TEMP_LAYER1_FP16_WEIGHTS, TEMP_LAYER1_HALF_BIAS,
+    10, 8,
+    CustomNN::HalfFormat::FP16,
+    CustomNN::ActivationType::ReLU
+};
+
+constexpr CustomNN::HalfDense TEMP_LAYER1_BF16 = {
+    TEMP_LAYER1_BF16_WEIGHTS, TEMP_LAYER1_HALF_BIAS,
+    10, 8,
+    CustomNN::HalfFormat::BF16,
+    CustomNN::ActivationType::ReLU
+};
+
+// Layer 2: Dense(2, Softmax), weights [8][2]
+constexpr uint16_t TEMP_LAYER2_FP16_WEIGHTS[16] = {
+    0x359A, 0xB59A, 0xB6B8, 0x36B8, 0x3614, 0xB614, 0xB666, 0x3666, 0x35EC, 0xB5EC,
+    0xB63D, 0x363D, 0x368F, 0xB68F, 0xB5C3, 0x35C3
+};
+
+constexpr uint16_t TEMP_LAYER2_BF16_WEIGHTS[16] = {
+    0x3EB3, 0xBEB3, 0xBED7, 0x3ED7, 0x3EC3, 0xBEC3, 0xBECD, 0x3ECD, 0x3EBD, 0xBEBD,
+    0xBEC8, 0x3EC8, 0x3ED2, 0xBED2, 0xBEB8, 0x3EB8
+};
+
+constexpr float TEMP_LAYER2_HALF_BIAS[2] = {
+    1.000000015e-01f, -1.000000015e-01f
+};
+
+constexpr CustomNN::HalfDense TEMP_LAYER2_FP16 = {
+    TEMP_LAYER2_FP16_WEIGHTS, TEMP_LAYER2_HALF_BIAS,
+    8, 2,
+    CustomNN::HalfFormat::FP16,
+    CustomNN::ActivationType::Softmax
+};
+
+constexpr CustomNN::HalfDense TEMP_LAYER2_BF16 = {
+    TEMP_LAYER2_BF16_WEIGHTS, TEMP_LAYER2_HALF_BIAS,
+    8, 2,
+    CustomNN::HalfFormat::BF16,
+    CustomNN::ActivationType::Softmax
+};
+
+#endif // TEMP_MODEL_WEIGHTS_HALF_H
@@ -0,0 +1,73 @@
+// Int8 quantized weights for temp_model_weights.h
+// Generated by tools/quantize_weights (make quantize)
+// DO NOT EDIT MANUALLY
+//
+// Symmetric per-channel int8 weights, int32 bias with the input zero
+// point folded in, Q31 requantization multipliers.
+// Calibration: 2097 samples (windows of normal.csv touched.csv)
+
+#ifndef TEMP_MODEL_WEIGHTS_INT8_H
+#define TEMP_MODEL_WEIGHTS_INT8_H
+
+#include <cstdint>
+#include "quantized.h"
+
+// Layer 1: Dense(8, ReLU) - int8 weights [8][10], output-major
+constexpr int8_t TEMP_LAYER1_Q8_WEIGHTS[8][10] = {
+    {87, -98, 110, -92, 121, -81, 98, -110, 127, -87},
+    {-121, 116, -83, 127, -99, 105, -110, 88, -77, 99},
+    {104, -75, 127, -81, 92, -121, 81, -104, 110, -92},
+    {-58, 127, -95, 101, -116, 85, -101, 111, -90, 106},
+    {127, -81, 71, -102, 66, -66, 112, -76, 81, -97},
+    {-101, 106, -111, 79, -90, 127, -85, 74, -106, 69},
+    {81, -69, 98, -104, 115, -98, 75, -127, 87, -98},
+    {-127, 105, -72, 121, -83, 99, -116, 94, -99, 116}
+};
+
+constexpr int32_t TEMP_LAYER1_Q8_BIAS[8] = {
+    71034, 41201, 39863, 64284, 33861, -35821, -36273, 34222
+};
+
+constexpr int32_t TEMP_LAYER1_Q8_MULTIPLIER[8] = {
+    1666199236, 1741935585, 1666199236, 1817671822, 1893408172, 1817671822, 1666199236, 1741935585
+};
+
+constexpr int32_t TEMP_LAYER1_Q8_SHIFT[8] = {
+    -8, -8, -8, -8, -8, -8, -8, -8
+};
+
+constexpr CustomNN::QuantizedDense TEMP_LAYER1_Q8 = {
+    &TEMP_LAYER1_Q8_WEIGHTS[0][0], TEMP_LAYER1_Q8_BIAS, TEMP_LAYER1_Q8_MULTIPLIER, TEMP_LAYER1_Q8_SHIFT,
+    10, 8,
+    {2.388235368e-02f, -931},   // input: scale, zero point
+    {1.365019940e-02f, -128},   // output: scale, zero point
+    CustomNN::ActivationType::ReLU
+};
+
+// Layer 2: Dense(2, Softmax) - int8 weights [2][8], output-major
+constexpr int8_t TEMP_LAYER2_Q8_WEIGHTS[2][8] = {
+    {106, -127, 115, -121, 112, -118, 124, -109},
+    {-106, 127, -115, 121, -112, 118, -124, 109}
+};
+
+constexpr int32_t TEMP_LAYER2_Q8_BIAS[2] = {
+    -89, 89
+};
+
+constexpr int32_t TEMP_LAYER2_Q8_MULTIPLIER[2] = {
+    1856555058, 1856555058
+};
+
+constexpr int32_t TEMP_LAYER2_Q8_SHIFT[2] = {
+    -7, -7
+};
+
+constexpr CustomNN::QuantizedDense TEMP_LAYER2_Q8 = {
+    &TEMP_LAYER2_Q8_WEIGHTS[0][0], TEMP_LAYER2_Q8_BIAS, TEMP_LAYER2_Q8_MULTIPLIER, TEMP_LAYER2_Q8_SHIFT,
+    8, 2,
+    {1.365019940e-02f, -128},   // input: scale, zero point
+    {6.683693733e-03f, 0},   // output: scale, zero point
+    CustomNN::ActivationType::Softmax
+};
+
+#endif // TEMP_MODEL_WEIGHTS_INT8_H
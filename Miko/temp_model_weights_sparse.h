@@ -0,0 +1,70 @@
+// Pruned CSR weights for temp_model_weights.h
+// Generated by tools/prune_weights (make prune)
+// DO NOT EDIT MANUALLY
+//
+// Magnitude pruning to density 0.5 per layer; each bias absorbs the
+// mean contribution of its dropped weights on windows of normal.csv touched.csv.
+// Argmax agreement with the unpruned model: 66.05% on windows of normal.csv touched.csv
+
+#ifndef TEMP_MODEL_WEIGHTS_SPARSE_H
+#define TEMP_MODEL_WEIGHTS_SPARSE_H
+
+#include <cstdint>
+#include "sparse.h"
+
+// Layer 1: Dense(8, ReLU) - 40 of 80 weights kept, CSR by output
+constexpr float TEMP_LAYER1_SPARSE_VALUES[40] = {
+    1.899999976e-01f, 2.099999934e-01f, -1.899999976e-01f, 2.199999988e-01f, -2.199999988e-01f, 2.099999934e-01f,
+    2.300000042e-01f, -1.800000072e-01f, 1.899999976e-01f, -2.000000030e-01f, 1.800000072e-01f, 2.199999988e-01f,
+    -2.099999934e-01f, -1.800000072e-01f, 1.899999976e-01f, 2.399999946e-01f, -1.800000072e-01f, 1.899999976e-01f,
+    -2.199999988e-01f, -1.899999976e-01f, 2.099999934e-01f, 2.000000030e-01f, 2.500000000e-01f, -2.000000030e-01f,
+    2.199999988e-01f, -1.899999976e-01f, -1.899999976e-01f, 2.000000030e-01f, -2.099999934e-01f, 2.399999946e-01f,
+    -2.000000030e-01f, -1.800000072e-01f, 2.000000030e-01f, -2.199999988e-01f, -2.300000042e-01f, 1.899999976e-01f,
+    2.199999988e-01f, 1.800000072e-01f, -2.099999934e-01f, 2.099999934e-01f
+};
+
+constexpr int16_t TEMP_LAYER1_SPARSE_INDICES[40] = {
+    2, 4, 7, 8, 0, 1, 3, 4, 5, 6, 0, 2, 5, 7, 8, 1,
+    2, 3, 4, 6, 7, 9, 0, 3, 6, 9, 0, 1, 2, 5, 8, 3,
+    4, 7, 0, 1, 3, 5, 6, 9
+};
+
+constexpr float TEMP_LAYER1_SPARSE_BIAS[8] = {
+    -5.990092754e+00f, 9.780813456e-01f, -2.547026157e+00f, -2.455889702e+00f, -1.408638209e-01f, 1.792672396e+00f, 2.656191111e+00f, -5.888076782e+00f
+};
+
+constexpr uint16_t TEMP_LAYER1_SPARSE_ROW_START[9] = {
+    0, 4, 10, 15, 22, 26, 31, 34, 40
+};
+
+constexpr CustomNN::SparseDense TEMP_LAYER1_SPARSE = {
+    TEMP_LAYER1_SPARSE_VALUES, TEMP_LAYER1_SPARSE_INDICES, TEMP_LAYER1_SPARSE_ROW_START, TEMP_LAYER1_SPARSE_BIAS,
+    10, 8,
+    CustomNN::ActivationType::ReLU
+};
+
+// Layer 2: Dense(2, Softmax) - 8 of 16 weights kept, CSR by output
+constexpr float TEMP_LAYER2_SPARSE_VALUES[8] = {
+    -4.199999869e-01f, -4.000000060e-01f, -3.899999857e-01f, 4.099999964e-01f, 4.199999869e-01f, 4.000000060e-01f,
+    3.899999857e-01f, -4.099999964e-01f
+};
+
+constexpr int16_t TEMP_LAYER2_SPARSE_INDICES[8] = {
+    1, 3, 5, 6, 1, 3, 5, 6
+};
+
+constexpr float TEMP_LAYER2_SPARSE_BIAS[2] = {
+    1.648003936e+00f, -1.648003936e+00f
+};
+
+constexpr uint16_t TEMP_LAYER2_SPARSE_ROW_START[3] = {
+    0, 4, 8
+};
+
+constexpr CustomNN::SparseDense TEMP_LAYER2_SPARSE = {
+    TEMP_LAYER2_SPARSE_VALUES, TEMP_LAYER2_SPARSE_INDICES, TEMP_LAYER2_SPARSE_ROW_START, TEMP_LAYER2_SPARSE_BIAS,
+    8, 2,
+    CustomNN::ActivationType::Softmax
+};
+
+#endif // TEMP_MODEL_WEIGHTS_SPARSE_H
@@ -18,18 +18,14 @@ void init_temp_sensor() {
 }
 
 float read_temperature() {
-    // 12-bit ADC with 3.3V reference
-    const float conversion_factor = 3.3f / (1 << 12);
-
-    // Read raw ADC value
-    uint16_t raw = adc_read();
-
-    // Convert to voltage
-    float voltage = raw * conversion_factor;
+    // Read raw ADC value and convert with the datasheet formula
+    return temperature_from_adc(adc_read());
+}
 
-    // Convert to temperature using RP2040 datasheet formula:
-    // T = 27 - (ADC_voltage - 0.706) / 0.001721
-    float temp_c = 27.0f - (voltage - 0.706f) / 0.001721f;
+uint16_t read_temperature_raw() {
+    return adc_read();
+}
 
-    return temp_c;
+int32_t read_temperature_q16() {
+    return temperature_q16_from_adc(adc_read());
 }
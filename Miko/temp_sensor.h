@@ -6,6 +6,8 @@
 #ifndef TEMP_SENSOR_H
 #define TEMP_SENSOR_H
 
+#include <cstdint>
+
 /**
  * Initialize the temperature sensor (ADC channel 4)
  * Call this once during setup
@@ -20,4 +22,40 @@ void init_temp_sensor();
  */
 float read_temperature();
 
+/**
+ * Read the raw 12-bit ADC code of the temperature sensor, unconverted
+ * (for models whose first layer takes codes, see code_lut.h)
+ *
+ * @return ADC code in [0, 4095]; higher codes are colder
+ */
+uint16_t read_temperature_raw();
+
+/**
+ * Read the current temperature as Q16.16 fixed point (integer-only)
+ * Same datasheet formula as read_temperature() without soft-float calls
+ *
+ * @return Temperature in degrees Celsius * 65536
+ */
+int32_t read_temperature_q16();
+
+/**
+ * Convert a raw 12-bit ADC code to degrees Celsius
+ * RP2040 datasheet formula: T = 27 - (ADC_voltage - 0.706) / 0.001721
+ */
+inline float temperature_from_adc(uint16_t raw) {
+    // 12-bit ADC with 3.3V reference
+    const float conversion_factor = 3.3f / (1 << 12);
+    const float voltage = static_cast<float>(raw) * conversion_factor;
+    return 27.0f - (voltage - 0.706f) / 0.001721f;
+}
+
+/**
+ * Convert a raw 12-bit ADC code to Q16.16 degrees Celsius (integer-only)
+ * The same formula folded to T = 437.2266 - 0.4681372 * raw,
+ * with the slope in Q20 so raw * slope stays within int32 (error < 0.003 C)
+ */
+constexpr int32_t temperature_q16_from_adc(uint16_t raw) {
+    return 28654083 - ((static_cast<int32_t>(raw) * 490877 + 8) >> 4);
+}
+
 #endif // TEMP_SENSOR_H
@@ -0,0 +1,533 @@
+/**
+ * TFLite Flatbuffer Importer Implementation
+ *
+ * Field indices follow tensorflow/lite/schema/schema.fbs (version 3).
+ */
+
+#include "tflite_import.h"
+#include <cstdint>
+#include <cstring>
+
+namespace CustomNN {
+
+namespace {
+
+// Model
+constexpr size_t kModelVersion = 0;
+constexpr size_t kModelOperatorCodes = 1;
+constexpr size_t kModelSubgraphs = 2;
+constexpr size_t kModelBuffers = 4;
+// OperatorCode
+constexpr size_t kCodeDeprecatedBuiltin = 0;
+constexpr size_t kCodeBuiltin = 3;
+// SubGraph
+constexpr size_t kGraphTensors = 0;
+constexpr size_t kGraphInputs = 1;
+constexpr size_t kGraphOutputs = 2;
+constexpr size_t kGraphOperators = 3;
+// Tensor
+constexpr size_t kTensorShape = 0;
+constexpr size_t kTensorType = 1;
+constexpr size_t kTensorBuffer = 2;
+constexpr size_t kTensorSparsity = 6;
+// Operator
+constexpr size_t kOpOpcodeIndex = 0;
+constexpr size_t kOpInputs = 1;
+constexpr size_t kOpOutputs = 2;
+constexpr size_t kOpBuiltinOptions = 4;
+// Buffer
+constexpr size_t kBufferData = 0;
+constexpr size_t kBufferOffset = 1;
+constexpr size_t kBufferSize = 2;
+// FullyConnectedOptions / SoftmaxOptions
+constexpr size_t kFcFusedActivation = 0;
+constexpr size_t kSoftmaxBeta = 0;
+
+constexpr uint8_t kTypeFloat32 = 0;
+constexpr int8_t kActivationNone = 0;
+constexpr int8_t kActivationRelu = 1;
+
+/**
+ * Bounds-checked little-endian reads of a flatbuffer. A read outside the
+ * data clears ok() and returns 0, and position 0 doubles as "absent"
+ * (nothing is ever referenced at offset 0, the root offset lives there).
+ */
+class FlatReader {
+private:
+    const uint8_t* data_;
+    size_t size_;
+    bool ok_;
+
+    bool has(size_t pos, size_t bytes) {
+        if (pos <= size_ && bytes <= size_ - pos) {
+            return true;
+        }
+        ok_ = false;
+        return false;
+    }
+
+public:
+    FlatReader(const uint8_t* data, size_t size) : data_(data), size_(size), ok_(true) {}
+
+    bool ok() const { return ok_; }
+    const uint8_t* at(size_t pos) const { return data_ + pos; }
+
+    uint32_t u32(size_t pos) {
+        uint32_t value = 0;
+        if (has(pos, sizeof(value))) {
+            std::memcpy(&value, data_ + pos, sizeof(value));
+        }
+        return value;
+    }
+
+    uint16_t u16(size_t pos) {
+        uint16_t value = 0;
+        if (has(pos, sizeof(value))) {
+            std::memcpy(&value, data_ + pos, sizeof(value));
+        }
+        return value;
+    }
+
+    uint8_t u8(size_t pos) { return has(pos, 1) ? data_[pos] : uint8_t{0}; }
+    int32_t i32(size_t pos) { return static_cast<int32_t>(u32(pos)); }
+
+    uint64_t u64(size_t pos) {
+        uint64_t value = 0;
+        if (has(pos, sizeof(value))) {
+            std::memcpy(&value, data_ + pos, sizeof(value));
+        }
+        return value;
+    }
+
+    float f32(size_t pos) {
+        float value = 0.0f;
+        if (has(pos, sizeof(value))) {
+            std::memcpy(&value, data_ + pos, sizeof(value));
+        }
+        return value;
+    }
+
+    // Position of field `index` of the table at `table`, 0 if absent
+    size_t field(size_t table, size_t index) {
+        if (table == 0) {
+            return 0;
+        }
+        const int64_t vtable = static_cast<int64_t>(table) - i32(table);
+        if (vtable < 0 || !has(static_cast<size_t>(vtable), 4)) {
+            ok_ = false;
+            return 0;
+        }
+        const size_t vt = static_cast<size_t>(vtable);
+        const size_t entry = 4 + 2 * index;
+        if (entry + 2 > u16(vt)) {
+            return 0;
+        }
+        const uint16_t offset = u16(vt + entry);
+        return (offset == 0) ? 0 : table + offset;
+    }
+
+    // Table, vector or string referenced by the offset stored at pos
+    size_t deref(size_t pos) {
+        if (pos == 0) {
+            return 0;
+        }
+        const size_t target = pos + u32(pos);
+        return has(target, 4) ? target : 0;
+    }
+
+    size_t ref_field(size_t table, size_t index) { return deref(field(table, index)); }
+
+    // Length of the vector at vec (elements of width bytes), 0 if absent
+    size_t length(size_t vec, size_t width = 4) {
+        if (vec == 0) {
+            return 0;
+        }
+        const size_t n = u32(vec);
+        if (!has(vec + 4, 0) || n > (size_ - vec - 4) / width) {
+            ok_ = false;
+            return 0;
+        }
+        return n;
+    }
+
+    // Position of element k of a vector
+    size_t element(size_t vec, size_t k, size_t width) { return vec + 4 + k * width; }
+    size_t table_at(size_t vec, size_t k) { return deref(element(vec, k, 4)); }
+
+    // Scalar fields with their schema defaults
+    uint32_t u32_field(size_t table, size_t index, uint32_t fallback) {
+        const size_t pos = field(table, index);
+        return (pos == 0) ? fallback : u32(pos);
+    }
+    int32_t i32_field(size_t table, size_t index, int32_t fallback) {
+        const size_t pos = field(table, index);
+        return (pos == 0) ? fallback : i32(pos);
+    }
+    uint8_t u8_field(size_t table, size_t index, uint8_t fallback) {
+        const size_t pos = field(table, index);
+        return (pos == 0) ? fallback : u8(pos);
+    }
+    uint64_t u64_field(size_t table, size_t index, uint64_t fallback) {
+        const size_t pos = field(table, index);
+        return (pos == 0) ? fallback : u64(pos);
+    }
+    float f32_field(size_t table, size_t index, float fallback) {
+        const size_t pos = field(table, index);
+        return (pos == 0) ? fallback : f32(pos);
+    }
+};
+
+// A FULLY_CONNECTED op waiting for any RELU / SOFTMAX that follows it
+struct PendingLayer {
+    const float* weights;
+    const float* bias;
+    size_t input_size;
+    size_t output_size;
+    ActivationType activation;
+};
+
+/**
+ * Walks one model; the results land in pending[] / error / op
+ */
+class Importer {
+private:
+    FlatReader r_;
+    size_t tensors_;
+    size_t buffers_;
+
+public:
+    TfliteError error;
+    int32_t op;
+
+    Importer(const uint8_t* data, size_t size)
+        : r_(data, size), tensors_(0), buffers_(0), error(TfliteError::None), op(-1) {}
+
+    bool failed(TfliteError e) {
+        error = r_.ok() ? e : TfliteError::Truncated;
+        return false;
+    }
+
+    // Element count of a tensor (product of its shape), 0 on error
+    size_t elements(size_t tensor) {
+        const size_t shape = r_.ref_field(tensor, kTensorShape);
+        const size_t dims = r_.length(shape);
+        size_t count = 1;
+        for (size_t d = 0; d < dims; ++d) {
+            const int32_t extent = r_.i32(r_.element(shape, d, 4));
+            if (extent <= 0 || count > SIZE_MAX / static_cast<size_t>(extent)) {
+                return 0;
+            }
+            count *= static_cast<size_t>(extent);
+        }
+        return (dims == 0) ? 0 : count;
+    }
+
+    // Innermost dimension of a tensor, 0 on error
+    size_t last_dim(size_t tensor) {
+        const size_t shape = r_.ref_field(tensor, kTensorShape);
+        const size_t dims = r_.length(shape);
+        if (dims == 0) {
+            return 0;
+        }
+        const int32_t extent = r_.i32(r_.element(shape, dims - 1, 4));
+        return (extent > 0) ? static_cast<size_t>(extent) : 0;
+    }
+
+    size_t tensor(int32_t index) {
+        if (index < 0 || static_cast<size_t>(index) >= r_.length(tensors_)) {
+            return 0;
+        }
+        return r_.table_at(tensors_, static_cast<size_t>(index));
+    }
+
+    /**
+     * Constant float32 data of a tensor with count elements
+     */
+    bool constant(int32_t index, size_t count, const float*& values) {
+        const size_t t = tensor(index);
+        if (t == 0) {
+            return failed(TfliteError::Graph);
+        }
+        if (r_.u8_field(t, kTensorType, kTypeFloat32) != kTypeFloat32 ||
+            r_.field(t, kTensorSparsity) != 0) {
+            return failed(TfliteError::Type);
+        }
+        if (elements(t) != count) {
+            return failed(TfliteError::Shape);
+        }
+        const uint32_t b = r_.u32_field(t, kTensorBuffer, 0);
+        if (b == 0 || b >= r_.length(buffers_)) {
+            return failed(TfliteError::Shape);   // Buffer 0 is the empty sentinel
+        }
+        const size_t buffer = r_.table_at(buffers_, b);
+
+        // Inline data vector, or (models over 2 GB) an offset from the start
+        size_t pos = 0;
+        size_t bytes = 0;
+        const size_t vec = r_.ref_field(buffer, kBufferData);
+        if (vec != 0) {
+            bytes = r_.length(vec, 1);
+            pos = vec + 4;
+        } else {
+            const uint64_t offset = r_.u64_field(buffer, kBufferOffset, 0);
+            const uint64_t size = r_.u64_field(buffer, kBufferSize, 0);
+            if (offset > 1 && size > 0) {
+                pos = static_cast<size_t>(offset);
+                bytes = static_cast<size_t>(size);
+                r_.u8(pos + bytes - 1);   // Bounds check
+            }
+        }
+        if (!r_.ok()) {
+            return failed(TfliteError::Truncated);
+        }
+        if (bytes != count * sizeof(float)) {
+            return failed(TfliteError::Shape);
+        }
+        if (reinterpret_cast<uintptr_t>(r_.at(pos)) % alignof(float) != 0) {
+            return failed(TfliteError::Alignment);
+        }
+        values = reinterpret_cast<const float*>(r_.at(pos));
+        return true;
+    }
+
+    /**
+     * Walk the model; pending is allocated with one entry per op
+     * @return Number of layers, 0 on failure
+     */
+    size_t run(PendingLayer*& pending) {
+        pending = nullptr;
+        if (!r_.ok() || std::memcmp(r_.at(0) + 4, "TFL3", 4) != 0) {
+            failed(TfliteError::Identifier);
+            return 0;
+        }
+        const size_t model = r_.u32(0);   // Root table offset
+        if (r_.u32_field(model, kModelVersion, 0) != TfliteModel::kSchemaVersion) {
+            failed(TfliteError::Version);
+            return 0;
+        }
+        const size_t codes = r_.ref_field(model, kModelOperatorCodes);
+        const size_t subgraphs = r_.ref_field(model, kModelSubgraphs);
+        buffers_ = r_.ref_field(model, kModelBuffers);
+        if (r_.length(subgraphs) != 1) {
+            failed(TfliteError::Graph);
+            return 0;
+        }
+        const size_t graph = r_.table_at(subgraphs, 0);
+        tensors_ = r_.ref_field(graph, kGraphTensors);
+        const size_t inputs = r_.ref_field(graph, kGraphInputs);
+        const size_t outputs = r_.ref_field(graph, kGraphOutputs);
+        const size_t ops = r_.ref_field(graph, kGraphOperators);
+        const size_t num_ops = r_.length(ops);
+        if (r_.length(inputs) != 1 || r_.length(outputs) != 1 || num_ops == 0) {
+            failed(TfliteError::Graph);
+            return 0;
+        }
+
+        // The chain: each op consumes the tensor the previous one produced
+        int32_t current = r_.i32(r_.element(inputs, 0, 4));
+        size_t width = last_dim(tensor(current));
+        if (width == 0 || elements(tensor(current)) != width) {
+            failed(TfliteError::Shape);
+            return 0;
+        }
+        pending = new PendingLayer[num_ops];
+        size_t count = 0;
+
+        for (size_t k = 0; k < num_ops; ++k) {
+            const size_t o = r_.table_at(ops, k);
+            const uint32_t code_index = r_.u32_field(o, kOpOpcodeIndex, 0);
+            if (code_index >= r_.length(codes)) {
+                failed(TfliteError::Graph);
+                return 0;
+            }
+            // Codes above 127 only fit the newer int32 field; take the larger
+            const size_t code = r_.table_at(codes, code_index);
+            const int32_t deprecated =
+                static_cast<int8_t>(r_.u8_field(code, kCodeDeprecatedBuiltin, 0));
+            const int32_t builtin = r_.i32_field(code, kCodeBuiltin, 0);
+            op = (builtin > deprecated) ? builtin : deprecated;
+
+            const size_t op_inputs = r_.ref_field(o, kOpInputs);
+            const size_t op_outputs = r_.ref_field(o, kOpOutputs);
+            if (r_.length(op_inputs) == 0 || r_.length(op_outputs) != 1 ||
+                r_.i32(r_.element(op_inputs, 0, 4)) != current) {
+                failed(TfliteError::Graph);
+                return 0;
+            }
+            const int32_t produced = r_.i32(r_.element(op_outputs, 0, 4));
+            const size_t options = r_.ref_field(o, kOpBuiltinOptions);
+
+            if (op == TfliteModel::kFullyConnected) {
+                if (r_.length(op_inputs) < 2) {
+                    failed(TfliteError::Graph);
+                    return 0;
+                }
+                const size_t out = last_dim(tensor(produced));
+                PendingLayer& layer = pending[count];
+                layer = PendingLayer{nullptr, nullptr, width, out, ActivationType::None};
+                const int32_t weights = r_.i32(r_.element(op_inputs, 1, 4));
+                const int32_t bias = (r_.length(op_inputs) > 2)
+                                         ? r_.i32(r_.element(op_inputs, 2, 4)) : -1;
+                if (out == 0) {
+                    failed(TfliteError::Shape);
+                    return 0;
+                }
+                if (!constant(weights, out * width, layer.weights) ||
+                    (bias >= 0 && !constant(bias, out, layer.bias))) {
+                    return 0;
+                }
+                const int8_t fused =
+                    static_cast<int8_t>(r_.u8_field(options, kFcFusedActivation, 0));
+                if (fused == kActivationRelu) {
+                    layer.activation = ActivationType::ReLU;
+                } else if (fused != kActivationNone) {
+                    failed(TfliteError::Operator);
+                    return 0;
+                }
+                ++count;
+                width = out;
+            } else if (op == TfliteModel::kRelu || op == TfliteModel::kSoftmax) {
+                // Folded into the layer before it
+                if (count == 0 || pending[count - 1].activation != ActivationType::None ||
+                    (op == TfliteModel::kSoftmax &&
+                     r_.f32_field(options, kSoftmaxBeta, 1.0f) != 1.0f)) {
+                    failed(TfliteError::Operator);
+                    return 0;
+                }
+                pending[count - 1].activation = (op == TfliteModel::kRelu)
+                                                    ? ActivationType::ReLU
+                                                    : ActivationType::Softmax;
+            } else if (op == TfliteModel::kReshape) {
+                // Only flattening (e.g. [1, n] <-> [n]) is an identity here
+                if (elements(tensor(produced)) != width) {
+                    failed(TfliteError::Shape);
+                    return 0;
+                }
+            } else {
+                failed(TfliteError::Operator);
+                return 0;
+            }
+            current = produced;
+            if (!r_.ok()) {
+                failed(TfliteError::Truncated);
+                return 0;
+            }
+        }
+
+        if (count == 0 || current != r_.i32(r_.element(outputs, 0, 4))) {
+            failed(TfliteError::Graph);
+            return 0;
+        }
+        op = -1;
+        return count;
+    }
+};
+
+} // namespace
+
+// ============================================================================
+// TfliteDenseLayer
+// ============================================================================
+
+void TfliteDenseLayer::forward(const float* input, float* output) const {
+    const bool relu = (activation_ == ActivationType::ReLU);
+    for (size_t j = 0; j < output_size_; ++j) {
+        const float* row = weights_ + j * input_size_;
+        float acc = (bias_ != nullptr) ? bias_[j] : 0.0f;
+        for (size_t i = 0; i < input_size_; ++i) {
+            acc += row[i] * input[i];
+        }
+        output[j] = (relu && !(acc > 0.0f)) ? 0.0f : acc;
+    }
+}
+
+// ============================================================================
+// TfliteModel
+// ============================================================================
+
+TfliteModel::TfliteModel()
+  : num_layers_(0),
+    layers_(nullptr),
+    model_(nullptr),
+    error_(TfliteError::None),
+    unsupported_op_(-1)
+{
+}
+
+TfliteModel::~TfliteModel() {
+    release();
+}
+
+void TfliteModel::release() {
+    delete model_;
+    model_ = nullptr;
+    if (layers_ != nullptr) {
+        for (size_t k = 0; k < num_layers_; ++k) {
+            delete layers_[k];
+        }
+    }
+    delete[] layers_;
+    layers_ = nullptr;
+    num_layers_ = 0;
+    error_ = TfliteError::None;
+    unsupported_op_ = -1;
+}
+
+bool TfliteModel::fail(TfliteError error) {
+    release();
+    error_ = error;
+    return false;
+}
+
+const char* TfliteModel::error_name(TfliteError error) {
+    switch (error) {
+        case TfliteError::None: return "none";
+        case TfliteError::Truncated: return "truncated or out-of-bounds offset";
+        case TfliteError::Identifier: return "not a TFLite flatbuffer";
+        case TfliteError::Version: return "unsupported schema version";
+        case TfliteError::Graph: return "graph is not a single chain";
+        case TfliteError::Operator: return "unsupported operator or activation";
+        case TfliteError::Type: return "unsupported tensor type";
+        case TfliteError::Shape: return "tensor shapes do not match";
+        case TfliteError::Alignment: return "weights not 4-byte aligned";
+    }
+    return "unknown";
+}
+
+bool TfliteModel::load(const void* data, size_t size) {
+    release();
+    if (data == nullptr || size < 8) {
+        return fail(TfliteError::Truncated);
+    }
+
+    Importer importer(static_cast<const uint8_t*>(data), size);
+    PendingLayer* pending = nullptr;
+    const size_t count = importer.run(pending);
+    if (count == 0) {
+        delete[] pending;
+        fail(importer.error);
+        unsupported_op_ = (importer.error == TfliteError::Operator) ? importer.op : -1;
+        return false;
+    }
+
+    num_layers_ = count;
+    layers_ = new Layer*[num_layers_];
+    for (size_t k = 0; k < num_layers_; ++k) {
+        const PendingLayer& p = pending[k];
+        layers_[k] = new TfliteDenseLayer(p.weights, p.bias, p.input_size, p.output_size,
+                                          p.activation);
+    }
+    delete[] pending;
+    model_ = new Sequential(layers_, num_layers_, nullptr, nullptr, 0);
+    return true;
+}
+
+bool TfliteModel::predict(const float* input, float* output, Scratch& scratch) const {
+    return is_loaded() && model_->predict(input, output, scratch);
+}
+
+bool TfliteModel::predict_logits(const float* input, float* output, Scratch& scratch) const {
+    return is_loaded() && model_->predict_logits(input, output, scratch);
+}
+
+} // namespace CustomNN
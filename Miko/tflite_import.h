@@ -0,0 +1,143 @@
+/**
+ * TFLite Flatbuffer Importer
+ * Runs float .tflite models on the CustomNN engine without TFLM
+ *
+ * TfliteModel walks the flatbuffer directly (no flatbuffers library, no
+ * generated schema code) and turns a chain of float FULLY_CONNECTED ops,
+ * with fused or separate RELU and SOFTMAX ops and flattening RESHAPEs,
+ * into a Sequential. Layer weights point straight into the flatbuffer:
+ * nothing is copied and no tensor arena is needed, only the usual
+ * Sequential scratch (the widest hidden layer, twice for 3+ layers).
+ *
+ * TFLite stores FULLY_CONNECTED weights output-major ([output][input]),
+ * which TfliteDenseLayer reads as is: one dot product per output over a
+ * contiguous row. Every read of the flatbuffer is bounds-checked, so a
+ * damaged or hostile model is refused rather than read past its end.
+ *
+ * Not supported (refused with TfliteError::Operator or Type): quantized
+ * or float16 weights, sparse tensors, other ops or activations, graphs
+ * that are not a single chain.
+ *
+ * Usage (firmware, the model embedded by model_data.cc):
+ *   TfliteModel tflite;
+ *   if (!tflite.load(scripts_model_tflite, scripts_model_tflite_len)) { ... }
+ *   float work[18];
+ *   Scratch scratch{work, 18};   // at least tflite.required_scratch()
+ *   tflite.predict(input, probabilities, scratch);
+ *
+ * The buffer must stay valid while the model is used and be 4-byte
+ * aligned (TFLite aligns tensor data within the file; model_data.cc
+ * aligns the array), since the M0+ faults on unaligned float loads.
+ */
+
+#ifndef TFLITE_IMPORT_H
+#define TFLITE_IMPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include "neural_network.h"
+
+namespace CustomNN {
+
+/**
+ * Why the last load() failed
+ */
+enum class TfliteError {
+    None,
+    Truncated,   // A table, vector or buffer lies outside the data
+    Identifier,  // Not a TFLite flatbuffer ("TFL3")
+    Version,     // Schema version other than 3
+    Graph,       // Not one subgraph with a single input and a chain of ops
+    Operator,    // Unsupported op or fused activation (see unsupported_op())
+    Type,        // Tensor type other than float32, or sparse
+    Shape,       // Tensor shapes or buffer sizes do not match
+    Alignment    // Weights or bias not 4-byte aligned in memory
+};
+
+/**
+ * Dense layer over borrowed output-major weights [output_size][input_size]
+ * (TFLite FULLY_CONNECTED layout)
+ */
+class TfliteDenseLayer : public Layer {
+private:
+    const float* weights_;  // [output_size][input_size]
+    const float* bias_;     // [output_size], or nullptr for none
+    size_t input_size_;
+    size_t output_size_;
+    ActivationType activation_;
+
+public:
+    TfliteDenseLayer(const float* weights, const float* bias, size_t input_size,
+                     size_t output_size, ActivationType activation)
+        : weights_(weights), bias_(bias), input_size_(input_size), output_size_(output_size),
+          activation_(activation) {}
+
+    size_t input_size() const override { return input_size_; }
+    size_t output_size() const override { return output_size_; }
+    ActivationType activation() const override { return activation_; }
+
+    void forward(const float* input, float* output) const override;
+};
+
+/**
+ * A float TFLite model loaded as a Sequential over its own bytes
+ */
+class TfliteModel {
+public:
+    // Builtin operator codes (tflite::BuiltinOperator)
+    static constexpr int32_t kFullyConnected = 9;
+    static constexpr int32_t kRelu = 19;
+    static constexpr int32_t kReshape = 22;
+    static constexpr int32_t kSoftmax = 25;
+
+    static constexpr uint32_t kSchemaVersion = 3;
+
+private:
+    size_t num_layers_;
+    Layer** layers_;            // Owned objects over borrowed weights [num_layers_]
+    Sequential* model_;         // Over layers_, no scratch of its own
+    TfliteError error_;
+    int32_t unsupported_op_;    // Builtin code of the op refused last, or -1
+
+public:
+    TfliteModel();
+    ~TfliteModel();
+
+    TfliteModel(const TfliteModel&) = delete;
+    TfliteModel& operator=(const TfliteModel&) = delete;
+
+    /**
+     * Build the network from a .tflite flatbuffer
+     * @param data Flatbuffer bytes (borrowed; must outlive the model)
+     * @param size Bytes at data
+     * @return false on failure (see error()); any previous model is released
+     */
+    bool load(const void* data, size_t size);
+
+    void release();
+
+    bool is_loaded() const { return model_ != nullptr; }
+    TfliteError error() const { return error_; }
+    int32_t unsupported_op() const { return unsupported_op_; }
+    static const char* error_name(TfliteError error);
+
+    size_t num_layers() const { return num_layers_; }
+    const Layer* const* layers() const { return layers_; }
+    size_t input_size() const { return is_loaded() ? model_->input_size() : 0; }
+    size_t output_size() const { return is_loaded() ? model_->output_size() : 0; }
+    size_t required_scratch() const { return is_loaded() ? model_->required_scratch() : 0; }
+
+    /**
+     * Reentrant inference, as Sequential::predict(input, output, scratch)
+     * @return false if nothing is loaded or scratch is too small
+     */
+    bool predict(const float* input, float* output, Scratch& scratch) const;
+    bool predict_logits(const float* input, float* output, Scratch& scratch) const;
+
+private:
+    bool fail(TfliteError error);
+};
+
+} // namespace CustomNN
+
+#endif // TFLITE_IMPORT_H
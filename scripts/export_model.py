@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+"""
+Export a trained model as a CustomNN binary model file (.cnnm).
+
+Any number of Dense layers is supported. The file is loaded on the host with
+ModelFile::open() (mmap, no parsing of the weights) or compiled into firmware
+flash and used with ModelFile::attach(); see Miko/model_file.h for the layout.
+
+Inputs:
+  - Keras models (.keras / .h5): every Dense layer in order, with its activation
+  - TFLite models (.tflite): every FULLY_CONNECTED op in order. Fused activations
+    are not visible through the interpreter, so hidden layers default to ReLU and
+    the last layer to softmax when the graph ends in a SOFTMAX op (override with
+    --activations)
+
+The writer itself only needs the standard library.
+"""
+
+import argparse
+import math
+import struct
+
+MAGIC = b'CNNM'
+VERSION_MAJOR = 1
+VERSION_MINOR = 0
+ALIGNMENT = 64
+HEADER_BYTES = 64
+RECORD_BYTES = 64
+
+KIND_DENSE = 1
+DTYPES = {'f32': 1, 'fp16': 2, 'bf16': 3}
+ACTIVATIONS = {'none': 0, 'linear': 0, 'relu': 1, 'softmax': 2}
+
+
+def align_up(n):
+    return (n + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+
+
+def packed_stride(input_size):
+    """Floats per packed row (MatrixOps::packed_stride)."""
+    per_line = ALIGNMENT // 4
+    return (input_size + per_line - 1) // per_line * per_line
+
+
+def float_bits(value):
+    return struct.unpack('<I', struct.pack('<f', value))[0]
+
+
+def to_bf16(value):
+    """Round to nearest even, NaN kept quiet (HalfOps::float_to_bf16)."""
+    bits = float_bits(value)
+    if math.isnan(value):
+        return (bits >> 16) | 0x0040
+    return (bits + 0x7FFF + ((bits >> 16) & 1)) >> 16
+
+
+def to_fp16(value):
+    """IEEE binary16, round to nearest even, saturating to infinity."""
+    value = struct.unpack('<f', struct.pack('<f', value))[0]
+    try:
+        return struct.unpack('<H', struct.pack('<e', value))[0]
+    except OverflowError:
+        return 0x7C00 if value > 0 else 0xFC00
+
+
+def layer_bytes(weights, input_size, output_size, dtype):
+    """Weights in the file layout: packed output-major F32 rows, or input-major halves."""
+    if dtype == 'f32':
+        stride = packed_stride(input_size)
+        out = bytearray(output_size * stride * 4)
+        for j in range(output_size):
+            row = struct.pack(f'<{input_size}f', *(weights[i][j] for i in range(input_size)))
+            out[j * stride * 4:j * stride * 4 + len(row)] = row
+        return stride, bytes(out)
+    convert = to_fp16 if dtype == 'fp16' else to_bf16
+    flat = [convert(weights[i][j]) for i in range(input_size) for j in range(output_size)]
+    return output_size, struct.pack(f'<{len(flat)}H', *flat)
+
+
+def serialize(layers, dtype):
+    """
+    layers: list of (weights [input_size][output_size], bias [output_size], activation)
+    Returns the file contents.
+    """
+    if not layers:
+        raise ValueError('no layers to export')
+    shapes = []
+    for k, (weights, bias, _) in enumerate(layers):
+        input_size, output_size = len(weights), len(bias)
+        if input_size == 0 or output_size == 0 or any(len(row) != output_size for row in weights):
+            raise ValueError(f'layer {k}: inconsistent weight/bias shapes')
+        if k > 0 and shapes[-1][1] != input_size:
+            raise ValueError(f'layer {k}: input {input_size} does not match the previous '
+                             f'output {shapes[-1][1]}')
+        shapes.append((input_size, output_size))
+
+    records = []
+    sections = []
+    offset = HEADER_BYTES + RECORD_BYTES * len(layers)
+    for (weights, bias, activation), (input_size, output_size) in zip(layers, shapes):
+        stride, weight_data = layer_bytes(weights, input_size, output_size, dtype)
+        bias_data = struct.pack(f'<{output_size}f', *bias)
+        weights_offset = offset
+        bias_offset = weights_offset + align_up(len(weight_data))
+        offset = bias_offset + align_up(len(bias_data))
+        records.append(struct.pack('<HBBIIIQQQQ16x', KIND_DENSE, DTYPES[dtype],
+                                   ACTIVATIONS[activation], input_size, output_size, stride,
+                                   weights_offset, len(weight_data),
+                                   bias_offset, len(bias_data)))
+        sections.append((weights_offset, weight_data))
+        sections.append((bias_offset, bias_data))
+
+    out = bytearray(offset)
+    out[0:HEADER_BYTES] = struct.pack('<4sHHIIIIIIQ24x', MAGIC, VERSION_MAJOR, VERSION_MINOR,
+                                      HEADER_BYTES, RECORD_BYTES, len(layers),
+                                      shapes[0][0], shapes[-1][1], 0, offset)
+    for k, record in enumerate(records):
+        out[HEADER_BYTES + k * RECORD_BYTES:HEADER_BYTES + (k + 1) * RECORD_BYTES] = record
+    for start, data in sections:
+        out[start:start + len(data)] = data
+    return bytes(out)
+
+
+def load_keras(path):
+    import tensorflow as tf
+
+    model = tf.keras.models.load_model(path)
+    layers = []
+    for layer in model.layers:
+        if not isinstance(layer, tf.keras.layers.Dense):
+            continue
+        kernel, bias = layer.get_weights()  # kernel is [input][output], the stored layout
+        activation = layer.activation.__name__
+        if activation not in ACTIVATIONS:
+            raise ValueError(f'{layer.name}: unsupported activation {activation}')
+        layers.append((kernel.tolist(), bias.tolist(), activation))
+    return layers
+
+
+def load_tflite(path, activations):
+    import tensorflow as tf
+
+    interpreter = tf.lite.Interpreter(model_path=path)
+    interpreter.allocate_tensors()
+    ops = interpreter._get_ops_details()
+    dense_ops = [op for op in ops if op['op_name'] == 'FULLY_CONNECTED']
+    if not dense_ops:
+        raise ValueError('no FULLY_CONNECTED ops in the model')
+
+    layers = []
+    for op in dense_ops:
+        weight_index, bias_index = op['inputs'][1], op['inputs'][2]
+        kernel = interpreter.get_tensor(weight_index)  # [output][input]
+        if kernel.dtype.kind != 'f':
+            raise ValueError('quantized weights are not supported; export the float model')
+        bias = interpreter.get_tensor(bias_index) if bias_index >= 0 else [0.0] * kernel.shape[0]
+        layers.append([kernel.T.tolist(), list(map(float, bias)), 'relu'])
+
+    if activations:
+        if len(activations) != len(layers):
+            raise ValueError(f'--activations lists {len(activations)} entries for '
+                             f'{len(layers)} layers')
+        for layer, activation in zip(layers, activations):
+            layer[2] = activation
+    else:
+        layers[-1][2] = 'softmax' if ops[-1]['op_name'] == 'SOFTMAX' else 'none'
+    return [tuple(layer) for layer in layers]
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Export a model as a CustomNN .cnnm file')
+    parser.add_argument('--model', type=str, default='scripts/model.tflite',
+                        help='Keras (.keras/.h5) or TFLite (.tflite) model')
+    parser.add_argument('--output', type=str, default='models/model.cnnm',
+                        help='Output model file')
+    parser.add_argument('--dtype', choices=sorted(DTYPES), default='f32',
+                        help='Weight storage type')
+    parser.add_argument('--activations', type=str, default=None,
+                        help='Comma-separated activation per layer for TFLite models '
+                             '(none, relu, softmax)')
+    args = parser.parse_args()
+
+    if args.model.endswith('.tflite'):
+        activations = args.activations.split(',') if args.activations else None
+        layers = load_tflite(args.model, activations)
+    else:
+        layers = load_keras(args.model)
+
+    data = serialize(layers, args.dtype)
+    with open(args.output, 'wb') as f:
+        f.write(data)
+
+    shapes = ' -> '.join([str(len(layers[0][0]))] + [str(len(bias)) for _, bias, _ in layers])
+    print(f'Wrote {args.output}: {len(layers)} layers ({shapes}), {args.dtype}, {len(data)} bytes')
+
+
+if __name__ == '__main__':
+    main()
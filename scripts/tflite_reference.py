@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""
+Write reference outputs for a float TFLite model without TensorFlow.
+
+Stand-in for `train_model.py --test MODEL --reference CSV` where TensorFlow
+is not installed. The model is read straight from the flatbuffer and run in
+double precision (FULLY_CONNECTED with its fused activation, SOFTMAX), then
+rounded to float. This is NOT the TFLite interpreter: the CSV says so on its
+first line, and the C++ tester only reports disagreements with it instead of
+failing. Replace it with an interpreter dump when TensorFlow is available.
+
+Inputs are a grid over [-range, range]^2 (the two-feature blob model).
+
+The script only needs the standard library.
+"""
+
+import argparse
+import math
+import struct
+
+SOURCE_LINE = '# source: tflite_reference.py (float64 flatbuffer evaluation, not the interpreter)'
+
+# tflite schema: builtin operator codes and activation enums used here
+OP_FULLY_CONNECTED = 9
+OP_SOFTMAX = 25
+ACT_NONE = 0
+ACT_RELU = 1
+TENSOR_FLOAT32 = 0
+
+
+class FlatBuffer:
+    """Minimal read-only flatbuffer table access (little-endian)."""
+
+    def __init__(self, data):
+        self.data = data
+
+    def u16(self, offset):
+        return struct.unpack_from('<H', self.data, offset)[0]
+
+    def u32(self, offset):
+        return struct.unpack_from('<I', self.data, offset)[0]
+
+    def i32(self, offset):
+        return struct.unpack_from('<i', self.data, offset)[0]
+
+    def deref(self, offset):
+        return offset + self.u32(offset)
+
+    def root(self):
+        return self.deref(0)
+
+    def field(self, table, index):
+        """Absolute offset of field `index`, or None when it is absent."""
+        vtable = table - self.i32(table)
+        if 4 + 2 * index >= self.u16(vtable):
+            return None
+        slot = self.u16(vtable + 4 + 2 * index)
+        return table + slot if slot else None
+
+    def scalar(self, table, index, fmt, default=0):
+        offset = self.field(table, index)
+        return default if offset is None else struct.unpack_from(fmt, self.data, offset)[0]
+
+    def vector(self, table, index):
+        """(start, length) of a vector field, or (0, 0) when absent."""
+        offset = self.field(table, index)
+        if offset is None:
+            return 0, 0
+        start = self.deref(offset)
+        return start + 4, self.u32(start)
+
+    def tables(self, table, index):
+        start, length = self.vector(table, index)
+        return [self.deref(start + 4 * k) for k in range(length)]
+
+    def ints(self, table, index):
+        start, length = self.vector(table, index)
+        return [self.i32(start + 4 * k) for k in range(length)]
+
+
+def load_layers(path):
+    """The model's ops as ('dense', weights[out][in], bias, act) / ('softmax',)."""
+    with open(path, 'rb') as f:
+        fb = FlatBuffer(f.read())
+    model = fb.root()
+    # Model: operator_codes(1), subgraphs(2), buffers(4)
+    opcodes = fb.tables(model, 1)
+    subgraph = fb.tables(model, 2)[0]
+    buffers = fb.tables(model, 4)
+    # SubGraph: tensors(0), operators(3)
+    tensors = fb.tables(subgraph, 0)
+
+    def tensor_floats(index):
+        # Tensor: shape(0), type(1), buffer(2); Buffer: data(0)
+        tensor = tensors[index]
+        if fb.scalar(tensor, 1, '<b') != TENSOR_FLOAT32:
+            raise ValueError('quantized tensors are not supported; use the float model')
+        start, length = fb.vector(buffers[fb.scalar(tensor, 2, '<I')], 0)
+        values = list(struct.unpack_from(f'<{length // 4}f', fb.data, start))
+        return fb.ints(tensor, 0), values
+
+    layers = []
+    for op in fb.tables(subgraph, 3):
+        # Operator: opcode_index(0), inputs(1), builtin_options(4)
+        # OperatorCode: deprecated_builtin_code(0, int8), builtin_code(3, int32)
+        code_table = opcodes[fb.scalar(op, 0, '<I')]
+        code = max(fb.scalar(code_table, 0, '<b'), fb.scalar(code_table, 3, '<i'))
+        inputs = fb.ints(op, 1)
+        if code == OP_FULLY_CONNECTED:
+            (outputs, width), weights = tensor_floats(inputs[1])
+            if len(inputs) > 2 and inputs[2] >= 0:
+                bias = tensor_floats(inputs[2])[1]
+            else:
+                bias = [0.0] * outputs
+            # FullyConnectedOptions: fused_activation_function(0)
+            options = fb.field(op, 4)
+            activation = ACT_NONE if options is None else fb.scalar(fb.deref(options), 0, '<b')
+            if activation not in (ACT_NONE, ACT_RELU):
+                raise ValueError(f'unsupported fused activation {activation}')
+            rows = [weights[o * width:(o + 1) * width] for o in range(outputs)]
+            layers.append(('dense', rows, bias, activation))
+        elif code == OP_SOFTMAX:
+            layers.append(('softmax',))
+        else:
+            raise ValueError(f'unsupported operator {code}')
+    return layers
+
+
+def run(layers, inputs):
+    values = [float(v) for v in inputs]
+    for layer in layers:
+        if layer[0] == 'dense':
+            _, rows, bias, activation = layer
+            values = [b + math.fsum(w * v for w, v in zip(row, values))
+                      for row, b in zip(rows, bias)]
+            if activation == ACT_RELU:
+                values = [max(0.0, v) for v in values]
+        else:
+            top = max(values)
+            exps = [math.exp(v - top) for v in values]
+            total = math.fsum(exps)
+            values = [e / total for e in exps]
+    return values
+
+
+def to_float32(value):
+    return struct.unpack('<f', struct.pack('<f', value))[0]
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Write TFLite reference outputs without TensorFlow (not the interpreter)')
+    parser.add_argument('--model', type=str, default='scripts/model.tflite',
+                        help='Float TFLite model')
+    parser.add_argument('--reference', type=str, default='scripts/model_reference.csv',
+                        help='Output CSV (x, y, p0, p1, ...)')
+    parser.add_argument('--grid', type=str, default='16x10',
+                        help='Input grid points per axis, XxY (default: 16x10)')
+    parser.add_argument('--range', type=float, default=12.0,
+                        help='Grid half-width (default: 12)')
+    args = parser.parse_args()
+
+    layers = load_layers(args.model)
+    outputs = len(layers[-1][2]) if layers[-1][0] == 'dense' else len(layers[-2][2])
+    nx, ny = (int(n) for n in args.grid.split('x'))
+    with open(args.reference, 'w') as f:
+        f.write(SOURCE_LINE + '\n')
+        f.write(','.join(['x', 'y'] + [f'p{k}' for k in range(outputs)]) + '\n')
+        for i in range(nx):
+            for j in range(ny):
+                point = [to_float32(-args.range + 2 * args.range * i / (nx - 1)),
+                         to_float32(-args.range + 2 * args.range * j / (ny - 1))]
+                values = point + [to_float32(p) for p in run(layers, point)]
+                f.write(','.join(f'{v:.9g}' for v in values) + '\n')
+    print(f'Wrote {args.reference}: {nx * ny} rows from {args.model} '
+          f'(float64 evaluation, not the TFLite interpreter)')
+
+
+if __name__ == '__main__':
+    main()
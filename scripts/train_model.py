@@ -120,8 +120,13 @@ def train_model(output_path='model.tflite'):
     print(f"  Confidence: {output_data[0][predicted_class]:.4f}")
 
 
-def test_model(model_path):
-    """Test a saved TFLite model on generated data."""
+def test_model(model_path, reference_path=None):
+    """Test a saved TFLite model on generated data.
+
+    With reference_path, also write every test input and the interpreter's
+    float output as CSV (x, y, p0, p1, ...), which the C++ tester compares
+    the native TFLite importer against.
+    """
     print(f"Loading TFLite model from: {model_path}")
     
     # Load the TFLite model
@@ -175,6 +180,21 @@ def test_model(model_path):
         if predicted_class == y_test[i]:
             correct += 1
 
+    if reference_path:
+        with open(reference_path, 'w') as f:
+            n_out = output_details[0]['shape'][-1]
+            # The C++ tester requires a reference marked as an interpreter dump
+            f.write('# source: tflite interpreter\n')
+            f.write(','.join(['x', 'y'] + [f'p{k}' for k in range(n_out)]) + '\n')
+            for i in range(total):
+                input_data = X_test[i:i+1].astype(np.float32)
+                interpreter.set_tensor(input_details[0]['index'], input_data)
+                interpreter.invoke()
+                output_data = interpreter.get_tensor(output_details[0]['index'])
+                values = list(input_data[0]) + list(output_data[0])
+                f.write(','.join(f'{v:.9g}' for v in values) + '\n')
+        print(f"\nReference outputs written to: {reference_path}")
+
     accuracy = correct / total
     print(f"\nTest Results:")
     print(f"  Correct predictions: {correct}/{total}")
@@ -209,6 +229,13 @@ def main():
         metavar='MODEL_PATH',
         help='Test mode: path to saved TFLite model file'
     )
+    parser.add_argument(
+        '--reference',
+        type=str,
+        metavar='CSV_PATH',
+        help='Test mode: also write inputs and float outputs as CSV '
+             '(the C++ tester reads scripts/model_reference.csv)'
+    )
     parser.add_argument(
         '--output',
         type=str,
@@ -220,7 +247,7 @@ def main():
 
     if args.test:
         # Test mode
-        test_model(args.test)
+        test_model(args.test, args.reference)
     else:
         # Training mode (default)
         train_model(args.output)
@@ -0,0 +1,419 @@
+// src/graph_optimizer.cpp
+// Graph optimizer passes: affine folding, linear merging, dead ReLU pruning.
+
+#include "graph_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace CustomNN {
+
+namespace {
+
+using Node = ModelGraph::Node;
+using OpKind = ModelGraph::OpKind;
+
+Node make_node(OpKind kind, size_t input_size, size_t output_size) {
+    Node node;
+    node.kind = kind;
+    node.input_size = input_size;
+    node.output_size = output_size;
+    return node;
+}
+
+// output = input * weights + bias, accumulated input by input like DenseLayer
+void dense(const Node& node, const float* input, float* output) {
+    std::copy(node.bias.begin(), node.bias.end(), output);
+    for (size_t i = 0; i < node.input_size; ++i) {
+        const float* row = node.weights.data() + i * node.output_size;
+        for (size_t j = 0; j < node.output_size; ++j) {
+            output[j] += input[i] * row[j];
+        }
+    }
+}
+
+void forward(const Node& node, const float* input, float* output) {
+    switch (node.kind) {
+        case OpKind::Dense:
+            dense(node, input, output);
+            return;
+        case OpKind::Affine:
+            for (size_t i = 0; i < node.input_size; ++i) {
+                output[i] = input[i] * node.scale[i] + node.shift[i];
+            }
+            return;
+        case OpKind::ReLU:
+            std::copy(input, input + node.input_size, output);
+            Activation::relu(output, node.input_size);
+            return;
+        case OpKind::Softmax:
+            std::copy(input, input + node.input_size, output);
+            Activation::softmax(output, node.input_size);
+            return;
+    }
+}
+
+// Affine before Dense: x' W + b = x (diag(scale) W) + (shift W + b)
+void fold_into_rows(const Node& affine, Node& layer) {
+    const size_t out = layer.output_size;
+    for (size_t j = 0; j < out; ++j) {
+        double bias = layer.bias[j];
+        for (size_t i = 0; i < layer.input_size; ++i) {
+            bias += static_cast<double>(affine.shift[i]) * layer.weights[i * out + j];
+        }
+        layer.bias[j] = static_cast<float>(bias);
+    }
+    for (size_t i = 0; i < layer.input_size; ++i) {
+        for (size_t j = 0; j < out; ++j) {
+            float& w = layer.weights[i * out + j];
+            w = static_cast<float>(static_cast<double>(w) * affine.scale[i]);
+        }
+    }
+}
+
+// Affine after Dense: (x W + b) * scale + shift = x (W diag(scale)) + (b * scale + shift)
+void fold_into_columns(Node& layer, const Node& affine) {
+    const size_t out = layer.output_size;
+    for (size_t i = 0; i < layer.input_size; ++i) {
+        for (size_t j = 0; j < out; ++j) {
+            float& w = layer.weights[i * out + j];
+            w = static_cast<float>(static_cast<double>(w) * affine.scale[j]);
+        }
+    }
+    for (size_t j = 0; j < out; ++j) {
+        layer.bias[j] = static_cast<float>(static_cast<double>(layer.bias[j]) * affine.scale[j] +
+                                           affine.shift[j]);
+    }
+}
+
+// Two affines in a row: (x * s1 + t1) * s2 + t2
+void fold_into_affine(Node& first, const Node& second) {
+    for (size_t i = 0; i < first.input_size; ++i) {
+        const double s2 = second.scale[i];
+        first.scale[i] = static_cast<float>(first.scale[i] * s2);
+        first.shift[i] = static_cast<float>(first.shift[i] * s2 + second.shift[i]);
+    }
+}
+
+// (x W1 + b1) W2 + b2 = x (W1 W2) + (b1 W2 + b2)
+Node merge(const Node& first, const Node& second) {
+    const size_t in = first.input_size;
+    const size_t mid = first.output_size;
+    const size_t out = second.output_size;
+    Node merged = make_node(OpKind::Dense, in, out);
+    merged.weights.resize(in * out);
+    merged.bias.resize(out);
+    for (size_t l = 0; l < out; ++l) {
+        double bias = second.bias[l];
+        for (size_t j = 0; j < mid; ++j) {
+            bias += static_cast<double>(first.bias[j]) * second.weights[j * out + l];
+        }
+        merged.bias[l] = static_cast<float>(bias);
+        for (size_t i = 0; i < in; ++i) {
+            double sum = 0.0;
+            for (size_t j = 0; j < mid; ++j) {
+                sum += static_cast<double>(first.weights[i * mid + j]) *
+                       second.weights[j * out + l];
+            }
+            merged.weights[i * out + l] = static_cast<float>(sum);
+        }
+    }
+    return merged;
+}
+
+bool is(const std::vector<Node>& nodes, size_t k, OpKind kind) {
+    return k < nodes.size() && nodes[k].kind == kind;
+}
+
+} // namespace
+
+ModelGraph::ModelGraph(size_t input_size)
+  : input_size_(input_size)
+{
+}
+
+size_t ModelGraph::output_size() const {
+    return nodes_.empty() ? input_size_ : nodes_.back().output_size;
+}
+
+bool ModelGraph::add_dense(const float* weights, const float* bias, size_t output_size) {
+    const size_t input_size = this->output_size();
+    if (weights == nullptr || bias == nullptr || input_size == 0 || output_size == 0) {
+        return false;
+    }
+    Node node = make_node(OpKind::Dense, input_size, output_size);
+    node.weights.assign(weights, weights + input_size * output_size);
+    node.bias.assign(bias, bias + output_size);
+    nodes_.push_back(std::move(node));
+    return true;
+}
+
+bool ModelGraph::add_activation(ActivationType activation) {
+    const size_t size = output_size();
+    if (size == 0) {
+        return false;
+    }
+    switch (activation) {
+        case ActivationType::None:
+            return true;
+        case ActivationType::ReLU:
+            nodes_.push_back(make_node(OpKind::ReLU, size, size));
+            return true;
+        case ActivationType::Softmax:
+            nodes_.push_back(make_node(OpKind::Softmax, size, size));
+            return true;
+    }
+    return false;
+}
+
+bool ModelGraph::add_standardize(const float* mean, const float* std) {
+    const size_t size = output_size();
+    if (mean == nullptr || std == nullptr || size == 0) {
+        return false;
+    }
+    Node node = make_node(OpKind::Affine, size, size);
+    for (size_t i = 0; i < size; ++i) {
+        if (std[i] == 0.0f) {
+            return false;
+        }
+        const double scale = 1.0 / static_cast<double>(std[i]);
+        node.scale.push_back(static_cast<float>(scale));
+        node.shift.push_back(static_cast<float>(-mean[i] * scale));
+    }
+    nodes_.push_back(std::move(node));
+    return true;
+}
+
+bool ModelGraph::add_batch_norm(const float* gamma, const float* beta, const float* mean,
+                                const float* variance, float epsilon) {
+    const size_t size = output_size();
+    if (gamma == nullptr || beta == nullptr || mean == nullptr || variance == nullptr ||
+        size == 0) {
+        return false;
+    }
+    Node node = make_node(OpKind::Affine, size, size);
+    for (size_t i = 0; i < size; ++i) {
+        const double denominator = std::sqrt(static_cast<double>(variance[i]) + epsilon);
+        if (!(denominator > 0.0)) {
+            return false;
+        }
+        const double scale = gamma[i] / denominator;
+        node.scale.push_back(static_cast<float>(scale));
+        node.shift.push_back(static_cast<float>(beta[i] - mean[i] * scale));
+    }
+    nodes_.push_back(std::move(node));
+    return true;
+}
+
+bool ModelGraph::add_layers(const ModelExportLayer* layers, size_t num_layers) {
+    if (layers == nullptr) {
+        return false;
+    }
+    for (size_t k = 0; k < num_layers; ++k) {
+        if (layers[k].input_size != output_size()) {
+            return false;
+        }
+        if (!add_dense(layers[k].weights, layers[k].bias, layers[k].output_size) ||
+            !add_activation(layers[k].activation)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t ModelGraph::macs() const {
+    size_t total = 0;
+    for (const Node& node : nodes_) {
+        if (node.kind == OpKind::Dense) {
+            total += node.input_size * node.output_size;
+        } else if (node.kind == OpKind::Affine) {
+            total += node.input_size;
+        }
+    }
+    return total;
+}
+
+void ModelGraph::run(const float* input, float* output) const {
+    size_t widest = input_size_;
+    for (const Node& node : nodes_) {
+        widest = std::max(widest, node.output_size);
+    }
+    std::vector<float> a(input, input + input_size_);
+    std::vector<float> b(widest);
+    a.resize(widest);
+    for (const Node& node : nodes_) {
+        forward(node, a.data(), b.data());
+        a.swap(b);
+    }
+    std::copy(a.begin(), a.begin() + static_cast<std::ptrdiff_t>(output_size()), output);
+}
+
+size_t ModelGraph::fold_affine() {
+    size_t folded = 0;
+    size_t k = 0;
+    while (k < nodes_.size()) {
+        if (nodes_[k].kind != OpKind::Affine) {
+            ++k;
+            continue;
+        }
+        if (k > 0 && nodes_[k - 1].kind == OpKind::Dense) {
+            fold_into_columns(nodes_[k - 1], nodes_[k]);
+        } else if (is(nodes_, k + 1, OpKind::Dense)) {
+            fold_into_rows(nodes_[k], nodes_[k + 1]);
+        } else if (is(nodes_, k + 1, OpKind::Affine)) {
+            fold_into_affine(nodes_[k], nodes_[k + 1]);
+            nodes_.erase(nodes_.begin() + static_cast<std::ptrdiff_t>(k + 1));
+            ++folded;
+            continue;   // Try the combined node again
+        } else {
+            ++k;        // Between activations: nothing linear to fold into
+            continue;
+        }
+        nodes_.erase(nodes_.begin() + static_cast<std::ptrdiff_t>(k));
+        ++folded;
+        k = (k > 0) ? k - 1 : 0;
+    }
+    return folded;
+}
+
+size_t ModelGraph::merge_linear() {
+    size_t merged = 0;
+    size_t k = 0;
+    while (k + 1 < nodes_.size()) {
+        const Node& first = nodes_[k];
+        const Node& second = nodes_[k + 1];
+        if (first.kind == OpKind::Dense && second.kind == OpKind::Dense) {
+            const size_t in = first.input_size;
+            const size_t mid = first.output_size;
+            const size_t out = second.output_size;
+            if (in * out <= in * mid + mid * out) {
+                nodes_[k] = merge(first, second);
+                nodes_.erase(nodes_.begin() + static_cast<std::ptrdiff_t>(k + 1));
+                ++merged;
+                continue;   // The merged layer may merge with the next one too
+            }
+        }
+        ++k;
+    }
+    return merged;
+}
+
+size_t ModelGraph::prune_dead_neurons(const float* calibration, size_t count) {
+    if (calibration == nullptr || count == 0 || nodes_.empty()) {
+        return 0;
+    }
+
+    // Largest pre-activation of every Dense output over the calibration set
+    size_t widest = input_size_;
+    for (const Node& node : nodes_) {
+        widest = std::max(widest, node.output_size);
+    }
+    std::vector<std::vector<float>> peak(nodes_.size());
+    for (size_t k = 0; k < nodes_.size(); ++k) {
+        if (nodes_[k].kind == OpKind::Dense) {
+            peak[k].assign(nodes_[k].output_size, -INFINITY);
+        }
+    }
+    std::vector<float> a(widest);
+    std::vector<float> b(widest);
+    for (size_t s = 0; s < count; ++s) {
+        std::copy(calibration + s * input_size_, calibration + (s + 1) * input_size_, a.begin());
+        for (size_t k = 0; k < nodes_.size(); ++k) {
+            forward(nodes_[k], a.data(), b.data());
+            for (size_t j = 0; j < peak[k].size(); ++j) {
+                peak[k][j] = std::max(peak[k][j], b[j]);
+            }
+            a.swap(b);
+        }
+    }
+
+    // Dense -> ReLU -> Dense: a neuron that never went above 0 only ever fed
+    // zeros to the next layer, so it and its row there can go. Removing it
+    // leaves every other activation on the calibration set unchanged.
+    size_t pruned = 0;
+    for (size_t k = 0; k + 2 < nodes_.size(); ++k) {
+        if (nodes_[k].kind != OpKind::Dense || nodes_[k + 1].kind != OpKind::ReLU ||
+            nodes_[k + 2].kind != OpKind::Dense) {
+            continue;
+        }
+        Node& layer = nodes_[k];
+        Node& next = nodes_[k + 2];
+        std::vector<size_t> live;
+        for (size_t j = 0; j < layer.output_size; ++j) {
+            if (peak[k][j] > 0.0f) {
+                live.push_back(j);
+            }
+        }
+        if (live.empty()) {
+            live.push_back(0);  // Keep the chain connected; it outputs 0 like the rest did
+        }
+        if (live.size() == layer.output_size) {
+            continue;
+        }
+
+        const size_t in = layer.input_size;
+        const size_t old_out = layer.output_size;
+        const size_t new_out = live.size();
+        std::vector<float> weights(in * new_out);
+        std::vector<float> bias(new_out);
+        for (size_t n = 0; n < new_out; ++n) {
+            bias[n] = layer.bias[live[n]];
+            for (size_t i = 0; i < in; ++i) {
+                weights[i * new_out + n] = layer.weights[i * old_out + live[n]];
+            }
+        }
+        std::vector<float> next_weights(new_out * next.output_size);
+        for (size_t n = 0; n < new_out; ++n) {
+            std::copy_n(next.weights.begin() +
+                            static_cast<std::ptrdiff_t>(live[n] * next.output_size),
+                        next.output_size,
+                        next_weights.begin() + static_cast<std::ptrdiff_t>(n * next.output_size));
+        }
+
+        layer.weights = std::move(weights);
+        layer.bias = std::move(bias);
+        layer.output_size = new_out;
+        nodes_[k + 1].input_size = new_out;
+        nodes_[k + 1].output_size = new_out;
+        next.weights = std::move(next_weights);
+        next.input_size = new_out;
+        pruned += old_out - new_out;
+    }
+    return pruned;
+}
+
+ModelGraph::Report ModelGraph::optimize(const float* calibration, size_t count) {
+    Report report{};
+    report.macs_before = macs();
+    report.folded = fold_affine();
+    report.merged = merge_linear();
+    report.pruned = prune_dead_neurons(calibration, count);
+    if (report.pruned > 0) {
+        report.merged += merge_linear();   // Narrower layers may now be worth merging
+    }
+    report.macs_after = macs();
+    return report;
+}
+
+std::vector<ModelExportLayer> ModelGraph::export_layers() const {
+    std::vector<ModelExportLayer> layers;
+    for (size_t k = 0; k < nodes_.size(); ++k) {
+        const Node& node = nodes_[k];
+        if (node.kind != OpKind::Dense) {
+            return {};
+        }
+        ActivationType activation = ActivationType::None;
+        if (is(nodes_, k + 1, OpKind::ReLU)) {
+            activation = ActivationType::ReLU;
+            ++k;
+        } else if (is(nodes_, k + 1, OpKind::Softmax)) {
+            activation = ActivationType::Softmax;
+            ++k;
+        }
+        layers.push_back({node.weights.data(), node.bias.data(), node.input_size,
+                          node.output_size, activation, ModelDType::F32});
+    }
+    return layers;
+}
+
+} // namespace CustomNN
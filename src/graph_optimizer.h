@@ -0,0 +1,148 @@
+// src/graph_optimizer.h
+// Offline optimization passes over a float model before deployment.
+
+#ifndef GRAPH_OPTIMIZER_H
+#define GRAPH_OPTIMIZER_H
+
+#include <cstddef>
+#include <vector>
+
+#include "model_file.h"
+#include "neural_network.h"
+
+namespace CustomNN {
+
+/**
+ * Editable float model: a chain of Dense, per-feature affine (input
+ * standardization, batch norm) and activation nodes
+ *
+ * The passes rewrite the chain into one that computes the same function
+ * with fewer multiply-adds, then export_layers() turns it into plain
+ * Dense layers for DenseLayer, ModelFile::write() or the header tools:
+ *
+ *   fold_affine()         y = x * scale + shift next to a Dense layer is
+ *                         folded into its weights and bias (before it:
+ *                         rows scale, bias absorbs shift * W; after it:
+ *                         columns and bias scale)
+ *   merge_linear()        Dense -> Dense with no activation between
+ *                         becomes one Dense (W1 W2, b1 W2 + b2) when that
+ *                         is fewer multiply-adds (not through a bottleneck)
+ *   prune_dead_neurons()  a ReLU neuron whose pre-activation is <= 0 on
+ *                         every calibration sample outputs exactly 0 on
+ *                         them, so it is removed with its weights in the
+ *                         next Dense layer
+ *
+ * Folding and merging are exact in real arithmetic and are done in double,
+ * so the float results differ only by rounding (the tester's "optimize"
+ * section measures it). Pruning is exact on the calibration samples; an
+ * input unlike all of them could have woken a removed neuron, so calibrate
+ * on data that covers what the device will see.
+ */
+class ModelGraph {
+public:
+    enum class OpKind {
+        Dense,     // output = input * weights + bias
+        Affine,    // output[i] = input[i] * scale[i] + shift[i]
+        ReLU,
+        Softmax
+    };
+
+    struct Node {
+        OpKind kind;
+        size_t input_size;
+        size_t output_size;
+        std::vector<float> weights;   // Dense: [input_size][output_size]
+        std::vector<float> bias;      // Dense: [output_size]
+        std::vector<float> scale;     // Affine: [size]
+        std::vector<float> shift;     // Affine: [size]
+    };
+
+    /**
+     * What optimize() did
+     */
+    struct Report {
+        size_t folded;          // Affine nodes folded into Dense layers
+        size_t merged;          // Dense pairs merged
+        size_t pruned;          // Neurons removed
+        size_t macs_before;
+        size_t macs_after;
+    };
+
+private:
+    std::vector<Node> nodes_;
+    size_t input_size_;
+
+public:
+    /**
+     * @param input_size Width of the model input
+     */
+    explicit ModelGraph(size_t input_size);
+
+    /**
+     * Append nodes. Each takes the current output width as its input.
+     * @return false (and no change) on a shape mismatch
+     */
+    bool add_dense(const float* weights, const float* bias, size_t output_size);
+    bool add_activation(ActivationType activation);
+
+    /**
+     * x' = (x - mean) / std per feature (std must be non-zero)
+     */
+    bool add_standardize(const float* mean, const float* std);
+
+    /**
+     * Inference-mode batch norm per feature:
+     * x' = gamma * (x - mean) / sqrt(variance + epsilon) + beta
+     */
+    bool add_batch_norm(const float* gamma, const float* beta, const float* mean,
+                        const float* variance, float epsilon);
+
+    /**
+     * Append Dense layers with their activations (e.g. an existing model)
+     */
+    bool add_layers(const ModelExportLayer* layers, size_t num_layers);
+
+    size_t input_size() const { return input_size_; }
+    size_t output_size() const;
+    const std::vector<Node>& nodes() const { return nodes_; }
+
+    /**
+     * Multiply-adds per inference: input * output per Dense, size per Affine
+     */
+    size_t macs() const;
+
+    /**
+     * Reference evaluation of the chain as written (float, node by node)
+     * @param input Input vector [input_size()]
+     * @param output Output vector [output_size()]
+     */
+    void run(const float* input, float* output) const;
+
+    /**
+     * The passes; each returns how many rewrites it made
+     */
+    size_t fold_affine();
+    size_t merge_linear();
+
+    /**
+     * @param calibration Inputs [count][input_size()]
+     */
+    size_t prune_dead_neurons(const float* calibration, size_t count);
+
+    /**
+     * All passes to a fixed point: fold, merge, prune, merge
+     */
+    Report optimize(const float* calibration, size_t count);
+
+    /**
+     * The chain as Dense layers, each taking the activation that follows
+     * it (F32, pointing into this graph)
+     * @return Empty if an Affine node is left or an activation does not
+     *         follow a Dense layer
+     */
+    std::vector<ModelExportLayer> export_layers() const;
+};
+
+} // namespace CustomNN
+
+#endif // GRAPH_OPTIMIZER_H
@@ -0,0 +1,114 @@
+// src/parallel_predict.cpp
+// Multi-threaded batch scoring implementation.
+
+#include "parallel_predict.h"
+
+#include <algorithm>
+#include <unistd.h>
+
+namespace CustomNN {
+
+namespace {
+
+// Chunks per worker to aim for, so stealing can even out slow cores
+constexpr size_t kChunksPerWorker = 4;
+
+size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+} // namespace
+
+ParallelPredictor::Worker::Worker(const Layer* const* layers, size_t num_layers,
+                                  size_t scratch_size)
+  : scratch_a(std::max<size_t>(scratch_size, 1)),
+    scratch_b(std::max<size_t>(scratch_size, 1)),
+    model(layers, num_layers, scratch_a.data(), scratch_b.data(), scratch_size)
+{
+}
+
+ParallelPredictor::ParallelPredictor(const Layer* const* layers, size_t num_layers,
+                                     ThreadPool& pool, size_t l2_bytes, Path path)
+  : pool_(pool),
+    input_size_(0),
+    output_size_(0),
+    chunk_size_(CUSTOMNN_BATCH_TILE),
+    path_(path),
+    valid_(false)
+{
+    if (layers == nullptr || num_layers == 0) {
+        return;
+    }
+    for (size_t i = 0; i < num_layers; ++i) {
+        if (layers[i] == nullptr) {
+            return;
+        }
+    }
+
+    const size_t scratch_size = Sequential::scratch_size_for(layers, num_layers,
+                                                             CUSTOMNN_BATCH_TILE);
+    for (size_t w = 0; w < pool_.size(); ++w) {
+        workers_.push_back(std::make_unique<Worker>(layers, num_layers, scratch_size));
+        if (!workers_.back()->model.is_valid()) {
+            return;
+        }
+    }
+    input_size_ = workers_.front()->model.input_size();
+    output_size_ = workers_.front()->model.output_size();
+
+    // A chunk's inputs and outputs take half of L2, in whole batch tiles
+    if (l2_bytes == 0) {
+        l2_bytes = l2_cache_bytes();
+    }
+    const size_t sample_bytes = (input_size_ + output_size_) * sizeof(float);
+    const size_t samples = l2_bytes / 2 / std::max<size_t>(sample_bytes, 1);
+    chunk_size_ = std::max<size_t>(samples / CUSTOMNN_BATCH_TILE, 1) * CUSTOMNN_BATCH_TILE;
+
+    valid_ = true;
+}
+
+size_t ParallelPredictor::l2_cache_bytes() {
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    const long bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (bytes > 0) {
+        return static_cast<size_t>(bytes);
+    }
+#endif
+    return kDefaultL2Bytes;
+}
+
+bool ParallelPredictor::predict(const float* inputs, size_t n, float* outputs) {
+    if (!valid_) {
+        return false;
+    }
+
+    // Smaller chunks for small batches so every worker gets some
+    const size_t spread = round_up(
+        (n + pool_.size() * kChunksPerWorker - 1) / (pool_.size() * kChunksPerWorker),
+        CUSTOMNN_BATCH_TILE);
+    const size_t chunk = std::max<size_t>(std::min(chunk_size_, spread), 1);
+    const size_t num_chunks = (n + chunk - 1) / chunk;
+
+    pool_.parallel_for(num_chunks, [&](size_t task, size_t worker) {
+        const size_t start = task * chunk;
+        const size_t rows = std::min(chunk, n - start);
+        Sequential& model = workers_[worker]->model;
+        if (path_ == Path::Batch) {
+            model.predict_batch(inputs + start * input_size_, rows,
+                                outputs + start * output_size_);
+            return;
+        }
+        for (size_t r = start; r < start + rows; ++r) {
+            model.predict(inputs + r * input_size_, outputs + r * output_size_);
+        }
+    });
+    return true;
+}
+
+bool parallel_predict(const Layer* const* layers, size_t num_layers, ThreadPool& pool,
+                      const float* inputs, size_t n, float* outputs) {
+    ParallelPredictor predictor(layers, num_layers, pool);
+    return predictor.predict(inputs, n, outputs);
+}
+
+} // namespace CustomNN
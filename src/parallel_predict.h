@@ -0,0 +1,111 @@
+// src/parallel_predict.h
+// Multi-threaded batch scoring of a Sequential model on the host.
+
+#ifndef PARALLEL_PREDICT_H
+#define PARALLEL_PREDICT_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "neural_network.h"
+#include "thread_pool.h"
+
+namespace CustomNN {
+
+/**
+ * Splits a batch across a ThreadPool
+ *
+ * The batch is cut into chunks whose inputs and outputs fit in half of the
+ * L2 cache (the shared weights and the per-worker hidden tiles take the
+ * rest), rounded to whole CUSTOMNN_BATCH_TILE tiles, and each chunk runs on
+ * the worker's own Sequential and scratch buffers.
+ *
+ * A chunk runs Sequential::predict_batch() (Path::Batch, the default) or
+ * predict() row by row (Path::PerRow, faster on some small models). The
+ * two paths round differently, so the path is fixed by the caller, never
+ * measured. Every row goes through the same kernels whichever worker and
+ * chunk it lands in, so the outputs are bit-identical to a single-threaded
+ * run of the same path for any thread count, construction or process.
+ */
+class ParallelPredictor {
+public:
+    // How a worker runs its chunk
+    enum class Path {
+        Batch,      // Sequential::predict_batch() on the whole chunk
+        PerRow      // Sequential::predict() on each row
+    };
+
+private:
+    struct Worker {
+        std::vector<float> scratch_a;
+        std::vector<float> scratch_b;
+        Sequential model;
+
+        Worker(const Layer* const* layers, size_t num_layers, size_t scratch_size);
+    };
+
+    ThreadPool& pool_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    size_t input_size_;
+    size_t output_size_;
+    size_t chunk_size_;     // Samples per task
+    Path path_;
+    bool valid_;
+
+public:
+    // Used when the L2 size cannot be queried
+    static constexpr size_t kDefaultL2Bytes = 256 * 1024;
+
+    /**
+     * Constructor
+     * @param layers Array of layer pointers [num_layers] (borrowed, shared
+     *               read-only by every worker)
+     * @param num_layers Number of layers
+     * @param pool Pool to run on (borrowed); one scratch set per worker
+     * @param l2_bytes Per-core L2 size to size chunks for; 0 queries it
+     * @param path How each chunk is run
+     */
+    ParallelPredictor(const Layer* const* layers, size_t num_layers, ThreadPool& pool,
+                      size_t l2_bytes = 0, Path path = Path::Batch);
+
+    /**
+     * L2 cache size of this machine, or kDefaultL2Bytes if unknown
+     */
+    static size_t l2_cache_bytes();
+
+    bool is_valid() const { return valid_; }
+
+    size_t input_size() const { return input_size_; }
+    size_t output_size() const { return output_size_; }
+    size_t chunk_size() const { return chunk_size_; }
+
+    Path path() const { return path_; }
+
+    /**
+     * Switch path (e.g. to match a reference computed with the other one)
+     */
+    void set_path(Path path) { path_ = path; }
+
+    /**
+     * Run inference on a batch of samples across the pool
+     * @param inputs Input matrix [n][input_size()]
+     * @param n Number of samples
+     * @param outputs Output matrix [n][output_size()]
+     * @return false if the model is invalid
+     */
+    bool predict(const float* inputs, size_t n, float* outputs);
+};
+
+/**
+ * One-shot form of ParallelPredictor::predict() on Path::Batch. Builds
+ * every worker's model and scratch per call: to score many batches, keep
+ * a ParallelPredictor and call its predict() instead.
+ * @return false if the layers do not form a valid model
+ */
+bool parallel_predict(const Layer* const* layers, size_t num_layers, ThreadPool& pool,
+                      const float* inputs, size_t n, float* outputs);
+
+} // namespace CustomNN
+
+#endif // PARALLEL_PREDICT_H
@@ -0,0 +1,4011 @@
+// src/tester.cpp
+// Host benchmarks for the CustomNN inference engine (Miko/).
+//
+// Usage: ./pico_ml_tester [section...]
+// With no arguments every section runs; pass section names to run a subset.
+// Each section checks its results (bit-exactness, error bounds, round
+// trips, agreement) as well as timing them; the exit status is non-zero if
+// any check of a selected section failed.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "binary.h"
+#include "code_lut.h"
+#include "codebook.h"
+#include "conv1d.h"
+#include "dense_kernels.h"
+#include "fast_exp.h"
+#include "fixed_point.h"
+#include "graph_optimizer.h"
+#include "half.h"
+#include "inference_cache.h"
+#include "model_file.h"
+#include "model_weights.h"
+#include "model_weights_file.h"
+#include "model_weights_half.h"
+#include "model_weights_int8.h"
+#include "neural_network.h"
+#include "parallel_predict.h"
+#include "quantized.h"
+#include "recurrent.h"
+#include "sparse.h"
+#include "streaming.h"
+#include "temp_model_weights.h"
+#include "temp_model_weights_codebook.h"
+#include "temp_model_weights_file.h"
+#include "temp_model_weights_half.h"
+#include "temp_model_weights_int8.h"
+#include "temp_sensor.h"
+#include "temperature_logs.h"
+#include "thread_pool.h"
+#include "tflite_import.h"
+
+using namespace CustomNN;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Keeps benchmark results observable so the optimizer cannot drop the work
+volatile float g_sink = 0.0f;
+
+template <typename Fn>
+double time_seconds(Fn&& fn) {
+    const auto start = Clock::now();
+    fn();
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+    return elapsed.count();
+}
+
+// Fastest of several runs: the timings least disturbed by the rest of the
+// machine, for results that are compared against each other
+template <typename Fn>
+double best_seconds(Fn&& fn, int runs = 3) {
+    double best = time_seconds(fn);
+    for (int run = 1; run < runs; ++run) {
+        best = std::min(best, time_seconds(fn));
+    }
+    return best;
+}
+
+/**
+ * Pass/fail record of one section. A check that fails prints a FAIL line
+ * with its description; the section returns passed().
+ */
+class Checks {
+public:
+    __attribute__((format(printf, 3, 4)))
+    bool check(bool ok, const char* format, ...) {
+        if (!ok) {
+            ++failures_;
+            std::printf("  FAIL: ");
+            va_list args;
+            va_start(args, format);
+            std::vprintf(format, args);
+            va_end(args);
+            std::printf("\n");
+        }
+        return ok;
+    }
+
+    bool passed() const { return failures_ == 0; }
+    size_t failures() const { return failures_; }
+
+private:
+    size_t failures_ = 0;
+};
+
+std::vector<float> random_vector(size_t n, std::mt19937& rng, float lo, float hi) {
+    std::uniform_real_distribution<float> dist(lo, hi);
+    std::vector<float> v(n);
+    for (float& x : v) {
+        x = dist(rng);
+    }
+    return v;
+}
+
+float max_abs_diff(const float* a, const float* b, size_t n) {
+    float worst = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        worst = std::max(worst, std::fabs(a[i] - b[i]));
+    }
+    return worst;
+}
+
+/**
+ * Dense stack with randomly initialized weights, owned on the host
+ * Used to benchmark shapes wider than the shipped models.
+ */
+class RandomModel {
+public:
+    RandomModel(const std::vector<size_t>& widths, std::mt19937& rng) {
+        const size_t num_layers = widths.size() - 1;
+        weights_.reserve(num_layers);
+        biases_.reserve(num_layers);
+        layers_.reserve(num_layers);
+
+        for (size_t i = 0; i < num_layers; ++i) {
+            const float limit = std::sqrt(6.0f / static_cast<float>(widths[i] + widths[i + 1]));
+            weights_.push_back(random_vector(widths[i] * widths[i + 1], rng, -limit, limit));
+            biases_.push_back(random_vector(widths[i + 1], rng, -0.1f, 0.1f));
+        }
+        for (size_t i = 0; i < num_layers; ++i) {
+            const ActivationType act = (i + 1 == num_layers) ? ActivationType::Softmax
+                                                             : ActivationType::ReLU;
+            layers_.emplace_back(weights_[i].data(), biases_[i].data(),
+                                 widths[i], widths[i + 1], act);
+        }
+        for (const DenseLayer& layer : layers_) {
+            layer_ptrs_.push_back(&layer);
+        }
+    }
+
+    const Layer* const* layers() const { return layer_ptrs_.data(); }
+    size_t num_layers() const { return layer_ptrs_.size(); }
+    const float* weights(size_t i) const { return weights_[i].data(); }
+    const float* bias(size_t i) const { return biases_[i].data(); }
+
+private:
+    std::vector<std::vector<float>> weights_;
+    std::vector<std::vector<float>> biases_;
+    std::vector<DenseLayer> layers_;
+    std::vector<const Layer*> layer_ptrs_;
+};
+
+// ============================================================================
+// Batched predict vs per-sample loop
+// ============================================================================
+
+// Rows below a GEMM register tile (all rows, if the batch tile holds
+// none) run the per-sample path, so there the two timings measure the same
+// code and only have to agree within noise
+constexpr double kSamePathSpeedup = 0.9;
+// Softmax outputs of the batched and per-sample kernels (different
+// summation order, same math)
+constexpr float kBatchTolerance = 1e-5f;
+
+void bench_batch_model(Checks& checks, const char* name, const Layer* const* layers,
+                       size_t num_layers, size_t total_samples) {
+    const size_t tile = CUSTOMNN_BATCH_TILE;
+    const size_t scratch_size = Sequential::scratch_size_for(layers, num_layers, tile);
+    std::vector<float> scratch_a(std::max<size_t>(scratch_size, 1));
+    std::vector<float> scratch_b(std::max<size_t>(scratch_size, 1));
+    Sequential model(layers, num_layers, scratch_a.data(), scratch_b.data(), scratch_size);
+
+    const size_t in = model.input_size();
+    const size_t out = model.output_size();
+    constexpr size_t kMaxBatch = 4096;
+
+    std::mt19937 rng(1234);
+    const std::vector<float> inputs = random_vector(kMaxBatch * in, rng, 15.0f, 30.0f);
+    std::vector<float> single(kMaxBatch * out);
+    std::vector<float> batched(kMaxBatch * out);
+
+    std::printf("\n%s (%zu layers, input %zu, output %zu, tile %zu)\n",
+                name, num_layers, in, out, tile);
+    std::printf("  %6s %16s %16s %9s %12s\n",
+                "batch", "loop samples/s", "batch samples/s", "speedup", "max |diff|");
+
+    for (size_t batch = 1; batch <= kMaxBatch; batch *= 2) {
+        const size_t reps = std::max<size_t>(total_samples / batch, 1);
+
+        const auto time_loop = [&] {
+            return best_seconds([&] {
+                for (size_t rep = 0; rep < reps; ++rep) {
+                    for (size_t r = 0; r < batch; ++r) {
+                        model.predict(&inputs[r * in], &single[r * out]);
+                    }
+                    g_sink = g_sink + single[0];
+                }
+            });
+        };
+        const auto time_batch = [&] {
+            return best_seconds([&] {
+                for (size_t rep = 0; rep < reps; ++rep) {
+                    model.predict_batch(inputs.data(), batch, batched.data());
+                    g_sink = g_sink + batched[0];
+                }
+            });
+        };
+        const bool same_path = batch < Kernels::kGemmRows || tile < Kernels::kGemmRows;
+        const double required = same_path ? kSamePathSpeedup : 1.0;
+        double t_loop = time_loop();
+        double t_batch = time_batch();
+        if (t_loop / t_batch < required) {
+            // Confirm a slow result before failing on it
+            t_loop = std::min(t_loop, time_loop());
+            t_batch = std::min(t_batch, time_batch());
+        }
+
+        const double samples = static_cast<double>(reps * batch);
+        const double speedup = t_loop / t_batch;
+        const float diff = max_abs_diff(single.data(), batched.data(), batch * out);
+        std::printf("  %6zu %16.0f %16.0f %8.2fx %12.3g\n",
+                    batch, samples / t_loop, samples / t_batch, speedup,
+                    static_cast<double>(diff));
+
+        if (same_path) {
+            checks.check(diff == 0.0f, "%s batch %zu: not identical to predict()", name, batch);
+        } else {
+            checks.check(diff <= kBatchTolerance, "%s batch %zu: max |diff| %g", name, batch,
+                         static_cast<double>(diff));
+        }
+        checks.check(speedup >= required, "%s batch %zu: %.2fx of the loop", name, batch,
+                     speedup);
+    }
+}
+
+bool bench_batch() {
+    std::printf("== Batched predict (blocked GEMM) vs per-sample predict ==\n");
+    Checks checks;
+
+    const DenseLayer temp_l1(&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS,
+                             TEMP_LAYER1_INPUT_SIZE, TEMP_LAYER1_OUTPUT_SIZE,
+                             ActivationType::ReLU);
+    const DenseLayer temp_l2(&TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS,
+                             TEMP_LAYER2_INPUT_SIZE, TEMP_LAYER2_OUTPUT_SIZE,
+                             ActivationType::Softmax);
+    const Layer* temp_layers[] = {&temp_l1, &temp_l2};
+    bench_batch_model(checks, "Temperature model 10-8-2", temp_layers, 2, 400000);
+
+    const DenseLayer blob_l1(&LAYER1_WEIGHTS[0][0], LAYER1_BIAS,
+                             LAYER1_INPUT_SIZE, LAYER1_OUTPUT_SIZE, ActivationType::ReLU);
+    const DenseLayer blob_l2(&LAYER2_WEIGHTS[0][0], LAYER2_BIAS,
+                             LAYER2_INPUT_SIZE, LAYER2_OUTPUT_SIZE, ActivationType::Softmax);
+    const Layer* blob_layers[] = {&blob_l1, &blob_l2};
+    bench_batch_model(checks, "Blob model 2-18-3", blob_layers, 2, 400000);
+
+    std::mt19937 rng(42);
+    const RandomModel wide({100, 128, 128, 2}, rng);
+    bench_batch_model(checks, "Wide model 100-128-128-2", wide.layers(), wide.num_layers(),
+                      20000);
+    return checks.passed();
+}
+
+// ============================================================================
+// SIMD kernel variants
+// ============================================================================
+
+bool bench_simd() {
+    std::printf("== Dense kernels per instruction set (active: %s) ==\n",
+                Kernels::active().name);
+    Checks checks;
+
+    const Kernels::Isa isas[] = {Kernels::Isa::Scalar, Kernels::Isa::SSE2,
+                                 Kernels::Isa::AVX2, Kernels::Isa::AVX512};
+    const Kernels::Isa best = Kernels::active().isa;
+
+    struct Shape {
+        size_t rows;
+        size_t cols;
+    };
+    const Shape shapes[] = {{10, 8}, {18, 3}, {100, 128}, {128, 128}, {512, 512}};
+
+    std::mt19937 rng(7);
+    std::printf("\ndense_forward (fused bias), GFLOP/s\n  %-10s", "rows x cols");
+    for (Kernels::Isa isa : isas) {
+        const Kernels::DenseKernels* k = Kernels::kernels_for(isa);
+        std::printf(" %10s", k ? k->name : "-");
+    }
+    std::printf(" %10s\n", "bit-exact");
+
+    for (const Shape& shape : shapes) {
+        const std::vector<float> w = random_vector(shape.rows * shape.cols, rng, -1.0f, 1.0f);
+        const std::vector<float> b = random_vector(shape.cols, rng, -1.0f, 1.0f);
+        const std::vector<float> x = random_vector(shape.rows, rng, -1.0f, 1.0f);
+        std::vector<float> reference(shape.cols);
+        std::vector<float> out(shape.cols);
+
+        Kernels::select(Kernels::Isa::Scalar);
+        MatrixOps::dense_forward(x.data(), w.data(), b.data(), reference.data(),
+                                 shape.rows, shape.cols);
+
+        const size_t flops_per_call = 2 * shape.rows * shape.cols;
+        const size_t reps = std::max<size_t>(200000000 / flops_per_call, 1);
+        bool exact = true;
+
+        char label[32];
+        std::snprintf(label, sizeof(label), "%zu x %zu", shape.rows, shape.cols);
+        std::printf("  %-10s", label);
+        for (Kernels::Isa isa : isas) {
+            if (!Kernels::select(isa)) {
+                std::printf(" %10s", "n/a");
+                continue;
+            }
+            const double t = time_seconds([&] {
+                for (size_t rep = 0; rep < reps; ++rep) {
+                    MatrixOps::dense_forward(x.data(), w.data(), b.data(), out.data(),
+                                             shape.rows, shape.cols);
+                    g_sink = g_sink + out[0];
+                }
+            });
+            exact = exact && std::memcmp(out.data(), reference.data(),
+                                         shape.cols * sizeof(float)) == 0;
+            std::printf(" %10.2f", static_cast<double>(reps * flops_per_call) / t * 1e-9);
+        }
+        std::printf(" %10s\n", exact ? "yes" : "NO");
+        checks.check(exact, "dense_forward %s differs across ISAs", label);
+    }
+
+    // Pre-packed output-major layer against the input-major reference
+    std::printf("\nDenseLayer::forward (packed dot products) vs dense_forward, GFLOP/s\n");
+    std::printf("  %-10s %10s %10s %12s\n", "rows x cols", "kernels", "packed", "max |diff|");
+    for (const Shape& shape : shapes) {
+        const std::vector<float> w = random_vector(shape.rows * shape.cols, rng, -1.0f, 1.0f);
+        const std::vector<float> b = random_vector(shape.cols, rng, -1.0f, 1.0f);
+        const std::vector<float> x = random_vector(shape.rows, rng, -1.0f, 1.0f);
+        const DenseLayer layer(w.data(), b.data(), shape.rows, shape.cols, ActivationType::None);
+        std::vector<float> reference(shape.cols);
+        std::vector<float> out(shape.cols);
+
+        const size_t flops_per_call = 2 * shape.rows * shape.cols;
+        const size_t reps = std::max<size_t>(200000000 / flops_per_call, 1);
+        char label[32];
+        std::snprintf(label, sizeof(label), "%zu x %zu", shape.rows, shape.cols);
+
+        for (Kernels::Isa isa : isas) {
+            if (!Kernels::select(isa)) {
+                continue;
+            }
+            MatrixOps::dense_forward(x.data(), w.data(), b.data(), reference.data(),
+                                     shape.rows, shape.cols);
+            const double t = time_seconds([&] {
+                for (size_t rep = 0; rep < reps; ++rep) {
+                    layer.forward(x.data(), out.data());
+                    g_sink = g_sink + out[0];
+                }
+            });
+            const float diff = max_abs_diff(out.data(), reference.data(), shape.cols);
+            std::printf("  %-10s %10s %10.2f %12.3g\n", label, Kernels::active().name,
+                        static_cast<double>(reps * flops_per_call) / t * 1e-9,
+                        static_cast<double>(diff));
+            // Lane sums reorder the additions: float rounding of sums of
+            // up to 512 products in [-1, 1]
+            checks.check(diff <= 1e-4f, "packed %s on %s: max |diff| %g", label,
+                         Kernels::active().name, static_cast<double>(diff));
+        }
+    }
+
+    // End-to-end batched scoring on a wide model
+    const RandomModel wide({100, 128, 128, 2}, rng);
+    const size_t scratch_size = Sequential::scratch_size_for(wide.layers(), wide.num_layers(),
+                                                             CUSTOMNN_BATCH_TILE);
+    std::vector<float> scratch_a(scratch_size);
+    std::vector<float> scratch_b(scratch_size);
+    Sequential model(wide.layers(), wide.num_layers(), scratch_a.data(), scratch_b.data(),
+                     scratch_size);
+
+    constexpr size_t kBatch = 4096;
+    const std::vector<float> inputs = random_vector(kBatch * 100, rng, 15.0f, 30.0f);
+    std::vector<float> reference(kBatch * 2);
+    std::vector<float> out(kBatch * 2);
+    Kernels::select(Kernels::Isa::Scalar);
+    model.predict_batch(inputs.data(), kBatch, reference.data());
+
+    std::printf("\npredict_batch, wide model 100-128-128-2, batch %zu\n", kBatch);
+    for (Kernels::Isa isa : isas) {
+        if (!Kernels::select(isa)) {
+            continue;
+        }
+        const double t = time_seconds([&] {
+            for (int rep = 0; rep < 5; ++rep) {
+                model.predict_batch(inputs.data(), kBatch, out.data());
+                g_sink = g_sink + out[0];
+            }
+        });
+        const bool exact = std::memcmp(out.data(), reference.data(),
+                                       out.size() * sizeof(float)) == 0;
+        std::printf("  %-8s %12.0f samples/s  bit-exact: %s\n", Kernels::active().name,
+                    5.0 * kBatch / t, exact ? "yes" : "NO");
+        checks.check(exact, "predict_batch on %s differs from scalar", Kernels::active().name);
+    }
+
+    Kernels::select(best);
+    return checks.passed();
+}
+
+// ============================================================================
+// Fused dense + bias + activation
+// ============================================================================
+
+bool bench_fused() {
+    std::printf("== Fused dense + bias + ReLU vs separate passes (kernels: %s) ==\n",
+                Kernels::active().name);
+    Checks checks;
+    std::printf("  %-10s %12s %12s %8s %12s\n", "rows x cols", "3-pass ns", "fused ns",
+                "speedup", "max |diff|");
+
+    struct Shape {
+        size_t rows;
+        size_t cols;
+    };
+    const Shape shapes[] = {{10, 8}, {8, 2}, {2, 18}, {18, 3}, {100, 128}, {512, 512}};
+
+    std::mt19937 rng(11);
+    for (const Shape& shape : shapes) {
+        const std::vector<float> w = random_vector(shape.rows * shape.cols, rng, -1.0f, 1.0f);
+        const std::vector<float> b = random_vector(shape.cols, rng, -1.0f, 1.0f);
+        const std::vector<float> x = random_vector(shape.rows, rng, -1.0f, 1.0f);
+        std::vector<float> separate(shape.cols);
+        std::vector<float> fused(shape.cols);
+
+        const size_t reps = std::max<size_t>(100000000 / (shape.rows * shape.cols), 1);
+
+        // The pre-fusion sequence: matvec, then bias, then ReLU, each a full
+        // pass over the output
+        const double t_separate = time_seconds([&] {
+            for (size_t rep = 0; rep < reps; ++rep) {
+                MatrixOps::matvec_multiply(w.data(), x.data(), separate.data(),
+                                           shape.rows, shape.cols);
+                MatrixOps::vector_add(separate.data(), b.data(), separate.data(), shape.cols);
+                Activation::relu(separate.data(), shape.cols);
+                g_sink = g_sink + separate[0];
+            }
+        });
+        const double t_fused = time_seconds([&] {
+            for (size_t rep = 0; rep < reps; ++rep) {
+                MatrixOps::dense_forward(x.data(), w.data(), b.data(), fused.data(),
+                                         shape.rows, shape.cols, ActivationType::ReLU);
+                g_sink = g_sink + fused[0];
+            }
+        });
+
+        // Bias-first accumulation rounds differently from bias-last
+        char label[48];
+        std::snprintf(label, sizeof(label), "%zu x %zu", shape.rows, shape.cols);
+        const float diff = max_abs_diff(fused.data(), separate.data(), shape.cols);
+        std::printf("  %-10s %12.1f %12.1f %7.2fx %12.3g\n", label,
+                    t_separate / static_cast<double>(reps) * 1e9,
+                    t_fused / static_cast<double>(reps) * 1e9, t_separate / t_fused,
+                    static_cast<double>(diff));
+        checks.check(diff <= 1e-4f, "fused %s: max |diff| %g", label, static_cast<double>(diff));
+    }
+    return checks.passed();
+}
+
+// ============================================================================
+// Int8 quantized path
+// ============================================================================
+
+size_t argmax(const float* values, size_t n) {
+    return static_cast<size_t>(std::max_element(values, values + n) - values);
+}
+
+// Sensor-like windows: a random start in the logged range, then small steps
+std::vector<float> random_walk_windows(size_t count, size_t width, std::mt19937& rng) {
+    std::uniform_real_distribution<float> start(20.0f, 24.5f);
+    std::normal_distribution<float> step(0.0f, 0.15f);
+    std::vector<float> windows(count * width);
+    for (size_t s = 0; s < count; ++s) {
+        float t = start(rng);
+        for (size_t k = 0; k < width; ++k) {
+            windows[s * width + k] = t;
+            t += step(rng);
+        }
+    }
+    return windows;
+}
+
+void bench_int8_model(Checks& checks, const char* name, const Layer* const* layers,
+                      size_t num_layers, const QuantizedDense* const* qlayers,
+                      const std::vector<float>& samples, double min_agreement) {
+    const size_t in = layers[0]->input_size();
+    const size_t out = layers[num_layers - 1]->output_size();
+    const size_t count = samples.size() / in;
+
+    const size_t scratch_size = Sequential::scratch_size_for(layers, num_layers);
+    std::vector<float> scratch_a(std::max<size_t>(scratch_size, 1));
+    std::vector<float> scratch_b(std::max<size_t>(scratch_size, 1));
+    Sequential reference(layers, num_layers, scratch_a.data(), scratch_b.data(), scratch_size);
+
+    const size_t q_size = QuantizedSequential::scratch_size_for(qlayers, num_layers);
+    std::vector<int8_t> q_a(q_size);
+    std::vector<int8_t> q_b(q_size);
+    QuantizedSequential quantized(qlayers, num_layers, q_a.data(), q_b.data(), q_size);
+
+    std::vector<float> expected(count * out);
+    std::vector<float> actual(count * out);
+    const double t_float = time_seconds([&] {
+        for (size_t s = 0; s < count; ++s) {
+            reference.predict(samples.data() + s * in, expected.data() + s * out);
+        }
+    });
+    const double t_int8 = time_seconds([&] {
+        for (size_t s = 0; s < count; ++s) {
+            quantized.predict(samples.data() + s * in, actual.data() + s * out);
+        }
+    });
+
+    size_t agree = 0;
+    for (size_t s = 0; s < count; ++s) {
+        agree += (argmax(expected.data() + s * out, out) == argmax(actual.data() + s * out, out))
+                     ? size_t{1} : size_t{0};
+    }
+
+    const double agreement = static_cast<double>(agree) / static_cast<double>(count);
+    std::printf("  %-24s %10.1f %10.1f %8.2fx %12.4g %9.2f%%\n", name,
+                t_float / static_cast<double>(count) * 1e9,
+                t_int8 / static_cast<double>(count) * 1e9, t_float / t_int8,
+                static_cast<double>(max_abs_diff(expected.data(), actual.data(), expected.size())),
+                100.0 * agreement);
+    checks.check(agreement >= min_agreement, "int8 %s: argmax agreement %.2f%% < %.2f%%",
+                 name, 100.0 * agreement, 100.0 * min_agreement);
+}
+
+bool bench_int8() {
+    // The host has an FPU and SIMD floats; the int8 path is for the FPU-less
+    // RP2040, so the interesting columns here are the two accuracy ones
+    std::printf("== Int8 per-channel path vs float (kernels: %s) ==\n", Kernels::active().name);
+    Checks checks;
+    std::printf("  %-24s %10s %10s %9s %12s %10s\n", "model", "float ns", "int8 ns", "speedup",
+                "max |diff|", "argmax");
+
+    std::mt19937 rng(13);
+
+    // Shipped models with their generated headers
+    const DenseLayer t1(&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, TEMP_LAYER1_INPUT_SIZE,
+                        TEMP_LAYER1_OUTPUT_SIZE, ActivationType::ReLU);
+    const DenseLayer t2(&TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS, TEMP_LAYER2_INPUT_SIZE,
+                        TEMP_LAYER2_OUTPUT_SIZE, ActivationType::Softmax);
+    const Layer* temp_layers[] = {&t1, &t2};
+    const QuantizedDense* temp_q8[] = {&TEMP_LAYER1_Q8, &TEMP_LAYER2_Q8};
+    // The temperature windows sit near the decision boundary, where 8-bit
+    // weights flip the most samples
+    bench_int8_model(checks, "temp 10-8-2", temp_layers, 2, temp_q8,
+                     random_walk_windows(100000, TEMP_LAYER1_INPUT_SIZE, rng), 0.94);
+
+    const DenseLayer b1(&LAYER1_WEIGHTS[0][0], LAYER1_BIAS, LAYER1_INPUT_SIZE, LAYER1_OUTPUT_SIZE,
+                        ActivationType::ReLU);
+    const DenseLayer b2(&LAYER2_WEIGHTS[0][0], LAYER2_BIAS, LAYER2_INPUT_SIZE, LAYER2_OUTPUT_SIZE,
+                        ActivationType::Softmax);
+    const Layer* blob_layers[] = {&b1, &b2};
+    const QuantizedDense* blob_q8[] = {&LAYER1_Q8, &LAYER2_Q8};
+    bench_int8_model(checks, "blobs 2-18-3", blob_layers, 2, blob_q8,
+                     random_vector(100000 * LAYER1_INPUT_SIZE, rng, -12.0f, 12.0f), 0.99);
+
+    // A wider model quantized at run time from its own calibration set
+    const std::vector<size_t> widths = {100, 128, 128, 2};
+    std::vector<std::vector<float>> weights;
+    std::vector<std::vector<float>> biases;
+    std::vector<DenseLayer> wide;
+    std::vector<const Layer*> wide_layers;
+    for (size_t i = 0; i + 1 < widths.size(); ++i) {
+        const float limit = std::sqrt(6.0f / static_cast<float>(widths[i] + widths[i + 1]));
+        weights.push_back(random_vector(widths[i] * widths[i + 1], rng, -limit, limit));
+        biases.push_back(random_vector(widths[i + 1], rng, -0.1f, 0.1f));
+    }
+    for (size_t i = 0; i + 1 < widths.size(); ++i) {
+        const ActivationType act = (i + 2 == widths.size()) ? ActivationType::Softmax
+                                                            : ActivationType::ReLU;
+        wide.emplace_back(weights[i].data(), biases[i].data(), widths[i], widths[i + 1], act);
+    }
+    for (const DenseLayer& layer : wide) {
+        wide_layers.push_back(&layer);
+    }
+
+    const std::vector<float> samples = random_vector(20000 * widths[0], rng, -1.0f, 1.0f);
+    std::vector<QuantParams> params(widths.size());
+    QuantOps::calibrate(wide_layers.data(), wide_layers.size(), samples.data(), 20000,
+                        params.data());
+    std::vector<QuantizedDenseLayer> wide_q8;
+    std::vector<const QuantizedDense*> wide_q8_layers;
+    for (size_t i = 0; i < wide.size(); ++i) {
+        wide_q8.emplace_back(weights[i].data(), biases[i].data(), widths[i], widths[i + 1],
+                             wide[i].activation(), params[i], params[i + 1]);
+    }
+    for (const QuantizedDenseLayer& layer : wide_q8) {
+        wide_q8_layers.push_back(&layer.params());
+    }
+    bench_int8_model(checks, "wide 100-128-128-2", wide_layers.data(), wide_layers.size(),
+                     wide_q8_layers.data(), samples, 0.99);
+    return checks.passed();
+}
+
+// ============================================================================
+// Q15 fixed-point path
+// ============================================================================
+
+// FNV-1a over int16 outputs; equal digests mean bit-identical results, so
+// a device log can be checked against this host run
+uint32_t fnv1a(const int16_t* values, size_t n, uint32_t hash = 2166136261u) {
+    for (size_t i = 0; i < n; ++i) {
+        const uint16_t bits = static_cast<uint16_t>(values[i]);
+        hash = (hash ^ (bits & 0xFFu)) * 16777619u;
+        hash = (hash ^ (bits >> 8u)) * 16777619u;
+    }
+    return hash;
+}
+
+// Sensor-like windows as raw ADC codes: the same walk as random_walk_windows
+// on the code grid the sensor actually produces
+std::vector<uint16_t> random_walk_codes(size_t count, size_t width, std::mt19937& rng) {
+    std::uniform_real_distribution<float> start(881.0f, 891.0f);
+    std::normal_distribution<float> step(0.0f, 0.32f);
+    std::vector<uint16_t> codes(count * width);
+    for (size_t s = 0; s < count; ++s) {
+        float code = start(rng);
+        for (size_t k = 0; k < width; ++k) {
+            codes[s * width + k] = static_cast<uint16_t>(std::lround(code));
+            code += step(rng);
+        }
+    }
+    return codes;
+}
+
+/**
+ * Owns a fixed-point conversion of a float Dense stack with worst-case
+ * activation formats, the way the firmware builds it
+ */
+class FixedModel {
+public:
+    FixedModel(const DenseLayer* const* layers, const float* const* weights,
+               const float* const* biases, size_t num_layers, float input_max_abs) {
+        QFormat format = FixedOps::format_for(input_max_abs);
+        layers_.reserve(num_layers);
+        for (size_t i = 0; i < num_layers; ++i) {
+            const size_t in = layers[i]->input_size();
+            const size_t out = layers[i]->output_size();
+            const QFormat next = FixedOps::output_bound(weights[i], biases[i], in, out, format);
+            layers_.emplace_back(weights[i], biases[i], in, out, layers[i]->activation(),
+                                 format, next);
+            format = next;
+        }
+        for (const FixedDenseLayer& layer : layers_) {
+            params_.push_back(&layer.params());
+        }
+        const size_t size = FixedSequential::scratch_size_for(params_.data(), num_layers);
+        scratch_a_.resize(size);
+        scratch_b_.resize(size);
+        model_ = std::make_unique<FixedSequential>(params_.data(), num_layers, scratch_a_.data(),
+                                                   scratch_b_.data(), size);
+    }
+
+    FixedSequential& model() { return *model_; }
+
+private:
+    std::vector<FixedDenseLayer> layers_;
+    std::vector<const FixedDense*> params_;
+    std::vector<int16_t> scratch_a_;
+    std::vector<int16_t> scratch_b_;
+    std::unique_ptr<FixedSequential> model_;
+};
+
+/**
+ * Modelled Cortex-M0+ cost per operation (cycles at 0 wait states)
+ * Soft-float figures approximate the RP2040 ROM routines behind pico_float;
+ * integer figures are the M0+ instruction timings (single-cycle multiplier,
+ * 2-cycle loads, SIO hardware divider). Swap in measured values if available.
+ */
+struct M0Costs {
+    double fadd = 60, fmul = 55, fdiv = 75, fcmp = 25, i2f = 30, f2i = 30, expf = 500;
+    double load = 2, alu = 1, mul = 1, div = 12;   // div: 8-cycle SIO divider + setup
+    double loop = 3;                               // Compare + taken branch per iteration
+};
+
+struct StageCycles {
+    double read = 0, dense = 0, softmax = 0;
+    double total() const { return read + dense + softmax; }
+};
+
+// Float path: read_temperature(), fused dense (acc = bias; acc += w * x),
+// ReLU compare, softmax with expf and a divide per class
+StageCycles float_cycles(const size_t* widths, size_t num_layers, const M0Costs& c) {
+    StageCycles s;
+    s.read = c.i2f + c.fmul + 2 * c.fadd + c.fdiv;
+    for (size_t i = 0; i < num_layers; ++i) {
+        const double macs = static_cast<double>(widths[i] * widths[i + 1]);
+        const double outs = static_cast<double>(widths[i + 1]);
+        s.dense += macs * (2 * c.load + c.fmul + c.fadd + c.loop) +
+                   outs * (c.load + c.load + c.loop) +
+                   ((i + 1 < num_layers) ? outs * c.fcmp : 0.0);
+    }
+    const double n = static_cast<double>(widths[num_layers]);
+    s.softmax = n * (c.fcmp + c.fadd + c.expf + c.fadd + c.fdiv + 3 * c.loop);
+    return s;
+}
+
+// Fixed path: read_temperature_q16() and the Q shift, int16 MACs into int32,
+// shift_round + ReLU + saturate per output, two-pass softmax with exp2_q15
+StageCycles fixed_cycles(const size_t* widths, size_t num_layers, const M0Costs& c) {
+    StageCycles s;
+    s.read = c.mul + 4 * c.alu + 3 * c.alu;
+    for (size_t i = 0; i < num_layers; ++i) {
+        const double macs = static_cast<double>(widths[i] * widths[i + 1]);
+        const double outs = static_cast<double>(widths[i + 1]);
+        s.dense += macs * (2 * c.load + c.mul + c.alu + c.loop) +
+                   outs * (2 * c.load + 6 * c.alu + 4 * c.alu + c.loop);
+    }
+    // Per class and pass: subtract, scale by log2(e), shift_round, three
+    // rounded Q15 multiplies, final shift; plus the divide in the second pass
+    const double term = c.alu + c.mul + 4 * c.alu + 3 * (c.mul + 2 * c.alu) + 5 * c.alu;
+    const double n = static_cast<double>(widths[num_layers]);
+    s.softmax = n * (c.alu + c.loop) + n * 2 * (term + c.load + c.loop) + n * (c.div + 4 * c.alu);
+    return s;
+}
+
+void bench_fixed_model(Checks& checks, const char* name, const DenseLayer* const* layers,
+                       const float* const* weights, const float* const* biases,
+                       size_t num_layers, float input_max_abs,
+                       const std::vector<float>& float_inputs,
+                       const std::vector<int16_t>& fixed_inputs) {
+    std::vector<const Layer*> layer_ptrs(layers, layers + num_layers);
+    const size_t in = layers[0]->input_size();
+    const size_t out = layers[num_layers - 1]->output_size();
+    const size_t count = float_inputs.size() / in;
+
+    const size_t scratch_size = Sequential::scratch_size_for(layer_ptrs.data(), num_layers);
+    std::vector<float> scratch_a(std::max<size_t>(scratch_size, 1));
+    std::vector<float> scratch_b(std::max<size_t>(scratch_size, 1));
+    Sequential reference(layer_ptrs.data(), num_layers, scratch_a.data(), scratch_b.data(),
+                         scratch_size);
+    FixedModel fixed(layers, weights, biases, num_layers, input_max_abs);
+    FixedSequential& model = fixed.model();
+
+    std::vector<float> expected(count * out);
+    std::vector<int16_t> logits(count * out);
+    std::vector<int16_t> probs(count * out);
+    const double t_float = time_seconds([&] {
+        for (size_t s = 0; s < count; ++s) {
+            reference.predict(float_inputs.data() + s * in, expected.data() + s * out);
+        }
+    });
+    const double t_fixed = time_seconds([&] {
+        for (size_t s = 0; s < count; ++s) {
+            model.predict_fixed(fixed_inputs.data() + s * in, logits.data() + s * out);
+            FixedOps::softmax(logits.data() + s * out, model.output_frac(),
+                              probs.data() + s * out, out);
+        }
+    });
+
+    float worst = 0.0f;
+    size_t agree = 0;
+    for (size_t s = 0; s < count; ++s) {
+        for (size_t k = 0; k < out; ++k) {
+            const float p = FixedOps::to_float(probs[s * out + k], FixedOps::kProbFracBits);
+            worst = std::max(worst, std::fabs(p - expected[s * out + k]));
+        }
+        agree += (argmax(expected.data() + s * out, out) ==
+                  FixedOps::argmax(logits.data() + s * out, out)) ? size_t{1} : size_t{0};
+    }
+
+    const double agreement = static_cast<double>(agree) / static_cast<double>(count);
+    std::printf("  %-24s %10.1f %10.1f %12.4g %9.2f%%   %08x\n", name,
+                t_float / static_cast<double>(count) * 1e9,
+                t_fixed / static_cast<double>(count) * 1e9,
+                static_cast<double>(worst), 100.0 * agreement,
+                fnv1a(logits.data(), logits.size()));
+    checks.check(worst <= 0.02f, "Q15 %s: max |dprob| %g", name, static_cast<double>(worst));
+    checks.check(agreement >= 0.999, "Q15 %s: argmax agreement %.2f%%", name,
+                 100.0 * agreement);
+}
+
+bool bench_fixed() {
+    std::printf("== Q15 fixed-point path vs float ==\n");
+    Checks checks;
+
+    // Sensor conversion over every 12-bit code
+    float worst_temp = 0.0f;
+    for (uint32_t raw = 0; raw < 4096; ++raw) {
+        const uint16_t code = static_cast<uint16_t>(raw);
+        worst_temp = std::max(worst_temp,
+                              std::fabs(FixedOps::to_float(temperature_q16_from_adc(code), 16) -
+                                        temperature_from_adc(code)));
+    }
+    std::printf("  ADC -> Q16.16 temperature, all 4096 codes: max |diff| %.4g C\n",
+                static_cast<double>(worst_temp));
+    checks.check(worst_temp <= 0.01f, "Q16.16 temperature off by %g C",
+                 static_cast<double>(worst_temp));
+
+    // Softmax alone on random logits
+    std::mt19937 rng(17);
+    float worst_softmax = 0.0f;
+    for (size_t t = 0; t < 10000; ++t) {
+        const size_t n = 2 + t % 9;
+        const std::vector<float> x = random_vector(n, rng, -8.0f, 8.0f);
+        std::vector<int16_t> q(n);
+        std::vector<int16_t> p(n);
+        std::vector<float> expected = x;
+        for (size_t k = 0; k < n; ++k) {
+            q[k] = FixedOps::to_fixed(x[k], 11);
+            expected[k] = FixedOps::to_float(q[k], 11);
+        }
+        Activation::softmax(expected.data(), n);
+        FixedOps::softmax(q.data(), 11, p.data(), n);
+        for (size_t k = 0; k < n; ++k) {
+            worst_softmax = std::max(worst_softmax,
+                                     std::fabs(FixedOps::to_float(p[k], 15) - expected[k]));
+        }
+    }
+    std::printf("  Q15 softmax vs expf softmax, 2-10 classes:  max |diff| %.4g\n\n",
+                static_cast<double>(worst_softmax));
+    checks.check(worst_softmax <= 5e-4f, "Q15 softmax off by %g",
+                 static_cast<double>(worst_softmax));
+
+    std::printf("  %-24s %10s %10s %12s %10s   %s\n", "model", "float ns", "fixed ns",
+                "max |dprob|", "argmax", "digest");
+
+    // Temperature model end to end from ADC codes, as the firmware runs it
+    const float* temp_w[] = {&TEMP_LAYER1_WEIGHTS[0][0], &TEMP_LAYER2_WEIGHTS[0][0]};
+    const float* temp_b[] = {TEMP_LAYER1_BIAS, TEMP_LAYER2_BIAS};
+    const DenseLayer t1(temp_w[0], temp_b[0], TEMP_LAYER1_INPUT_SIZE, TEMP_LAYER1_OUTPUT_SIZE,
+                        ActivationType::ReLU);
+    const DenseLayer t2(temp_w[1], temp_b[1], TEMP_LAYER2_INPUT_SIZE, TEMP_LAYER2_OUTPUT_SIZE,
+                        ActivationType::Softmax);
+    const DenseLayer* temp_layers[] = {&t1, &t2};
+    const float temp_range = 100.0f;   // FIXED_INPUT_MAX_C in Miko.cpp
+    const int32_t temp_frac = FixedOps::frac_bits_for(temp_range);
+    const std::vector<uint16_t> codes = random_walk_codes(100000, TEMP_LAYER1_INPUT_SIZE, rng);
+    std::vector<float> temps(codes.size());
+    std::vector<int16_t> temps_q(codes.size());
+    for (size_t k = 0; k < codes.size(); ++k) {
+        temps[k] = temperature_from_adc(codes[k]);
+        temps_q[k] = FixedOps::saturate(
+            FixedOps::shift_round(temperature_q16_from_adc(codes[k]), 16 - temp_frac));
+    }
+    bench_fixed_model(checks, "temp 10-8-2 (from ADC)", temp_layers, temp_w, temp_b, 2, temp_range,
+                      temps, temps_q);
+
+    // Blob classifier on float inputs converted at the model boundary
+    const float* blob_w[] = {&LAYER1_WEIGHTS[0][0], &LAYER2_WEIGHTS[0][0]};
+    const float* blob_b[] = {LAYER1_BIAS, LAYER2_BIAS};
+    const DenseLayer b1(blob_w[0], blob_b[0], LAYER1_INPUT_SIZE, LAYER1_OUTPUT_SIZE,
+                        ActivationType::ReLU);
+    const DenseLayer b2(blob_w[1], blob_b[1], LAYER2_INPUT_SIZE, LAYER2_OUTPUT_SIZE,
+                        ActivationType::Softmax);
+    const DenseLayer* blob_layers[] = {&b1, &b2};
+    const float blob_range = 12.0f;
+    const int32_t blob_frac = FixedOps::frac_bits_for(blob_range);
+    const std::vector<float> blobs = random_vector(100000 * LAYER1_INPUT_SIZE, rng,
+                                                   -blob_range, blob_range);
+    std::vector<float> blobs_exact(blobs.size());
+    std::vector<int16_t> blobs_q(blobs.size());
+    for (size_t k = 0; k < blobs.size(); ++k) {
+        blobs_q[k] = FixedOps::to_fixed(blobs[k], blob_frac);
+        blobs_exact[k] = FixedOps::to_float(blobs_q[k], blob_frac);
+    }
+    bench_fixed_model(checks, "blobs 2-18-3", blob_layers, blob_w, blob_b, 2, blob_range,
+                      blobs_exact, blobs_q);
+
+    // Modelled M0+ cycles for the firmware's per-sample work
+    const M0Costs costs;
+    const size_t temp_widths[] = {TEMP_LAYER1_INPUT_SIZE, TEMP_LAYER1_OUTPUT_SIZE,
+                                  TEMP_LAYER2_OUTPUT_SIZE};
+    const StageCycles f = float_cycles(temp_widths, 2, costs);
+    const StageCycles q = fixed_cycles(temp_widths, 2, costs);
+    std::printf("\n  Modelled Cortex-M0+ cycles per sample, temp 10-8-2 (read + predict)\n");
+    std::printf("  (soft-float fadd %.0f, fmul %.0f, fdiv %.0f, expf %.0f; int mul %.0f, div %.0f)\n",
+                costs.fadd, costs.fmul, costs.fdiv, costs.expf, costs.mul, costs.div);
+    std::printf("  %-12s %10s %10s %10s %10s\n", "path", "read", "dense", "softmax", "total");
+    std::printf("  %-12s %10.0f %10.0f %10.0f %10.0f\n", "float", f.read, f.dense, f.softmax,
+                f.total());
+    std::printf("  %-12s %10.0f %10.0f %10.0f %10.0f\n", "Q15 fixed", q.read, q.dense, q.softmax,
+                q.total());
+    std::printf("  %-12s %10.1fx %9.1fx %9.1fx %9.1fx  (%.1f us saved at 125 MHz)\n", "saving",
+                f.read / q.read, f.dense / q.dense, f.softmax / q.softmax, f.total() / q.total(),
+                (f.total() - q.total()) / 125.0);
+    return checks.passed();
+}
+
+// ============================================================================
+// Fast exp approximations
+// ============================================================================
+
+constexpr ExpApprox kExpMethods[] = {ExpApprox::Exact, ExpApprox::Schraudolph,
+                                     ExpApprox::Polynomial, ExpApprox::Table};
+
+// Modelled M0+ cycles per call from the soft-float operations each method
+// issues (see fast_exp.cpp), priced with M0Costs
+double exp_cycles(ExpApprox method, const M0Costs& c) {
+    switch (method) {
+        case ExpApprox::Schraudolph:   // clamps, a * x + b, f2i, underflow select
+            return 3 * c.fcmp + c.fmul + c.fadd + c.f2i;
+        case ExpApprox::Polynomial:    // + round, Cody-Waite, degree-5 Horner, 2^k
+            return 3 * c.fcmp + 8 * c.fmul + 9 * c.fadd + 4 * c.alu;
+        case ExpApprox::Table:         // + round, table load, (1 + r), 2^n
+            return 3 * c.fcmp + 3 * c.fmul + 4 * c.fadd + c.load + 6 * c.alu;
+        case ExpApprox::Exact:
+            break;
+    }
+    return c.expf;
+}
+
+bool bench_exp() {
+    std::printf("== Fast exp approximations vs expf ==\n");
+    Checks checks;
+
+    // Relative error against double exp over the whole supported range
+    const size_t points = 2000001;
+    const double lo = FastExp::kMinInput;
+    const double hi = FastExp::kMaxInput;
+    std::printf("  %-12s %12s %12s %10s %9s %12s %9s\n", "method", "max rel err", "documented",
+                "host ns", "speedup", "M0+ cycles", "speedup");
+    const M0Costs costs;
+
+    // Softmax arguments are x - max <= 0; most land in [-20, 0]
+    std::mt19937 rng(19);
+    const std::vector<float> inputs = random_vector(1 << 20, rng, -20.0f, 0.0f);
+    std::vector<float> work(inputs.size());
+    const size_t reps = 20;
+    double t_exact = 0.0;
+
+    for (const ExpApprox method : kExpMethods) {
+        double worst = 0.0;
+        for (size_t k = 0; k < points; ++k) {
+            const float x = static_cast<float>(lo + (hi - lo) * static_cast<double>(k) /
+                                                        static_cast<double>(points - 1));
+            const double exact = std::exp(static_cast<double>(x));
+            const double approx = static_cast<double>(FastExp::exp(x, method));
+            worst = std::max(worst, std::fabs(approx / exact - 1.0));
+        }
+
+        const double t = time_seconds([&] {
+            for (size_t rep = 0; rep < reps; ++rep) {
+                std::copy(inputs.begin(), inputs.end(), work.begin());
+                FastExp::exp_inplace(work.data(), work.size(), method);
+                g_sink = g_sink + work[rep];
+            }
+        });
+        if (method == ExpApprox::Exact) {
+            t_exact = t;
+        }
+
+        std::printf("  %-12s %12.3g %12.3g %10.2f %8.2fx %12.0f %8.2fx\n", FastExp::name(method),
+                    worst, static_cast<double>(FastExp::max_rel_error(method)),
+                    t / static_cast<double>(reps * inputs.size()) * 1e9, t_exact / t,
+                    exp_cycles(method, costs),
+                    exp_cycles(ExpApprox::Exact, costs) / exp_cycles(method, costs));
+        // expf itself is documented as exact; allow it one float rounding
+        const double bound = std::max(static_cast<double>(FastExp::max_rel_error(method)),
+                                      1.2e-7);
+        checks.check(worst <= bound, "%s: relative error %g above its documented %g",
+                     FastExp::name(method), worst, bound);
+    }
+    std::printf("  (M0+ cycles modelled from soft-float operation counts; the host has an\n"
+                "   FPU and a tuned expf, so host ns says little about the RP2040)\n");
+
+    // Accuracy impact on the recorded logs: every sliding window through the
+    // temperature model, softmax with each method against expf
+    const DenseLayer t1(&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, TEMP_LAYER1_INPUT_SIZE,
+                        TEMP_LAYER1_OUTPUT_SIZE, ActivationType::ReLU);
+    const DenseLayer t2(&TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS, TEMP_LAYER2_INPUT_SIZE,
+                        TEMP_LAYER2_OUTPUT_SIZE, ActivationType::None);
+    const Layer* layers[] = {&t1, &t2};
+    const size_t scratch_size = Sequential::scratch_size_for(layers, 2);
+    std::vector<float> scratch_a(scratch_size);
+    std::vector<float> scratch_b(scratch_size);
+    Sequential logits_model(layers, 2, scratch_a.data(), scratch_b.data(), scratch_size);
+
+    const size_t width = TEMP_LAYER1_INPUT_SIZE;
+    const size_t out = TEMP_LAYER2_OUTPUT_SIZE;
+    const float threshold = 0.7f;   // DETECTION_THRESHOLD in Miko.cpp
+    std::printf("\n  %-12s %-12s %8s %12s %10s %12s\n", "log", "method", "windows",
+                "max |dprob|", "argmax", "detections");
+
+    for (const char* path : {"touched.csv", "normal.csv"}) {
+        const std::vector<float> temps = read_temperatures(path);
+        if (!checks.check(temps.size() >= width, "%s not found (run from the repository root)",
+                          path)) {
+            continue;
+        }
+        const size_t count = temps.size() - width + 1;
+        std::vector<float> logits(count * out);
+        for (size_t s = 0; s < count; ++s) {
+            logits_model.predict(temps.data() + s, logits.data() + s * out);
+        }
+
+        std::vector<float> reference = logits;
+        for (size_t s = 0; s < count; ++s) {
+            Activation::softmax(reference.data() + s * out, out, ExpApprox::Exact);
+        }
+
+        for (const ExpApprox method : kExpMethods) {
+            std::vector<float> probs = logits;
+            for (size_t s = 0; s < count; ++s) {
+                Activation::softmax(probs.data() + s * out, out, method);
+            }
+
+            size_t agree = 0;
+            size_t detections = 0;
+            size_t detections_ref = 0;
+            for (size_t s = 0; s < count; ++s) {
+                agree += (argmax(probs.data() + s * out, out) ==
+                          argmax(reference.data() + s * out, out)) ? size_t{1} : size_t{0};
+                detections += (probs[s * out + 1] > threshold) ? size_t{1} : size_t{0};
+                detections_ref += (reference[s * out + 1] > threshold) ? size_t{1} : size_t{0};
+            }
+
+            char detected[32];
+            std::snprintf(detected, sizeof(detected), "%zu/%zu", detections, detections_ref);
+            std::printf("  %-12s %-12s %8zu %12.3g %9.2f%% %12s\n", path, FastExp::name(method),
+                        count,
+                        static_cast<double>(max_abs_diff(probs.data(), reference.data(),
+                                                         probs.size())),
+                        100.0 * static_cast<double>(agree) / static_cast<double>(count),
+                        detected);
+            // exp is monotonic in every method, so the class never flips; the
+            // threshold can, but only for the coarse Schraudolph method
+            checks.check(agree == count, "%s %s: argmax changed on %zu windows", path,
+                         FastExp::name(method), count - agree);
+            if (method != ExpApprox::Schraudolph) {
+                checks.check(detections == detections_ref, "%s %s: %s detections", path,
+                             FastExp::name(method), detected);
+            }
+        }
+    }
+    return checks.passed();
+}
+
+// ============================================================================
+// Class decisions on logits
+// ============================================================================
+
+void bench_class_model(Checks& checks, const char* name, const Layer* const* layers,
+                       size_t num_layers, const std::vector<float>& samples) {
+    const size_t in = layers[0]->input_size();
+    const size_t out = layers[num_layers - 1]->output_size();
+    const size_t count = samples.size() / in;
+
+    const size_t scratch_size = Sequential::scratch_size_for(layers, num_layers);
+    std::vector<float> scratch_a(std::max<size_t>(scratch_size, 1));
+    std::vector<float> scratch_b(std::max<size_t>(scratch_size, 1));
+    Sequential model(layers, num_layers, scratch_a.data(), scratch_b.data(), scratch_size);
+
+    std::vector<float> probs(out);
+    std::vector<float> logits(out);
+    std::vector<int> expected(count);
+    std::vector<int> actual(count);
+    const double t_softmax = time_seconds([&] {
+        for (size_t s = 0; s < count; ++s) {
+            model.predict(samples.data() + s * in, probs.data());
+            expected[s] = static_cast<int>(argmax(probs.data(), out));
+        }
+    });
+    const double t_logits = time_seconds([&] {
+        for (size_t s = 0; s < count; ++s) {
+            actual[s] = model.predict_class(samples.data() + s * in, logits.data());
+        }
+    });
+
+    // Top-k order must match a full sort of the probabilities
+    const size_t k = std::min<size_t>(3, out);
+    std::vector<size_t> top(k);
+    std::vector<size_t> order(out);
+    size_t agree = 0;
+    size_t topk_agree = 0;
+    for (size_t s = 0; s < count; ++s) {
+        agree += (expected[s] == actual[s]) ? size_t{1} : size_t{0};
+
+        model.predict(samples.data() + s * in, probs.data());
+        for (size_t c = 0; c < out; ++c) {
+            order[c] = c;
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [&](size_t a, size_t b) { return probs[a] > probs[b]; });
+        model.predict_topk(samples.data() + s * in, k, top.data(), logits.data());
+        topk_agree += std::equal(top.begin(), top.end(), order.begin()) ? size_t{1} : size_t{0};
+    }
+
+    std::printf("  %-24s %12.1f %12.1f %8.2fx %9.2f%% %9.2f%%\n", name,
+                t_softmax / static_cast<double>(count) * 1e9,
+                t_logits / static_cast<double>(count) * 1e9, t_softmax / t_logits,
+                100.0 * static_cast<double>(agree) / static_cast<double>(count),
+                100.0 * static_cast<double>(topk_agree) / static_cast<double>(count));
+    checks.check(agree == count, "%s: predict_class differs from argmax on %zu samples", name,
+                 count - agree);
+    checks.check(topk_agree == count, "%s: predict_topk differs from the sorted softmax on %zu "
+                 "samples", name, count - topk_agree);
+}
+
+bool bench_class() {
+    std::printf("== predict_class on logits vs argmax after softmax (kernels: %s) ==\n",
+                Kernels::active().name);
+    Checks checks;
+    std::printf("  %-24s %12s %12s %9s %10s %10s\n", "model", "softmax ns", "logits ns",
+                "speedup", "argmax", "top-3");
+
+    std::mt19937 rng(23);
+
+    const DenseLayer t1(&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, TEMP_LAYER1_INPUT_SIZE,
+                        TEMP_LAYER1_OUTPUT_SIZE, ActivationType::ReLU);
+    const DenseLayer t2(&TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS, TEMP_LAYER2_INPUT_SIZE,
+                        TEMP_LAYER2_OUTPUT_SIZE, ActivationType::Softmax);
+    const Layer* temp_layers[] = {&t1, &t2};
+    bench_class_model(checks, "temp 10-8-2", temp_layers, 2,
+                      random_walk_windows(100000, TEMP_LAYER1_INPUT_SIZE, rng));
+
+    const DenseLayer b1(&LAYER1_WEIGHTS[0][0], LAYER1_BIAS, LAYER1_INPUT_SIZE, LAYER1_OUTPUT_SIZE,
+                        ActivationType::ReLU);
+    const DenseLayer b2(&LAYER2_WEIGHTS[0][0], LAYER2_BIAS, LAYER2_INPUT_SIZE, LAYER2_OUTPUT_SIZE,
+                        ActivationType::Softmax);
+    const Layer* blob_layers[] = {&b1, &b2};
+    bench_class_model(checks, "blobs 2-18-3", blob_layers, 2,
+                      random_vector(100000 * LAYER1_INPUT_SIZE, rng, -12.0f, 12.0f));
+
+    const RandomModel wide({64, 64, 10}, rng);
+    bench_class_model(checks, "random 64-64-10", wide.layers(), wide.num_layers(),
+                      random_vector(100000 * 64, rng, -1.0f, 1.0f));
+
+    // NeuralNetwork used to assume three classes; the temperature model has two
+    NeuralNetwork temp_net(&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, TEMP_LAYER1_INPUT_SIZE,
+                           TEMP_LAYER1_OUTPUT_SIZE, &TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS,
+                           TEMP_LAYER2_INPUT_SIZE, TEMP_LAYER2_OUTPUT_SIZE);
+    const std::vector<float> windows = random_walk_windows(10000, TEMP_LAYER1_INPUT_SIZE, rng);
+    size_t in_range = 0;
+    float probs[TEMP_LAYER2_OUTPUT_SIZE];
+    size_t agree = 0;
+    for (size_t s = 0; s < 10000; ++s) {
+        const float* window = windows.data() + s * TEMP_LAYER1_INPUT_SIZE;
+        const int c = temp_net.predict_class(window);
+        temp_net.predict(window, probs);
+        in_range += (c >= 0 && static_cast<size_t>(c) < TEMP_LAYER2_OUTPUT_SIZE) ? size_t{1}
+                                                                                 : size_t{0};
+        agree += (static_cast<size_t>(c) == argmax(probs, TEMP_LAYER2_OUTPUT_SIZE)) ? size_t{1}
+                                                                                    : size_t{0};
+    }
+    std::printf("  NeuralNetwork temp predict_class: %zu/10000 in range, %zu/10000 match argmax\n",
+                in_range, agree);
+    checks.check(in_range == 10000 && agree == 10000, "NeuralNetwork predict_class");
+
+    // Layers that do not chain: predict reports it and leaves the output alone
+    NeuralNetwork broken(&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, TEMP_LAYER1_INPUT_SIZE,
+                         TEMP_LAYER1_OUTPUT_SIZE, &TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS,
+                         TEMP_LAYER2_INPUT_SIZE + 1, TEMP_LAYER2_OUTPUT_SIZE);
+    float untouched[TEMP_LAYER2_OUTPUT_SIZE] = {-1.0f, -1.0f};
+    const bool ran = broken.predict(windows.data(), untouched);
+    std::printf("  NeuralNetwork with l1_out != l2_in: is_valid %s, predict %s, output %s\n",
+                broken.is_valid() ? "true" : "false", ran ? "true" : "false",
+                (untouched[0] == -1.0f && untouched[1] == -1.0f) ? "untouched" : "WRITTEN");
+    checks.check(!broken.is_valid() && !ran && untouched[0] == -1.0f && untouched[1] == -1.0f,
+                 "NeuralNetwork with mismatched layers ran");
+    return checks.passed();
+}
+
+// ============================================================================
+// Logit-margin binary decisions
+// ============================================================================
+
+bool bench_margin() {
+    Checks checks;
+    const float threshold = 0.7f;   // DETECTION_THRESHOLD in Miko.cpp
+    std::printf("== Binary decision: logit margin vs softmax threshold (t = %.2f, margin %.4f) ==\n",
+                static_cast<double>(threshold),
+                static_cast<double>(BinaryClassifier::margin_for(threshold)));
+
+    NeuralNetwork softmax_net(&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS,
+                              TEMP_LAYER1_INPUT_SIZE, TEMP_LAYER1_OUTPUT_SIZE,
+                              &TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS,
+                              TEMP_LAYER2_INPUT_SIZE, TEMP_LAYER2_OUTPUT_SIZE);
+    BinaryClassifier margin_net(&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS,
+                                TEMP_LAYER1_INPUT_SIZE, TEMP_LAYER1_OUTPUT_SIZE,
+                                &TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS,
+                                TEMP_LAYER2_INPUT_SIZE, TEMP_LAYER2_OUTPUT_SIZE, threshold);
+
+    std::mt19937 rng(29);
+    struct Source {
+        const char* name;
+        std::vector<float> temps;   // Windows are every consecutive run
+        bool sliding;
+    };
+    Source sources[] = {
+        {"touched.csv", read_temperatures("touched.csv"), true},
+        {"normal.csv", read_temperatures("normal.csv"), true},
+        {"random walks", random_walk_windows(100000, TEMP_LAYER1_INPUT_SIZE, rng), false},
+    };
+
+    const size_t width = TEMP_LAYER1_INPUT_SIZE;
+    std::printf("  %-14s %8s %12s %12s %9s %10s %12s\n", "windows", "count", "softmax ns",
+                "margin ns", "speedup", "agree", "max |dprob|");
+    for (const Source& source : sources) {
+        if (!checks.check(source.temps.size() >= width,
+                          "%s not found (run from the repository root)", source.name)) {
+            continue;
+        }
+        const size_t count = source.sliding ? source.temps.size() - width + 1
+                                            : source.temps.size() / width;
+        const size_t step = source.sliding ? 1 : width;
+
+        std::vector<char> by_softmax(count);
+        std::vector<char> by_margin(count);
+        std::vector<float> touched(count);
+        std::vector<float> margins(count);
+        float probs[TEMP_LAYER2_OUTPUT_SIZE];
+        const double t_softmax = time_seconds([&] {
+            for (size_t s = 0; s < count; ++s) {
+                softmax_net.predict(source.temps.data() + s * step, probs);
+                by_softmax[s] = probs[1] > threshold;
+                touched[s] = probs[1];
+            }
+        });
+        const double t_margin = time_seconds([&] {
+            for (size_t s = 0; s < count; ++s) {
+                by_margin[s] = margin_net.decide(source.temps.data() + s * step, &margins[s]);
+            }
+        });
+
+        size_t agree = 0;
+        float worst = 0.0f;
+        for (size_t s = 0; s < count; ++s) {
+            agree += (by_softmax[s] == by_margin[s]) ? size_t{1} : size_t{0};
+            worst = std::max(worst,
+                             std::fabs(BinaryClassifier::probability(margins[s]) - touched[s]));
+        }
+        std::printf("  %-14s %8zu %12.1f %12.1f %8.2fx %9.2f%% %12.3g\n", source.name, count,
+                    t_softmax / static_cast<double>(count) * 1e9,
+                    t_margin / static_cast<double>(count) * 1e9, t_softmax / t_margin,
+                    100.0 * static_cast<double>(agree) / static_cast<double>(count),
+                    static_cast<double>(worst));
+        checks.check(agree == count, "%s: margin and softmax disagree on %zu windows",
+                     source.name, count - agree);
+        checks.check(worst <= 1e-6f, "%s: margin probability off by %g", source.name,
+                     static_cast<double>(worst));
+    }
+    return checks.passed();
+}
+
+// ============================================================================
+// Sparse (pruned) dense layers
+// ============================================================================
+
+// Modelled M0+ cycles per stored weight: the dense kernel loads the weight
+// and the input; CSR also loads the index and adds it to the input base
+double m0_dense_cycles_per_weight(const M0Costs& c) {
+    return 2 * c.load + c.fmul + c.fadd + c.loop;
+}
+
+double m0_csr_cycles_per_weight(const M0Costs& c) {
+    return 3 * c.load + c.alu + c.fmul + c.fadd + c.loop;
+}
+
+// Modelled M0+ cycles per output row: bias load, ReLU compare, store and
+// loop; CSR also loads the row's two offsets
+double m0_dense_cycles_per_row(const M0Costs& c) {
+    return 2 * c.load + c.fcmp + c.loop;
+}
+
+double m0_csr_cycles_per_row(const M0Costs& c) {
+    return 4 * c.load + c.fcmp + c.loop;
+}
+
+// Least-squares fit of time ~ a * x1 + b * x2 in relative error (each
+// sample weighted by 1 / time, so small layers count as much as big ones)
+struct CostFit {
+    double per_weight;
+    double per_row;
+};
+
+CostFit fit_costs(const std::vector<double>& x1, const std::vector<double>& x2,
+                  const std::vector<double>& t) {
+    double s11 = 0.0, s12 = 0.0, s22 = 0.0, r1 = 0.0, r2 = 0.0;
+    for (size_t k = 0; k < t.size(); ++k) {
+        const double u = x1[k] / t[k];
+        const double v = x2[k] / t[k];
+        s11 += u * u;
+        s12 += u * v;
+        s22 += v * v;
+        r1 += u;
+        r2 += v;
+    }
+    const double det = s11 * s22 - s12 * s12;
+    if (det == 0.0) {
+        return {0.0, 0.0};
+    }
+    return {(r1 * s22 - r2 * s12) / det, (r2 * s11 - r1 * s12) / det};
+}
+
+// The modelled choice may run this much slower than the faster kernel
+// (measured: within 1.4x at every shape and density, the worst next to a
+// crossover where the two kernels are close). Checked only against the
+// packed dense kernel the host cost defaults are fitted to.
+constexpr double kSparseChoiceSlack = 1.5;
+
+bool bench_sparse() {
+    std::printf("== Sparse CSR dense layers vs packed dense (kernels: %s) ==\n",
+                Kernels::active().name);
+    Checks checks;
+
+    struct Shape {
+        size_t rows;
+        size_t cols;
+    };
+    const Shape shapes[] = {{10, 8}, {18, 3}, {64, 64}, {256, 256}, {512, 512}};
+    const float densities[] = {1.0f, 0.75f, 0.5f, 0.3f, 0.2f, 0.1f, 0.05f};
+    const Kernels::DenseKernels* scalar = Kernels::kernels_for(Kernels::Isa::Scalar);
+
+    // Per measurement: shape, non-zeros and both kernels' ns per forward
+    struct Sample {
+        size_t rows;
+        size_t cols;
+        size_t nonzeros;
+        double dense_ns;
+        double csr_ns;
+    };
+    std::vector<Sample> samples;
+
+    std::mt19937 rng(41);
+    std::printf("  %-10s %7s %11s %11s %8s %10s %11s %6s\n", "rows x cols", "density",
+                "dense ns", "csr ns", "speedup", "vs scalar", "csr / dense B", "model");
+    for (const Shape& shape : shapes) {
+        const size_t count = shape.rows * shape.cols;
+        const std::vector<float> w = random_vector(count, rng, -1.0f, 1.0f);
+        const std::vector<float> b = random_vector(shape.cols, rng, -1.0f, 1.0f);
+        const std::vector<float> x = random_vector(shape.rows, rng, -1.0f, 1.0f);
+        std::vector<float> pruned(count);
+        std::vector<float> expected(shape.cols);
+        std::vector<float> dense_out(shape.cols);
+        std::vector<float> sparse_out(shape.cols);
+        const size_t reps = std::max<size_t>(50000000 / count, 1);
+
+        float crossover = 0.0f;
+        for (float density : densities) {
+            const size_t nonzeros = SparseOps::prune(w.data(), pruned.data(), count, density);
+            const DenseLayer dense(pruned.data(), b.data(), shape.rows, shape.cols,
+                                   ActivationType::ReLU);
+            const SparseDenseLayer sparse(pruned.data(), b.data(), shape.rows, shape.cols,
+                                          ActivationType::ReLU);
+            char label[48];
+            std::snprintf(label, sizeof(label), "%zu x %zu", shape.rows, shape.cols);
+            if (!sparse.is_valid()) {
+                std::printf("  %-10s %6.0f%%  (%zu non-zeros exceed the uint16 row offsets)\n",
+                            label, 100.0 * static_cast<double>(density), nonzeros);
+                continue;
+            }
+
+            // ns per forward of each kernel; a slow modelled pick is
+            // re-measured once before it counts
+            double dense_ns = 0.0;
+            double csr_ns = 0.0;
+            const auto measure = [&] {
+                dense_ns = best_seconds([&] {
+                    for (size_t rep = 0; rep < reps; ++rep) {
+                        dense.forward(x.data(), dense_out.data());
+                        g_sink = g_sink + dense_out[0];
+                    }
+                }) / static_cast<double>(reps) * 1e9;
+                csr_ns = best_seconds([&] {
+                    for (size_t rep = 0; rep < reps; ++rep) {
+                        sparse.forward(x.data(), sparse_out.data());
+                        g_sink = g_sink + sparse_out[0];
+                    }
+                }) / static_cast<double>(reps) * 1e9;
+            };
+            const bool model_sparse = SparseOps::prefer_sparse(shape.rows, shape.cols, nonzeros);
+            const auto chosen_slowdown = [&] {
+                return (model_sparse ? csr_ns : dense_ns) / std::min(dense_ns, csr_ns);
+            };
+            measure();
+            if (DenseLayer::kPacked && chosen_slowdown() > kSparseChoiceSlack) {
+                measure();
+            }
+            if (csr_ns < dense_ns) {
+                crossover = std::max(crossover, density);
+            }
+            samples.push_back({shape.rows, shape.cols, nonzeros, dense_ns, csr_ns});
+
+            // Same summation order as the scalar input-major kernel: exact
+            scalar->dense(pruned.data(), b.data(), x.data(), expected.data(), shape.rows,
+                          shape.cols, true);
+
+            const float diff = max_abs_diff(sparse_out.data(), expected.data(), shape.cols);
+            std::printf("  %-10s %6.0f%% %11.1f %11.1f %7.2fx %10.3g %5zu/%-5zu %6s\n", label,
+                        100.0 * static_cast<double>(nonzeros) / static_cast<double>(count),
+                        dense_ns, csr_ns, dense_ns / csr_ns, static_cast<double>(diff),
+                        SparseOps::storage_bytes(nonzeros, shape.cols),
+                        (count + shape.cols) * sizeof(float), model_sparse ? "csr" : "dense");
+            checks.check(diff == 0.0f, "CSR %s @ %.0f%% differs from the scalar kernel", label,
+                         100.0 * static_cast<double>(density));
+            checks.check(!DenseLayer::kPacked || chosen_slowdown() <= kSparseChoiceSlack,
+                         "model picks %s for %s @ %.0f%%, %.2fx slower than the other kernel",
+                         model_sparse ? "CSR" : "dense", label,
+                         100.0 * static_cast<double>(density), chosen_slowdown());
+        }
+        std::printf("  %-10s CSR faster up to density %.0f%%, model crossover %.0f%%\n", "",
+                    100.0 * static_cast<double>(crossover),
+                    100.0 * static_cast<double>(SparseOps::crossover(shape.rows, shape.cols)));
+    }
+
+    // Per-weight and per-row costs fitted to the measurements: the values
+    // for the CUSTOMNN_SPARSE_*_COST defaults on this machine
+    std::vector<double> weights, rows, dense_ns, stored, csr_ns;
+    for (const Sample& sample : samples) {
+        weights.push_back(static_cast<double>(sample.rows * sample.cols));
+        rows.push_back(static_cast<double>(sample.cols));
+        dense_ns.push_back(sample.dense_ns);
+        stored.push_back(static_cast<double>(sample.nonzeros));
+        csr_ns.push_back(sample.csr_ns);
+    }
+    const CostFit dense_fit = fit_costs(weights, rows, dense_ns);
+    const CostFit csr_fit = fit_costs(stored, rows, csr_ns);
+    std::printf("  fitted host ns:  dense %.3f/weight + %.2f/row, CSR %.3f/weight + %.2f/row\n",
+                dense_fit.per_weight, dense_fit.per_row, csr_fit.per_weight, csr_fit.per_row);
+    std::printf("  in use (CUSTOMNN_SPARSE_*_COST): dense %.3f/weight + %.2f/row, "
+                "CSR %.3f/weight + %.2f/row\n",
+                static_cast<double>(SparseOps::kDenseWeightCost),
+                static_cast<double>(SparseOps::kDenseRowCost),
+                static_cast<double>(SparseOps::kCsrWeightCost),
+                static_cast<double>(SparseOps::kCsrRowCost));
+
+    // The RP2040 build's costs (Miko/CMakeLists.txt) and the crossover
+    // they give on the temperature model's first layer
+    const M0Costs c;
+    const double m0_dense_weight = m0_dense_cycles_per_weight(c);
+    const double m0_dense_row = m0_dense_cycles_per_row(c);
+    const double m0_csr_weight = m0_csr_cycles_per_weight(c);
+    const double m0_csr_row = m0_csr_cycles_per_row(c);
+    const double m0_crossover =
+        std::min(1.0, (80 * m0_dense_weight + 8 * (m0_dense_row - m0_csr_row)) /
+                          (80 * m0_csr_weight));
+    std::printf("  modelled M0+ cycles: dense %.0f/weight + %.0f/row, CSR %.0f/weight + %.0f/row"
+                " -> 10 x 8 crossover %.0f%%\n", m0_dense_weight, m0_dense_row, m0_csr_weight,
+                m0_csr_row, 100.0 * m0_crossover);
+
+    // Automatic selection on the bundled models and a pruned wide layer
+    struct Candidate {
+        const char* name;
+        std::vector<float> weights;
+        size_t rows;
+        size_t cols;
+    };
+    std::vector<float> wide = random_vector(256 * 256, rng, -1.0f, 1.0f);
+    SparseOps::prune(wide.data(), wide.data(), wide.size(), 0.05f);
+    const Candidate candidates[] = {
+        {"temp layer 1", std::vector<float>(&TEMP_LAYER1_WEIGHTS[0][0],
+                                            &TEMP_LAYER1_WEIGHTS[0][0] + 80), 10, 8},
+        {"256 x 256 @ 5%", wide, 256, 256},
+    };
+    const std::vector<float> zeros(256, 0.0f);
+    for (const Candidate& candidate : candidates) {
+        const std::unique_ptr<Layer> layer(SparseOps::make_layer(
+            candidate.weights.data(), zeros.data(), candidate.rows, candidate.cols,
+            ActivationType::None));
+        const float density = SparseOps::density(candidate.weights.data(),
+                                                 candidate.weights.size());
+        const bool chose_sparse = dynamic_cast<const SparseDenseLayer*>(layer.get()) != nullptr;
+        std::printf("  make_layer(%s, density %.0f%%): %s\n", candidate.name,
+                    100.0 * static_cast<double>(density),
+                    chose_sparse ? "SparseDenseLayer" : "DenseLayer");
+        const size_t nonzeros = SparseOps::count_nonzero(candidate.weights.data(),
+                                                         candidate.weights.size());
+        checks.check(chose_sparse ==
+                         SparseOps::prefer_sparse(candidate.rows, candidate.cols, nonzeros),
+                     "make_layer(%s) chose against the cost model", candidate.name);
+    }
+
+    // ReLU as the dense kernels apply it: -0 and NaN sums give +0 (an
+    // empty CSR row leaves the bias as the sum)
+    const float edge_bias[] = {-0.0f, std::nanf(""), -1.0f, 2.0f};
+    const float edge_weights[2 * 4] = {};
+    const float edge_input[2] = {1.0f, 1.0f};
+    float edge_sparse[4];
+    float edge_dense[4];
+    const SparseDenseLayer edge(edge_weights, edge_bias, 2, 4, ActivationType::ReLU);
+    edge.forward(edge_input, edge_sparse);
+    scalar->dense(edge_weights, edge_bias, edge_input, edge_dense, 2, 4, true);
+    checks.check(std::memcmp(edge_sparse, edge_dense, sizeof(edge_dense)) == 0,
+                 "CSR ReLU of -0 / NaN sums differs from the dense kernel");
+    return checks.passed();
+}
+
+// ============================================================================
+// Binary / ternary weight layers
+// ============================================================================
+
+// Modelled M0+ cycles for one sample of a rows x cols layer. Per 32-weight
+// word: loads, XOR (and AND), SWAR popcount (12 ALU + 1 multiply), add and
+// loop; per input: load, sign/abs bit ops and the float add for beta (an
+// integer add on the fixed path); per output: i2f and a multiply-add.
+double m0_binary_cycles(size_t rows, size_t cols, bool ternary, bool fixed, const M0Costs& c) {
+    const double popcount = 12 * c.alu + c.mul;
+    const double per_word = ternary ? 3 * c.load + 2 * c.alu + 2 * popcount + 2 * c.alu + c.loop
+                                    : 2 * c.load + c.alu + popcount + c.alu + c.loop;
+    const double per_input = c.load + 4 * c.alu + c.loop + (fixed ? c.alu : c.fadd);
+    const double per_output = fixed ? 2 * c.mul + 6 * c.alu + c.load + c.loop
+                                    : c.i2f + c.fmul + c.fadd + c.fcmp + c.load + c.loop;
+    return static_cast<double>(cols * BinaryOps::words(rows)) * per_word +
+           static_cast<double>(rows) * per_input + static_cast<double>(cols) * per_output;
+}
+
+// Float reference on the binarized weights and inputs:
+// bias + sum_i(alpha * t(w) * beta * sign(x)), in double
+void binarized_reference(const BinaryDenseLayer& layer, const float* x, const float* b,
+                         double* out) {
+    const BinaryDense& p = layer.params();
+    const size_t row_words = BinaryOps::words(p.input_size);
+    double beta = 0.0;
+    for (size_t i = 0; i < p.input_size; ++i) {
+        beta += std::fabs(static_cast<double>(x[i]));
+    }
+    beta /= static_cast<double>(p.input_size);
+    for (size_t j = 0; j < p.output_size; ++j) {
+        double acc = 0.0;
+        for (size_t i = 0; i < p.input_size; ++i) {
+            const size_t word = j * row_words + i / BinaryOps::kWordBits;
+            const uint32_t bit = uint32_t{1} << (i % BinaryOps::kWordBits);
+            if (p.nonzero != nullptr && (p.nonzero[word] & bit) == 0) {
+                continue;
+            }
+            const double w = ((p.signs[word] & bit) != 0) ? -1.0 : 1.0;
+            const double s = std::signbit(x[i]) ? -1.0 : 1.0;
+            acc += w * s;
+        }
+        out[j] = static_cast<double>(b[j]) + static_cast<double>(p.scale) * beta * acc;
+    }
+}
+
+bool bench_binary() {
+    std::printf("== Binary / ternary XOR-popcount layers vs float matvec_multiply ==\n");
+    Checks checks;
+    std::printf("  %-11s %11s %11s %11s %9s %9s %17s\n", "rows x cols", "matvec ns",
+                "binary ns", "ternary ns", "bin x", "ter x", "float/bin/ter B");
+
+    struct Shape {
+        size_t rows;
+        size_t cols;
+    };
+    const Shape shapes[] = {{18, 3}, {64, 64}, {256, 256}, {784, 256}, {1024, 1024}};
+    const M0Costs c;
+
+    std::mt19937 rng(53);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    for (const Shape& shape : shapes) {
+        const size_t count = shape.rows * shape.cols;
+        std::vector<float> w(count);
+        std::vector<float> x(shape.rows);
+        for (float& v : w) {
+            v = normal(rng);
+        }
+        for (float& v : x) {
+            v = normal(rng);
+        }
+        const std::vector<float> b = random_vector(shape.cols, rng, -0.1f, 0.1f);
+        std::vector<float> out(shape.cols);
+
+        const BinaryDenseLayer binary(w.data(), b.data(), shape.rows, shape.cols,
+                                      ActivationType::None, BinaryDenseLayer::Mode::Binary);
+        const BinaryDenseLayer ternary(w.data(), b.data(), shape.rows, shape.cols,
+                                       ActivationType::None, BinaryDenseLayer::Mode::Ternary);
+
+        const size_t reps = std::max<size_t>(50000000 / count, 1);
+        const double t_float = time_seconds([&] {
+            for (size_t rep = 0; rep < reps; ++rep) {
+                MatrixOps::matvec_multiply(w.data(), x.data(), out.data(), shape.rows, shape.cols);
+                g_sink = g_sink + out[0];
+            }
+        });
+        const double t_binary = time_seconds([&] {
+            for (size_t rep = 0; rep < reps; ++rep) {
+                binary.forward(x.data(), out.data());
+                g_sink = g_sink + out[0];
+            }
+        });
+        const double t_ternary = time_seconds([&] {
+            for (size_t rep = 0; rep < reps; ++rep) {
+                ternary.forward(x.data(), out.data());
+                g_sink = g_sink + out[0];
+            }
+        });
+
+        char label[48];
+        char bytes[48];
+        std::snprintf(label, sizeof(label), "%zu x %zu", shape.rows, shape.cols);
+        std::snprintf(bytes, sizeof(bytes), "%zu/%zu/%zu", (count + shape.cols) * sizeof(float),
+                      BinaryOps::storage_bytes(shape.rows, shape.cols, false),
+                      BinaryOps::storage_bytes(shape.rows, shape.cols, true));
+        const double per = 1e9 / static_cast<double>(reps);
+        std::printf("  %-11s %11.1f %11.1f %11.1f %8.2fx %8.2fx %17s\n", label, t_float * per,
+                    t_binary * per, t_ternary * per, t_float / t_binary, t_float / t_ternary,
+                    bytes);
+    }
+
+    // Exactness of the kernels against the binarized model, the integer
+    // path against the float one, and how far binarization moves a float
+    // layer (random Gaussian weights and inputs, no activation)
+    std::printf("  checks on 256 x 64, 200 random inputs:\n");
+    const size_t rows = 256;
+    const size_t cols = 64;
+    std::vector<float> w(rows * cols);
+    for (float& v : w) {
+        v = normal(rng);
+    }
+    const std::vector<float> b = random_vector(cols, rng, -0.1f, 0.1f);
+    const DenseLayer dense(w.data(), b.data(), rows, cols, ActivationType::None);
+    const QFormat in_format = FixedOps::format_for(8.0f);
+    for (BinaryDenseLayer::Mode mode : {BinaryDenseLayer::Mode::Binary,
+                                        BinaryDenseLayer::Mode::Ternary}) {
+        const BinaryDenseLayer layer(w.data(), b.data(), rows, cols, ActivationType::None, mode);
+        std::vector<float> x(rows);
+        std::vector<float> got(cols);
+        std::vector<float> exact(cols);
+        std::vector<double> reference(cols);
+        std::vector<int16_t> xq(rows);
+        std::vector<int16_t> yq(cols);
+        std::vector<int32_t> dots(cols);
+
+        double worst_rel = 0.0;
+        float worst_fixed = 0.0f;
+        double cosine_sum = 0.0;
+        const size_t samples = 200;
+        float max_out = 0.0f;
+        for (size_t s = 0; s < samples; ++s) {
+            // Inputs on the Q grid, so both paths see the same signs (a tiny
+            // negative that rounds to 0 would flip its bit)
+            for (size_t i = 0; i < rows; ++i) {
+                xq[i] = FixedOps::to_fixed(normal(rng), in_format.frac_bits);
+                x[i] = FixedOps::to_float(xq[i], in_format.frac_bits);
+            }
+            layer.forward(x.data(), got.data());
+            binarized_reference(layer, x.data(), b.data(), reference.data());
+            dense.forward(x.data(), exact.data());
+            for (size_t j = 0; j < cols; ++j) {
+                max_out = std::max(max_out, std::fabs(got[j]));
+            }
+
+            // Output format with headroom for the largest float output so far
+            const QFormat out_format = FixedOps::format_for(4.0f * std::max(max_out, 1.0f));
+            BinaryOps::dense_forward_fixed(layer.params(), xq.data(), in_format.frac_bits,
+                                           yq.data(), out_format.frac_bits, dots.data());
+
+            double dot = 0.0;
+            double norm_a = 0.0;
+            double norm_b = 0.0;
+            for (size_t j = 0; j < cols; ++j) {
+                const double diff = std::fabs(static_cast<double>(got[j]) - reference[j]);
+                worst_rel = std::max(worst_rel, diff / std::max(std::fabs(reference[j]), 1.0));
+                const float fixed = FixedOps::to_float(yq[j], out_format.frac_bits);
+                worst_fixed = std::max(worst_fixed, std::fabs(fixed - got[j]) /
+                                                        std::max(std::fabs(got[j]), 1.0f));
+                dot += static_cast<double>(got[j]) * static_cast<double>(exact[j]);
+                norm_a += static_cast<double>(got[j]) * static_cast<double>(got[j]);
+                norm_b += static_cast<double>(exact[j]) * static_cast<double>(exact[j]);
+            }
+            cosine_sum += dot / std::sqrt(norm_a * norm_b);
+        }
+        const char* name = (mode == BinaryDenseLayer::Mode::Binary) ? "binary" : "ternary";
+        std::printf("    %-7s alpha %.3f  kernel vs binarized ref %.2g  Q-format vs float %.2g"
+                    "  cosine to float layer %.3f\n",
+                    name, static_cast<double>(layer.params().scale), worst_rel,
+                    static_cast<double>(worst_fixed),
+                    cosine_sum / static_cast<double>(samples));
+        // Float rounding of the scale and bias only; one Q step of the output
+        checks.check(worst_rel <= 1e-5, "%s kernel off the binarized reference by %g", name,
+                     worst_rel);
+        checks.check(worst_fixed <= 0.02f, "%s Q-format path off the float one by %g", name,
+                     static_cast<double>(worst_fixed));
+    }
+
+    std::printf("  modelled M0+ cycles per sample (float MAC %.0f cycles/weight):\n",
+                m0_dense_cycles_per_weight(c));
+    std::printf("    %-11s %12s %12s %12s %12s %12s\n", "rows x cols", "float", "binary",
+                "ternary", "binary Q", "speedup Q");
+    for (const Shape& shape : shapes) {
+        const double dense_cycles = static_cast<double>(shape.rows * shape.cols) *
+                                    m0_dense_cycles_per_weight(c);
+        char label[48];
+        std::snprintf(label, sizeof(label), "%zu x %zu", shape.rows, shape.cols);
+        const double fixed_binary = m0_binary_cycles(shape.rows, shape.cols, false, true, c);
+        std::printf("    %-11s %12.0f %12.0f %12.0f %12.0f %11.1fx\n", label, dense_cycles,
+                    m0_binary_cycles(shape.rows, shape.cols, false, false, c),
+                    m0_binary_cycles(shape.rows, shape.cols, true, false, c), fixed_binary,
+                    dense_cycles / fixed_binary);
+    }
+    return checks.passed();
+}
+
+// ============================================================================
+// Multi-threaded batch scoring
+// ============================================================================
+
+void bench_parallel_model(Checks& checks, const char* name, const Layer* const* layers,
+                          size_t num_layers, const std::vector<float>& inputs,
+                          size_t max_threads) {
+    const size_t scratch_size = Sequential::scratch_size_for(layers, num_layers,
+                                                             CUSTOMNN_BATCH_TILE);
+    std::vector<float> scratch_a(std::max<size_t>(scratch_size, 1));
+    std::vector<float> scratch_b(std::max<size_t>(scratch_size, 1));
+    Sequential reference(layers, num_layers, scratch_a.data(), scratch_b.data(), scratch_size);
+
+    const size_t in = reference.input_size();
+    const size_t out = reference.output_size();
+    const size_t n = inputs.size() / in;
+    std::vector<float> per_row(n * out);
+    std::vector<float> batched(n * out);
+    std::vector<float> actual(n * out);
+
+    // Both single-threaded paths; the pool runs predict_batch() unless told
+    // otherwise, and its outputs must be that path's bits
+    const double t_loop = best_seconds([&] {
+        for (size_t s = 0; s < n; ++s) {
+            reference.predict(&inputs[s * in], &per_row[s * out]);
+        }
+    });
+    const double t_batch = best_seconds([&] {
+        reference.predict_batch(inputs.data(), n, batched.data());
+    });
+
+    std::printf("\n%s, %zu samples (single-threaded: predict loop %.0f samples/s, "
+                "predict_batch %.0f samples/s)\n", name, n, static_cast<double>(n) / t_loop,
+                static_cast<double>(n) / t_batch);
+    std::printf("  %7s %7s %16s %13s %10s %7s %10s\n", "threads", "chunk", "samples/s",
+                "vs predict()", "efficiency", "steals", "identical");
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        // A fresh predictor per thread count: every construction must give
+        // the same bits
+        ThreadPool pool(threads);
+        ParallelPredictor predictor(layers, num_layers, pool);
+        std::fill(actual.begin(), actual.end(), 0.0f);
+        predictor.predict(inputs.data(), n, actual.data());   // Warm-up
+        const auto run = [&] { predictor.predict(inputs.data(), n, actual.data()); };
+        double t = best_seconds(run);
+        if (threads == 1 && t_batch / t < kSamePathSpeedup) {
+            t = std::min(t, best_seconds(run));   // Confirm a slow result
+        }
+        const bool identical = std::memcmp(batched.data(), actual.data(),
+                                           batched.size() * sizeof(float)) == 0;
+        std::printf("  %7zu %7zu %16.0f %12.2fx %9.0f%% %7zu %10s\n", threads,
+                    predictor.chunk_size(), static_cast<double>(n) / t, t_loop / t,
+                    100.0 * t_batch / t / static_cast<double>(threads), pool.last_steals(),
+                    identical ? "yes" : "NO");
+        checks.check(predictor.path() == ParallelPredictor::Path::Batch,
+                     "%s: a default ParallelPredictor does not run predict_batch()", name);
+        checks.check(identical, "%s on %zu threads differs from the single-threaded "
+                     "predict_batch()", name, threads);
+        if (threads == 1) {
+            // One worker must run about as fast as the serial path it runs
+            checks.check(t_batch / t >= kSamePathSpeedup, "%s on 1 thread: %.2fx of "
+                         "predict_batch()", name, t_batch / t);
+        }
+    }
+
+    // The one-shot helper, and the per-row path when asked for
+    ThreadPool pool(max_threads);
+    std::fill(actual.begin(), actual.end(), 0.0f);
+    parallel_predict(layers, num_layers, pool, inputs.data(), n, actual.data());
+    checks.check(std::memcmp(batched.data(), actual.data(), batched.size() * sizeof(float)) == 0,
+                 "%s: parallel_predict() differs from the single-threaded predict_batch()", name);
+    ParallelPredictor predictor(layers, num_layers, pool, 0, ParallelPredictor::Path::PerRow);
+    predictor.predict(inputs.data(), n, actual.data());
+    checks.check(std::memcmp(per_row.data(), actual.data(), per_row.size() * sizeof(float)) == 0,
+                 "%s: the per-row path differs from the single-threaded predict() loop", name);
+}
+
+bool bench_parallel() {
+    Checks checks;
+    const size_t cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    // Up to the core count, and at least 4 so the pool logic is exercised
+    const size_t max_threads = std::max<size_t>(cores, 4);
+    std::printf("== Parallel predict on a work-stealing pool (%zu hardware threads, L2 %zu KiB) ==\n",
+                cores, ParallelPredictor::l2_cache_bytes() / 1024);
+    if (cores < max_threads) {
+        std::printf("  note: more threads than cores below measure overhead, not scaling\n");
+    }
+
+    std::mt19937 rng(67);
+    const DenseLayer temp_l1(&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS,
+                             TEMP_LAYER1_INPUT_SIZE, TEMP_LAYER1_OUTPUT_SIZE,
+                             ActivationType::ReLU);
+    const DenseLayer temp_l2(&TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS,
+                             TEMP_LAYER2_INPUT_SIZE, TEMP_LAYER2_OUTPUT_SIZE,
+                             ActivationType::Softmax);
+    const Layer* temp_layers[] = {&temp_l1, &temp_l2};
+    bench_parallel_model(checks, "Temperature model 10-8-2", temp_layers, 2,
+                         random_walk_windows(2000000, TEMP_LAYER1_INPUT_SIZE, rng), max_threads);
+
+    const RandomModel wide({100, 128, 128, 2}, rng);
+    bench_parallel_model(checks, "Wide model 100-128-128-2", wide.layers(), wide.num_layers(),
+                         random_vector(100000 * 100, rng, 15.0f, 30.0f), max_threads);
+
+    // Tasks of very different cost: stealing keeps the pool busy
+    ThreadPool pool(max_threads);
+    std::vector<size_t> counts(max_threads, 0);
+    std::vector<double> work(256, 0.0);
+    const double t = time_seconds([&] {
+        pool.parallel_for(work.size(), [&](size_t task, size_t worker) {
+            double acc = 0.0;
+            const size_t iterations = (task < 32) ? 200000 : 2000;   // First runs are heavy
+            for (size_t i = 0; i < iterations; ++i) {
+                acc += std::sqrt(static_cast<double>(i + task));
+            }
+            work[task] = acc;
+            ++counts[worker];
+        });
+    });
+    std::printf("\nUneven parallel_for (256 tasks, first 32 heavy): %.2f ms, %zu steals, "
+                "tasks per worker:", t * 1e3, pool.last_steals());
+    size_t ran = 0;
+    for (size_t count : counts) {
+        std::printf(" %zu", count);
+        ran += count;
+    }
+    std::printf("\n");
+    checks.check(ran == work.size(), "parallel_for ran %zu of %zu tasks", ran, work.size());
+    return checks.passed();
+}
+
+bool bench_reentrant() {
+    std::printf("== Reentrant const predict with caller-owned scratch ==\n");
+    Checks checks;
+
+    // One immutable model shared by every thread; no constructor scratch
+    std::mt19937 rng(71);
+    const RandomModel wide({100, 128, 128, 2}, rng);
+    const Sequential shared(wide.layers(), wide.num_layers(), nullptr, nullptr, 0);
+    const size_t in = shared.input_size();
+    const size_t out = shared.output_size();
+    std::printf("Model 100-128-128-2: required_scratch() = %zu floats per caller\n",
+                shared.required_scratch());
+
+    const size_t n = 20000;
+    const std::vector<float> inputs = random_vector(n * in, rng, 15.0f, 30.0f);
+
+    // Reference: the stateful predict() on a model with its own buffers
+    const size_t scratch_size = Sequential::scratch_size_for(wide.layers(), wide.num_layers());
+    std::vector<float> scratch_a(scratch_size);
+    std::vector<float> scratch_b(scratch_size);
+    Sequential stateful(wide.layers(), wide.num_layers(), scratch_a.data(), scratch_b.data(),
+                        scratch_size);
+    std::vector<float> expected(n * out);
+    const double t_stateful = time_seconds([&] {
+        for (size_t s = 0; s < n; ++s) {
+            stateful.predict(&inputs[s * in], &expected[s * out]);
+        }
+    });
+
+    std::vector<float> actual(n * out);
+    auto run_range = [&](size_t begin, size_t end) {
+        // Per-call stack workspace
+        float workspace[2 * 128];
+        Scratch scratch{workspace, 2 * 128};
+        for (size_t s = begin; s < end; ++s) {
+            shared.predict(std::span<const float>(&inputs[s * in], in),
+                           std::span<float>(&actual[s * out], out), scratch);
+        }
+    };
+    const double t_const = time_seconds([&] { run_range(0, n); });
+    bool identical = std::memcmp(expected.data(), actual.data(),
+                                 expected.size() * sizeof(float)) == 0;
+    std::printf("  stateful predict():           %9.0f samples/s\n",
+                static_cast<double>(n) / t_stateful);
+    std::printf("  const predict(span, Scratch): %9.0f samples/s  identical: %s\n",
+                static_cast<double>(n) / t_const, identical ? "yes" : "NO");
+    checks.check(identical, "const predict differs from the stateful one");
+
+    // The same const model from several threads at once, no locking
+    const size_t cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    for (size_t threads : {size_t{2}, size_t{4}}) {
+        std::fill(actual.begin(), actual.end(), 0.0f);
+        const double t = time_seconds([&] {
+            std::vector<std::thread> pool;
+            for (size_t k = 0; k < threads; ++k) {
+                pool.emplace_back(run_range, n * k / threads, n * (k + 1) / threads);
+            }
+            for (std::thread& thread : pool) {
+                thread.join();
+            }
+        });
+        identical = std::memcmp(expected.data(), actual.data(),
+                                expected.size() * sizeof(float)) == 0;
+        std::printf("  %zu threads sharing one model:  %9.0f samples/s  identical: %s%s\n",
+                    threads, static_cast<double>(n) / t, identical ? "yes" : "NO",
+                    (threads > cores) ? "  (more threads than cores)" : "");
+        checks.check(identical, "%zu threads sharing one model differ", threads);
+    }
+
+    // Undersized workspace and short spans are refused, not overrun
+    float small[8];
+    Scratch too_small{small, 8};
+    float result[2];
+    const bool rejected_scratch = !shared.predict(inputs.data(), result, too_small);
+    float workspace[2 * 128];
+    Scratch scratch{workspace, 2 * 128};
+    const bool rejected_span = !shared.predict(std::span<const float>(inputs.data(), in - 1),
+                                               std::span<float>(result, out), scratch);
+    std::printf("  undersized scratch rejected: %s, short input span rejected: %s\n",
+                rejected_scratch ? "yes" : "NO", rejected_span ? "yes" : "NO");
+    checks.check(rejected_scratch && rejected_span, "undersized scratch or span accepted");
+    return checks.passed();
+}
+
+// ============================================================================
+// Half-precision weights
+// ============================================================================
+
+uint32_t bits_of(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+bool bench_half() {
+    std::printf("== fp16 / bf16 weight storage vs float (kernels: %s, dense: %s) ==\n",
+                HalfOps::kernel_name(), Kernels::active().name);
+    Checks checks;
+
+    // Conversions: every 16-bit pattern round-trips, the SIMD widening
+    // matches the scalar one bit for bit, and narrowing picks the nearest
+    // representable value
+    std::vector<uint16_t> all(65536);
+    for (size_t k = 0; k < all.size(); ++k) {
+        all[k] = static_cast<uint16_t>(k);
+    }
+    std::vector<float> wide(all.size());
+    std::mt19937 rng(73);
+    std::uniform_real_distribution<float> mantissa(1.0f, 2.0f);
+    for (HalfFormat format : {HalfFormat::FP16, HalfFormat::BF16}) {
+        const char* name = (format == HalfFormat::FP16) ? "fp16" : "bf16";
+        size_t round_trip = 0;
+        size_t nans = 0;
+        size_t simd_match = 0;
+        HalfOps::widen(all.data(), wide.data(), all.size(), format);
+        for (size_t k = 0; k < all.size(); ++k) {
+            const float value = HalfOps::to_float(all[k], format);
+            simd_match += (bits_of(value) == bits_of(wide[k])) ? size_t{1} : size_t{0};
+            if (std::isnan(value)) {
+                nans += std::isnan(HalfOps::to_float(HalfOps::from_float(value, format), format))
+                    ? size_t{1} : size_t{0};
+            } else {
+                round_trip += (HalfOps::from_float(value, format) == all[k]) ? size_t{1} : size_t{0};
+            }
+        }
+
+        // Down through the fp16 subnormals, up to just below 65536
+        std::uniform_int_distribution<int> exponent((format == HalfFormat::FP16) ? -27 : -130,
+                                                    (format == HalfFormat::FP16) ? 15 : 120);
+        size_t nearest = 0;
+        const size_t samples = 1000000;
+        for (size_t s = 0; s < samples; ++s) {
+            const float x = std::ldexp(mantissa(rng), exponent(rng)) *
+                            ((s % 2 == 0) ? 1.0f : -1.0f);
+            const uint16_t h = HalfOps::from_float(x, format);
+            const double error = std::fabs(static_cast<double>(x) -
+                                           static_cast<double>(HalfOps::to_float(h, format)));
+            // From 65504 + half an ulp up, Inf is the correct result
+            const bool overflow = std::isinf(HalfOps::to_float(h, format));
+            bool best = !overflow || std::fabs(x) >= 65520.0f;
+            for (int step : {-1, 1}) {
+                if (overflow) {
+                    break;
+                }
+                const uint16_t other = static_cast<uint16_t>(h + step);
+                const float neighbour = HalfOps::to_float(other, format);
+                if (!std::isnan(neighbour) && !std::isinf(neighbour) &&
+                    std::fabs(static_cast<double>(x) - static_cast<double>(neighbour)) < error) {
+                    best = false;
+                }
+            }
+            nearest += best ? size_t{1} : size_t{0};
+        }
+        std::printf("  %s: round trip %zu/%zu (+%zu NaN), SIMD widen == scalar %zu/65536, "
+                    "nearest %zu/%zu\n", name, round_trip, all.size() - nans, nans, simd_match,
+                    nearest, samples);
+        checks.check(round_trip + nans == all.size(), "%s: %zu patterns do not round-trip",
+                     name, all.size() - nans - round_trip);
+        checks.check(simd_match == all.size(), "%s: SIMD widening differs on %zu patterns",
+                     name, all.size() - simd_match);
+        checks.check(nearest == samples, "%s: %zu conversions not to nearest", name,
+                     samples - nearest);
+    }
+
+    // Matvec: float weights vs 16-bit weights widened in the kernel. The
+    // half kernel must equal the input-major float kernel run on the
+    // widened weights, bit for bit, with SIMD on and off.
+    std::printf("  %-11s %10s %10s %10s %8s %8s %15s %10s\n", "rows x cols", "float ns",
+                "fp16 ns", "bf16 ns", "fp16 x", "bf16 x", "float/half B", "identical");
+    struct Shape {
+        size_t rows;
+        size_t cols;
+    };
+    const Shape shapes[] = {{10, 8}, {64, 64}, {256, 256}, {1024, 1024}, {2048, 2048}};
+    std::normal_distribution<float> normal(0.0f, 0.1f);
+    for (const Shape& shape : shapes) {
+        const size_t count = shape.rows * shape.cols;
+        std::vector<float> w(count);
+        for (float& v : w) {
+            v = normal(rng);
+        }
+        const std::vector<float> b = random_vector(shape.cols, rng, -0.1f, 0.1f);
+        const std::vector<float> x = random_vector(shape.rows, rng, -1.0f, 1.0f);
+        std::vector<float> out(shape.cols);
+        std::vector<float> expected(shape.cols);
+
+        const DenseLayer dense(w.data(), b.data(), shape.rows, shape.cols, ActivationType::ReLU);
+        const HalfDenseLayer fp16(w.data(), b.data(), shape.rows, shape.cols,
+                                  ActivationType::ReLU, HalfFormat::FP16);
+        const HalfDenseLayer bf16(w.data(), b.data(), shape.rows, shape.cols,
+                                  ActivationType::ReLU, HalfFormat::BF16);
+
+        bool identical = true;
+        std::vector<float> widened(count);
+        for (const HalfDenseLayer* layer : {&fp16, &bf16}) {
+            HalfOps::widen(layer->params().weights, widened.data(), count, layer->params().format);
+            Kernels::active().dense(widened.data(), b.data(), x.data(), expected.data(),
+                                    shape.rows, shape.cols, true);
+            for (bool simd : {true, false}) {
+                if (!HalfOps::use_simd(simd)) {
+                    continue;
+                }
+                layer->forward(x.data(), out.data());
+                identical = identical && std::memcmp(out.data(), expected.data(),
+                                                     shape.cols * sizeof(float)) == 0;
+            }
+            HalfOps::use_simd(true);
+        }
+
+        const size_t reps = std::max<size_t>(50000000 / count, 1);
+        auto time_layer = [&](const Layer& layer) {
+            return time_seconds([&] {
+                for (size_t rep = 0; rep < reps; ++rep) {
+                    layer.forward(x.data(), out.data());
+                    g_sink = g_sink + out[0];
+                }
+            });
+        };
+        const double t_float = time_layer(dense);
+        const double t_fp16 = time_layer(fp16);
+        const double t_bf16 = time_layer(bf16);
+
+        char label[48];
+        char bytes[48];
+        std::snprintf(label, sizeof(label), "%zu x %zu", shape.rows, shape.cols);
+        std::snprintf(bytes, sizeof(bytes), "%zu/%zu", (count + shape.cols) * sizeof(float),
+                      HalfOps::storage_bytes(shape.rows, shape.cols));
+        const double per = 1e9 / static_cast<double>(reps);
+        std::printf("  %-11s %10.1f %10.1f %10.1f %7.2fx %7.2fx %15s %10s\n", label,
+                    t_float * per, t_fp16 * per, t_bf16 * per, t_float / t_fp16,
+                    t_float / t_bf16, bytes, identical ? "yes" : "NO");
+        checks.check(identical, "half %s differs from the float kernel on widened weights",
+                     label);
+    }
+
+    // Accuracy of the generated headers on the stored temperature logs:
+    // argmax and the firmware's p > 0.7 decision against the float model
+    const float threshold = 0.7f;   // DETECTION_THRESHOLD in Miko.cpp
+    const DenseLayer t1(&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, TEMP_LAYER1_INPUT_SIZE,
+                        TEMP_LAYER1_OUTPUT_SIZE, ActivationType::ReLU);
+    const DenseLayer t2(&TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS, TEMP_LAYER2_INPUT_SIZE,
+                        TEMP_LAYER2_OUTPUT_SIZE, ActivationType::Softmax);
+    const HalfLayer f1(TEMP_LAYER1_FP16);
+    const HalfLayer f2(TEMP_LAYER2_FP16);
+    const HalfLayer g1(TEMP_LAYER1_BF16);
+    const HalfLayer g2(TEMP_LAYER2_BF16);
+    const Layer* float_layers[] = {&t1, &t2};
+    const Layer* fp16_layers[] = {&f1, &f2};
+    const Layer* bf16_layers[] = {&g1, &g2};
+    float hidden[TEMP_LAYER1_OUTPUT_SIZE];
+    Sequential reference(float_layers, 2, hidden, nullptr, TEMP_LAYER1_OUTPUT_SIZE);
+
+    std::printf("  temperature model (temp_model_weights_half.h), decision at p > %.2f:\n",
+                static_cast<double>(threshold));
+    std::printf("  %-38s %7s %6s %12s %9s %9s\n", "log", "windows", "format", "max |dprob|",
+                "argmax", "decision");
+    const char* logs[] = {"normal.csv", "touched.csv", "touched2.csv", "touched3.csv",
+                          "temperature_data_20251122_135801.csv"};
+    const size_t width = TEMP_LAYER1_INPUT_SIZE;
+    for (const char* path : logs) {
+        const std::vector<float> temps = read_temperatures(path);
+        if (!checks.check(temps.size() >= width, "%s not found (run from the repository root)",
+                          path)) {
+            continue;
+        }
+        const size_t count = temps.size() - width + 1;
+        for (const Layer* const* layers : {fp16_layers, bf16_layers}) {
+            Sequential half(layers, 2, hidden, nullptr, TEMP_LAYER1_OUTPUT_SIZE);
+            float expected[TEMP_LAYER2_OUTPUT_SIZE];
+            float actual[TEMP_LAYER2_OUTPUT_SIZE];
+            float worst = 0.0f;
+            size_t agree = 0;
+            size_t decisions = 0;
+            for (size_t s = 0; s < count; ++s) {
+                reference.predict(&temps[s], expected);
+                half.predict(&temps[s], actual);
+                worst = std::max({worst, std::fabs(expected[0] - actual[0]),
+                                  std::fabs(expected[1] - actual[1])});
+                agree += (Classify::argmax(expected, TEMP_LAYER2_OUTPUT_SIZE) ==
+                          Classify::argmax(actual, TEMP_LAYER2_OUTPUT_SIZE)) ? size_t{1}
+                                                                             : size_t{0};
+                decisions += ((expected[1] > threshold) == (actual[1] > threshold)) ? size_t{1}
+                                                                                    : size_t{0};
+            }
+            const bool fp16 = (layers == fp16_layers);
+            const double agreement = static_cast<double>(agree) / static_cast<double>(count);
+            const double same = static_cast<double>(decisions) / static_cast<double>(count);
+            std::printf("  %-38s %7zu %6s %12.3g %8.2f%% %8.2f%%\n", path, count,
+                        fp16 ? "fp16" : "bf16", static_cast<double>(worst), 100.0 * agreement,
+                        100.0 * same);
+            // bf16 keeps 8 mantissa bits to fp16's 11: about 8x the error, and
+            // windows near p = 0.7 flip their decision
+            checks.check(worst <= (fp16 ? 0.002f : 0.02f), "%s %s: max |dprob| %g", path,
+                         fp16 ? "fp16" : "bf16", static_cast<double>(worst));
+            checks.check(agreement >= 0.999 && same >= (fp16 ? 0.995 : 0.95),
+                         "%s %s: argmax %.2f%%, decisions %.2f%%", path,
+                         fp16 ? "fp16" : "bf16", 100.0 * agreement, 100.0 * same);
+        }
+    }
+    return checks.passed();
+}
+
+// ============================================================================
+// Weight-clustered (codebook) layers
+// ============================================================================
+
+// Modelled M0+ cycles of a codebook layer: per weight, the index nibble
+// (byte load amortized over two), the input load and a read-modify-write
+// of its bucket (16 floats do not fit the M0+'s registers); per output,
+// 16 multiply-adds with the codebook. Up to 16 inputs, one codebook
+// multiply-add per weight instead.
+double m0_codebook_cycles(size_t rows, size_t cols, const M0Costs& c) {
+    if (rows <= CodebookOps::kEntries) {
+        return static_cast<double>(rows * cols) *
+               (c.load / 2 + 2 * c.alu + 2 * c.load + c.fmul + c.fadd + c.loop);
+    }
+    const double per_weight = c.load / 2 + 2 * c.alu + c.load + 2 * c.load + c.fadd + c.loop;
+    const double per_output = static_cast<double>(CodebookOps::kEntries) *
+                              (2 * c.load + c.fmul + c.fadd + c.loop);
+    return static_cast<double>(rows * cols) * per_weight + static_cast<double>(cols) * per_output;
+}
+
+bool bench_codebook() {
+    std::printf("== 16-entry codebook layers (4-bit indices) vs float dense (kernels: %s) ==\n",
+                Kernels::active().name);
+    Checks checks;
+    std::printf("  %-11s %10s %10s %8s %9s %9s %10s %17s\n", "rows x cols", "float ns",
+                "cbook ns", "speedup", "fmul", "cb fmul", "M0+ x", "float/cbook B");
+
+    struct Shape {
+        size_t rows;
+        size_t cols;
+    };
+    const Shape shapes[] = {{10, 8}, {64, 64}, {256, 256}, {784, 256}, {1024, 1024}};
+    const M0Costs c;
+    std::mt19937 rng(79);
+    std::normal_distribution<float> normal(0.0f, 0.1f);
+    for (const Shape& shape : shapes) {
+        const size_t count = shape.rows * shape.cols;
+        std::vector<float> w(count);
+        for (float& v : w) {
+            v = normal(rng);
+        }
+        const std::vector<float> b = random_vector(shape.cols, rng, -0.1f, 0.1f);
+        const std::vector<float> x = random_vector(shape.rows, rng, -1.0f, 1.0f);
+        std::vector<float> out(shape.cols);
+
+        const DenseLayer dense(w.data(), b.data(), shape.rows, shape.cols, ActivationType::ReLU);
+        const CodebookDenseLayer codebook(w.data(), b.data(), shape.rows, shape.cols,
+                                          ActivationType::ReLU);
+
+        const size_t reps = std::max<size_t>(20000000 / count, 1);
+        auto time_layer = [&](const Layer& layer) {
+            return time_seconds([&] {
+                for (size_t rep = 0; rep < reps; ++rep) {
+                    layer.forward(x.data(), out.data());
+                    g_sink = g_sink + out[0];
+                }
+            });
+        };
+        const double t_float = time_layer(dense);
+        const double t_codebook = time_layer(codebook);
+
+        const double m0_float = static_cast<double>(count) * m0_dense_cycles_per_weight(c);
+        char label[48];
+        char bytes[48];
+        std::snprintf(label, sizeof(label), "%zu x %zu", shape.rows, shape.cols);
+        std::snprintf(bytes, sizeof(bytes), "%zu/%zu", (count + shape.cols) * sizeof(float),
+                      CodebookOps::storage_bytes(shape.rows, shape.cols));
+        const double per = 1e9 / static_cast<double>(reps);
+        std::printf("  %-11s %10.1f %10.1f %7.2fx %9zu %9zu %9.2fx %17s\n", label,
+                    t_float * per, t_codebook * per, t_float / t_codebook, count,
+                    shape.cols * std::min(shape.rows, CodebookOps::kEntries),
+                    m0_float / m0_codebook_cycles(shape.rows, shape.cols, c), bytes);
+    }
+
+    // Kernels against a double evaluation of the clustered weights, the
+    // integer path against the float one, and the clustering error itself
+    std::printf("  checks on 256 x 64, 200 random inputs:\n");
+    const size_t rows = 256;
+    const size_t cols = 64;
+    std::vector<float> w(rows * cols);
+    for (float& v : w) {
+        v = normal(rng);
+    }
+    const std::vector<float> b = random_vector(cols, rng, -0.1f, 0.1f);
+    const DenseLayer dense(w.data(), b.data(), rows, cols, ActivationType::None);
+    const CodebookDenseLayer layer(w.data(), b.data(), rows, cols, ActivationType::None);
+    const CodebookDense& p = layer.params();
+    const QFormat in_format = FixedOps::format_for(4.0f);
+    const QFormat out_format = FixedOps::format_for(16.0f);
+
+    std::vector<float> x(rows);
+    std::vector<float> got(cols);
+    std::vector<float> exact(cols);
+    std::vector<int16_t> xq(rows);
+    std::vector<int16_t> yq(cols);
+    double worst_kernel = 0.0;
+    float worst_fixed = 0.0f;
+    double cosine_sum = 0.0;
+    for (size_t s = 0; s < 200; ++s) {
+        for (size_t i = 0; i < rows; ++i) {
+            xq[i] = FixedOps::to_fixed(normal(rng) * 10.0f, in_format.frac_bits);
+            x[i] = FixedOps::to_float(xq[i], in_format.frac_bits);
+        }
+        layer.forward(x.data(), got.data());
+        dense.forward(x.data(), exact.data());
+        CodebookOps::dense_forward_fixed(p, xq.data(), in_format.frac_bits, yq.data(),
+                                         out_format.frac_bits);
+
+        double dot = 0.0;
+        double norm_got = 0.0;
+        double norm_exact = 0.0;
+        for (size_t j = 0; j < cols; ++j) {
+            double reference = static_cast<double>(p.bias[j]);
+            double magnitude = std::fabs(reference);
+            for (size_t i = 0; i < rows; ++i) {
+                const double term = static_cast<double>(p.codebook[CodebookOps::index_at(p, j, i)]) *
+                                    static_cast<double>(x[i]);
+                reference += term;
+                magnitude += std::fabs(term);
+            }
+            worst_kernel = std::max(worst_kernel,
+                                    std::fabs(static_cast<double>(got[j]) - reference) / magnitude);
+            worst_fixed = std::max(worst_fixed, std::fabs(
+                FixedOps::to_float(yq[j], out_format.frac_bits) - got[j]));
+            dot += static_cast<double>(got[j]) * static_cast<double>(exact[j]);
+            norm_got += static_cast<double>(got[j]) * static_cast<double>(got[j]);
+            norm_exact += static_cast<double>(exact[j]) * static_cast<double>(exact[j]);
+        }
+        cosine_sum += dot / std::sqrt(norm_got * norm_exact);
+    }
+    std::printf("    float kernel vs double on the codebook weights: max rel err %.3g\n",
+                worst_kernel);
+    std::printf("    integer path vs float kernel: max |diff| %.4g (output lsb %.4g)\n",
+                static_cast<double>(worst_fixed),
+                static_cast<double>(std::ldexp(1.0f, -out_format.frac_bits)));
+    std::printf("    clustered vs unclustered layer: mean cosine similarity %.5f\n",
+                cosine_sum / 200.0);
+    const float lsb = std::ldexp(1.0f, -out_format.frac_bits);
+    checks.check(worst_kernel <= 1e-6, "codebook kernel off the double reference by %g",
+                 worst_kernel);
+    // Rounded products and output: within two output steps
+    checks.check(worst_fixed <= 2.0f * lsb, "codebook integer path off by %g (lsb %g)",
+                 static_cast<double>(worst_fixed), static_cast<double>(lsb));
+    checks.check(cosine_sum / 200.0 >= 0.99, "clustering moved the layer: cosine %g",
+                 cosine_sum / 200.0);
+
+    // The generated temperature model on the stored logs
+    const float threshold = 0.7f;   // DETECTION_THRESHOLD in Miko.cpp
+    const DenseLayer t1(&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, TEMP_LAYER1_INPUT_SIZE,
+                        TEMP_LAYER1_OUTPUT_SIZE, ActivationType::ReLU);
+    const DenseLayer t2(&TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS, TEMP_LAYER2_INPUT_SIZE,
+                        TEMP_LAYER2_OUTPUT_SIZE, ActivationType::Softmax);
+    const CodebookLayer c1(TEMP_LAYER1_CB);
+    const CodebookLayer c2(TEMP_LAYER2_CB);
+    const Layer* float_layers[] = {&t1, &t2};
+    const Layer* codebook_layers[] = {&c1, &c2};
+    float hidden[TEMP_LAYER1_OUTPUT_SIZE];
+    Sequential reference(float_layers, 2, hidden, nullptr, TEMP_LAYER1_OUTPUT_SIZE);
+    Sequential clustered(codebook_layers, 2, hidden, nullptr, TEMP_LAYER1_OUTPUT_SIZE);
+    std::printf("  temperature model (temp_model_weights_codebook.h), decision at p > %.2f:\n",
+                static_cast<double>(threshold));
+    const size_t width = TEMP_LAYER1_INPUT_SIZE;
+    for (const char* path : {"normal.csv", "touched.csv", "touched2.csv", "touched3.csv",
+                             "temperature_data_20251122_135801.csv"}) {
+        const std::vector<float> temps = read_temperatures(path);
+        if (!checks.check(temps.size() >= width, "%s not found (run from the repository root)",
+                          path)) {
+            continue;
+        }
+        const size_t windows = temps.size() - width + 1;
+        size_t agree = 0;
+        for (size_t s = 0; s < windows; ++s) {
+            float expected[TEMP_LAYER2_OUTPUT_SIZE];
+            float actual[TEMP_LAYER2_OUTPUT_SIZE];
+            reference.predict(&temps[s], expected);
+            clustered.predict(&temps[s], actual);
+            agree += ((expected[1] > threshold) == (actual[1] > threshold)) ? size_t{1}
+                                                                            : size_t{0};
+        }
+        const double same = static_cast<double>(agree) / static_cast<double>(windows);
+        std::printf("    %-38s %5zu windows, decisions agree %.2f%%\n", path, windows,
+                    100.0 * same);
+        checks.check(same >= 0.99, "codebook %s: decisions agree %.2f%%", path, 100.0 * same);
+    }
+    return checks.passed();
+}
+
+// ============================================================================
+// Binary model files
+// ============================================================================
+
+// Export description of a RandomModel (hidden ReLU, softmax output)
+std::vector<ModelExportLayer> export_layers(const RandomModel& model, ModelDType dtype) {
+    std::vector<ModelExportLayer> layers;
+    for (size_t i = 0; i < model.num_layers(); ++i) {
+        const Layer* layer = model.layers()[i];
+        layers.push_back({model.weights(i), model.bias(i), layer->input_size(),
+                          layer->output_size(), layer->activation(), dtype});
+    }
+    return layers;
+}
+
+// 64-byte aligned byte buffer (model files must be attached aligned)
+struct AlignedBytes {
+    float* storage;
+    uint8_t* data;
+
+    explicit AlignedBytes(size_t size)
+        : storage(MatrixOps::allocate_packed(size / sizeof(float) + 1)),
+          data(reinterpret_cast<uint8_t*>(storage)) {}
+    ~AlignedBytes() { MatrixOps::free_packed(storage); }
+    AlignedBytes(const AlignedBytes&) = delete;
+    AlignedBytes& operator=(const AlignedBytes&) = delete;
+};
+
+// F32 files run the packed kernel DenseLayer uses, except in unpacked
+// (CUSTOMNN_BATCH_TILE == 1) builds, where the summation order differs.
+// Half-precision files against the float model (measured: 2.7e-5, 1.9e-4)
+constexpr float kF32FileTolerance = DenseLayer::kPacked ? 0.0f : 1e-5f;
+constexpr float kFp16FileTolerance = 2e-4f;
+constexpr float kBf16FileTolerance = 2e-3f;
+
+// Largest |difference| between a model file and a reference on samples
+float file_vs_reference(const ModelFile& file, const Sequential& reference,
+                        const std::vector<float>& samples) {
+    const size_t in = file.input_size();
+    const size_t out = file.output_size();
+    std::vector<float> work(std::max(file.required_scratch(), reference.required_scratch()));
+    Scratch scratch{work.data(), work.size()};
+    std::vector<float> expected(out);
+    std::vector<float> actual(out);
+    float worst = 0.0f;
+    for (size_t s = 0; s + in <= samples.size(); s += in) {
+        reference.predict(&samples[s], expected.data(), scratch);
+        file.predict(&samples[s], actual.data(), scratch);
+        worst = std::max(worst, max_abs_diff(expected.data(), actual.data(), out));
+    }
+    return worst;
+}
+
+bool bench_model_file() {
+    Checks checks;
+    std::printf("== Binary model files (CNNM v%u.%u): zero-copy load ==\n",
+                static_cast<unsigned>(ModelFile::kVersionMajor),
+                static_cast<unsigned>(ModelFile::kVersionMinor));
+
+    // The generated flash images against the float weight headers
+    std::mt19937 rng(83);
+    {
+        const DenseLayer t1(&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, TEMP_LAYER1_INPUT_SIZE,
+                            TEMP_LAYER1_OUTPUT_SIZE, ActivationType::ReLU);
+        const DenseLayer t2(&TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS, TEMP_LAYER2_INPUT_SIZE,
+                            TEMP_LAYER2_OUTPUT_SIZE, ActivationType::Softmax);
+        const Layer* temp_layers[] = {&t1, &t2};
+        const Sequential temp(temp_layers, 2, nullptr, nullptr, 0);
+        ModelFile file;
+        const bool loaded = file.attach(TEMP_MODEL_FILE, sizeof(TEMP_MODEL_FILE));
+        std::vector<float> windows;
+        for (int k = 0; k < 4000; ++k) {
+            const std::vector<float> w = random_vector(TEMP_LAYER1_INPUT_SIZE, rng, 15.0f, 35.0f);
+            windows.insert(windows.end(), w.begin(), w.end());
+        }
+        const float temp_diff = file_vs_reference(file, temp, windows);
+        std::printf("  TEMP_MODEL_FILE (%zu B, flash image): loaded %s, max |diff| vs "
+                    "temp_model_weights.h %.3g\n", sizeof(TEMP_MODEL_FILE),
+                    loaded ? "yes" : "NO", static_cast<double>(temp_diff));
+        checks.check(loaded && temp_diff <= kF32FileTolerance, "TEMP_MODEL_FILE differs from the headers");
+
+        const DenseLayer b1(&LAYER1_WEIGHTS[0][0], LAYER1_BIAS, LAYER1_INPUT_SIZE,
+                            LAYER1_OUTPUT_SIZE, ActivationType::ReLU);
+        const DenseLayer b2(&LAYER2_WEIGHTS[0][0], LAYER2_BIAS, LAYER2_INPUT_SIZE,
+                            LAYER2_OUTPUT_SIZE, ActivationType::Softmax);
+        const Layer* blob_layers[] = {&b1, &b2};
+        const Sequential blobs(blob_layers, 2, nullptr, nullptr, 0);
+        const bool blob_loaded = file.attach(MODEL_FILE, sizeof(MODEL_FILE));
+        const float blob_diff = file_vs_reference(
+            file, blobs, random_vector(2 * 4000, rng, -12.0f, 12.0f));
+        std::printf("  MODEL_FILE      (%zu B, flash image): loaded %s, max |diff| vs "
+                    "model_weights.h %.3g\n", sizeof(MODEL_FILE), blob_loaded ? "yes" : "NO",
+                    static_cast<double>(blob_diff));
+        checks.check(blob_loaded && blob_diff <= kF32FileTolerance, "MODEL_FILE differs from the headers");
+    }
+
+    // Any depth, every dtype
+    {
+        const RandomModel deep({40, 96, 80, 72, 64, 48, 32, 10}, rng);
+        const Sequential reference(deep.layers(), deep.num_layers(), nullptr, nullptr, 0);
+        const std::vector<float> samples = random_vector(40 * 2000, rng, -1.0f, 1.0f);
+        std::printf("  7-layer 40-96-80-72-64-48-32-10 model, 2000 samples:\n");
+        for (ModelDType dtype : {ModelDType::F32, ModelDType::FP16, ModelDType::BF16}) {
+            const std::vector<ModelExportLayer> layers = export_layers(deep, dtype);
+            const size_t size = ModelFile::serialized_size(layers.data(), layers.size());
+            AlignedBytes bytes(size);
+            ModelFile::serialize(layers.data(), layers.size(), bytes.data, size);
+            ModelFile file;
+            const bool loaded = file.attach(bytes.data, size);
+            const char* name = (dtype == ModelDType::F32) ? "F32 " :
+                               (dtype == ModelDType::FP16) ? "FP16" : "BF16";
+            const float diff = file_vs_reference(file, reference, samples);
+            std::printf("    %s %7zu B  loaded %-3s  max |dprob| vs float model %.3g%s\n", name,
+                        size, loaded ? "yes" : "NO", static_cast<double>(diff),
+                        (dtype == ModelDType::F32 && DenseLayer::kPacked) ? " (must be 0)"
+                                                                           : "");
+            const float limit = (dtype == ModelDType::F32) ? kF32FileTolerance :
+                                (dtype == ModelDType::FP16) ? kFp16FileTolerance :
+                                kBf16FileTolerance;
+            checks.check(loaded && diff <= limit, "%s file: max |dprob| %.3g > %.3g", name,
+                         static_cast<double>(diff), static_cast<double>(limit));
+        }
+    }
+
+    // Load cost against model size: open() maps and reads only the header
+    // and layer table; the copying baseline reads the whole file and builds
+    // DenseLayers (which pack their weights)
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    std::printf("  load time, 4 layers of width W (file in %s):\n", dir.c_str());
+    std::printf("    %6s %10s %12s %14s %16s\n", "W", "MiB", "open() us", "read+copy us",
+                "1st predict us");
+    for (size_t width : {size_t{64}, size_t{256}, size_t{1024}, size_t{2048}}) {
+        const RandomModel model({width, width, width, width, width}, rng);
+        const std::vector<ModelExportLayer> layers = export_layers(model, ModelDType::F32);
+        const std::string path = (dir / ("customnn_bench_" + std::to_string(width) + ".cnnm"))
+                                     .string();
+        if (!ModelFile::write(path.c_str(), layers.data(), layers.size())) {
+            std::printf("    %6zu (cannot write %s)\n", width, path.c_str());
+            continue;
+        }
+        const size_t size = ModelFile::serialized_size(layers.data(), layers.size());
+
+        const int repeats = 20;
+        ModelFile file;
+        const double t_open = time_seconds([&] {
+            for (int r = 0; r < repeats; ++r) {
+                file.open(path.c_str());
+            }
+        }) / repeats;
+
+        std::vector<float> input = random_vector(width, rng, -1.0f, 1.0f);
+        std::vector<float> output(width);
+        std::vector<float> work(file.required_scratch());
+        Scratch scratch{work.data(), work.size()};
+        const double t_first = time_seconds([&] {
+            file.predict(input.data(), output.data(), scratch);
+        });
+        g_sink = output[0];
+
+        const double t_copy = time_seconds([&] {
+            std::vector<uint8_t> contents(size);
+            FILE* in = std::fopen(path.c_str(), "rb");
+            const size_t got = (in != nullptr) ? std::fread(contents.data(), 1, size, in) : 0;
+            if (in != nullptr) {
+                std::fclose(in);
+            }
+            std::vector<DenseLayer> copied;
+            copied.reserve(layers.size());
+            for (const ModelExportLayer& layer : layers) {
+                copied.emplace_back(layer.weights, layer.bias, layer.input_size,
+                                    layer.output_size, layer.activation);
+            }
+            g_sink = static_cast<float>(got) + static_cast<float>(contents[size / 2]);
+        });
+        std::printf("    %6zu %10.2f %12.1f %14.1f %16.1f\n", width,
+                    static_cast<double>(size) / (1024.0 * 1024.0), t_open * 1e6, t_copy * 1e6,
+                    t_first * 1e6);
+        file.close();
+        std::filesystem::remove(path);
+    }
+
+    // Damaged files are refused with a reason, never read out of bounds
+    const RandomModel small({10, 8, 2}, rng);
+    const std::vector<ModelExportLayer> layers = export_layers(small, ModelDType::F32);
+    const size_t size = ModelFile::serialized_size(layers.data(), layers.size());
+    AlignedBytes good(size);
+    ModelFile::serialize(layers.data(), layers.size(), good.data, size);
+    AlignedBytes bad(size + ModelFile::kAlignment);
+
+    struct Damage {
+        const char* what;
+        size_t offset;          // Byte to overwrite (size: none)
+        uint8_t value;
+        size_t length;          // Bytes handed to attach()
+        size_t shift;           // Start of the copy within bad
+        ModelFileError expected;
+    };
+    const size_t record1 = sizeof(FileHeader) + sizeof(LayerRecord);
+    const Damage damages[] = {
+        {"magic", 0, 'X', size, 0, ModelFileError::Magic},
+        {"major version 2", 4, 2, size, 0, ModelFileError::Version},
+        {"truncated", size, 0, size - 64, 0, ModelFileError::Truncated},
+        {"misaligned base", size, 0, size, 4, ModelFileError::Alignment},
+        {"weights offset + 4", sizeof(FileHeader) + 16, 0x44, size, 0, ModelFileError::Alignment},
+        {"unknown dtype", sizeof(FileHeader) + 2, 9, size, 0, ModelFileError::Layer},
+        {"layer 2 input 9", record1 + 4, 9, size, 0, ModelFileError::Shape},
+        {"header input 11", 20, 11, size, 0, ModelFileError::Shape},
+    };
+    bool all_refused = true;
+    std::printf("  damaged files:");
+    for (const Damage& damage : damages) {
+        std::memcpy(bad.data + damage.shift, good.data, size);
+        if (damage.offset < size) {
+            bad.data[damage.shift + damage.offset] = damage.value;
+        }
+        ModelFile file;
+        const bool loaded = file.attach(bad.data + damage.shift, damage.length);
+        const bool ok = !loaded && file.error() == damage.expected;
+        all_refused = all_refused && ok;
+        if (!ok) {
+            std::printf("\n    %s: got %s", damage.what,
+                        loaded ? "loaded" : ModelFile::error_name(file.error()));
+        }
+    }
+    std::printf("%s\n", all_refused ? " all 8 refused with the expected error" : "\n");
+    checks.check(all_refused, "a damaged file was not refused as expected");
+    return checks.passed();
+}
+
+// ============================================================================
+// TFLite flatbuffer importer
+// ============================================================================
+
+std::vector<uint8_t> read_file(const char* path) {
+    std::vector<uint8_t> bytes;
+    FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) {
+        return bytes;
+    }
+    uint8_t chunk[4096];
+    size_t got = 0;
+    while ((got = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + got);
+    }
+    std::fclose(file);
+    return bytes;
+}
+
+const char* activation_label(ActivationType activation) {
+    switch (activation) {
+        case ActivationType::ReLU: return "ReLU";
+        case ActivationType::Softmax: return "Softmax";
+        case ActivationType::None: break;
+    }
+    return "None";
+}
+
+// Same float graph as the interpreter and the headers, up to summation order
+constexpr float kTfliteTolerance = 1e-5f;
+
+// First line of a model_reference.csv written by the TFLite interpreter
+constexpr const char* kInterpreterSource = "# source: tflite interpreter";
+
+bool bench_tflite() {
+    Checks checks;
+    std::printf("== Native TFLite importer (scripts/model.tflite, same bytes as model_data.cc) ==\n");
+    const std::vector<uint8_t> contents = read_file("scripts/model.tflite");
+    if (contents.empty()) {
+        return checks.check(false, "scripts/model.tflite not found (run from the repository "
+                                   "root)");
+    }
+    AlignedBytes flatbuffer(contents.size());
+    std::memcpy(flatbuffer.data, contents.data(), contents.size());
+
+    TfliteModel tflite;
+    if (!tflite.load(flatbuffer.data, contents.size())) {
+        return checks.check(false, "load failed: %s", TfliteModel::error_name(tflite.error()));
+    }
+    std::printf("  %zu B flatbuffer -> %zu layers:", contents.size(), tflite.num_layers());
+    for (size_t k = 0; k < tflite.num_layers(); ++k) {
+        const Layer* layer = tflite.layers()[k];
+        std::printf(" Dense(%zu->%zu, %s)", layer->input_size(), layer->output_size(),
+                    activation_label(layer->activation()));
+    }
+    std::printf("\n  working memory: %zu floats of scratch (TFLM: 10240 B tensor arena)\n",
+                tflite.required_scratch());
+
+    // Against the weights extract_weights.py took from the same model
+    const DenseLayer l1(&LAYER1_WEIGHTS[0][0], LAYER1_BIAS, LAYER1_INPUT_SIZE,
+                        LAYER1_OUTPUT_SIZE, ActivationType::ReLU);
+    const DenseLayer l2(&LAYER2_WEIGHTS[0][0], LAYER2_BIAS, LAYER2_INPUT_SIZE,
+                        LAYER2_OUTPUT_SIZE, ActivationType::Softmax);
+    const Layer* header_layers[] = {&l1, &l2};
+    const Sequential header_model(header_layers, 2, nullptr, nullptr, 0);
+    std::vector<float> work(std::max(tflite.required_scratch(), header_model.required_scratch()));
+    Scratch scratch{work.data(), work.size()};
+
+    std::mt19937 rng(89);
+    const size_t n = 20000;
+    const std::vector<float> inputs = random_vector(2 * n, rng, -12.0f, 12.0f);
+    std::vector<float> expected(3 * n);
+    std::vector<float> actual(3 * n);
+    const double t_header = time_seconds([&] {
+        for (size_t s = 0; s < n; ++s) {
+            header_model.predict(&inputs[2 * s], &expected[3 * s], scratch);
+        }
+    });
+    const double t_tflite = time_seconds([&] {
+        for (size_t s = 0; s < n; ++s) {
+            tflite.predict(&inputs[2 * s], &actual[3 * s], scratch);
+        }
+    });
+    size_t agree = 0;
+    for (size_t s = 0; s < n; ++s) {
+        agree += (Classify::argmax(&expected[3 * s], 3) == Classify::argmax(&actual[3 * s], 3))
+                     ? size_t{1} : size_t{0};
+    }
+    const float header_diff = max_abs_diff(expected.data(), actual.data(), expected.size());
+    std::printf("  vs model_weights.h on %zu random inputs: max |dprob| %.3g, argmax agree "
+                "%.2f%%\n", n, static_cast<double>(header_diff),
+                100.0 * static_cast<double>(agree) / static_cast<double>(n));
+    checks.check(header_diff <= kTfliteTolerance && agree == n,
+                 "differs from model_weights.h: max |dprob| %.3g, agree %zu/%zu",
+                 static_cast<double>(header_diff), agree, n);
+    std::printf("  ns/predict: weight header %.1f, TFLite in place %.1f\n",
+                t_header * 1e9 / static_cast<double>(n), t_tflite * 1e9 / static_cast<double>(n));
+
+    // Against the float outputs in scripts/model_reference.csv. Only a dump
+    // from the TFLite interpreter (train_model.py --reference, first line
+    // "# source: tflite interpreter") is required to exist and to agree;
+    // other references (tflite_reference.py) are reported, not enforced.
+    const char* reference_path = "scripts/model_reference.csv";
+    FILE* reference = std::fopen(reference_path, "r");
+    if (reference == nullptr) {
+        std::printf("  %s not found; write it with\n"
+                    "    python scripts/train_model.py --test scripts/model.tflite "
+                    "--reference %s\n", reference_path, reference_path);
+    } else {
+        char line[256];
+        bool interpreter = false;
+        size_t rows = 0;
+        size_t matches = 0;
+        float worst = 0.0f;
+        while (std::fgets(line, sizeof(line), reference) != nullptr) {
+            if (line[0] == '#') {
+                interpreter = interpreter ||
+                              std::strncmp(line, kInterpreterSource,
+                                           std::strlen(kInterpreterSource)) == 0;
+                continue;
+            }
+            float values[5];
+            if (std::sscanf(line, "%f,%f,%f,%f,%f", &values[0], &values[1], &values[2],
+                            &values[3], &values[4]) != 5) {
+                continue;   // Column names
+            }
+            float probs[3];
+            tflite.predict(values, probs, scratch);
+            worst = std::max(worst, max_abs_diff(probs, values + 2, 3));
+            matches += (Classify::argmax(probs, 3) == Classify::argmax(values + 2, 3))
+                           ? size_t{1} : size_t{0};
+            ++rows;
+        }
+        std::fclose(reference);
+        const bool agree_all = rows > 0 && worst <= kTfliteTolerance && matches == rows;
+        std::printf("  vs %s (%s): %zu rows, max |dprob| %.3g, argmax agree %zu/%zu\n",
+                    interpreter ? "TFLite interpreter" : "non-interpreter reference",
+                    reference_path, rows, static_cast<double>(worst), matches, rows);
+        if (interpreter) {
+            checks.check(agree_all,
+                         "differs from the TFLite interpreter (%s): %zu rows, max |dprob| "
+                         "%.3g, argmax agree %zu/%zu", reference_path, rows,
+                         static_cast<double>(worst), matches, rows);
+        } else {
+            std::printf("  %s: not an interpreter dump, not enforced; regenerate it with\n"
+                        "    python scripts/train_model.py --test scripts/model.tflite "
+                        "--reference %s\n", agree_all ? "agrees" : "WARNING: disagrees",
+                        reference_path);
+        }
+    }
+
+    // Damaged flatbuffers are refused, never read out of bounds: every
+    // truncation, every single-byte corruption, and a misaligned copy
+    size_t truncated_loads = 0;
+    for (size_t length = 0; length < contents.size(); ++length) {
+        TfliteModel partial;
+        truncated_loads += partial.load(flatbuffer.data, length) ? size_t{1} : size_t{0};
+    }
+    AlignedBytes damaged(contents.size());
+    size_t loaded = 0;
+    size_t refused[static_cast<size_t>(TfliteError::Alignment) + 1] = {};
+    for (size_t pos = 0; pos < contents.size(); ++pos) {
+        for (uint8_t value : {uint8_t{0x00}, uint8_t{0x7F}, uint8_t{0xFF}}) {
+            std::memcpy(damaged.data, contents.data(), contents.size());
+            if (damaged.data[pos] == value) {
+                continue;
+            }
+            damaged.data[pos] = value;
+            TfliteModel model;
+            if (model.load(damaged.data, contents.size())) {
+                ++loaded;   // Changed weights or unused bytes
+                float probs[3];
+                std::vector<float> w(model.required_scratch() + 1);
+                Scratch s{w.data(), w.size()};
+                if (model.input_size() == 2 && model.output_size() == 3) {
+                    model.predict(inputs.data(), probs, s);
+                }
+            } else {
+                ++refused[static_cast<size_t>(model.error())];
+            }
+        }
+    }
+    std::printf("  %zu truncations: %zu loaded\n", contents.size(), truncated_loads);
+    checks.check(truncated_loads == 0, "%zu truncated flatbuffers loaded", truncated_loads);
+    std::printf("  single-byte corruptions: %zu still load (weights or unused bytes), refused:\n",
+                loaded);
+    for (size_t e = 1; e < sizeof(refused) / sizeof(refused[0]); ++e) {
+        if (refused[e] > 0) {
+            std::printf("    %-36s %5zu\n", TfliteModel::error_name(static_cast<TfliteError>(e)),
+                        refused[e]);
+        }
+    }
+
+    AlignedBytes shifted(contents.size() + 1);
+    std::memcpy(shifted.data + 1, contents.data(), contents.size());
+    TfliteModel misaligned;
+    const bool misaligned_refused = !misaligned.load(shifted.data + 1, contents.size()) &&
+                                    misaligned.error() == TfliteError::Alignment;
+    std::printf("  misaligned copy refused: %s\n", misaligned_refused ? "yes" : "NO");
+    checks.check(misaligned_refused, "misaligned flatbuffer not refused");
+    return checks.passed();
+}
+
+// ============================================================================
+// Graph optimizer
+// ============================================================================
+
+void print_graph(const char* label, const ModelGraph& graph) {
+    std::printf("  %-10s", label);
+    for (const ModelGraph::Node& node : graph.nodes()) {
+        switch (node.kind) {
+            case ModelGraph::OpKind::Dense:
+                std::printf(" Dense(%zu->%zu)", node.input_size, node.output_size);
+                break;
+            case ModelGraph::OpKind::Affine:
+                std::printf(" Affine(%zu)", node.input_size);
+                break;
+            case ModelGraph::OpKind::ReLU:
+                std::printf(" ReLU");
+                break;
+            case ModelGraph::OpKind::Softmax:
+                std::printf(" Softmax");
+                break;
+        }
+    }
+    std::printf("  [%zu MACs]\n", graph.macs());
+}
+
+// Folding and merging only reorder float rounding (measured: up to 1.4e-6)
+constexpr float kGraphTolerance = 1e-5f;
+
+// Reference graph vs the exported layers on every sample
+void graph_vs_layers(Checks& checks, const char* label, const ModelGraph& graph,
+                     const Sequential& model, const std::vector<float>& samples,
+                     float threshold) {
+    const size_t in = graph.input_size();
+    const size_t out = graph.output_size();
+    std::vector<float> work(model.required_scratch());
+    Scratch scratch{work.data(), work.size()};
+    std::vector<float> expected(out);
+    std::vector<float> actual(out);
+    float worst = 0.0f;
+    size_t agree = 0;
+    const size_t count = samples.size() / in;
+    for (size_t s = 0; s < count; ++s) {
+        graph.run(&samples[s * in], expected.data());
+        model.predict(&samples[s * in], actual.data(), scratch);
+        worst = std::max(worst, max_abs_diff(expected.data(), actual.data(), out));
+        agree += ((expected[out - 1] > threshold) == (actual[out - 1] > threshold)) ? size_t{1}
+                                                                                  : size_t{0};
+    }
+    std::printf("  %-26s %6zu windows, max |dprob| %.3g, decisions agree %zu/%zu\n", label,
+                count, static_cast<double>(worst), agree, count);
+    checks.check(worst <= kGraphTolerance && agree == count,
+                 "%s: optimized model differs from the reference graph", label);
+}
+
+bool bench_optimize() {
+    Checks checks;
+    std::printf("== Graph optimizer: fold normalization, merge linear layers, prune dead ReLUs "
+                "==\n");
+    const size_t width = TEMP_LAYER1_INPUT_SIZE;
+    std::vector<float> calibration;
+    std::vector<float> held_out;
+    for (const char* path : {"normal.csv", "touched.csv", "touched2.csv", "touched3.csv",
+                             "temperature_data_20251122_135801.csv"}) {
+        const bool hold_out = std::strcmp(path, "touched3.csv") == 0 ||
+                              std::strcmp(path, "temperature_data_20251122_135801.csv") == 0;
+        append_windows(read_temperatures(path), width, hold_out ? held_out : calibration);
+    }
+    if (calibration.empty()) {
+        return checks.check(false, "temperature logs not found (run from the repository "
+                                   "root)");
+    }
+    const size_t calibration_count = calibration.size() / width;
+
+    // Input standardization as a training pipeline would fit it
+    std::vector<float> mean(width);
+    std::vector<float> stddev(width);
+    for (size_t i = 0; i < width; ++i) {
+        double sum = 0.0;
+        double sum_sq = 0.0;
+        for (size_t s = 0; s < calibration_count; ++s) {
+            const double x = calibration[s * width + i];
+            sum += x;
+            sum_sq += x * x;
+        }
+        const double m = sum / static_cast<double>(calibration_count);
+        const double var = sum_sq / static_cast<double>(calibration_count) - m * m;
+        mean[i] = static_cast<float>(m);
+        stddev[i] = static_cast<float>(std::sqrt(std::max(var, 1e-6)));
+    }
+
+    // Standardize -> Dense -> BatchNorm -> ReLU -> Dense -> Dense -> ReLU -> Dense -> Softmax,
+    // with a quarter of the batch-norm units shifted far negative: ReLUs that
+    // stopped firing during training
+    std::mt19937 rng(97);
+    const size_t hidden = 32;
+    const std::vector<float> w1 = random_vector(width * hidden, rng, -0.4f, 0.4f);
+    const std::vector<float> b1 = random_vector(hidden, rng, -0.1f, 0.1f);
+    const std::vector<float> gamma = random_vector(hidden, rng, 0.5f, 1.5f);
+    std::vector<float> beta = random_vector(hidden, rng, -0.5f, 0.5f);
+    const std::vector<float> bn_mean = random_vector(hidden, rng, -0.2f, 0.2f);
+    const std::vector<float> bn_var = random_vector(hidden, rng, 0.5f, 2.0f);
+    for (size_t j = hidden - hidden / 4; j < hidden; ++j) {
+        beta[j] = -20.0f;
+    }
+    const std::vector<float> w2 = random_vector(hidden * hidden, rng, -0.3f, 0.3f);
+    const std::vector<float> b2 = random_vector(hidden, rng, -0.1f, 0.1f);
+    const std::vector<float> w3 = random_vector(hidden * 8, rng, -0.4f, 0.4f);
+    const std::vector<float> b3 = random_vector(8, rng, -0.1f, 0.1f);
+    const std::vector<float> w4 = random_vector(8 * 2, rng, -0.8f, 0.8f);
+    const std::vector<float> b4 = random_vector(2, rng, -0.1f, 0.1f);
+
+    ModelGraph graph(width);
+    const bool built = graph.add_standardize(mean.data(), stddev.data()) &&
+                       graph.add_dense(w1.data(), b1.data(), hidden) &&
+                       graph.add_batch_norm(gamma.data(), beta.data(), bn_mean.data(),
+                                            bn_var.data(), 1e-3f) &&
+                       graph.add_activation(ActivationType::ReLU) &&
+                       graph.add_dense(w2.data(), b2.data(), hidden) &&
+                       graph.add_dense(w3.data(), b3.data(), 8) &&
+                       graph.add_activation(ActivationType::ReLU) &&
+                       graph.add_dense(w4.data(), b4.data(), 2) &&
+                       graph.add_activation(ActivationType::Softmax);
+    if (!built) {
+        return checks.check(false, "building the demo graph failed");
+    }
+
+    ModelGraph optimized = graph;
+    const ModelGraph::Report report = optimized.optimize(calibration.data(), calibration_count);
+    std::printf("  calibrated on %zu windows (normal, touched, touched2)\n", calibration_count);
+    print_graph("before", graph);
+    print_graph("after", optimized);
+    std::printf("  folded %zu affine, merged %zu pairs, pruned %zu neurons: %zu -> %zu MACs "
+                "(%.2fx fewer)\n", report.folded, report.merged, report.pruned,
+                report.macs_before, report.macs_after,
+                static_cast<double>(report.macs_before) / static_cast<double>(report.macs_after));
+    checks.check(report.macs_after < report.macs_before, "optimize() saved no MACs");
+
+    const std::vector<ModelExportLayer> exported = optimized.export_layers();
+    if (exported.empty()) {
+        return checks.check(false, "optimized graph does not export to Dense layers");
+    }
+    std::vector<DenseLayer> dense;
+    dense.reserve(exported.size());
+    std::vector<const Layer*> dense_ptrs;
+    for (const ModelExportLayer& layer : exported) {
+        dense.emplace_back(layer.weights, layer.bias, layer.input_size, layer.output_size,
+                           layer.activation);
+        dense_ptrs.push_back(&dense.back());
+    }
+    const Sequential model(dense_ptrs.data(), dense_ptrs.size(), nullptr, nullptr, 0);
+    const float threshold = 0.5f;
+    graph_vs_layers(checks, "calibration set", graph, model, calibration, threshold);
+    if (!held_out.empty()) {
+        graph_vs_layers(checks, "held out (touched3, 1122)", graph, model, held_out, threshold);
+    }
+
+    std::vector<float> work(model.required_scratch());
+    Scratch scratch{work.data(), work.size()};
+    float probs[2];
+    const double t_graph = time_seconds([&] {
+        for (size_t s = 0; s < calibration_count; ++s) {
+            graph.run(&calibration[s * width], probs);
+            g_sink = probs[1];
+        }
+    });
+    const double t_optimized = time_seconds([&] {
+        for (size_t s = 0; s < calibration_count; ++s) {
+            optimized.run(&calibration[s * width], probs);
+            g_sink = probs[1];
+        }
+    });
+    const double t_model = time_seconds([&] {
+        for (size_t s = 0; s < calibration_count; ++s) {
+            model.predict(&calibration[s * width], probs, scratch);
+            g_sink = probs[1];
+        }
+    });
+    const double per = 1e9 / static_cast<double>(calibration_count);
+    std::printf("  ns/predict: reference graph %.1f, optimized graph %.1f, exported Dense "
+                "layers %.1f\n", t_graph * per, t_optimized * per, t_model * per);
+
+    // The exported layers go through the model file path unchanged
+    const size_t size = ModelFile::serialized_size(exported.data(), exported.size());
+    AlignedBytes bytes(size);
+    ModelFile file;
+    const bool attached =
+        ModelFile::serialize(exported.data(), exported.size(), bytes.data, size) == size &&
+        file.attach(bytes.data, size);
+    const bool reproduces = attached &&
+                            file_vs_reference(file, model, calibration) <= kF32FileTolerance;
+    std::printf("  as a model file: %zu bytes, %s\n", size,
+                attached ? (reproduces ? "reproduces the exported layers exactly"
+                                       : "DIFFERS from the exported layers")
+                         : ModelFile::error_name(file.error()));
+    checks.check(reproduces, "model file does not reproduce the exported layers");
+
+    // Linear pairs merge only when that saves multiply-adds
+    std::printf("  linear pairs (no activation between), 1000 random inputs:\n");
+    const size_t shapes[][3] = {{32, 32, 8}, {16, 64, 16}, {64, 8, 64}, {10, 4, 10}};
+    for (const auto& shape : shapes) {
+        const std::vector<float> wa = random_vector(shape[0] * shape[1], rng, -0.3f, 0.3f);
+        const std::vector<float> ba = random_vector(shape[1], rng, -0.1f, 0.1f);
+        const std::vector<float> wb = random_vector(shape[1] * shape[2], rng, -0.3f, 0.3f);
+        const std::vector<float> bb = random_vector(shape[2], rng, -0.1f, 0.1f);
+        ModelGraph pair(shape[0]);
+        pair.add_dense(wa.data(), ba.data(), shape[1]);
+        pair.add_dense(wb.data(), bb.data(), shape[2]);
+        ModelGraph merged = pair;
+        const size_t merges = merged.merge_linear();
+        const std::vector<float> inputs = random_vector(1000 * shape[0], rng, -2.0f, 2.0f);
+        std::vector<float> expected(shape[2]);
+        std::vector<float> actual(shape[2]);
+        float worst = 0.0f;
+        for (size_t s = 0; s < 1000; ++s) {
+            pair.run(&inputs[s * shape[0]], expected.data());
+            merged.run(&inputs[s * shape[0]], actual.data());
+            worst = std::max(worst, max_abs_diff(expected.data(), actual.data(), shape[2]));
+        }
+        std::printf("    %3zu->%3zu->%3zu: %-10s %5zu -> %5zu MACs, max |diff| %.3g\n",
+                    shape[0], shape[1], shape[2], merges > 0 ? "merged" : "kept apart",
+                    pair.macs(), merged.macs(), static_cast<double>(worst));
+        checks.check(worst <= kGraphTolerance, "%zu->%zu->%zu: merged pair differs",
+                     shape[0], shape[1], shape[2]);
+    }
+    return checks.passed();
+}
+
+// ============================================================================
+// Conv1D and pooling layers
+// ============================================================================
+
+// The convolution as the equivalent Dense weight matrix
+// [input_length * in_channels][output_length * out_channels]
+std::vector<float> conv_as_dense(const Conv1D& conv) {
+    const size_t out_length = ConvOps::output_length(conv);
+    const size_t rows = conv.input_length * conv.in_channels;
+    const size_t cols = out_length * conv.out_channels;
+    std::vector<float> dense(rows * cols, 0.0f);
+    for (size_t t = 0; t < out_length; ++t) {
+        for (size_t k = 0; k < conv.kernel_size; ++k) {
+            const size_t position = t * conv.stride + k * conv.dilation;
+            for (size_t c = 0; c < conv.in_channels; ++c) {
+                for (size_t o = 0; o < conv.out_channels; ++o) {
+                    dense[(position * conv.in_channels + c) * cols + t * conv.out_channels + o] =
+                        conv.weights[(k * conv.in_channels + c) * conv.out_channels + o];
+                }
+            }
+        }
+    }
+    return dense;
+}
+
+// Modelled M0+ cycles: every multiply-add loads an input and a weight
+double m0_mac_cycles(size_t macs, const M0Costs& c) {
+    return static_cast<double>(macs) * (2 * c.load + c.fmul + c.fadd + c.loop);
+}
+
+// Same products as the Dense matrix, summed in another order (measured: 9.5e-7)
+constexpr float kConvTolerance = 1e-5f;
+
+bool bench_conv() {
+    Checks checks;
+    std::printf("== Conv1D / MaxPool1D / GlobalAveragePool layers (direct, no im2col) ==\n");
+    std::mt19937 rng(101);
+
+    // Conv1D against the same operator written out as a Dense layer
+    std::printf("  Conv1D vs equivalent Dense matrix, 500 random inputs each:\n");
+    const size_t shapes[][6] = {
+        // length, in, out, kernel, stride, dilation
+        {10, 1, 8, 3, 1, 1}, {100, 1, 8, 5, 2, 1}, {64, 4, 8, 3, 1, 4}, {50, 3, 5, 4, 3, 2},
+    };
+    for (const auto& shape : shapes) {
+        const std::vector<float> w = random_vector(shape[3] * shape[1] * shape[2], rng, -0.5f,
+                                                   0.5f);
+        const std::vector<float> b = random_vector(shape[2], rng, -0.1f, 0.1f);
+        const Conv1D params = {w.data(), b.data(), shape[0], shape[1], shape[2], shape[3],
+                               shape[4], shape[5], ActivationType::ReLU};
+        const Conv1DLayer conv(params);
+        const std::vector<float> matrix = conv_as_dense(params);
+        const size_t out_length = conv.output_length();
+        std::vector<float> dense_bias(conv.output_size());
+        for (size_t t = 0; t < out_length; ++t) {
+            std::copy(b.begin(), b.end(), dense_bias.begin() +
+                                              static_cast<std::ptrdiff_t>(t * shape[2]));
+        }
+        const DenseLayer dense(matrix.data(), dense_bias.data(), conv.input_size(),
+                               conv.output_size(), ActivationType::ReLU);
+        std::vector<float> expected(conv.output_size());
+        std::vector<float> actual(conv.output_size());
+        float worst = 0.0f;
+        for (int s = 0; s < 500; ++s) {
+            const std::vector<float> x = random_vector(conv.input_size(), rng, -2.0f, 2.0f);
+            dense.forward(x.data(), expected.data());
+            conv.forward(x.data(), actual.data());
+            worst = std::max(worst, max_abs_diff(expected.data(), actual.data(), expected.size()));
+        }
+        std::printf("    L=%4zu c=%zu->%zu k=%zu s=%zu d=%zu: %4zu x %zu out, %4zu weights "
+                    "(Dense: %6zu), max |diff| %.3g\n", shape[0], shape[1], shape[2], shape[3],
+                    shape[4], shape[5], out_length, shape[2], w.size(), matrix.size(),
+                    static_cast<double>(worst));
+        checks.check(worst <= kConvTolerance, "Conv1D L=%zu differs from the Dense matrix",
+                     shape[0]);
+    }
+
+    // Pooling against straightforward loops
+    {
+        const size_t length = 37;
+        const size_t channels = 3;
+        const std::vector<float> x = random_vector(length * channels, rng, -3.0f, 3.0f);
+        const MaxPool1DLayer pool(length, channels, 4, 3);
+        const GlobalAveragePoolLayer gap(length, channels);
+        std::vector<float> pooled(pool.output_size());
+        float averaged[channels];
+        pool.forward(x.data(), pooled.data());
+        gap.forward(x.data(), averaged);
+        bool pool_ok = pool.output_length() == 12;
+        for (size_t t = 0; t < pool.output_length(); ++t) {
+            for (size_t c = 0; c < channels; ++c) {
+                float m = -INFINITY;
+                for (size_t k = 0; k < 4; ++k) {
+                    m = std::max(m, x[(t * 3 + k) * channels + c]);
+                }
+                pool_ok = pool_ok && pooled[t * channels + c] == m;
+            }
+        }
+        float gap_worst = 0.0f;
+        for (size_t c = 0; c < channels; ++c) {
+            double sum = 0.0;
+            for (size_t t = 0; t < length; ++t) {
+                sum += x[t * channels + c];
+            }
+            gap_worst = std::max(gap_worst, std::fabs(averaged[c] -
+                                                      static_cast<float>(sum / length)));
+        }
+        std::printf("  MaxPool1D(4, stride 3) on 37 x 3: %s; GlobalAveragePool max |diff| %.3g\n",
+                    pool_ok ? "exact" : "MISMATCH", static_cast<double>(gap_worst));
+        checks.check(pool_ok, "MaxPool1D differs from the reference loop");
+        checks.check(gap_worst <= kConvTolerance, "GlobalAveragePool max |diff| %.3g",
+                     static_cast<double>(gap_worst));
+    }
+
+    // Window length scaling: a conv front end vs a Dense first layer
+    std::printf("  window -> 2 classes; conv: Conv1D(k5, s2, 4) MaxPool(2) Conv1D(k3, d2, 8) "
+                "GAP Dense(8->2); dense: Dense(L->8) Dense(8->2)\n");
+    std::printf("    %6s %9s %9s %11s %11s %10s %10s %12s %12s\n", "window", "params",
+                "(dense)", "MACs", "(dense)", "ns conv", "ns dense", "M0 cyc conv",
+                "(dense)");
+    const M0Costs costs;
+    const std::vector<float> w1 = random_vector(5 * 4, rng, -0.5f, 0.5f);
+    const std::vector<float> b1 = random_vector(4, rng, -0.1f, 0.1f);
+    const std::vector<float> w2 = random_vector(3 * 4 * 8, rng, -0.3f, 0.3f);
+    const std::vector<float> b2 = random_vector(8, rng, -0.1f, 0.1f);
+    const std::vector<float> w3 = random_vector(8 * 2, rng, -0.5f, 0.5f);
+    const std::vector<float> b3 = random_vector(2, rng, -0.1f, 0.1f);
+    for (size_t length : {size_t{32}, size_t{100}, size_t{300}, size_t{1000}}) {
+        const Conv1D c1 = {w1.data(), b1.data(), length, 1, 4, 5, 2, 1, ActivationType::ReLU};
+        const Conv1DLayer conv1(c1);
+        const MaxPool1DLayer pool(conv1.output_length(), 4, 2);
+        const Conv1D c2 = {w2.data(), b2.data(), pool.output_length(), 4, 8, 3, 1, 2,
+                           ActivationType::ReLU};
+        const Conv1DLayer conv2(c2);
+        const GlobalAveragePoolLayer gap(conv2.output_length(), 8);
+        const DenseLayer head(w3.data(), b3.data(), 8, 2, ActivationType::Softmax);
+        const Layer* conv_layers[] = {&conv1, &pool, &conv2, &gap, &head};
+        const Sequential conv_model(conv_layers, 5, nullptr, nullptr, 0);
+        const size_t conv_params = w1.size() + b1.size() + w2.size() + b2.size() + w3.size() +
+                                   b3.size();
+        const size_t conv_macs = ConvOps::macs(c1) + ConvOps::macs(c2) + 8 * 2;
+
+        const std::vector<float> dw1 = random_vector(length * 8, rng, -0.1f, 0.1f);
+        const std::vector<float> db1 = random_vector(8, rng, -0.1f, 0.1f);
+        const DenseLayer d1(dw1.data(), db1.data(), length, 8, ActivationType::ReLU);
+        const Layer* dense_layers[] = {&d1, &head};
+        const Sequential dense_model(dense_layers, 2, nullptr, nullptr, 0);
+        const size_t dense_params = dw1.size() + db1.size() + w3.size() + b3.size();
+        const size_t dense_macs = length * 8 + 8 * 2;
+
+        std::vector<float> work(std::max(conv_model.required_scratch(),
+                                         dense_model.required_scratch()));
+        Scratch scratch{work.data(), work.size()};
+        const size_t n = 2000;
+        const std::vector<float> inputs = random_vector(length + n, rng, 18.0f, 30.0f);
+        float probs[2];
+        const double t_conv = time_seconds([&] {
+            for (size_t s = 0; s < n; ++s) {
+                conv_model.predict(&inputs[s], probs, scratch);
+                g_sink = probs[1];
+            }
+        });
+        const double t_dense = time_seconds([&] {
+            for (size_t s = 0; s < n; ++s) {
+                dense_model.predict(&inputs[s], probs, scratch);
+                g_sink = probs[1];
+            }
+        });
+        std::printf("    %6zu %9zu %9zu %11zu %11zu %10.1f %10.1f %12.0f %12.0f\n", length,
+                    conv_params, dense_params, conv_macs, dense_macs,
+                    t_conv * 1e9 / static_cast<double>(n), t_dense * 1e9 / static_cast<double>(n),
+                    m0_mac_cycles(conv_macs, costs), m0_mac_cycles(dense_macs, costs));
+    }
+    return checks.passed();
+}
+
+// ============================================================================
+// Streaming causal inference
+// ============================================================================
+
+// Every stored log, one sequence each
+std::vector<std::vector<float>> read_logs() {
+    std::vector<std::vector<float>> logs;
+    for (const char* path : {"normal.csv", "touched.csv", "touched2.csv", "touched3.csv",
+                             "temperature_data_20251122_135801.csv"}) {
+        std::vector<float> temps = read_temperatures(path);
+        if (!temps.empty()) {
+            logs.push_back(std::move(temps));
+        }
+    }
+    return logs;
+}
+
+// Ring buffers change only the summation order (measured: up to 1.6e-6)
+constexpr float kStreamTolerance = 1e-5f;
+
+/**
+ * Stream every log through `stream` and compare each output with the
+ * windowed model on the window ending at the same sample, where the two are
+ * aligned (the window start a multiple of `alignment`)
+ */
+void stream_vs_windowed(Checks& checks, const char* label, StreamingSequential& stream,
+                        const Sequential& windowed, size_t alignment,
+                        const std::vector<std::vector<float>>& logs, size_t windowed_macs,
+                        size_t streaming_macs) {
+    const size_t width = windowed.input_size();
+    const size_t out = windowed.output_size();
+    std::vector<float> work(windowed.required_scratch());
+    Scratch scratch{work.data(), work.size()};
+    std::vector<float> expected(out);
+    std::vector<float> actual(out);
+    float worst = 0.0f;
+    size_t compared = 0;
+    size_t emitted = 0;
+    size_t samples = 0;
+    for (const std::vector<float>& temps : logs) {
+        stream.reset();
+        for (size_t t = 0; t < temps.size(); ++t) {
+            if (!stream.push(&temps[t], actual.data())) {
+                continue;
+            }
+            ++emitted;
+            if (t + 1 < width || (t + 1 - width) % alignment != 0) {
+                continue;
+            }
+            windowed.predict(&temps[t + 1 - width], expected.data(), scratch);
+            worst = std::max(worst, max_abs_diff(expected.data(), actual.data(), out));
+            ++compared;
+        }
+        samples += temps.size();
+    }
+
+    // Per new sample: the windowed model reruns over the whole window
+    const std::vector<float>& longest = *std::max_element(
+        logs.begin(), logs.end(),
+        [](const std::vector<float>& a, const std::vector<float>& b) { return a.size() < b.size(); });
+    const double t_stream = time_seconds([&] {
+        stream.reset();
+        for (float temp : longest) {
+            if (stream.push(&temp, actual.data())) {
+                g_sink = actual[0];
+            }
+        }
+    });
+    const size_t windows = longest.size() - width + 1;
+    const double t_windowed = time_seconds([&] {
+        for (size_t s = 0; s < windows; ++s) {
+            windowed.predict(&longest[s], expected.data(), scratch);
+            g_sink = expected[0];
+        }
+    });
+    std::printf("  %s\n", label);
+    std::printf("    window %zu, stream state %zu B: %zu samples, %zu outputs, %zu compared, "
+                "max |diff| %.3g\n", width, stream.state_bytes(), samples, emitted, compared,
+                static_cast<double>(worst));
+    checks.check(compared > 0 && worst <= kStreamTolerance,
+                 "streaming differs from the windowed model: max |diff| %.3g",
+                 static_cast<double>(worst));
+    std::printf("    per sample: windowed %6zu MACs %8.1f ns, streaming %5zu MACs %8.1f ns "
+                "(%.1fx)\n", windowed_macs, t_windowed * 1e9 / static_cast<double>(windows),
+                streaming_macs, t_stream * 1e9 / static_cast<double>(longest.size()),
+                (t_windowed / static_cast<double>(windows)) /
+                    (t_stream / static_cast<double>(longest.size())));
+}
+
+bool bench_stream() {
+    Checks checks;
+    std::printf("== Streaming causal inference: per-layer ring buffers vs windowed rerun ==\n");
+    const std::vector<std::vector<float>> logs = read_logs();
+    if (logs.empty()) {
+        return checks.check(false, "temperature logs not found (run from the repository "
+                                   "root)");
+    }
+
+    // The shipped temperature model: its Dense first layer is a causal
+    // Conv1D with 10 taps, the weights already in [kernel][1][out] order
+    {
+        const Conv1D c1 = {&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, 0, 1,
+                           TEMP_LAYER1_OUTPUT_SIZE, TEMP_LAYER1_INPUT_SIZE, 1, 1,
+                           ActivationType::ReLU};
+        const StreamingConv1DLayer conv(c1);
+        const DenseLayer dense1(&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS,
+                                TEMP_LAYER1_INPUT_SIZE, TEMP_LAYER1_OUTPUT_SIZE,
+                                ActivationType::ReLU);
+        const DenseLayer dense2(&TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS,
+                                TEMP_LAYER2_INPUT_SIZE, TEMP_LAYER2_OUTPUT_SIZE,
+                                ActivationType::Softmax);
+        const StreamingPointwiseLayer head(dense2);
+        const StreamingLayer* stream_layers[] = {&conv, &head};
+        StreamingSequential stream(stream_layers, 2);
+        const Layer* layers[] = {&dense1, &dense2};
+        const Sequential windowed(layers, 2, nullptr, nullptr, 0);
+        const size_t macs = TEMP_LAYER1_INPUT_SIZE * TEMP_LAYER1_OUTPUT_SIZE +
+                            TEMP_LAYER2_INPUT_SIZE * TEMP_LAYER2_OUTPUT_SIZE;
+        stream_vs_windowed(checks, "temperature model 10-8-2 (Dense(10) as a 10-tap causal conv)",
+                           stream, windowed, 1, logs, macs, macs);
+    }
+
+    // Long context: dilated causal convs (dilation 1..32, receptive field
+    // 127 samples), the mean over the last 64 positions, a Dense head. The
+    // windowed equivalent needs 190-sample windows.
+    std::mt19937 rng(103);
+    const size_t channels = 8;
+    const size_t average = 64;
+    std::vector<std::vector<float>> weights;
+    std::vector<std::vector<float>> biases;
+    std::vector<Conv1D> convs;
+    size_t length = average;
+    for (size_t d = 1; d <= 32; d *= 2) {
+        length += 2 * d;
+    }
+    const size_t window = length;
+    size_t positions = window;
+    size_t conv_macs = 0;
+    size_t step_macs = 0;
+    for (size_t d = 1; d <= 32; d *= 2) {
+        const size_t in_ch = convs.empty() ? 1 : channels;
+        const float limit = std::sqrt(6.0f / static_cast<float>(3 * in_ch + channels));
+        weights.push_back(random_vector(3 * in_ch * channels, rng, -limit, limit));
+        biases.push_back(random_vector(channels, rng, -0.1f, 0.1f));
+        convs.push_back({weights.back().data(), biases.back().data(), positions, in_ch, channels,
+                         3, 1, d, ActivationType::ReLU});
+        positions = ConvOps::output_length(convs.back());
+        conv_macs += ConvOps::macs(convs.back());
+        step_macs += 3 * in_ch * channels;
+    }
+    // Inputs around 0: the logs are centred on their first reading
+    const std::vector<float> w_head = random_vector(channels * 2, rng, -0.8f, 0.8f);
+    const std::vector<float> b_head = random_vector(2, rng, -0.1f, 0.1f);
+    const DenseLayer head_layer(w_head.data(), b_head.data(), channels, 2,
+                                ActivationType::Softmax);
+
+    std::vector<std::vector<float>> centred = logs;
+    for (std::vector<float>& temps : centred) {
+        const float first = temps.front();
+        for (float& t : temps) {
+            t -= first;
+        }
+    }
+    {
+        std::vector<Conv1DLayer> conv_layers(convs.begin(), convs.end());
+        const GlobalAveragePoolLayer gap(positions, channels);
+        std::vector<const Layer*> layers;
+        for (const Conv1DLayer& layer : conv_layers) {
+            layers.push_back(&layer);
+        }
+        layers.push_back(&gap);
+        layers.push_back(&head_layer);
+        const Sequential windowed(layers.data(), layers.size(), nullptr, nullptr, 0);
+
+        std::vector<StreamingConv1DLayer> stream_convs(convs.begin(), convs.end());
+        const StreamingAverageLayer mean(average, channels);
+        const StreamingPointwiseLayer head(head_layer);
+        std::vector<const StreamingLayer*> stream_layers;
+        for (const StreamingConv1DLayer& layer : stream_convs) {
+            stream_layers.push_back(&layer);
+        }
+        stream_layers.push_back(&mean);
+        stream_layers.push_back(&head);
+        StreamingSequential stream(stream_layers.data(), stream_layers.size());
+        stream_vs_windowed(checks,
+                           "6 dilated convs (k3, d1-32, 8 ch) + mean of 64 + Dense(8->2)",
+                           stream, windowed, 1, centred, conv_macs + 16, step_macs + 16);
+    }
+
+    // Strided: conv, MaxPool(2), dilated conv, mean of 16. Outputs come
+    // every second sample and match windows that start on an even sample.
+    {
+        const std::vector<float> wa = random_vector(3 * channels, rng, -0.6f, 0.6f);
+        const std::vector<float> wb = random_vector(3 * channels * channels, rng, -0.3f, 0.3f);
+        const size_t pooled_window = 2 * (16 + 4) + 2;
+        const Conv1D ca = {wa.data(), biases[0].data(), pooled_window, 1, channels, 3, 1, 1,
+                           ActivationType::ReLU};
+        const Conv1D cb = {wb.data(), biases[1].data(), (pooled_window - 2) / 2, channels,
+                           channels, 3, 1, 2, ActivationType::ReLU};
+        const Conv1DLayer conv_a(ca);
+        const MaxPool1DLayer pool(conv_a.output_length(), channels, 2);
+        const Conv1DLayer conv_b(cb);
+        const GlobalAveragePoolLayer gap(conv_b.output_length(), channels);
+        const Layer* layers[] = {&conv_a, &pool, &conv_b, &gap, &head_layer};
+        const Sequential windowed(layers, 5, nullptr, nullptr, 0);
+
+        const StreamingConv1DLayer stream_a(ca);
+        const StreamingMaxPool1DLayer stream_pool(channels, 2);
+        const StreamingConv1DLayer stream_b(cb);
+        const StreamingAverageLayer mean(16, channels);
+        const StreamingPointwiseLayer head(head_layer);
+        const StreamingLayer* stream_layers[] = {&stream_a, &stream_pool, &stream_b, &mean,
+                                                 &head};
+        StreamingSequential stream(stream_layers, 5);
+        const size_t windowed_macs = ConvOps::macs(ca) + ConvOps::macs(cb) + 16;
+        const size_t streaming_macs = 3 * channels + (3 * channels * channels + 16) / 2;
+        stream_vs_windowed(checks, "conv k3 + MaxPool(2) + conv k3 d2 + mean of 16 + Dense(8->2)",
+                           stream, windowed, 2, centred, windowed_macs, streaming_macs);
+    }
+
+    // The M0+ budget for the long-context model at one sample per 100 ms
+    const M0Costs costs;
+    std::printf("  M0+ model, 6 dilated convs: windowed %.1f ms per sample, streaming %.2f ms\n",
+                m0_mac_cycles(conv_macs + 16, costs) / 125e3,
+                m0_mac_cycles(step_macs + 16, costs) / 125e3);
+    return checks.passed();
+}
+
+// ============================================================================
+// Recurrent layers
+// ============================================================================
+
+// Keras GRU (reset_after) in double, straight from the equations
+void gru_reference(const GRU& gru, const float* x, std::vector<double>& h) {
+    const size_t u = gru.units;
+    const size_t width = 3 * u;
+    std::vector<double> gx(width);
+    std::vector<double> gh(width);
+    for (size_t k = 0; k < width; ++k) {
+        gx[k] = gru.bias[k];
+        gh[k] = gru.bias[width + k];
+        for (size_t i = 0; i < gru.input_size; ++i) {
+            gx[k] += static_cast<double>(x[i]) * gru.kernel[i * width + k];
+        }
+        for (size_t i = 0; i < u; ++i) {
+            gh[k] += h[i] * gru.recurrent[i * width + k];
+        }
+    }
+    for (size_t j = 0; j < u; ++j) {
+        const double z = 1.0 / (1.0 + std::exp(-(gx[j] + gh[j])));
+        const double r = 1.0 / (1.0 + std::exp(-(gx[u + j] + gh[u + j])));
+        const double candidate = std::tanh(gx[2 * u + j] + r * gh[2 * u + j]);
+        h[j] = z * h[j] + (1.0 - z) * candidate;
+    }
+}
+
+// Modelled M0+ cycles of one GRU step: the fused matvecs plus, per unit,
+// two sigmoids and a tanh and the blend
+double m0_gru_cycles(const GRU& gru, bool fixed, const M0Costs& c) {
+    const double macs = static_cast<double>(RecurrentOps::macs(gru));
+    const double units = static_cast<double>(gru.units);
+    if (fixed) {
+        // exp2_q15: 3 rounded multiplies and shifts; one divide per gate
+        const double gate = 3 * (c.mul + 2 * c.alu) + 8 * c.alu + c.div + 4 * c.alu;
+        return macs * (2 * c.load + c.mul + c.alu + c.loop) + units * (3 * gate + 2 * c.mul +
+                                                                      6 * c.alu + c.loop);
+    }
+    const double gate = c.expf + c.fadd + c.fdiv;
+    return macs * (2 * c.load + c.fmul + c.fadd + c.loop) +
+           units * (3 * gate + 4 * c.fadd + 3 * c.fmul + c.loop);
+}
+
+// Float cells against double (measured: 2.1e-7); the Q15 cell against the
+// float one (measured: 3.8e-4 on the state, 2.6e-4 on the probabilities)
+constexpr float kRecurrentTolerance = 1e-5f;
+constexpr float kQ15Tolerance = 2e-3f;
+
+bool bench_gru() {
+    Checks checks;
+    std::printf("== Stateful GRU / SimpleRNN cells: one reading per step ==\n");
+    const std::vector<std::vector<float>> logs = read_logs();
+    if (logs.empty()) {
+        return checks.check(false, "temperature logs not found (run from the repository "
+                                   "root)");
+    }
+    // Readings relative to the first one of each log, in units of 2 C
+    std::vector<std::vector<float>> inputs = logs;
+    for (std::vector<float>& temps : inputs) {
+        const float first = temps.front();
+        for (float& t : temps) {
+            t = (t - first) * 0.5f;
+        }
+    }
+
+    std::mt19937 rng(107);
+    const size_t units = 16;
+    const float kernel_limit = std::sqrt(6.0f / static_cast<float>(1 + 3 * units));
+    const float recurrent_limit = std::sqrt(6.0f / static_cast<float>(units + 3 * units));
+    const std::vector<float> kernel = random_vector(3 * units, rng, -kernel_limit, kernel_limit);
+    const std::vector<float> recurrent = random_vector(units * 3 * units, rng, -recurrent_limit,
+                                                       recurrent_limit);
+    const std::vector<float> bias = random_vector(2 * 3 * units, rng, -0.1f, 0.1f);
+    const GRU gru = {kernel.data(), recurrent.data(), bias.data(), 1, units};
+    const std::vector<float> w_head = random_vector(units * 2, rng, -1.0f, 1.0f);
+    const std::vector<float> b_head = random_vector(2, rng, -0.1f, 0.1f);
+
+    const StreamingGRULayer cell(gru);
+    const DenseLayer dense(w_head.data(), b_head.data(), units, 2, ActivationType::Softmax);
+    const StreamingPointwiseLayer head(dense);
+    const StreamingLayer* cell_only[] = {&cell};
+    const StreamingLayer* layers[] = {&cell, &head};
+    StreamingSequential states(cell_only, 1);
+    StreamingSequential model(layers, 2);
+    std::printf("  GRU(1 -> %zu) + Dense(%zu -> 2): %zu weights, %zu MACs per step, "
+                "%zu B state per stream\n", units, units, kernel.size() + recurrent.size() +
+                bias.size() + w_head.size() + b_head.size(), RecurrentOps::macs(gru) + 2 * units,
+                model.state_bytes());
+
+    // Float cell against the double reference, state carried across each log
+    float worst = 0.0f;
+    size_t steps = 0;
+    std::vector<float> h(units);
+    for (const std::vector<float>& temps : inputs) {
+        states.reset();
+        std::vector<double> reference(units, 0.0);
+        for (float x : temps) {
+            states.push(&x, h.data());
+            gru_reference(gru, &x, reference);
+            for (size_t j = 0; j < units; ++j) {
+                worst = std::max(worst, std::fabs(h[j] - static_cast<float>(reference[j])));
+            }
+            ++steps;
+        }
+    }
+    std::printf("  float vs double reference over %zu steps (state carried per log): "
+                "max |dh| %.3g\n", steps, static_cast<double>(worst));
+    checks.check(worst <= kRecurrentTolerance, "GRU differs from the double reference");
+
+    // reset() gives a fresh stream: run one log, reset, run another, and
+    // compare with a new model on the second log alone
+    {
+        StreamingSequential fresh(layers, 2);
+        for (float x : inputs[0]) {
+            float probs[2];
+            model.push(&x, probs);
+        }
+        model.reset();
+        bool same = true;
+        for (float x : inputs.back()) {
+            float a[2];
+            float b[2];
+            model.push(&x, a);
+            fresh.push(&x, b);
+            same = same && std::memcmp(a, b, sizeof(a)) == 0;
+        }
+        std::printf("  after reset(): %s a fresh stream\n", same ? "bit-identical to"
+                                                                  : "DIFFERS from");
+        checks.check(same, "reset() does not give a fresh stream");
+    }
+
+    // Q15: the same cell with integer gates, and a fixed-point head
+    const QFormat input_format = FixedOps::format_for(16.0f);
+    const FixedGRULayer fixed_cell(gru, input_format);
+    const QFormat state_format = {FixedGRULayer::kStateFracBits, 1.0f};
+    const FixedDenseLayer fixed_head(w_head.data(), b_head.data(), units, 2,
+                                     ActivationType::Softmax, state_format,
+                                     FixedOps::output_bound(w_head.data(), b_head.data(), units,
+                                                            2, state_format));
+    std::printf("  Q15 cell: input Q%d, gates Q%d, state Q15\n", input_format.frac_bits,
+                fixed_cell.gate_frac());
+    std::vector<int16_t> hq(units);
+    std::vector<int16_t> work(6 * units);
+    float worst_h = 0.0f;
+    float worst_p = 0.0f;
+    size_t agree = 0;
+    for (const std::vector<float>& temps : inputs) {
+        states.reset();
+        model.reset();
+        fixed_cell.reset(hq.data());
+        for (float x : temps) {
+            float probs[2];
+            states.push(&x, h.data());
+            model.push(&x, probs);
+            const int16_t xq = FixedOps::to_fixed(x, input_format.frac_bits);
+            fixed_cell.step(&xq, hq.data(), work.data());
+            int16_t logits[2];
+            int16_t probs_q[2];
+            FixedOps::dense_forward(fixed_head.params(), hq.data(), logits);
+            FixedOps::softmax(logits, fixed_head.params().output_frac, probs_q, 2);
+            for (size_t j = 0; j < units; ++j) {
+                worst_h = std::max(worst_h, std::fabs(h[j] - FixedOps::to_float(hq[j], 15)));
+            }
+            const float p1 = FixedOps::to_float(probs_q[1], FixedOps::kProbFracBits);
+            worst_p = std::max(worst_p, std::fabs(probs[1] - p1));
+            agree += ((probs[1] > 0.5f) == (p1 > 0.5f)) ? size_t{1} : size_t{0};
+        }
+    }
+    std::printf("  Q15 vs float over %zu steps: max |dh| %.3g, max |dprob| %.3g, "
+                "decisions agree %zu/%zu\n", steps, static_cast<double>(worst_h),
+                static_cast<double>(worst_p), agree, steps);
+    checks.check(worst_h <= kQ15Tolerance && worst_p <= kQ15Tolerance && agree == steps,
+                 "Q15 GRU differs from the float cell");
+
+    // A long stream: the state stays bounded and tracks the float cell
+    {
+        const size_t n = 100000;
+        std::vector<float> walk(n);
+        float level = 0.0f;
+        std::normal_distribution<float> step(0.0f, 0.05f);
+        for (float& x : walk) {
+            level = std::min(std::max(level + step(rng), -8.0f), 8.0f);
+            x = level;
+        }
+        states.reset();
+        fixed_cell.reset(hq.data());
+        float drift = 0.0f;
+        const double t_float = time_seconds([&] {
+            for (float x : walk) {
+                states.push(&x, h.data());
+            }
+        });
+        const double t_fixed = time_seconds([&] {
+            for (float x : walk) {
+                const int16_t xq = FixedOps::to_fixed(x, input_format.frac_bits);
+                fixed_cell.step(&xq, hq.data(), work.data());
+            }
+        });
+        for (size_t j = 0; j < units; ++j) {
+            drift = std::max(drift, std::fabs(h[j] - FixedOps::to_float(hq[j], 15)));
+        }
+        std::printf("  %zu-step random walk: final |dh| Q15 vs float %.3g; ns/step float %.1f, "
+                    "Q15 %.1f\n", n, static_cast<double>(drift),
+                    t_float * 1e9 / static_cast<double>(n), t_fixed * 1e9 / static_cast<double>(n));
+        checks.check(drift <= kQ15Tolerance, "Q15 GRU drifts from the float cell: %.3g",
+                     static_cast<double>(drift));
+    }
+
+    // SimpleRNN against the same kind of reference
+    {
+        const std::vector<float> rk = random_vector(units, rng, -0.5f, 0.5f);
+        const std::vector<float> rr = random_vector(units * units, rng, -0.25f, 0.25f);
+        const std::vector<float> rb = random_vector(units, rng, -0.1f, 0.1f);
+        const SimpleRNN rnn = {rk.data(), rr.data(), rb.data(), 1, units};
+        const StreamingRNNLayer rnn_cell(rnn);
+        const StreamingLayer* rnn_layers[] = {&rnn_cell};
+        StreamingSequential rnn_model(rnn_layers, 1);
+        float rnn_worst = 0.0f;
+        for (const std::vector<float>& temps : inputs) {
+            rnn_model.reset();
+            std::vector<double> reference(units, 0.0);
+            std::vector<double> next(units);
+            for (float x : temps) {
+                rnn_model.push(&x, h.data());
+                for (size_t j = 0; j < units; ++j) {
+                    double pre = static_cast<double>(rb[j]) + static_cast<double>(x) * rk[j];
+                    for (size_t i = 0; i < units; ++i) {
+                        pre += reference[i] * rr[i * units + j];
+                    }
+                    next[j] = std::tanh(pre);
+                }
+                reference = next;
+                for (size_t j = 0; j < units; ++j) {
+                    rnn_worst = std::max(rnn_worst,
+                                         std::fabs(h[j] - static_cast<float>(reference[j])));
+                }
+            }
+        }
+        std::printf("  SimpleRNN(1 -> %zu): %zu MACs per step, max |dh| vs double %.3g\n", units,
+                    RecurrentOps::macs(rnn), static_cast<double>(rnn_worst));
+        checks.check(rnn_worst <= kRecurrentTolerance,
+                     "SimpleRNN differs from the double reference");
+    }
+
+    // Per reading on the M0+, against Dense windows that look as far back
+    const M0Costs costs;
+    std::printf("  M0+ model per reading: GRU float %.0f cycles, Q15 %.0f cycles, for any "
+                "history length\n", m0_gru_cycles(gru, false, costs),
+                m0_gru_cycles(gru, true, costs));
+    for (size_t window : {size_t{10}, size_t{100}, size_t{1000}}) {
+        std::printf("    Dense(%4zu -> 8) window: %9.0f cycles, %6zu B of readings\n", window,
+                    m0_mac_cycles(window * 8, costs), window * sizeof(float));
+    }
+    return checks.passed();
+}
+
+// ============================================================================
+// Inference cache
+// ============================================================================
+
+bool bench_cache() {
+    Checks checks;
+    std::printf("== Inference cache keyed on quantized windows: replay of the logs ==\n");
+    std::vector<std::pair<const char*, std::vector<float>>> logs;
+    for (const char* path : {"normal.csv", "touched.csv", "touched2.csv", "touched3.csv",
+                             "temperature_data_20251122_135801.csv",
+                             "Miko/data/room_tmp1.csv"}) {
+        std::vector<float> temps = read_temperatures(path);
+        if (temps.size() > TEMP_LAYER1_INPUT_SIZE) {
+            logs.emplace_back(path, std::move(temps));
+        }
+    }
+    if (logs.empty()) {
+        return checks.check(false, "temperature logs not found (run from the repository "
+                                   "root)");
+    }
+
+    // Distinct ADC codes must never share a key, or a hit could return the
+    // output of a different window: every code once must miss every time
+    const float adc_step = temperature_from_adc(0) - temperature_from_adc(1);
+    {
+        InferenceCache codes(1, 1, 4096, adc_step);
+        const float zero = 0.0f;
+        for (uint16_t raw = 0; raw < 4096; ++raw) {
+            const float t = temperature_from_adc(raw);
+            if (codes.find(&t) == nullptr) {
+                codes.insert(&zero);
+            }
+        }
+        std::printf("  ADC step %.4f C; all 4096 codes: %zu hits (%s)\n",
+                    static_cast<double>(adc_step), codes.hits(),
+                    (codes.hits() == 0) ? "one key per code" : "KEYS COLLIDE");
+        checks.check(codes.hits() == 0, "distinct ADC codes share a key");
+    }
+
+    NeuralNetwork model(&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, TEMP_LAYER1_INPUT_SIZE,
+                        TEMP_LAYER1_OUTPUT_SIZE, &TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS,
+                        TEMP_LAYER2_INPUT_SIZE, TEMP_LAYER2_OUTPUT_SIZE);
+    const size_t width = TEMP_LAYER1_INPUT_SIZE;
+    const size_t out = TEMP_LAYER2_OUTPUT_SIZE;
+
+    // Per log, a fresh 64-slot cache: hit rate, and outputs against the
+    // model run on every window
+    std::printf("  %-38s %7s %8s %8s %10s\n", "log (64 slots)", "windows", "misses", "hit rate",
+                "max |diff|");
+    std::vector<float> expected(out);
+    std::vector<float> got(out);
+    size_t all_windows = 0;
+    for (const auto& [path, temps] : logs) {
+        InferenceCache cache(width, out, 64, adc_step);
+        float worst = 0.0f;
+        const size_t windows = temps.size() - width + 1;
+        for (size_t w = 0; w < windows; ++w) {
+            model.predict(temps.data() + w, expected.data());
+            cache.predict(model, temps.data() + w, got.data());
+            worst = std::max(worst, max_abs_diff(expected.data(), got.data(), out));
+        }
+        std::printf("  %-38s %7zu %8zu %7.1f%% %10.3g\n", path, windows,
+                    cache.misses(), 100.0 * static_cast<double>(cache.hit_rate()),
+                    static_cast<double>(worst));
+        checks.check(worst == 0.0f, "%s: a hit differs from the model", path);
+        all_windows += windows;
+    }
+
+    // All logs back to back through one cache, by capacity, and the host
+    // time of the replay with and without it
+    std::printf("  all logs in one stream (%zu windows):\n", all_windows);
+    std::printf("  %8s %8s %10s %10s %12s\n", "slots", "hit rate", "evictions", "ns/window",
+                "vs uncached");
+    const double t_direct = time_seconds([&] {
+        for (const auto& entry : logs) {
+            const std::vector<float>& temps = entry.second;
+            for (size_t w = 0; w + width <= temps.size(); ++w) {
+                model.predict(temps.data() + w, got.data());
+                g_sink = g_sink + got[1];
+            }
+        }
+    });
+    const double n = static_cast<double>(all_windows);
+    std::printf("  %8s %8s %10s %10.1f %12s\n", "none", "-", "-", t_direct * 1e9 / n, "1.00x");
+    float firmware_rate = 0.0f;   // At the 64 slots Miko.cpp uses
+    for (size_t slots : {size_t{16}, size_t{64}, size_t{256}, size_t{1024}}) {
+        InferenceCache cache(width, out, slots, adc_step);
+        const double t_cached = time_seconds([&] {
+            for (const auto& entry : logs) {
+                const std::vector<float>& temps = entry.second;
+                for (size_t w = 0; w + width <= temps.size(); ++w) {
+                    cache.predict(model, temps.data() + w, got.data());
+                    g_sink = g_sink + got[1];
+                }
+            }
+        });
+        std::printf("  %8zu %7.1f%% %10zu %10.1f %11.2fx\n", cache.capacity(),
+                    100.0 * static_cast<double>(cache.hit_rate()), cache.evictions(),
+                    t_cached * 1e9 / n, t_direct / t_cached);
+        firmware_rate = (slots == 64) ? cache.hit_rate() : firmware_rate;
+    }
+
+    // The firmware path on the M0+: the static model's margin (Dense 10 -> 8,
+    // ReLU, one dot product) against a lookup (quantize, hash, compare keys)
+    const M0Costs c;
+    const double model_cycles = m0_mac_cycles(width * TEMP_LAYER1_OUTPUT_SIZE +
+                                              TEMP_LAYER1_OUTPUT_SIZE, c) +
+                                static_cast<double>(TEMP_LAYER1_OUTPUT_SIZE) * c.fcmp;
+    const double lookup_cycles = static_cast<double>(width) *
+                                 (c.load + c.fmul + 2 * c.fcmp + c.fadd + c.f2i + c.alu +
+                                  c.mul + 2 * c.load + c.alu + 2 * c.loop);
+    const double insert_cycles = static_cast<double>(width + 1) * (2 * c.load + c.loop);
+    const double rate = static_cast<double>(firmware_rate);
+    const double cached_cycles = lookup_cycles + (1.0 - rate) * (model_cycles + insert_cycles);
+    std::printf("  M0+ model per window: margin %.0f cycles, lookup %.0f, miss adds %.0f; "
+                "at %.1f%% hits %.0f cycles (%.2fx)\n\n", model_cycles, lookup_cycles,
+                model_cycles + insert_cycles, 100.0 * rate, cached_cycles,
+                model_cycles / cached_cycles);
+    return checks.passed();
+}
+
+// ============================================================================
+// ADC-code input layer
+// ============================================================================
+
+// The ADC code whose datasheet temperature is nearest t
+uint16_t adc_code_for(float t) {
+    uint16_t best = 0;
+    for (uint16_t raw = 1; raw < 4096; ++raw) {
+        if (std::fabs(temperature_from_adc(raw) - t) < std::fabs(temperature_from_adc(best) - t)) {
+            best = raw;
+        }
+    }
+    return best;
+}
+
+// The temperature model's logit margin from its hidden layer, as the
+// static margin head computes it
+float temp_margin(const float* hidden) {
+    float margin = TEMP_LAYER2_BIAS[1] - TEMP_LAYER2_BIAS[0];
+    for (size_t k = 0; k < TEMP_LAYER2_INPUT_SIZE; ++k) {
+        margin += hidden[k] * (TEMP_LAYER2_WEIGHTS[k][1] - TEMP_LAYER2_WEIGHTS[k][0]);
+    }
+    return margin;
+}
+
+// Table rounding plus the float layer's own (measured: 7.6e-6 on the hidden
+// units, 1.5e-5 on the margin)
+constexpr float kLutTolerance = 1e-4f;
+
+bool bench_adc_lut() {
+    Checks checks;
+    std::printf("== ADC-code input layer: per-position lookup tables vs float conversion ==\n");
+    const size_t width = TEMP_LAYER1_INPUT_SIZE;
+    const size_t hidden_size = TEMP_LAYER1_OUTPUT_SIZE;
+    const uint16_t code_min = 806;   // As Miko.cpp: about 60 C down to 0 C
+    const uint16_t code_max = 934;
+    const CodeLutDenseLayer lut(&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, width, hidden_size,
+                                ActivationType::ReLU, code_min, code_max, temperature_from_adc);
+    std::printf("  codes %u-%u (%.1f C to %.1f C): %zu bytes of tables, Q%d entries, "
+                "rounding bound %.3g\n", code_min, code_max,
+                static_cast<double>(temperature_from_adc(code_min)),
+                static_cast<double>(temperature_from_adc(code_max)), lut.table_bytes(),
+                lut.frac_bits(), static_cast<double>(lut.max_error()));
+
+    // The float path as the firmware runs it: convert each code, Dense + ReLU
+    const auto float_hidden = [&](const uint16_t* codes, float* hidden) {
+        float temps[TEMP_LAYER1_INPUT_SIZE];
+        for (size_t i = 0; i < width; ++i) {
+            temps[i] = temperature_from_adc(codes[i]);
+        }
+        MatrixOps::dense_forward(temps, &TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, hidden,
+                                 width, hidden_size, ActivationType::ReLU);
+    };
+
+    // Every code in range at every position, plus random windows
+    std::mt19937 rng(251);
+    std::uniform_int_distribution<int> pick(code_min, code_max);
+    std::vector<uint16_t> codes(width);
+    float expected[TEMP_LAYER1_OUTPUT_SIZE];
+    float got[TEMP_LAYER1_OUTPUT_SIZE];
+    float worst_hidden = 0.0f;
+    float worst_margin = 0.0f;
+    size_t windows = 0;
+    for (int trial = 0; trial < 20000; ++trial) {
+        for (size_t i = 0; i < width; ++i) {
+            codes[i] = (trial < code_max - code_min + 1)
+                           ? static_cast<uint16_t>(code_min + trial)
+                           : static_cast<uint16_t>(pick(rng));
+        }
+        float_hidden(codes.data(), expected);
+        lut.forward(codes.data(), got);
+        worst_hidden = std::max(worst_hidden, max_abs_diff(expected, got, hidden_size));
+        worst_margin = std::max(worst_margin, std::fabs(temp_margin(expected) - temp_margin(got)));
+        ++windows;
+    }
+    std::printf("  %zu windows over the table range: max |dhidden| %.3g, max |dmargin| %.3g\n",
+                windows, static_cast<double>(worst_hidden), static_cast<double>(worst_margin));
+    checks.check(worst_hidden <= kLutTolerance && worst_margin <= kLutTolerance,
+                 "tables differ from the float layer");
+
+    // Codes beyond the range clamp to its ends
+    {
+        std::vector<uint16_t> low(width, 0);
+        std::vector<uint16_t> edge(width, code_min);
+        lut.forward(low.data(), expected);
+        lut.forward(edge.data(), got);
+        const bool low_ok = (std::memcmp(expected, got, sizeof(got)) == 0);
+        std::vector<uint16_t> high(width, 4095);
+        std::fill(edge.begin(), edge.end(), code_max);
+        lut.forward(high.data(), expected);
+        lut.forward(edge.data(), got);
+        const bool high_ok = (std::memcmp(expected, got, sizeof(got)) == 0);
+        std::printf("  codes 0 and 4095 give the range ends: %s\n",
+                    (low_ok && high_ok) ? "yes" : "NO");
+        checks.check(low_ok && high_ok, "out-of-range codes do not clamp");
+    }
+
+    // Replay of the logs (readings mapped back to their ADC codes)
+    const std::vector<std::vector<float>> logs = read_logs();
+    std::vector<std::vector<uint16_t>> code_logs;
+    float worst_roundtrip = 0.0f;
+    for (const std::vector<float>& temps : logs) {
+        std::vector<uint16_t> log_codes(temps.size());
+        for (size_t k = 0; k < temps.size(); ++k) {
+            log_codes[k] = adc_code_for(temps[k]);
+            worst_roundtrip = std::max(worst_roundtrip,
+                                       std::fabs(temperature_from_adc(log_codes[k]) - temps[k]));
+        }
+        code_logs.push_back(std::move(log_codes));
+    }
+    const float threshold = BinaryClassifier::margin_for(0.7f);
+    size_t agree = 0;
+    size_t log_windows = 0;
+    worst_margin = 0.0f;
+    for (const std::vector<uint16_t>& log_codes : code_logs) {
+        for (size_t w = 0; w + width <= log_codes.size(); ++w) {
+            float_hidden(log_codes.data() + w, expected);
+            lut.forward(log_codes.data() + w, got);
+            const float a = temp_margin(expected);
+            const float b = temp_margin(got);
+            worst_margin = std::max(worst_margin, std::fabs(a - b));
+            agree += ((a > threshold) == (b > threshold)) ? size_t{1} : size_t{0};
+            ++log_windows;
+        }
+    }
+    if (log_windows > 0) {
+        std::printf("  logs as ADC codes (each within %.3f C of the CSV): %zu windows, "
+                    "max |dmargin| %.3g, decisions agree %zu/%zu\n",
+                    static_cast<double>(worst_roundtrip), log_windows,
+                    static_cast<double>(worst_margin), agree, log_windows);
+        checks.check(worst_roundtrip <= 0.01f && agree == log_windows,
+                     "table decisions differ on the logs");
+    }
+
+    // Host time of layer 1 per window, conversion included on the float side
+    const size_t reps = 200000;
+    std::vector<uint16_t> bench(width + reps);
+    for (uint16_t& c : bench) {
+        c = static_cast<uint16_t>(pick(rng));
+    }
+    const double t_float = time_seconds([&] {
+        for (size_t r = 0; r < reps; ++r) {
+            float_hidden(bench.data() + r, expected);
+            g_sink = g_sink + expected[0];
+        }
+    });
+    const double t_lut = time_seconds([&] {
+        for (size_t r = 0; r < reps; ++r) {
+            lut.forward(bench.data() + r, got);
+            g_sink = g_sink + got[0];
+        }
+    });
+    std::printf("  host, layer 1 per window: float %.1f ns, tables %.1f ns (%.2fx)\n",
+                t_float * 1e9 / static_cast<double>(reps), t_lut * 1e9 / static_cast<double>(reps),
+                t_float / t_lut);
+
+    // Per reading on the M0+ (layer 2 is the same on both paths): the float
+    // path converts the new reading and runs Dense 10 -> 8 + ReLU; the table
+    // path clamps and indexes 10 codes, adds 10 rows, converts 8 outputs
+    const M0Costs c;
+    const double h = static_cast<double>(hidden_size);
+    const double n = static_cast<double>(width);
+    const double float_cycles = c.i2f + c.fmul + 2 * c.fadd + c.fdiv +
+                                m0_mac_cycles(width * hidden_size, c) + h * c.fcmp;
+    const double lut_cycles = n * (c.load + 4 * c.alu + c.mul + c.loop) +
+                              n * h * (c.load + c.alu) + h * (c.alu + c.i2f + c.fmul);
+    std::printf("  M0+ per reading: float %.0f cycles (%zu soft-float ops), tables %.0f cycles "
+                "(%zu soft-float ops), %.1fx\n\n", float_cycles, 5 + 2 * width * hidden_size +
+                hidden_size, lut_cycles, 2 * hidden_size, float_cycles / lut_cycles);
+    return checks.passed();
+}
+
+// ============================================================================
+// Section registry
+// ============================================================================
+
+struct Section {
+    const char* name;
+    const char* description;
+    bool (*run)();   // false if a check failed
+};
+
+constexpr Section kSections[] = {
+    {"batch", "Batched predict vs per-sample loop, batch sizes 1-4096", bench_batch},
+    {"simd", "Scalar/SSE2/AVX2/AVX-512 dense kernels and dispatch", bench_simd},
+    {"fused", "Fused dense + bias + ReLU vs separate passes", bench_fused},
+    {"int8", "Int8 quantized path vs float: speed and agreement", bench_int8},
+    {"fixed", "Q15 fixed-point path vs float: deviation, digest, M0+ cycles", bench_fixed},
+    {"exp", "Fast exp approximations: error, throughput, effect on the logs", bench_exp},
+    {"class", "predict_class / predict_topk on logits vs softmax + argmax", bench_class},
+    {"margin", "Binary logit-margin decision vs softmax threshold", bench_margin},
+    {"sparse", "CSR pruned layers vs dense: per-shape crossover and footprint", bench_sparse},
+    {"binary", "Binary/ternary XOR-popcount layers vs float matvec", bench_binary},
+    {"parallel", "Multi-threaded predict on a work-stealing pool: scaling", bench_parallel},
+    {"reentrant", "Const predict shared across threads with caller scratch", bench_reentrant},
+    {"half", "fp16/bf16 weight storage: conversions, speed, accuracy on the logs", bench_half},
+    {"codebook", "4-bit k-means codebook layers: bucket sums, footprint, accuracy", bench_codebook},
+    {"model_file", "Binary model files: round trip, load time vs size, damage", bench_model_file},
+    {"tflite", "Native TFLite flatbuffer importer vs weight headers and TFLM", bench_tflite},
+    {"optimize", "Graph optimizer: folded normalization, merged and pruned layers", bench_optimize},
+    {"conv", "Conv1D / pooling layers: correctness and window-length scaling", bench_conv},
+    {"stream", "Streaming causal inference with ring buffers vs windowed rerun", bench_stream},
+    {"gru", "Stateful GRU / SimpleRNN cells: float, Q15, reset, per-step cost", bench_gru},
+    {"cache", "Inference cache on quantized windows: hit rate and time saved", bench_cache},
+    {"adc", "ADC-code first layer from lookup tables vs float conversion", bench_adc_lut},
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1 && (std::strcmp(argv[1], "-h") == 0 || std::strcmp(argv[1], "--help") == 0)) {
+        std::printf("Usage: %s [section...]\nSections:\n", argv[0]);
+        for (const Section& section : kSections) {
+            std::printf("  %-12s %s\n", section.name, section.description);
+        }
+        return 0;
+    }
+
+    int status = 0;
+    size_t failed = 0;
+    for (const Section& section : kSections) {
+        bool selected = (argc == 1);
+        for (int i = 1; i < argc; ++i) {
+            selected = selected || std::strcmp(argv[i], section.name) == 0;
+        }
+        if (selected && !section.run()) {
+            std::printf("-- %s: FAILED\n", section.name);
+            ++failed;
+            status = 1;
+        }
+        if (selected) {
+            std::printf("\n");
+        }
+    }
+    for (int i = 1; i < argc; ++i) {
+        const bool known = std::any_of(std::begin(kSections), std::end(kSections),
+                                       [&](const Section& s) { return std::strcmp(argv[i], s.name) == 0; });
+        if (!known) {
+            std::fprintf(stderr, "Unknown section: %s\n", argv[i]);
+            status = 1;
+        }
+    }
+    if (failed > 0) {
+        std::printf("%zu section(s) FAILED\n", failed);
+    }
+    return status;
+}
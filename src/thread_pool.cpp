@@ -0,0 +1,124 @@
+// src/thread_pool.cpp
+// Work-stealing thread pool implementation.
+
+#include "thread_pool.h"
+#include <algorithm>
+
+namespace CustomNN {
+
+ThreadPool::ThreadPool(size_t num_workers) {
+    if (num_workers == 0) {
+        num_workers = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    for (size_t w = 0; w < num_workers; ++w) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    // Worker 0 is whichever thread calls parallel_for()
+    for (size_t w = 1; w < num_workers; ++w) {
+        threads_.emplace_back(&ThreadPool::worker_loop, this, w);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (std::thread& thread : threads_) {
+        thread.join();
+    }
+}
+
+void ThreadPool::parallel_for(size_t num_tasks, const Task& task) {
+    if (num_tasks == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> job_lock(job_mutex_);
+
+    // One contiguous run of task indices per worker
+    const size_t workers = size();
+    for (size_t w = 0; w < workers; ++w) {
+        std::lock_guard<std::mutex> lock(queues_[w]->mutex);
+        const size_t begin = num_tasks * w / workers;
+        const size_t end = num_tasks * (w + 1) / workers;
+        for (size_t t = begin; t < end; ++t) {
+            queues_[w]->tasks.push_back(t);
+        }
+    }
+    steals_.store(0, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        task_ = &task;
+        running_ = threads_.size();
+        ++generation_;
+    }
+    start_cv_.notify_all();
+
+    run_tasks(0);
+
+    // Helpers leave a job only once every deque is empty and their own
+    // task has finished, so this also waits for all tasks
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    done_cv_.wait(lock, [this] { return running_ == 0; });
+    task_ = nullptr;
+}
+
+void ThreadPool::worker_loop(size_t worker) {
+    size_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(state_mutex_);
+            start_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+        }
+
+        run_tasks(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            --running_;
+        }
+        done_cv_.notify_one();
+    }
+}
+
+void ThreadPool::run_tasks(size_t worker) {
+    size_t task = 0;
+    while (take(worker, task)) {
+        (*task_)(task, worker);
+    }
+}
+
+bool ThreadPool::take(size_t worker, size_t& task) {
+    {
+        Queue& own = *queues_[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+
+    // Steal from the back: the victim works from the front, so the two
+    // meet only on its last task
+    const size_t workers = size();
+    for (size_t offset = 1; offset < workers; ++offset) {
+        Queue& victim = *queues_[(worker + offset) % workers];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace CustomNN
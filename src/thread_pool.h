@@ -0,0 +1,92 @@
+// src/thread_pool.h
+// Work-stealing thread pool for host-side batch jobs (not built for the
+// firmware: the RP2040 build has no std::thread).
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CustomNN {
+
+/**
+ * Fixed set of workers running parallel_for() jobs
+ *
+ * Each job's task indices are split into one contiguous run per worker.
+ * A worker takes tasks from the front of its own deque (in index order,
+ * for locality) and, once that is empty, steals from the back of another
+ * worker's, so uneven tasks still keep every core busy. The calling thread
+ * is worker 0, so a pool of size 1 runs everything inline.
+ *
+ * Jobs run one at a time: concurrent parallel_for() calls are serialized.
+ * Tasks must not throw.
+ */
+class ThreadPool {
+public:
+    /**
+     * Task body: task index in [0, num_tasks) and the worker running it, in
+     * [0, size()) (use it to pick per-worker scratch)
+     */
+    using Task = std::function<void(size_t task, size_t worker)>;
+
+    /**
+     * Constructor
+     * @param num_workers Worker count including the caller; 0 means one per
+     *                    hardware thread
+     */
+    explicit ThreadPool(size_t num_workers = 0);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return queues_.size(); }
+
+    /**
+     * Run task(t, worker) for every t in [0, num_tasks) and wait for all of
+     * them
+     */
+    void parallel_for(size_t num_tasks, const Task& task);
+
+    /**
+     * Tasks taken from another worker's deque during the last job
+     */
+    size_t last_steals() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    void worker_loop(size_t worker);
+    void run_tasks(size_t worker);
+    bool take(size_t worker, size_t& task);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::mutex job_mutex_;      // Serializes parallel_for() callers
+    std::mutex state_mutex_;    // Guards the fields below
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    const Task* task_ = nullptr;
+    size_t generation_ = 0;     // Incremented per job
+    size_t running_ = 0;        // Helper threads still inside the current job
+    bool stop_ = false;
+
+    std::atomic<size_t> steals_{0};
+};
+
+} // namespace CustomNN
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,345 @@
+// tools/cluster_weights.cpp
+// Clusters the float weight headers in Miko/ into 16-entry codebooks and
+// writes 4-bit index headers for the codebook path (Miko/codebook.h).
+//
+// Usage: ./cluster_weights [temperature.csv...]
+// Run from the repository root (`make cluster` does this). Each layer's
+// weights are clustered with 1-D k-means and its bias absorbs the mean
+// contribution of the clustering error on the evaluation inputs (all the
+// logs for the temperature model). The temperature model is checked
+// against the float model on sliding windows over each log (default: every
+// stored log), the 2-18-3 demo model on a grid covering the training
+// blobs. Writes Miko/temp_model_weights_codebook.h and
+// Miko/model_weights_codebook.h.
+
+#include "codebook.h"
+#include "neural_network.h"
+#include "temp_model_weights.h"
+#include "model_weights.h"
+#include "temperature_logs.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace CustomNN;
+
+namespace {
+
+constexpr float kDetectionThreshold = 0.7f;   // DETECTION_THRESHOLD in Miko.cpp
+
+struct LayerSpec {
+    const char* prefix;      // e.g. "TEMP_LAYER1"
+    const float* weights;    // [input_size][output_size]
+    const float* bias;
+    size_t input_size;
+    size_t output_size;
+    ActivationType activation;
+};
+
+const char* activation_name(ActivationType activation) {
+    switch (activation) {
+        case ActivationType::ReLU:
+            return "ReLU";
+        case ActivationType::Softmax:
+            return "Softmax";
+        case ActivationType::None:
+            break;
+    }
+    return "None";
+}
+
+// 2-D grid over [-12, 12]^2: make_blobs(random_state=42) centres lie in
+// [-10, 10] with unit spread
+std::vector<float> blob_grid() {
+    std::vector<float> samples;
+    for (int y = -24; y <= 24; ++y) {
+        for (int x = -24; x <= 24; ++x) {
+            samples.push_back(0.5f * static_cast<float>(x));
+            samples.push_back(0.5f * static_cast<float>(y));
+        }
+    }
+    return samples;
+}
+
+/**
+ * Bias of the clustered layer corrected by the mean contribution of the
+ * clustering error, sum_i (w[i][j] - centroid[i][j]) * mean(input[i]),
+ * which matters for inputs far from zero such as temperatures
+ * @param inputs Layer inputs to average [count][spec.input_size]
+ */
+std::vector<float> corrected_bias(const LayerSpec& spec, const CodebookDense& clustered,
+                                  const std::vector<float>& inputs) {
+    const size_t count = inputs.size() / spec.input_size;
+    std::vector<double> mean(spec.input_size, 0.0);
+    for (size_t s = 0; s < count; ++s) {
+        for (size_t i = 0; i < spec.input_size; ++i) {
+            mean[i] += static_cast<double>(inputs[s * spec.input_size + i]);
+        }
+    }
+    std::vector<float> bias(spec.bias, spec.bias + spec.output_size);
+    for (size_t j = 0; j < spec.output_size; ++j) {
+        double error = 0.0;
+        for (size_t i = 0; i < spec.input_size; ++i) {
+            const float centroid = clustered.codebook[CodebookOps::index_at(clustered, j, i)];
+            error += static_cast<double>(spec.weights[i * spec.output_size + j] - centroid) *
+                     mean[i] / static_cast<double>(count);
+        }
+        bias[j] += static_cast<float>(error);
+    }
+    return bias;
+}
+
+/**
+ * Two-layer model in float and clustered
+ */
+class Variants {
+private:
+    DenseLayer d1_;
+    DenseLayer d2_;
+    std::vector<float> bias_[2];
+    std::unique_ptr<CodebookDenseLayer> c_[2];
+    std::vector<float> hidden_;
+
+public:
+    /**
+     * @param calibration Model inputs the bias correction averages over
+     */
+    Variants(const LayerSpec (&specs)[2], const std::vector<float>& calibration)
+      : d1_(specs[0].weights, specs[0].bias, specs[0].input_size, specs[0].output_size,
+            specs[0].activation),
+        d2_(specs[1].weights, specs[1].bias, specs[1].input_size, specs[1].output_size,
+            specs[1].activation),
+        hidden_(specs[0].output_size)
+    {
+        // Layer by layer, each corrected on the outputs of the clustered
+        // layers before it. Clustering does not depend on the bias, so the
+        // second conversion keeps the same codebook and indices.
+        std::vector<float> inputs = calibration;
+        for (size_t l = 0; l < 2; ++l) {
+            const LayerSpec& spec = specs[l];
+            const CodebookDenseLayer plain(spec.weights, spec.bias, spec.input_size,
+                                           spec.output_size, spec.activation);
+            bias_[l] = corrected_bias(spec, plain.params(), inputs);
+            c_[l] = std::make_unique<CodebookDenseLayer>(spec.weights, bias_[l].data(),
+                                                         spec.input_size, spec.output_size,
+                                                         spec.activation);
+
+            const size_t count = inputs.size() / spec.input_size;
+            std::vector<float> outputs(count * spec.output_size);
+            for (size_t s = 0; s < count; ++s) {
+                c_[l]->forward(inputs.data() + s * spec.input_size,
+                               outputs.data() + s * spec.output_size);
+            }
+            inputs.swap(outputs);
+        }
+    }
+
+    const CodebookDenseLayer& layer(size_t l) const { return *c_[l]; }
+
+    /**
+     * Compare the clustered model with float on samples and print a report line
+     */
+    void report(const char* label, const std::vector<float>& samples, bool threshold) {
+        const size_t input_size = d1_.input_size();
+        const size_t output_size = d2_.output_size();
+        const size_t count = samples.size() / input_size;
+
+        const Layer* float_layers[] = {&d1_, &d2_};
+        const Layer* codebook_layers[] = {c_[0].get(), c_[1].get()};
+        Sequential reference(float_layers, 2, hidden_.data(), nullptr, hidden_.size());
+        Sequential clustered(codebook_layers, 2, hidden_.data(), nullptr, hidden_.size());
+
+        std::vector<float> expected(output_size);
+        std::vector<float> actual(output_size);
+        float max_diff = 0.0f;
+        size_t agree = 0;
+        size_t decisions = 0;
+        for (size_t s = 0; s < count; ++s) {
+            reference.predict(samples.data() + s * input_size, expected.data());
+            clustered.predict(samples.data() + s * input_size, actual.data());
+            for (size_t k = 0; k < output_size; ++k) {
+                max_diff = std::max(max_diff, std::abs(expected[k] - actual[k]));
+            }
+            agree += (Classify::argmax(expected.data(), output_size) ==
+                      Classify::argmax(actual.data(), output_size)) ? size_t{1} : size_t{0};
+            if (threshold) {
+                decisions += ((expected[1] > kDetectionThreshold) ==
+                              (actual[1] > kDetectionThreshold)) ? size_t{1} : size_t{0};
+            }
+        }
+
+        std::printf("  %-38s %7zu %12.3g %9.2f%%", label, count, static_cast<double>(max_diff),
+                    100.0 * static_cast<double>(agree) / static_cast<double>(count));
+        if (threshold) {
+            std::printf(" %9.2f%%", 100.0 * static_cast<double>(decisions) /
+                                    static_cast<double>(count));
+        }
+        std::printf("\n");
+    }
+};
+
+void print_layers(const LayerSpec (&specs)[2], const Variants& variants) {
+    size_t float_bytes = 0;
+    size_t codebook_bytes = 0;
+    for (size_t l = 0; l < 2; ++l) {
+        const LayerSpec& spec = specs[l];
+        const CodebookDense& c = variants.layer(l).params();
+        float worst = 0.0f;
+        for (size_t i = 0; i < spec.input_size; ++i) {
+            for (size_t j = 0; j < spec.output_size; ++j) {
+                const float w = spec.weights[i * spec.output_size + j];
+                worst = std::max(worst, std::abs(w - c.codebook[CodebookOps::index_at(c, j, i)]));
+            }
+        }
+        float_bytes += (spec.input_size + 1) * spec.output_size * sizeof(float);
+        codebook_bytes += CodebookOps::storage_bytes(spec.input_size, spec.output_size);
+        std::printf("  %s: codebook [%.4g .. %.4g], max |w - centroid| %.3g\n", spec.prefix,
+                    static_cast<double>(c.codebook[0]),
+                    static_cast<double>(c.codebook[CodebookOps::kEntries - 1]),
+                    static_cast<double>(worst));
+    }
+    std::printf("  weights + bias: %zu B float -> %zu B codebook (%.2fx)\n", float_bytes,
+                codebook_bytes,
+                static_cast<double>(float_bytes) / static_cast<double>(codebook_bytes));
+}
+
+void write_layer(FILE* out, const LayerSpec& spec, const CodebookDense& c, size_t index) {
+    const size_t rb = CodebookOps::row_bytes(spec.input_size);
+    std::fprintf(out, "// Layer %zu: Dense(%zu, %s), 4-bit indices [%zu][%zu]\n", index + 1,
+                 spec.output_size, activation_name(spec.activation), spec.output_size,
+                 spec.input_size);
+
+    std::fprintf(out, "constexpr uint8_t %s_CB_INDICES[%zu] = {", spec.prefix,
+                 spec.output_size * rb);
+    for (size_t k = 0; k < spec.output_size * rb; ++k) {
+        std::fprintf(out, "%s%s0x%02X", (k == 0) ? "" : ",", (k % rb == 0) ? "\n    " : " ",
+                     static_cast<unsigned>(c.indices[k]));
+    }
+    std::fprintf(out, "\n};\n\n");
+
+    std::fprintf(out, "constexpr float %s_CB_CODEBOOK[%zu] = {", spec.prefix,
+                 CodebookOps::kEntries);
+    for (size_t k = 0; k < CodebookOps::kEntries; ++k) {
+        std::fprintf(out, "%s%s%.9ef", (k == 0) ? "" : ",", (k % 4 == 0) ? "\n    " : " ",
+                     static_cast<double>(c.codebook[k]));
+    }
+    std::fprintf(out, "\n};\n\n");
+
+    std::fprintf(out, "constexpr int32_t %s_CB_CODEBOOK_Q16[%zu] = {", spec.prefix,
+                 CodebookOps::kEntries);
+    for (size_t k = 0; k < CodebookOps::kEntries; ++k) {
+        std::fprintf(out, "%s%s%ld", (k == 0) ? "" : ",", (k % 8 == 0) ? "\n    " : " ",
+                     static_cast<long>(c.codebook_q16[k]));
+    }
+    std::fprintf(out, "\n};\n\n");
+
+    std::fprintf(out, "constexpr float %s_CB_BIAS[%zu] = {\n    ", spec.prefix, spec.output_size);
+    for (size_t j = 0; j < spec.output_size; ++j) {
+        std::fprintf(out, "%s%.9ef", (j == 0) ? "" : ", ", static_cast<double>(c.bias[j]));
+    }
+    std::fprintf(out, "\n};\n\n");
+
+    std::fprintf(out, "constexpr int32_t %s_CB_BIAS_Q16[%zu] = {\n    ", spec.prefix,
+                 spec.output_size);
+    for (size_t j = 0; j < spec.output_size; ++j) {
+        std::fprintf(out, "%s%ld", (j == 0) ? "" : ", ", static_cast<long>(c.bias_q16[j]));
+    }
+    std::fprintf(out, "\n};\n\n");
+
+    std::fprintf(out, "constexpr CustomNN::CodebookDense %s_CB = {\n", spec.prefix);
+    std::fprintf(out, "    %s_CB_INDICES, %s_CB_CODEBOOK, %s_CB_CODEBOOK_Q16,\n", spec.prefix,
+                 spec.prefix, spec.prefix);
+    std::fprintf(out, "    %s_CB_BIAS, %s_CB_BIAS_Q16,\n", spec.prefix, spec.prefix);
+    std::fprintf(out, "    %zu, %zu,\n", spec.input_size, spec.output_size);
+    std::fprintf(out, "    CustomNN::ActivationType::%s\n};\n\n", activation_name(spec.activation));
+}
+
+bool write_header(const char* header_path, const char* guard, const char* source,
+                  const LayerSpec (&specs)[2], const Variants& variants) {
+    FILE* out = std::fopen(header_path, "w");
+    if (out == nullptr) {
+        std::fprintf(stderr, "error: cannot write %s\n", header_path);
+        return false;
+    }
+    std::fprintf(out, "// Weight-clustered (codebook) weights for %s\n", source);
+    std::fprintf(out, "// Generated by tools/cluster_weights (make cluster)\n");
+    std::fprintf(out, "// DO NOT EDIT MANUALLY\n");
+    std::fprintf(out, "//\n");
+    std::fprintf(out, "// 16-entry k-means codebook per layer, 4-bit indices packed two per\n");
+    std::fprintf(out, "// byte (even input in the low nibble), output-major rows.\n\n");
+    std::fprintf(out, "#ifndef %s\n#define %s\n\n", guard, guard);
+    std::fprintf(out, "#include <cstdint>\n#include \"codebook.h\"\n\n");
+    write_layer(out, specs[0], variants.layer(0).params(), 0);
+    write_layer(out, specs[1], variants.layer(1).params(), 1);
+    std::fprintf(out, "#endif // %s\n", guard);
+    std::fclose(out);
+    std::printf("  wrote %s\n\n", header_path);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<const char*> logs;
+    for (int i = 1; i < argc; ++i) {
+        logs.push_back(argv[i]);
+    }
+    if (logs.empty()) {
+        logs = {"normal.csv", "touched.csv", "touched2.csv", "touched3.csv",
+                "temperature_data_20251122_135801.csv"};
+    }
+
+    const LayerSpec temp_specs[2] = {
+        {"TEMP_LAYER1", &TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, TEMP_LAYER1_INPUT_SIZE,
+         TEMP_LAYER1_OUTPUT_SIZE, ActivationType::ReLU},
+        {"TEMP_LAYER2", &TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS, TEMP_LAYER2_INPUT_SIZE,
+         TEMP_LAYER2_OUTPUT_SIZE, ActivationType::Softmax},
+    };
+    const LayerSpec blob_specs[2] = {
+        {"LAYER1", &LAYER1_WEIGHTS[0][0], LAYER1_BIAS, LAYER1_INPUT_SIZE, LAYER1_OUTPUT_SIZE,
+         ActivationType::ReLU},
+        {"LAYER2", &LAYER2_WEIGHTS[0][0], LAYER2_BIAS, LAYER2_INPUT_SIZE, LAYER2_OUTPUT_SIZE,
+         ActivationType::Softmax},
+    };
+
+    std::printf("16-entry codebook weights vs float\n\n");
+    std::printf("  %-38s %7s %12s %10s %10s\n", "evaluation set", "count", "max |dprob|",
+                "argmax", "decision");
+
+    std::vector<std::vector<float>> windows;
+    std::vector<float> calibration;
+    for (const char* path : logs) {
+        windows.push_back(windows_of(read_temperatures(path), TEMP_LAYER1_INPUT_SIZE));
+        calibration.insert(calibration.end(), windows.back().begin(), windows.back().end());
+    }
+    if (calibration.empty()) {
+        std::fprintf(stderr, "error: no temperature windows to evaluate on\n");
+        return 1;
+    }
+
+    Variants temp(temp_specs, calibration);
+    std::printf("Temperature model 10-8-2 (temp_model_weights.h), decision at p > %.2f\n",
+                static_cast<double>(kDetectionThreshold));
+    for (size_t k = 0; k < logs.size(); ++k) {
+        if (!windows[k].empty()) {
+            temp.report(logs[k], windows[k], true);
+        }
+    }
+    print_layers(temp_specs, temp);
+    bool ok = write_header("Miko/temp_model_weights_codebook.h", "TEMP_MODEL_WEIGHTS_CODEBOOK_H",
+                           "temp_model_weights.h", temp_specs, temp);
+
+    const std::vector<float> grid = blob_grid();
+    Variants blobs(blob_specs, grid);
+    std::printf("Blob model 2-18-3 (model_weights.h)\n");
+    blobs.report("grid over [-12, 12]^2, step 0.5", grid, false);
+    print_layers(blob_specs, blobs);
+    ok = write_header("Miko/model_weights_codebook.h", "MODEL_WEIGHTS_CODEBOOK_H",
+                      "model_weights.h", blob_specs, blobs) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,241 @@
+// tools/export_model.cpp
+// Exports the float weight headers in Miko/ as binary model files (see
+// Miko/model_file.h) and as headers that embed the same bytes for flash.
+//
+// Usage: ./export_model [f32|fp16|bf16] [temperature.csv...]
+// Run from the repository root (`make export` does this). Each file is
+// reloaded through ModelFile::open() and compared with the in-memory
+// model: the temperature model on sliding windows over each log (default:
+// every stored log), the 2-18-3 demo model on a grid covering the
+// training blobs. Writes models/temp_model.cnnm, models/model.cnnm,
+// Miko/temp_model_weights_file.h and Miko/model_weights_file.h.
+//
+// scripts/export_model.py writes the same format from a trained Keras or
+// TFLite model of any depth.
+
+#include "model_file.h"
+#include "half.h"
+#include "neural_network.h"
+#include "temp_model_weights.h"
+#include "model_weights.h"
+#include "temperature_logs.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace CustomNN;
+
+namespace {
+
+const char* dtype_name(ModelDType dtype) {
+    switch (dtype) {
+        case ModelDType::FP16:
+            return "FP16";
+        case ModelDType::BF16:
+            return "BF16";
+        case ModelDType::F32:
+            break;
+    }
+    return "F32";
+}
+
+bool parse_dtype(const char* name, ModelDType& dtype) {
+    for (ModelDType candidate : {ModelDType::F32, ModelDType::FP16, ModelDType::BF16}) {
+        const char* upper = dtype_name(candidate);
+        size_t k = 0;
+        while (upper[k] != '\0' && std::tolower(upper[k]) == name[k]) {
+            ++k;
+        }
+        if (upper[k] == '\0' && name[k] == '\0') {
+            dtype = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 2-D grid over [-12, 12]^2: make_blobs(random_state=42) centres lie in
+// [-10, 10] with unit spread
+std::vector<float> blob_grid() {
+    std::vector<float> samples;
+    for (int y = -24; y <= 24; ++y) {
+        for (int x = -24; x <= 24; ++x) {
+            samples.push_back(0.5f * static_cast<float>(x));
+            samples.push_back(0.5f * static_cast<float>(y));
+        }
+    }
+    return samples;
+}
+
+// The layer the file should reproduce bit for bit: DenseLayer for F32,
+// HalfDenseLayer for the half formats. Owned by the caller.
+Layer* reference_layer(const ModelExportLayer& layer) {
+    if (layer.dtype == ModelDType::F32) {
+        return new DenseLayer(layer.weights, layer.bias, layer.input_size, layer.output_size,
+                              layer.activation);
+    }
+    return new HalfDenseLayer(layer.weights, layer.bias, layer.input_size, layer.output_size,
+                              layer.activation, (layer.dtype == ModelDType::BF16)
+                                                    ? HalfFormat::BF16 : HalfFormat::FP16);
+}
+
+/**
+ * Largest |difference| between the reloaded file and the in-memory model
+ */
+float compare(const ModelFile& file, const ModelExportLayer (&layers)[2],
+              const std::vector<float>& samples) {
+    Layer* l1 = reference_layer(layers[0]);
+    Layer* l2 = reference_layer(layers[1]);
+    const Layer* reference_layers[] = {l1, l2};
+    Sequential reference(reference_layers, 2, nullptr, nullptr, 0);
+    std::vector<float> work(std::max(reference.required_scratch(), file.required_scratch()));
+    Scratch scratch{work.data(), work.size()};
+
+    const size_t input_size = file.input_size();
+    const size_t output_size = file.output_size();
+    std::vector<float> expected(output_size);
+    std::vector<float> actual(output_size);
+    float max_diff = 0.0f;
+    for (size_t s = 0; s + input_size <= samples.size(); s += input_size) {
+        reference.predict(samples.data() + s, expected.data(), scratch);
+        file.predict(samples.data() + s, actual.data(), scratch);
+        for (size_t k = 0; k < output_size; ++k) {
+            max_diff = std::max(max_diff, std::abs(expected[k] - actual[k]));
+        }
+    }
+    delete l2;
+    delete l1;
+    return max_diff;
+}
+
+// The file's bytes as a 64-byte aligned array for ModelFile::attach()
+bool write_embedded_header(const char* header_path, const char* guard, const char* array,
+                           const char* source, ModelDType dtype,
+                           const std::vector<uint8_t>& bytes) {
+    FILE* out = std::fopen(header_path, "w");
+    if (out == nullptr) {
+        std::fprintf(stderr, "error: cannot write %s\n", header_path);
+        return false;
+    }
+    std::fprintf(out, "// Model file for %s (CNNM v%u.%u, %s weights, %zu bytes)\n", source,
+                 static_cast<unsigned>(ModelFile::kVersionMajor),
+                 static_cast<unsigned>(ModelFile::kVersionMinor), dtype_name(dtype),
+                 bytes.size());
+    std::fprintf(out, "// Generated by tools/export_model (make export)\n");
+    std::fprintf(out, "// DO NOT EDIT MANUALLY\n");
+    std::fprintf(out, "//\n");
+    std::fprintf(out, "// Byte for byte the .cnnm file, so it can be used from flash with\n");
+    std::fprintf(out, "// ModelFile::attach(%s, sizeof(%s)).\n\n", array, array);
+    std::fprintf(out, "#ifndef %s\n#define %s\n\n", guard, guard);
+    std::fprintf(out, "#include <cstdint>\n\n");
+    std::fprintf(out, "alignas(64) constexpr uint8_t %s[%zu] = {", array, bytes.size());
+    for (size_t k = 0; k < bytes.size(); ++k) {
+        std::fprintf(out, "%s%s0x%02X", (k == 0) ? "" : ",", (k % 16 == 0) ? "\n    " : " ",
+                     static_cast<unsigned>(bytes[k]));
+    }
+    std::fprintf(out, "\n};\n\n#endif // %s\n", guard);
+    std::fclose(out);
+    std::printf("  wrote %s\n", header_path);
+    return true;
+}
+
+/**
+ * Write one model as a file and an embedded header, then reload the file
+ * and check it against the in-memory model
+ */
+bool export_model(const char* file_path, const char* header_path, const char* guard,
+                  const char* array, const char* source, const ModelExportLayer (&layers)[2],
+                  const std::vector<std::vector<float>>& sample_sets) {
+    const size_t size = ModelFile::serialized_size(layers, 2);
+    std::vector<uint8_t> bytes(size);
+    if (size == 0 || ModelFile::serialize(layers, 2, bytes.data(), size) != size ||
+        !ModelFile::write(file_path, layers, 2)) {
+        std::fprintf(stderr, "error: cannot write %s\n", file_path);
+        return false;
+    }
+    std::printf("  wrote %s (%zu bytes)\n", file_path, size);
+
+    ModelFile file;
+    if (!file.open(file_path)) {
+        std::fprintf(stderr, "error: %s does not load: %s\n", file_path,
+                     ModelFile::error_name(file.error()));
+        return false;
+    }
+    float max_diff = 0.0f;
+    size_t count = 0;
+    for (const std::vector<float>& samples : sample_sets) {
+        max_diff = std::max(max_diff, compare(file, layers, samples));
+        count += samples.size() / file.input_size();
+    }
+    std::printf("  reloaded: %zu layers, %zu -> %zu, max |diff| vs in-memory model %.3g "
+                "on %zu samples\n", file.num_layers(), file.input_size(), file.output_size(),
+                static_cast<double>(max_diff), count);
+    if (max_diff != 0.0f) {
+        std::fprintf(stderr, "error: %s does not reproduce the model\n", file_path);
+        return false;
+    }
+    return write_embedded_header(header_path, guard, array, source, layers[0].dtype, bytes);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    ModelDType dtype = ModelDType::F32;
+    int first_log = 1;
+    if (argc > 1 && parse_dtype(argv[1], dtype)) {
+        first_log = 2;
+    }
+    std::vector<const char*> logs;
+    for (int i = first_log; i < argc; ++i) {
+        logs.push_back(argv[i]);
+    }
+    if (logs.empty()) {
+        logs = {"normal.csv", "touched.csv", "touched2.csv", "touched3.csv",
+                "temperature_data_20251122_135801.csv"};
+    }
+
+    const ModelExportLayer temp_layers[2] = {
+        {&TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, TEMP_LAYER1_INPUT_SIZE,
+         TEMP_LAYER1_OUTPUT_SIZE, ActivationType::ReLU, dtype},
+        {&TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS, TEMP_LAYER2_INPUT_SIZE,
+         TEMP_LAYER2_OUTPUT_SIZE, ActivationType::Softmax, dtype},
+    };
+    const ModelExportLayer blob_layers[2] = {
+        {&LAYER1_WEIGHTS[0][0], LAYER1_BIAS, LAYER1_INPUT_SIZE, LAYER1_OUTPUT_SIZE,
+         ActivationType::ReLU, dtype},
+        {&LAYER2_WEIGHTS[0][0], LAYER2_BIAS, LAYER2_INPUT_SIZE, LAYER2_OUTPUT_SIZE,
+         ActivationType::Softmax, dtype},
+    };
+
+    std::printf("Model files (CNNM v%u.%u), %s weights\n\n",
+                static_cast<unsigned>(ModelFile::kVersionMajor),
+                static_cast<unsigned>(ModelFile::kVersionMinor), dtype_name(dtype));
+
+    std::vector<std::vector<float>> temp_samples;
+    for (const char* path : logs) {
+        std::vector<float> windows = windows_of(read_temperatures(path), TEMP_LAYER1_INPUT_SIZE);
+        if (!windows.empty()) {
+            temp_samples.push_back(std::move(windows));
+        }
+    }
+    if (temp_samples.empty()) {
+        std::fprintf(stderr, "error: no temperature windows to check the export on\n");
+        return 1;
+    }
+
+    std::printf("Temperature model 10-8-2 (temp_model_weights.h)\n");
+    bool ok = export_model("models/temp_model.cnnm", "Miko/temp_model_weights_file.h",
+                           "TEMP_MODEL_WEIGHTS_FILE_H", "TEMP_MODEL_FILE",
+                           "temp_model_weights.h", temp_layers, temp_samples);
+
+    std::printf("\nBlob model 2-18-3 (model_weights.h)\n");
+    ok = export_model("models/model.cnnm", "Miko/model_weights_file.h",
+                      "MODEL_WEIGHTS_FILE_H", "MODEL_FILE", "model_weights.h",
+                      blob_layers, {blob_grid()}) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,290 @@
+// tools/half_weights.cpp
+// Converts the float weight headers in Miko/ to fp16 and bf16 headers for
+// the half-precision path (Miko/half.h) and reports the accuracy cost.
+//
+// Usage: ./half_weights [temperature.csv...]
+// Run from the repository root (`make half` does this). The temperature
+// model is compared with the float model on sliding windows over each log
+// (default: every stored log), the 2-18-3 demo model on a grid covering
+// the training blobs. Writes Miko/temp_model_weights_half.h and
+// Miko/model_weights_half.h.
+
+#include "half.h"
+#include "neural_network.h"
+#include "temp_model_weights.h"
+#include "model_weights.h"
+#include "temperature_logs.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace CustomNN;
+
+namespace {
+
+constexpr float kDetectionThreshold = 0.7f;   // DETECTION_THRESHOLD in Miko.cpp
+
+struct LayerSpec {
+    const char* prefix;      // e.g. "TEMP_LAYER1"
+    const float* weights;    // [input_size][output_size]
+    const float* bias;
+    size_t input_size;
+    size_t output_size;
+    ActivationType activation;
+};
+
+const char* activation_name(ActivationType activation) {
+    switch (activation) {
+        case ActivationType::ReLU:
+            return "ReLU";
+        case ActivationType::Softmax:
+            return "Softmax";
+        case ActivationType::None:
+            break;
+    }
+    return "None";
+}
+
+const char* format_name(HalfFormat format) {
+    return (format == HalfFormat::FP16) ? "FP16" : "BF16";
+}
+
+// 2-D grid over [-12, 12]^2: make_blobs(random_state=42) centres lie in
+// [-10, 10] with unit spread
+std::vector<float> blob_grid() {
+    std::vector<float> samples;
+    for (int y = -24; y <= 24; ++y) {
+        for (int x = -24; x <= 24; ++x) {
+            samples.push_back(0.5f * static_cast<float>(x));
+            samples.push_back(0.5f * static_cast<float>(y));
+        }
+    }
+    return samples;
+}
+
+/**
+ * Two-layer model in float and in both half formats
+ */
+class Variants {
+private:
+    DenseLayer d1_;
+    DenseLayer d2_;
+    HalfDenseLayer h1_[2];
+    HalfDenseLayer h2_[2];
+    std::vector<float> hidden_;
+
+public:
+    explicit Variants(const LayerSpec (&specs)[2])
+      : d1_(specs[0].weights, specs[0].bias, specs[0].input_size, specs[0].output_size,
+            specs[0].activation),
+        d2_(specs[1].weights, specs[1].bias, specs[1].input_size, specs[1].output_size,
+            specs[1].activation),
+        h1_{HalfDenseLayer(specs[0].weights, specs[0].bias, specs[0].input_size,
+                           specs[0].output_size, specs[0].activation, HalfFormat::FP16),
+            HalfDenseLayer(specs[0].weights, specs[0].bias, specs[0].input_size,
+                           specs[0].output_size, specs[0].activation, HalfFormat::BF16)},
+        h2_{HalfDenseLayer(specs[1].weights, specs[1].bias, specs[1].input_size,
+                           specs[1].output_size, specs[1].activation, HalfFormat::FP16),
+            HalfDenseLayer(specs[1].weights, specs[1].bias, specs[1].input_size,
+                           specs[1].output_size, specs[1].activation, HalfFormat::BF16)},
+        hidden_(specs[0].output_size) {}
+
+    const HalfDenseLayer& layer(size_t l, HalfFormat format) const {
+        const size_t f = (format == HalfFormat::FP16) ? 0 : 1;
+        return (l == 0) ? h1_[f] : h2_[f];
+    }
+
+    /**
+     * Compare one half format with float on samples and print a report line
+     */
+    void report(const char* label, HalfFormat format, const std::vector<float>& samples,
+                bool threshold) {
+        const size_t input_size = d1_.input_size();
+        const size_t output_size = d2_.output_size();
+        const size_t count = samples.size() / input_size;
+
+        const Layer* float_layers[] = {&d1_, &d2_};
+        const Layer* half_layers[] = {&layer(0, format), &layer(1, format)};
+        Sequential reference(float_layers, 2, hidden_.data(), nullptr, hidden_.size());
+        Sequential half(half_layers, 2, hidden_.data(), nullptr, hidden_.size());
+
+        std::vector<float> expected(output_size);
+        std::vector<float> actual(output_size);
+        float max_diff = 0.0f;
+        size_t agree = 0;
+        size_t decisions = 0;
+        for (size_t s = 0; s < count; ++s) {
+            reference.predict(samples.data() + s * input_size, expected.data());
+            half.predict(samples.data() + s * input_size, actual.data());
+            for (size_t k = 0; k < output_size; ++k) {
+                max_diff = std::max(max_diff, std::abs(expected[k] - actual[k]));
+            }
+            agree += (Classify::argmax(expected.data(), output_size) ==
+                      Classify::argmax(actual.data(), output_size)) ? size_t{1} : size_t{0};
+            if (threshold) {
+                decisions += ((expected[1] > kDetectionThreshold) ==
+                              (actual[1] > kDetectionThreshold)) ? size_t{1} : size_t{0};
+            }
+        }
+
+        std::printf("  %-38s %s %7zu %12.3g %9.2f%%", label, format_name(format), count,
+                    static_cast<double>(max_diff),
+                    100.0 * static_cast<double>(agree) / static_cast<double>(count));
+        if (threshold) {
+            std::printf(" %9.2f%%", 100.0 * static_cast<double>(decisions) /
+                                    static_cast<double>(count));
+        }
+        std::printf("\n");
+    }
+};
+
+// Largest |w - widen(narrow(w))| over a layer's weights
+float max_weight_error(const LayerSpec& spec, HalfFormat format) {
+    float worst = 0.0f;
+    for (size_t k = 0; k < spec.input_size * spec.output_size; ++k) {
+        const float w = spec.weights[k];
+        worst = std::max(worst, std::abs(w - HalfOps::to_float(HalfOps::from_float(w, format),
+                                                               format)));
+    }
+    return worst;
+}
+
+void write_layer(FILE* out, const LayerSpec& spec, const Variants& variants, size_t index) {
+    const size_t count = spec.input_size * spec.output_size;
+    std::fprintf(out, "// Layer %zu: Dense(%zu, %s), weights [%zu][%zu]\n", index + 1,
+                 spec.output_size, activation_name(spec.activation), spec.input_size,
+                 spec.output_size);
+
+    for (HalfFormat format : {HalfFormat::FP16, HalfFormat::BF16}) {
+        const HalfDense& h = variants.layer(index, format).params();
+        std::fprintf(out, "constexpr uint16_t %s_%s_WEIGHTS[%zu] = {", spec.prefix,
+                     format_name(format), count);
+        for (size_t k = 0; k < count; ++k) {
+            std::fprintf(out, "%s%s0x%04X", (k == 0) ? "" : ",", (k % 10 == 0) ? "\n    " : " ",
+                         static_cast<unsigned>(h.weights[k]));
+        }
+        std::fprintf(out, "\n};\n\n");
+    }
+
+    std::fprintf(out, "constexpr float %s_HALF_BIAS[%zu] = {\n    ", spec.prefix,
+                 spec.output_size);
+    for (size_t j = 0; j < spec.output_size; ++j) {
+        std::fprintf(out, "%s%.9ef", (j == 0) ? "" : ", ", static_cast<double>(spec.bias[j]));
+    }
+    std::fprintf(out, "\n};\n\n");
+
+    for (HalfFormat format : {HalfFormat::FP16, HalfFormat::BF16}) {
+        std::fprintf(out, "constexpr CustomNN::HalfDense %s_%s = {\n", spec.prefix,
+                     format_name(format));
+        std::fprintf(out, "    %s_%s_WEIGHTS, %s_HALF_BIAS,\n", spec.prefix, format_name(format),
+                     spec.prefix);
+        std::fprintf(out, "    %zu, %zu,\n", spec.input_size, spec.output_size);
+        std::fprintf(out, "    CustomNN::HalfFormat::%s,\n", format_name(format));
+        std::fprintf(out, "    CustomNN::ActivationType::%s\n};\n\n",
+                     activation_name(spec.activation));
+    }
+}
+
+bool write_header(const char* header_path, const char* guard, const char* source,
+                  const LayerSpec (&specs)[2], const Variants& variants) {
+    FILE* out = std::fopen(header_path, "w");
+    if (out == nullptr) {
+        std::fprintf(stderr, "error: cannot write %s\n", header_path);
+        return false;
+    }
+    std::fprintf(out, "// Half-precision weights for %s\n", source);
+    std::fprintf(out, "// Generated by tools/half_weights (make half)\n");
+    std::fprintf(out, "// DO NOT EDIT MANUALLY\n");
+    std::fprintf(out, "//\n");
+    std::fprintf(out, "// Each layer in fp16 (_FP16) and bf16 (_BF16), rounded to nearest even;\n");
+    std::fprintf(out, "// unused arrays are dropped by the linker. Biases stay float.\n\n");
+    std::fprintf(out, "#ifndef %s\n#define %s\n\n", guard, guard);
+    std::fprintf(out, "#include <cstdint>\n#include \"half.h\"\n\n");
+    write_layer(out, specs[0], variants, 0);
+    write_layer(out, specs[1], variants, 1);
+    std::fprintf(out, "#endif // %s\n", guard);
+    std::fclose(out);
+    std::printf("  wrote %s\n\n", header_path);
+    return true;
+}
+
+void print_footprint(const LayerSpec (&specs)[2]) {
+    size_t float_bytes = 0;
+    size_t half_bytes = 0;
+    for (const LayerSpec& spec : specs) {
+        float_bytes += (spec.input_size + 1) * spec.output_size * sizeof(float);
+        half_bytes += HalfOps::storage_bytes(spec.input_size, spec.output_size);
+        std::printf("  %s: max |w - stored w|  FP16 %.3g  BF16 %.3g\n", spec.prefix,
+                    static_cast<double>(max_weight_error(spec, HalfFormat::FP16)),
+                    static_cast<double>(max_weight_error(spec, HalfFormat::BF16)));
+    }
+    std::printf("  weights + bias: %zu B float -> %zu B half (%.2fx)\n", float_bytes, half_bytes,
+                static_cast<double>(float_bytes) / static_cast<double>(half_bytes));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<const char*> logs;
+    for (int i = 1; i < argc; ++i) {
+        logs.push_back(argv[i]);
+    }
+    if (logs.empty()) {
+        logs = {"normal.csv", "touched.csv", "touched2.csv", "touched3.csv",
+                "temperature_data_20251122_135801.csv"};
+    }
+
+    const LayerSpec temp_specs[2] = {
+        {"TEMP_LAYER1", &TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, TEMP_LAYER1_INPUT_SIZE,
+         TEMP_LAYER1_OUTPUT_SIZE, ActivationType::ReLU},
+        {"TEMP_LAYER2", &TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS, TEMP_LAYER2_INPUT_SIZE,
+         TEMP_LAYER2_OUTPUT_SIZE, ActivationType::Softmax},
+    };
+    const LayerSpec blob_specs[2] = {
+        {"LAYER1", &LAYER1_WEIGHTS[0][0], LAYER1_BIAS, LAYER1_INPUT_SIZE, LAYER1_OUTPUT_SIZE,
+         ActivationType::ReLU},
+        {"LAYER2", &LAYER2_WEIGHTS[0][0], LAYER2_BIAS, LAYER2_INPUT_SIZE, LAYER2_OUTPUT_SIZE,
+         ActivationType::Softmax},
+    };
+
+    std::printf("Half-precision weights vs float (kernels: %s)\n\n", HalfOps::kernel_name());
+    std::printf("  %-38s %4s %7s %12s %10s %10s\n", "evaluation set", "fmt", "count",
+                "max |dprob|", "argmax", "decision");
+
+    Variants temp(temp_specs);
+    std::printf("Temperature model 10-8-2 (temp_model_weights.h), decision at p > %.2f\n",
+                static_cast<double>(kDetectionThreshold));
+    bool any = false;
+    for (const char* path : logs) {
+        const std::vector<float> windows = windows_of(read_temperatures(path),
+                                                      TEMP_LAYER1_INPUT_SIZE);
+        if (windows.empty()) {
+            continue;
+        }
+        any = true;
+        for (HalfFormat format : {HalfFormat::FP16, HalfFormat::BF16}) {
+            temp.report(path, format, windows, true);
+        }
+    }
+    if (!any) {
+        std::fprintf(stderr, "error: no temperature windows to evaluate on\n");
+        return 1;
+    }
+    print_footprint(temp_specs);
+    bool ok = write_header("Miko/temp_model_weights_half.h", "TEMP_MODEL_WEIGHTS_HALF_H",
+                           "temp_model_weights.h", temp_specs, temp);
+
+    Variants blobs(blob_specs);
+    std::printf("Blob model 2-18-3 (model_weights.h)\n");
+    for (HalfFormat format : {HalfFormat::FP16, HalfFormat::BF16}) {
+        blobs.report("grid over [-12, 12]^2, step 0.5", format, blob_grid(), false);
+    }
+    print_footprint(blob_specs);
+    ok = write_header("Miko/model_weights_half.h", "MODEL_WEIGHTS_HALF_H", "model_weights.h",
+                      blob_specs, blobs) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,302 @@
+// tools/prune_weights.cpp
+// Magnitude-prunes the float weight headers in Miko/ and writes CSR headers
+// for the sparse inference path (Miko/sparse.h).
+//
+// Usage: ./prune_weights [density] [temperature.csv...]
+// Run from the repository root (`make prune` does this). Every layer keeps
+// the given fraction of its largest-magnitude weights (default 0.5) and
+// folds the mean contribution of the dropped ones into its bias. The
+// pruned temperature model is checked against the float model on sliding
+// windows over the given logs (default: normal.csv touched.csv), the
+// 2-18-3 demo model on a grid covering the training blobs. Writes
+// Miko/temp_model_weights_sparse.h and Miko/model_weights_sparse.h and
+// prints an accuracy / footprint report.
+
+#include "neural_network.h"
+#include "sparse.h"
+#include "temp_model_weights.h"
+#include "model_weights.h"
+#include "temperature_logs.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace CustomNN;
+
+namespace {
+
+struct LayerSpec {
+    const char* prefix;      // e.g. "TEMP_LAYER1"
+    const float* weights;    // [input_size][output_size]
+    const float* bias;
+    size_t input_size;
+    size_t output_size;
+    ActivationType activation;
+};
+
+const char* activation_name(ActivationType activation) {
+    switch (activation) {
+        case ActivationType::ReLU:
+            return "ReLU";
+        case ActivationType::Softmax:
+            return "Softmax";
+        case ActivationType::None:
+            break;
+    }
+    return "None";
+}
+
+// 2-D grid over [-12, 12]^2: make_blobs(random_state=42) centres lie in
+// [-10, 10] with unit spread
+std::vector<float> blob_grid() {
+    std::vector<float> samples;
+    for (int y = -24; y <= 24; ++y) {
+        for (int x = -24; x <= 24; ++x) {
+            samples.push_back(0.5f * static_cast<float>(x));
+            samples.push_back(0.5f * static_cast<float>(y));
+        }
+    }
+    return samples;
+}
+
+void write_layer(FILE* out, const LayerSpec& spec, const SparseDenseLayer& layer,
+                 const char* number) {
+    const SparseDense& s = layer.params();
+    const size_t nonzeros = layer.nonzeros();
+    const std::string name = std::string(spec.prefix) + "_SPARSE";
+
+    std::fprintf(out, "// Layer %s: Dense(%zu, %s) - %zu of %zu weights kept, CSR by output\n",
+                 number, s.output_size, activation_name(s.activation), nonzeros,
+                 s.input_size * s.output_size);
+    // Zero-length arrays are not allowed; a fully pruned layer keeps one
+    // unused entry
+    const size_t stored = std::max<size_t>(nonzeros, 1);
+    std::fprintf(out, "constexpr float %s_VALUES[%zu] = {", name.c_str(), stored);
+    for (size_t k = 0; k < stored; ++k) {
+        std::fprintf(out, "%s%s%.9ef", (k == 0) ? "" : ",", (k % 6 == 0) ? "\n    " : " ",
+                     static_cast<double>((k < nonzeros) ? s.values[k] : 0.0f));
+    }
+    std::fprintf(out, "\n};\n\n");
+
+    std::fprintf(out, "constexpr int16_t %s_INDICES[%zu] = {", name.c_str(), stored);
+    for (size_t k = 0; k < stored; ++k) {
+        std::fprintf(out, "%s%s%d", (k == 0) ? "" : ",", (k % 16 == 0) ? "\n    " : " ",
+                     (k < nonzeros) ? s.indices[k] : 0);
+    }
+    std::fprintf(out, "\n};\n\n");
+
+    std::fprintf(out, "constexpr float %s_BIAS[%zu] = {\n    ", name.c_str(), s.output_size);
+    for (size_t j = 0; j < s.output_size; ++j) {
+        std::fprintf(out, "%s%.9ef", (j == 0) ? "" : ", ", static_cast<double>(s.bias[j]));
+    }
+    std::fprintf(out, "\n};\n\n");
+
+    std::fprintf(out, "constexpr uint16_t %s_ROW_START[%zu] = {\n    ", name.c_str(),
+                 s.output_size + 1);
+    for (size_t j = 0; j <= s.output_size; ++j) {
+        std::fprintf(out, "%s%u", (j == 0) ? "" : ", ", static_cast<unsigned>(s.row_start[j]));
+    }
+    std::fprintf(out, "\n};\n\n");
+
+    std::fprintf(out, "constexpr CustomNN::SparseDense %s = {\n", name.c_str());
+    std::fprintf(out, "    %s_VALUES, %s_INDICES, %s_ROW_START, %s_BIAS,\n", name.c_str(),
+                 name.c_str(), name.c_str(), name.c_str());
+    std::fprintf(out, "    %zu, %zu,\n", s.input_size, s.output_size);
+    std::fprintf(out, "    CustomNN::ActivationType::%s\n};\n\n", activation_name(s.activation));
+}
+
+/**
+ * Prune, convert, report and write one two-layer model
+ * @return false if a layer does not fit CSR or the output file failed
+ */
+bool convert_model(const char* title, const char* header_path, const char* guard,
+                   const char* source, const char* evaluation, float density,
+                   const LayerSpec (&specs)[2], const std::vector<float>& samples) {
+    const size_t input_size = specs[0].input_size;
+    const size_t output_size = specs[1].output_size;
+    const size_t count = samples.size() / input_size;
+
+    // Prune layer by layer. The expected contribution of the dropped
+    // weights (mean input * weight) is folded into the bias, which matters
+    // for inputs far from zero such as temperatures.
+    std::vector<float> pruned[2];
+    std::vector<float> bias[2];
+    std::vector<float> layer_inputs = samples;
+    std::vector<float> layer_outputs;
+    std::unique_ptr<SparseDenseLayer> layers[2];
+    for (size_t l = 0; l < 2; ++l) {
+        const LayerSpec& spec = specs[l];
+        pruned[l].resize(spec.input_size * spec.output_size);
+        SparseOps::prune(spec.weights, pruned[l].data(), pruned[l].size(), density);
+
+        std::vector<double> mean(spec.input_size, 0.0);
+        for (size_t s = 0; s < count; ++s) {
+            for (size_t i = 0; i < spec.input_size; ++i) {
+                mean[i] += layer_inputs[s * spec.input_size + i];
+            }
+        }
+        bias[l].assign(spec.bias, spec.bias + spec.output_size);
+        for (size_t j = 0; j < spec.output_size; ++j) {
+            double dropped = 0.0;
+            for (size_t i = 0; i < spec.input_size; ++i) {
+                const size_t k = i * spec.output_size + j;
+                dropped += static_cast<double>(spec.weights[k] - pruned[l][k]) *
+                           mean[i] / static_cast<double>(count);
+            }
+            bias[l][j] += static_cast<float>(dropped);
+        }
+
+        layers[l] = std::make_unique<SparseDenseLayer>(pruned[l].data(), bias[l].data(),
+                                                       spec.input_size, spec.output_size,
+                                                       spec.activation);
+        layer_outputs.resize(count * spec.output_size);
+        for (size_t s = 0; s < count; ++s) {
+            layers[l]->forward(layer_inputs.data() + s * spec.input_size,
+                               layer_outputs.data() + s * spec.output_size);
+        }
+        layer_inputs.swap(layer_outputs);
+    }
+    const SparseDenseLayer& s1 = *layers[0];
+    const SparseDenseLayer& s2 = *layers[1];
+    if (!s1.is_valid() || !s2.is_valid()) {
+        std::fprintf(stderr, "error: %s exceeds the CSR index limits\n", title);
+        return false;
+    }
+
+    // Accuracy against the unpruned float model
+    DenseLayer d1(specs[0].weights, specs[0].bias, specs[0].input_size, specs[0].output_size,
+                  specs[0].activation);
+    DenseLayer d2(specs[1].weights, specs[1].bias, specs[1].input_size, specs[1].output_size,
+                  specs[1].activation);
+    const Layer* dense_layers[] = {&d1, &d2};
+    const Layer* sparse_layers[] = {&s1, &s2};
+    std::vector<float> hidden(specs[0].output_size);
+    Sequential reference(dense_layers, 2, hidden.data(), nullptr, hidden.size());
+    Sequential sparse(sparse_layers, 2, hidden.data(), nullptr, hidden.size());
+
+    std::vector<float> expected(output_size);
+    std::vector<float> actual(output_size);
+    float max_diff = 0.0f;
+    size_t agree = 0;
+    for (size_t s = 0; s < count; ++s) {
+        reference.predict(samples.data() + s * input_size, expected.data());
+        sparse.predict(samples.data() + s * input_size, actual.data());
+        for (size_t k = 0; k < output_size; ++k) {
+            max_diff = std::max(max_diff, std::abs(expected[k] - actual[k]));
+        }
+        agree += (Classify::argmax(expected.data(), output_size) ==
+                  Classify::argmax(actual.data(), output_size)) ? size_t{1} : size_t{0};
+    }
+
+    size_t float_bytes = 0;
+    size_t sparse_bytes = 0;
+    std::printf("%s\n", title);
+    for (size_t l = 0; l < 2; ++l) {
+        const SparseDenseLayer& layer = (l == 0) ? s1 : s2;
+        const size_t total = specs[l].input_size * specs[l].output_size;
+        const size_t layer_float = (total + specs[l].output_size) * sizeof(float);
+        const size_t layer_sparse = SparseOps::storage_bytes(layer.nonzeros(),
+                                                             specs[l].output_size);
+        float_bytes += layer_float;
+        sparse_bytes += layer_sparse;
+        std::printf("  layer %zu: %3zu / %3zu weights kept (%.0f%%)  %4zu B dense -> %4zu B CSR\n",
+                    l + 1, layer.nonzeros(), total,
+                    100.0 * static_cast<double>(layer.nonzeros()) / static_cast<double>(total),
+                    layer_float, layer_sparse);
+    }
+    std::printf("  total: %zu B -> %zu B (%.2fx)\n", float_bytes, sparse_bytes,
+                static_cast<double>(float_bytes) / static_cast<double>(sparse_bytes));
+    std::printf("  max |prob diff| vs unpruned: %.4g   argmax agreement: %zu/%zu (%.2f%%) on %s\n",
+                static_cast<double>(max_diff), agree, count,
+                100.0 * static_cast<double>(agree) / static_cast<double>(count), evaluation);
+
+    FILE* out = std::fopen(header_path, "w");
+    if (out == nullptr) {
+        std::fprintf(stderr, "error: cannot write %s\n", header_path);
+        return false;
+    }
+    std::fprintf(out, "// Pruned CSR weights for %s\n", source);
+    std::fprintf(out, "// Generated by tools/prune_weights (make prune)\n");
+    std::fprintf(out, "// DO NOT EDIT MANUALLY\n");
+    std::fprintf(out, "//\n");
+    std::fprintf(out, "// Magnitude pruning to density %.3g per layer; each bias absorbs the\n",
+                 static_cast<double>(density));
+    std::fprintf(out, "// mean contribution of its dropped weights on %s.\n", evaluation);
+    std::fprintf(out, "// Argmax agreement with the unpruned model: %.2f%% on %s\n\n",
+                 100.0 * static_cast<double>(agree) / static_cast<double>(count), evaluation);
+    std::fprintf(out, "#ifndef %s\n#define %s\n\n", guard, guard);
+    std::fprintf(out, "#include <cstdint>\n#include \"sparse.h\"\n\n");
+    write_layer(out, specs[0], s1, "1");
+    write_layer(out, specs[1], s2, "2");
+    std::fprintf(out, "#endif // %s\n", guard);
+    std::fclose(out);
+
+    std::printf("  wrote %s\n\n", header_path);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    float density = 0.5f;
+    int first_log = 1;
+    if (argc > 1) {
+        char* end = nullptr;
+        const float value = std::strtof(argv[1], &end);
+        if (end != argv[1] && *end == '\0') {
+            if (value <= 0.0f || value > 1.0f) {
+                std::fprintf(stderr, "error: density must be in (0, 1]\n");
+                return 1;
+            }
+            density = value;
+            first_log = 2;
+        }
+    }
+
+    std::vector<const char*> logs;
+    for (int i = first_log; i < argc; ++i) {
+        logs.push_back(argv[i]);
+    }
+    if (logs.empty()) {
+        logs = {"normal.csv", "touched.csv"};
+    }
+
+    std::vector<float> windows;
+    std::string evaluation = "windows of";
+    for (const char* path : logs) {
+        append_windows(read_temperatures(path), TEMP_LAYER1_INPUT_SIZE, windows);
+        evaluation += std::string(" ") + path;
+    }
+    if (windows.empty()) {
+        std::fprintf(stderr, "error: no temperature windows to evaluate on\n");
+        return 1;
+    }
+
+    const LayerSpec temp_specs[2] = {
+        {"TEMP_LAYER1", &TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, TEMP_LAYER1_INPUT_SIZE,
+         TEMP_LAYER1_OUTPUT_SIZE, ActivationType::ReLU},
+        {"TEMP_LAYER2", &TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS, TEMP_LAYER2_INPUT_SIZE,
+         TEMP_LAYER2_OUTPUT_SIZE, ActivationType::Softmax},
+    };
+    const LayerSpec blob_specs[2] = {
+        {"LAYER1", &LAYER1_WEIGHTS[0][0], LAYER1_BIAS, LAYER1_INPUT_SIZE, LAYER1_OUTPUT_SIZE,
+         ActivationType::ReLU},
+        {"LAYER2", &LAYER2_WEIGHTS[0][0], LAYER2_BIAS, LAYER2_INPUT_SIZE, LAYER2_OUTPUT_SIZE,
+         ActivationType::Softmax},
+    };
+
+    std::printf("Magnitude pruning to density %.3g\n\n", static_cast<double>(density));
+    bool ok = convert_model("Temperature model 10-8-2 (temp_model_weights.h)",
+                            "Miko/temp_model_weights_sparse.h", "TEMP_MODEL_WEIGHTS_SPARSE_H",
+                            "temp_model_weights.h", evaluation.c_str(), density, temp_specs,
+                            windows);
+    ok = convert_model("Blob model 2-18-3 (model_weights.h)", "Miko/model_weights_sparse.h",
+                       "MODEL_WEIGHTS_SPARSE_H", "model_weights.h",
+                       "grid over [-12, 12]^2, step 0.5", density, blob_specs, blob_grid()) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,256 @@
+// tools/quantize_weights.cpp
+// Converts the float weight headers in Miko/ to int8 per-channel headers
+// for the integer-only inference path (Miko/quantized.h).
+//
+// Usage: ./quantize_weights [temperature.csv...]
+// Run from the repository root (`make quantize` does this). Activation
+// ranges are calibrated on sliding windows over the given temperature logs
+// (default: normal.csv touched.csv) for the temperature model, and on a
+// grid covering the training blobs for the 2-18-3 demo model. Writes
+// Miko/temp_model_weights_int8.h and Miko/model_weights_int8.h and prints
+// an accuracy / footprint report against the float model.
+
+#include "neural_network.h"
+#include "quantized.h"
+#include "temp_model_weights.h"
+#include "model_weights.h"
+#include "temperature_logs.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace CustomNN;
+
+namespace {
+
+struct LayerSpec {
+    const char* prefix;      // e.g. "TEMP_LAYER1"
+    const float* weights;    // [input_size][output_size]
+    const float* bias;
+    size_t input_size;
+    size_t output_size;
+    ActivationType activation;
+};
+
+const char* activation_name(ActivationType activation) {
+    switch (activation) {
+        case ActivationType::ReLU:
+            return "ReLU";
+        case ActivationType::Softmax:
+            return "Softmax";
+        case ActivationType::None:
+            break;
+    }
+    return "None";
+}
+
+// 2-D grid over [-12, 12]^2: make_blobs(random_state=42) centres lie in
+// [-10, 10] with unit spread
+std::vector<float> blob_grid() {
+    std::vector<float> samples;
+    for (int y = -24; y <= 24; ++y) {
+        for (int x = -24; x <= 24; ++x) {
+            samples.push_back(0.5f * static_cast<float>(x));
+            samples.push_back(0.5f * static_cast<float>(y));
+        }
+    }
+    return samples;
+}
+
+void write_layer(FILE* out, const LayerSpec& spec, const QuantizedDenseLayer& layer,
+                 const char* number) {
+    const QuantizedDense& q = layer.params();
+    const std::string name = std::string(spec.prefix) + "_Q8";
+
+    std::fprintf(out, "// Layer %s: Dense(%zu, %s) - int8 weights [%zu][%zu], output-major\n",
+                 number, q.output_size, activation_name(q.activation), q.output_size,
+                 q.input_size);
+    std::fprintf(out, "constexpr int8_t %s_WEIGHTS[%zu][%zu] = {\n", name.c_str(),
+                 q.output_size, q.input_size);
+    for (size_t j = 0; j < q.output_size; ++j) {
+        std::fprintf(out, "    {");
+        for (size_t i = 0; i < q.input_size; ++i) {
+            std::fprintf(out, "%s%d", (i == 0) ? "" : ", ", q.weights[j * q.input_size + i]);
+        }
+        std::fprintf(out, "}%s\n", (j + 1 == q.output_size) ? "" : ",");
+    }
+    std::fprintf(out, "};\n\n");
+
+    const struct {
+        const char* suffix;
+        const int32_t* values;
+    } vectors[] = {
+        {"BIAS", q.bias},
+        {"MULTIPLIER", q.multiplier},
+        {"SHIFT", q.shift},
+    };
+    for (const auto& vec : vectors) {
+        std::fprintf(out, "constexpr int32_t %s_%s[%zu] = {\n    ", name.c_str(), vec.suffix,
+                     q.output_size);
+        for (size_t j = 0; j < q.output_size; ++j) {
+            std::fprintf(out, "%s%d", (j == 0) ? "" : ", ", vec.values[j]);
+        }
+        std::fprintf(out, "\n};\n\n");
+    }
+
+    std::fprintf(out, "constexpr CustomNN::QuantizedDense %s = {\n", name.c_str());
+    std::fprintf(out, "    &%s_WEIGHTS[0][0], %s_BIAS, %s_MULTIPLIER, %s_SHIFT,\n",
+                 name.c_str(), name.c_str(), name.c_str(), name.c_str());
+    std::fprintf(out, "    %zu, %zu,\n", q.input_size, q.output_size);
+    std::fprintf(out, "    {%.9ef, %d},   // input: scale, zero point\n",
+                 static_cast<double>(q.input.scale), q.input.zero_point);
+    std::fprintf(out, "    {%.9ef, %d},   // output: scale, zero point\n",
+                 static_cast<double>(q.output.scale), q.output.zero_point);
+    std::fprintf(out, "    CustomNN::ActivationType::%s\n};\n\n", activation_name(q.activation));
+}
+
+/**
+ * Calibrate, convert, report and write one two-layer model
+ * @return false if calibration or the output file failed
+ */
+bool convert_model(const char* title, const char* header_path, const char* guard,
+                   const char* source, const char* calibration,
+                   const LayerSpec (&specs)[2], const std::vector<float>& samples) {
+    const size_t input_size = specs[0].input_size;
+    const size_t output_size = specs[1].output_size;
+    const size_t count = samples.size() / input_size;
+
+    DenseLayer l1(specs[0].weights, specs[0].bias, specs[0].input_size, specs[0].output_size,
+                  specs[0].activation);
+    DenseLayer l2(specs[1].weights, specs[1].bias, specs[1].input_size, specs[1].output_size,
+                  specs[1].activation);
+    const Layer* layers[] = {&l1, &l2};
+
+    QuantParams params[3];
+    if (!QuantOps::calibrate(layers, 2, samples.data(), count, params)) {
+        std::fprintf(stderr, "error: calibration failed for %s\n", title);
+        return false;
+    }
+
+    const QuantizedDenseLayer q1(specs[0].weights, specs[0].bias, specs[0].input_size,
+                                 specs[0].output_size, specs[0].activation, params[0], params[1]);
+    const QuantizedDenseLayer q2(specs[1].weights, specs[1].bias, specs[1].input_size,
+                                 specs[1].output_size, specs[1].activation, params[1], params[2]);
+
+    // Accuracy against the float model on the calibration set
+    std::vector<float> hidden(specs[0].output_size);
+    Sequential reference(layers, 2, hidden.data(), nullptr, hidden.size());
+
+    const QuantizedDense* qlayers[] = {&q1.params(), &q2.params()};
+    const size_t qscratch = QuantizedSequential::scratch_size_for(qlayers, 2);
+    std::vector<int8_t> qa(qscratch);
+    std::vector<int8_t> qb(qscratch);
+    QuantizedSequential quantized(qlayers, 2, qa.data(), qb.data(), qscratch);
+
+    std::vector<float> expected(output_size);
+    std::vector<float> actual(output_size);
+    float max_diff = 0.0f;
+    size_t agree = 0;
+    for (size_t s = 0; s < count; ++s) {
+        reference.predict(samples.data() + s * input_size, expected.data());
+        quantized.predict(samples.data() + s * input_size, actual.data());
+        for (size_t k = 0; k < output_size; ++k) {
+            max_diff = std::max(max_diff, std::abs(expected[k] - actual[k]));
+        }
+        const auto argmax = [](const std::vector<float>& v) {
+            return std::max_element(v.begin(), v.end()) - v.begin();
+        };
+        agree += (argmax(expected) == argmax(actual)) ? size_t{1} : size_t{0};
+    }
+
+    size_t float_bytes = 0;
+    size_t weight_bytes = 0;
+    size_t int8_bytes = 0;
+    for (const LayerSpec& spec : specs) {
+        weight_bytes += spec.input_size * spec.output_size;
+        float_bytes += (spec.input_size * spec.output_size + spec.output_size) * sizeof(float);
+        // int8 weights + int32 bias, multiplier and shift per channel
+        int8_bytes += spec.input_size * spec.output_size +
+                      3 * spec.output_size * sizeof(int32_t);
+    }
+
+    std::printf("%s\n", title);
+    std::printf("  calibration: %zu samples (%s)\n", count, calibration);
+    for (size_t i = 0; i < 3; ++i) {
+        std::printf("  %-8s scale %.6g  zero point %4d\n",
+                    (i == 0) ? "input" : (i == 1) ? "hidden" : "logits",
+                    static_cast<double>(params[i].scale), params[i].zero_point);
+    }
+    std::printf("  weights: %zu B float -> %zu B int8 (4.0x); with bias and requant params "
+                "%zu B -> %zu B (%.1fx)\n",
+                weight_bytes * sizeof(float), weight_bytes, float_bytes, int8_bytes,
+                static_cast<double>(float_bytes) / static_cast<double>(int8_bytes));
+    std::printf("  max |prob diff| vs float: %.4g   argmax agreement: %zu/%zu (%.2f%%)\n",
+                static_cast<double>(max_diff), agree, count,
+                100.0 * static_cast<double>(agree) / static_cast<double>(count));
+
+    FILE* out = std::fopen(header_path, "w");
+    if (out == nullptr) {
+        std::fprintf(stderr, "error: cannot write %s\n", header_path);
+        return false;
+    }
+    std::fprintf(out, "// Int8 quantized weights for %s\n", source);
+    std::fprintf(out, "// Generated by tools/quantize_weights (make quantize)\n");
+    std::fprintf(out, "// DO NOT EDIT MANUALLY\n");
+    std::fprintf(out, "//\n");
+    std::fprintf(out, "// Symmetric per-channel int8 weights, int32 bias with the input zero\n");
+    std::fprintf(out, "// point folded in, Q31 requantization multipliers.\n");
+    std::fprintf(out, "// Calibration: %zu samples (%s)\n\n", count, calibration);
+    std::fprintf(out, "#ifndef %s\n#define %s\n\n", guard, guard);
+    std::fprintf(out, "#include <cstdint>\n#include \"quantized.h\"\n\n");
+    write_layer(out, specs[0], q1, "1");
+    write_layer(out, specs[1], q2, "2");
+    std::fprintf(out, "#endif // %s\n", guard);
+    std::fclose(out);
+
+    std::printf("  wrote %s\n\n", header_path);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<const char*> logs;
+    for (int i = 1; i < argc; ++i) {
+        logs.push_back(argv[i]);
+    }
+    if (logs.empty()) {
+        logs = {"normal.csv", "touched.csv"};
+    }
+
+    std::vector<float> windows;
+    std::string calibration = "windows of";
+    for (const char* path : logs) {
+        append_windows(read_temperatures(path), TEMP_LAYER1_INPUT_SIZE, windows);
+        calibration += std::string(" ") + path;
+    }
+    if (windows.empty()) {
+        std::fprintf(stderr, "error: no temperature windows to calibrate on\n");
+        return 1;
+    }
+
+    const LayerSpec temp_specs[2] = {
+        {"TEMP_LAYER1", &TEMP_LAYER1_WEIGHTS[0][0], TEMP_LAYER1_BIAS, TEMP_LAYER1_INPUT_SIZE,
+         TEMP_LAYER1_OUTPUT_SIZE, ActivationType::ReLU},
+        {"TEMP_LAYER2", &TEMP_LAYER2_WEIGHTS[0][0], TEMP_LAYER2_BIAS, TEMP_LAYER2_INPUT_SIZE,
+         TEMP_LAYER2_OUTPUT_SIZE, ActivationType::Softmax},
+    };
+    const LayerSpec blob_specs[2] = {
+        {"LAYER1", &LAYER1_WEIGHTS[0][0], LAYER1_BIAS, LAYER1_INPUT_SIZE, LAYER1_OUTPUT_SIZE,
+         ActivationType::ReLU},
+        {"LAYER2", &LAYER2_WEIGHTS[0][0], LAYER2_BIAS, LAYER2_INPUT_SIZE, LAYER2_OUTPUT_SIZE,
+         ActivationType::Softmax},
+    };
+
+    bool ok = convert_model("Temperature model 10-8-2 (temp_model_weights.h)",
+                            "Miko/temp_model_weights_int8.h", "TEMP_MODEL_WEIGHTS_INT8_H",
+                            "temp_model_weights.h", calibration.c_str(), temp_specs, windows);
+    ok = convert_model("Blob model 2-18-3 (model_weights.h)", "Miko/model_weights_int8.h",
+                       "MODEL_WEIGHTS_INT8_H", "model_weights.h",
+                       "grid over [-12, 12]^2, step 0.5", blob_specs, blob_grid()) && ok;
+    return ok ? 0 : 1;
+}
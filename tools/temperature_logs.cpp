@@ -0,0 +1,39 @@
+// tools/temperature_logs.cpp
+// Temperature log reading implementation.
+
+#include "temperature_logs.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+std::vector<float> read_temperatures(const char* path) {
+    std::vector<float> values;
+    FILE* file = std::fopen(path, "r");
+    if (file == nullptr) {
+        std::fprintf(stderr, "warning: cannot open %s\n", path);
+        return values;
+    }
+    char line[128];
+    while (std::fgets(line, sizeof(line), file) != nullptr) {
+        char* end = nullptr;
+        const float value = std::strtof(line, &end);
+        if (end != line) {
+            values.push_back(value);
+        }
+    }
+    std::fclose(file);
+    return values;
+}
+
+void append_windows(const std::vector<float>& values, size_t width, std::vector<float>& out) {
+    for (size_t start = 0; start + width <= values.size(); ++start) {
+        out.insert(out.end(), values.begin() + static_cast<std::ptrdiff_t>(start),
+                   values.begin() + static_cast<std::ptrdiff_t>(start + width));
+    }
+}
+
+std::vector<float> windows_of(const std::vector<float>& values, size_t width) {
+    std::vector<float> out;
+    append_windows(values, width, out);
+    return out;
+}
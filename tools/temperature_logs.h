@@ -0,0 +1,33 @@
+// tools/temperature_logs.h
+// Temperature log (CSV) reading and sliding windows, shared by the weight
+// tools and the tester.
+
+#ifndef TEMPERATURE_LOGS_H
+#define TEMPERATURE_LOGS_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Read a temperature log: one reading per line, the value first (any
+ * further columns are ignored); headers and blank lines are skipped
+ * @param path CSV file
+ * @return The readings in file order; empty, with a warning on stderr, if
+ *         the file cannot be opened
+ */
+std::vector<float> read_temperatures(const char* path);
+
+/**
+ * Append every sliding window of `width` consecutive readings, flattened
+ * @param values Readings
+ * @param width Readings per window
+ * @param out Windows [count][width], appended to
+ */
+void append_windows(const std::vector<float>& values, size_t width, std::vector<float>& out);
+
+/**
+ * append_windows() into a new vector
+ */
+std::vector<float> windows_of(const std::vector<float>& values, size_t width);
+
+#endif // TEMPERATURE_LOGS_H